@@ -0,0 +1,133 @@
+
+// Project Includes
+#include "BinaryCursor.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------------------
+BinaryCursor::BinaryCursor(const unsigned char * data, const size_t size)
+    :
+    m_data    (data),
+    m_size    (size),
+    m_position(0)
+{
+}
+
+//------------------------------------------------------------------------------------------
+const size_t BinaryCursor::GetPosition() const
+{
+    return m_position;
+}
+
+//------------------------------------------------------------------------------------------
+const size_t BinaryCursor::GetRemaining() const
+{
+    return m_size - m_position;
+}
+
+//------------------------------------------------------------------------------------------
+const bool BinaryCursor::IsEnd() const
+{
+    return m_position >= m_size;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned BinaryCursor::ReadUInt8()
+{
+    Require(1);
+
+    unsigned value = m_data[m_position];
+    m_position += 1;
+
+    return value;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned BinaryCursor::ReadUInt32()
+{
+    Require(4);
+
+    unsigned int value = 0;
+    memcpy(&value, m_data + m_position, 4);
+    m_position += 4;
+
+    return value;
+}
+
+//------------------------------------------------------------------------------------------
+const float BinaryCursor::ReadFloat()
+{
+    Require(4);
+
+    float value = 0.0f;
+    memcpy(&value, m_data + m_position, 4);
+    m_position += 4;
+
+    return value;
+}
+
+//------------------------------------------------------------------------------------------
+void BinaryCursor::ReadString(std::string & value)
+{
+    const void * terminator = NULL;
+
+    if( m_position < m_size )
+    {
+        terminator = memchr(m_data + m_position, 0x00, m_size - m_position);
+    }
+
+    if( !terminator )
+    {
+        std::ostringstream msg;
+        msg << "Unterminated string at offset " << m_position;
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    const unsigned char * start  = m_data + m_position;
+    const size_t          length = static_cast<const unsigned char *>(terminator) - start;
+
+    value.assign(reinterpret_cast<const char *>(start), length);
+    m_position += length + 1;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned char * BinaryCursor::ReadBytes(const size_t numBytes)
+{
+    Require(numBytes);
+
+    const unsigned char * block = m_data + m_position;
+    m_position += numBytes;
+
+    return block;
+}
+
+//------------------------------------------------------------------------------------------
+void BinaryCursor::Seek(const size_t position)
+{
+    if( position > m_size )
+    {
+        std::ostringstream msg;
+        msg << "Cannot seek to offset " << position << " in data of size " << m_size;
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    m_position = position;
+}
+
+//------------------------------------------------------------------------------------------
+void BinaryCursor::Require(const size_t numBytes) const
+{
+    // Written so that a huge numBytes cannot overflow the check
+    if( numBytes > m_size - m_position )
+    {
+        std::ostringstream msg;
+        msg << "Unexpected end of data. Needed " << numBytes << " bytes at offset " << m_position
+            << ", but only " << (m_size - m_position) << " remain";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+}
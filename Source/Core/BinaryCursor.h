@@ -0,0 +1,108 @@
+#ifndef BINARYCURSOR_H
+#define BINARYCURSOR_H
+
+// EngineX Includes
+#include "Core\BinaryReader.h"
+
+// Standard Includes
+#include <cstddef>
+#include <string>
+
+//------------------------------------------------------------------------------------------
+/**
+* Bounds checked, forward reading cursor over a block of binary data in memory
+*
+* Reads never copy more than the value being read, and ReadBytes hands out a pointer directly into 
+* the underlying data, which stays valid for as long as the data does.
+**/
+class BinaryCursor : public BinaryReader
+{
+public:
+
+   /**
+   * Constructor
+   *
+   * @param data - Start of the data to read. The data must outlive the cursor.
+   * @param size - Size of the data in bytes
+   **/
+   BinaryCursor(const unsigned char * data, const size_t size);
+
+   /**
+   * Gets the offset, in bytes, from the start of the data to the next byte to be read
+   **/
+   virtual const size_t GetPosition() const;
+
+   /**
+   * Gets the number of bytes left to read
+   **/
+   virtual const size_t GetRemaining() const;
+
+   /**
+   * Query whether all the data has been read
+   **/
+   virtual const bool IsEnd() const;
+
+
+   /**
+   * Reads a 1 byte unsigned integral value
+   *
+   * @throws BaseException - If there is not enough data left
+   **/
+   virtual const unsigned ReadUInt8();
+
+   /**
+   * Reads a 4 byte unsigned integral value
+   *
+   * @throws BaseException - If there is not enough data left
+   **/
+   virtual const unsigned ReadUInt32();
+
+   /**
+   * Reads a 4 byte floating point value
+   *
+   * @throws BaseException - If there is not enough data left
+   **/
+   virtual const float ReadFloat();
+
+   /**
+   * Reads a null terminated string
+   *
+   * @param value OUT - The string, without the null terminator
+   *
+   * @throws BaseException - If the data ends before a null terminator is found
+   **/
+   virtual void ReadString(std::string & value);
+
+   /**
+   * Reads a block of bytes without copying it
+   *
+   * @param numBytes - Number of bytes to read
+   * @return         - Pointer to the first byte of the block, inside the data the cursor was created with
+   *
+   * @throws BaseException - If there is not enough data left
+   **/
+   virtual const unsigned char * ReadBytes(const size_t numBytes);
+
+   /**
+   * Moves the cursor to an absolute offset from the start of the data
+   *
+   * @throws BaseException - If the offset is past the end of the data
+   **/
+   void Seek(const size_t position);
+
+private:
+
+   /**
+   * Checks that a number of bytes can be read from the current position
+   *
+   * @throws BaseException - If there is not enough data left
+   **/
+   void Require(const size_t numBytes) const;
+
+
+   const unsigned char * m_data;       // Start of the data
+   size_t                m_size;       // Size of the data in bytes
+   size_t                m_position;   // Offset of the next byte to be read
+};
+
+#endif // BINARYCURSOR_H
@@ -0,0 +1,237 @@
+
+// Project Includes
+#include "BinaryFileReader.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------------------
+BinaryFileReader::BinaryFileReader(const std::string & filePath, const size_t bufferSize)
+    :
+    m_filePath   (filePath),
+    m_fileSize   (0),
+    m_position   (0),
+    m_bufferStart(0),
+    m_bufferEnd  (0)
+{
+    if( bufferSize == 0 )
+    {
+        const std::string msg("The buffer of a file reader cannot be empty");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    m_file.open(filePath.c_str(), std::ios::in | std::ios::binary);
+
+    if( !m_file )
+    {
+        std::string msg("Could not open file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    m_file.seekg(0, std::ios::end);
+    m_fileSize = static_cast<size_t>(m_file.tellg());
+    m_file.seekg(0, std::ios::beg);
+
+    m_buffer.resize(bufferSize);
+}
+
+//------------------------------------------------------------------------------------------
+BinaryFileReader::~BinaryFileReader()
+{
+}
+
+//------------------------------------------------------------------------------------------
+const std::string & BinaryFileReader::GetFilePath() const
+{
+    return m_filePath;
+}
+
+//------------------------------------------------------------------------------------------
+const size_t BinaryFileReader::GetBufferSize() const
+{
+    return m_buffer.size();
+}
+
+//------------------------------------------------------------------------------------------
+const size_t BinaryFileReader::GetPosition() const
+{
+    return m_position;
+}
+
+//------------------------------------------------------------------------------------------
+const size_t BinaryFileReader::GetRemaining() const
+{
+    return m_fileSize - m_position;
+}
+
+//------------------------------------------------------------------------------------------
+const bool BinaryFileReader::IsEnd() const
+{
+    return m_position >= m_fileSize;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned BinaryFileReader::ReadUInt8()
+{
+    Require(1);
+
+    unsigned value = m_buffer[m_bufferStart];
+    m_bufferStart += 1;
+    m_position    += 1;
+
+    return value;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned BinaryFileReader::ReadUInt32()
+{
+    Require(4);
+
+    unsigned int value = 0;
+    memcpy(&value, &m_buffer[m_bufferStart], 4);
+    m_bufferStart += 4;
+    m_position    += 4;
+
+    return value;
+}
+
+//------------------------------------------------------------------------------------------
+const float BinaryFileReader::ReadFloat()
+{
+    Require(4);
+
+    float value = 0.0f;
+    memcpy(&value, &m_buffer[m_bufferStart], 4);
+    m_bufferStart += 4;
+    m_position    += 4;
+
+    return value;
+}
+
+//------------------------------------------------------------------------------------------
+void BinaryFileReader::ReadString(std::string & value)
+{
+    while( true )
+    {
+        const size_t numBuffered = m_bufferEnd - m_bufferStart;
+        const void * terminator  = NULL;
+
+        if( numBuffered > 0 )
+        {
+            terminator = memchr(&m_buffer[m_bufferStart], 0x00, numBuffered);
+        }
+
+        if( terminator )
+        {
+            const unsigned char * start  = &m_buffer[m_bufferStart];
+            const size_t          length = static_cast<const unsigned char *>(terminator) - start;
+
+            value.assign(reinterpret_cast<const char *>(start), length);
+            m_bufferStart += length + 1;
+            m_position    += length + 1;
+            return;
+        }
+
+        // Everything left of the file is already in the buffer
+        if( numBuffered >= GetRemaining() )
+        {
+            std::ostringstream msg;
+            msg << "Unterminated string at offset " << m_position << " in file: " << m_filePath;
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        if( numBuffered == m_buffer.size() )
+        {
+            std::ostringstream msg;
+            msg << "String at offset " << m_position << " in file: " << m_filePath
+                << " is longer than the read buffer of " << m_buffer.size() << " bytes";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        Refill();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned char * BinaryFileReader::ReadBytes(const size_t numBytes)
+{
+    Require(numBytes);
+
+    if( numBytes == 0 )
+    {
+        return NULL;
+    }
+
+    const unsigned char * block = &m_buffer[m_bufferStart];
+    m_bufferStart += numBytes;
+    m_position    += numBytes;
+
+    return block;
+}
+
+//------------------------------------------------------------------------------------------
+void BinaryFileReader::Require(const size_t numBytes)
+{
+    // Written so that a huge numBytes cannot overflow the check
+    if( numBytes > GetRemaining() )
+    {
+        std::ostringstream msg;
+        msg << "Unexpected end of file: " << m_filePath << ". Needed " << numBytes << " bytes at offset "
+            << m_position << ", but only " << GetRemaining() << " remain";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    if( numBytes > m_buffer.size() )
+    {
+        std::ostringstream msg;
+        msg << "Cannot read " << numBytes << " bytes at once from file: " << m_filePath
+            << " through a buffer of " << m_buffer.size() << " bytes";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    if( numBytes > m_bufferEnd - m_bufferStart )
+    {
+        Refill();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void BinaryFileReader::Refill()
+{
+    const size_t numBuffered = m_bufferEnd - m_bufferStart;
+
+    if( numBuffered > 0 && m_bufferStart > 0 )
+    {
+        memmove(&m_buffer[0], &m_buffer[m_bufferStart], numBuffered);
+    }
+
+    m_bufferStart = 0;
+    m_bufferEnd   = numBuffered;
+
+    // Read as much of the rest of the file as fits
+    const size_t numUnread = m_fileSize - m_position - numBuffered;
+    const size_t numToRead = std::min<size_t>(m_buffer.size() - numBuffered, numUnread);
+
+    if( numToRead == 0 )
+    {
+        return;
+    }
+
+    m_file.read(reinterpret_cast<char *>(&m_buffer[m_bufferEnd]), static_cast<std::streamsize>(numToRead));
+
+    if( static_cast<size_t>(m_file.gcount()) != numToRead )
+    {
+        std::ostringstream msg;
+        msg << "Failed to read " << numToRead << " bytes at offset " << (m_position + numBuffered)
+            << " from file: " << m_filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    m_bufferEnd += numToRead;
+}
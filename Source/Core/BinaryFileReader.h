@@ -0,0 +1,103 @@
+#ifndef BINARYFILEREADER_H
+#define BINARYFILEREADER_H
+
+// EngineX Includes
+#include "Core\BinaryReader.h"
+
+// Standard Includes
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+/**
+* Bounds checked, forward reading of a file on disk, through a buffer of fixed size
+*
+* Unlike mapping the file (see MappedFile.h), no more than one buffer of the file is ever held in memory
+* or in the address space of the process, however large the file is. Blocks handed out by ReadBytes lie
+* in the buffer, so they are only valid until the next read, and can be no larger than the buffer.
+**/
+class BinaryFileReader : public BinaryReader
+{
+public:
+
+   /**
+   * Constructor
+   *
+   * @param filePath   - Path to the file to read
+   * @param bufferSize - Size of the buffer in bytes, which is the largest block ReadBytes can hand out
+   *
+   * @throws BaseException - If the file could not be opened
+   **/
+   BinaryFileReader(const std::string & filePath, const size_t bufferSize = 1 << 20);
+
+   /**
+   * Deconstructor
+   **/
+   virtual ~BinaryFileReader();
+
+
+   /**
+   * Gets the path to the file being read
+   **/
+   const std::string & GetFilePath() const;
+
+   /**
+   * Gets the size of the buffer in bytes
+   **/
+   const size_t GetBufferSize() const;
+
+   virtual const size_t GetPosition() const;
+   virtual const size_t GetRemaining() const;
+   virtual const bool IsEnd() const;
+
+   virtual const unsigned ReadUInt8();
+   virtual const unsigned ReadUInt32();
+   virtual const float ReadFloat();
+   virtual void ReadString(std::string & value);
+
+   /**
+   * Reads a block of bytes without copying it out of the buffer
+   *
+   * @param numBytes - Number of bytes to read, at most the size of the buffer
+   * @return         - Pointer to the first byte of the block, valid until the next read
+   *
+   * @throws BaseException - If there is not enough data left, or the block is larger than the buffer
+   **/
+   virtual const unsigned char * ReadBytes(const size_t numBytes);
+
+private:
+
+   /** No Copy allowed */
+   BinaryFileReader(const BinaryFileReader & rhs);
+
+   /** No assignment allowed */
+   BinaryFileReader & operator = (const BinaryFileReader & rhs);
+
+   /**
+   * Makes sure a number of bytes can be read from the buffer, reading more of the file into it if needed
+   *
+   * @throws BaseException - If there is not enough data left, or the bytes do not fit in the buffer
+   **/
+   void Require(const size_t numBytes);
+
+   /**
+   * Moves the bytes not read yet to the front of the buffer, and fills the rest of it from the file
+   *
+   * @throws BaseException - If the file could not be read
+   **/
+   void Refill();
+
+
+   std::string                m_filePath;      // Path to the file
+   std::ifstream              m_file;          // The file, positioned after the last byte in the buffer
+   size_t                     m_fileSize;      // Size of the file in bytes
+   size_t                     m_position;      // Offset in the file of the next byte to be read
+
+   std::vector<unsigned char> m_buffer;        // Part of the file, starting with the next byte to be read
+   size_t                     m_bufferStart;   // Offset in the buffer of the next byte to be read
+   size_t                     m_bufferEnd;     // Offset in the buffer past the last byte read from the file
+};
+
+#endif // BINARYFILEREADER_H
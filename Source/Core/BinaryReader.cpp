@@ -0,0 +1,8 @@
+
+// Project Includes
+#include "BinaryReader.h"
+
+//------------------------------------------------------------------------------------------
+BinaryReader::~BinaryReader()
+{
+}
@@ -0,0 +1,83 @@
+#ifndef BINARYREADER_H
+#define BINARYREADER_H
+
+// Standard Includes
+#include <cstddef>
+#include <string>
+
+//------------------------------------------------------------------------------------------
+/**
+* Bounds checked, forward reading of binary data, wherever the data comes from
+*
+* All multi-byte values are read in the byte order of the machine, which matches the little endian
+* files written by the EngineX export scripts.
+**/
+class BinaryReader
+{
+public:
+
+   /**
+   * Deconstructor
+   **/
+   virtual ~BinaryReader();
+
+
+   /**
+   * Gets the offset, in bytes, from the start of the data to the next byte to be read
+   **/
+   virtual const size_t GetPosition() const = 0;
+
+   /**
+   * Gets the number of bytes left to read
+   **/
+   virtual const size_t GetRemaining() const = 0;
+
+   /**
+   * Query whether all the data has been read
+   **/
+   virtual const bool IsEnd() const = 0;
+
+
+   /**
+   * Reads a 1 byte unsigned integral value
+   *
+   * @throws BaseException - If there is not enough data left
+   **/
+   virtual const unsigned ReadUInt8() = 0;
+
+   /**
+   * Reads a 4 byte unsigned integral value
+   *
+   * @throws BaseException - If there is not enough data left
+   **/
+   virtual const unsigned ReadUInt32() = 0;
+
+   /**
+   * Reads a 4 byte floating point value
+   *
+   * @throws BaseException - If there is not enough data left
+   **/
+   virtual const float ReadFloat() = 0;
+
+   /**
+   * Reads a null terminated string
+   *
+   * @param value OUT - The string, without the null terminator
+   *
+   * @throws BaseException - If the data ends before a null terminator is found
+   **/
+   virtual void ReadString(std::string & value) = 0;
+
+   /**
+   * Reads a block of bytes without copying it
+   *
+   * @param numBytes - Number of bytes to read
+   * @return         - Pointer to the first byte of the block. Only valid until the next read, unless the
+   *                   reader says otherwise.
+   *
+   * @throws BaseException - If there is not enough data left, or the reader cannot hand out a block that large
+   **/
+   virtual const unsigned char * ReadBytes(const size_t numBytes) = 0;
+};
+
+#endif // BINARYREADER_H
@@ -0,0 +1,143 @@
+
+// Project Includes
+#include "ContentHash.h"
+#include "MappedFile.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cstring>
+
+//------------------------------------------------------------------------------------------
+namespace
+{
+    const ContentHash PRIME1 = 0x9E3779B185EBCA87ULL;
+    const ContentHash PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    const ContentHash PRIME3 = 0x165667B19E3779F9ULL;
+    const ContentHash PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    const ContentHash PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    //--------------------------------------------------------------------------------------
+    inline ContentHash RotateLeft(const ContentHash value, const unsigned bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    //--------------------------------------------------------------------------------------
+    inline ContentHash Read64(const unsigned char * data)
+    {
+        ContentHash value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    //--------------------------------------------------------------------------------------
+    inline ContentHash Read32(const unsigned char * data)
+    {
+        unsigned int value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    //--------------------------------------------------------------------------------------
+    inline ContentHash Round(ContentHash accumulator, const ContentHash input)
+    {
+        accumulator += input * PRIME2;
+        accumulator  = RotateLeft(accumulator, 31);
+        return accumulator * PRIME1;
+    }
+
+    //--------------------------------------------------------------------------------------
+    inline ContentHash MergeRound(ContentHash accumulator, const ContentHash value)
+    {
+        accumulator ^= Round(0, value);
+        return accumulator * PRIME1 + PRIME4;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const ContentHash HashContent(const void * data, const size_t numBytes, const ContentHash seed)
+{
+    const unsigned char * current = static_cast<const unsigned char *>(data);
+    const unsigned char * end     = current + numBytes;
+    ContentHash           hash;
+
+    // Four independent lanes over 32 byte stripes
+    if( numBytes >= 32 )
+    {
+        const unsigned char * lastStripe = end - 32;
+
+        ContentHash lane1 = seed + PRIME1 + PRIME2;
+        ContentHash lane2 = seed + PRIME2;
+        ContentHash lane3 = seed;
+        ContentHash lane4 = seed - PRIME1;
+
+        do
+        {
+            lane1 = Round(lane1, Read64(current));
+            lane2 = Round(lane2, Read64(current + 8));
+            lane3 = Round(lane3, Read64(current + 16));
+            lane4 = Round(lane4, Read64(current + 24));
+            current += 32;
+        }
+        while( current <= lastStripe );
+
+        hash = RotateLeft(lane1, 1) + RotateLeft(lane2, 7) + RotateLeft(lane3, 12) + RotateLeft(lane4, 18);
+        hash = MergeRound(hash, lane1);
+        hash = MergeRound(hash, lane2);
+        hash = MergeRound(hash, lane3);
+        hash = MergeRound(hash, lane4);
+    }
+    else
+    {
+        hash = seed + PRIME5;
+    }
+
+    hash += static_cast<ContentHash>(numBytes);
+
+    // Whatever is left of the last stripe
+    while( current + 8 <= end )
+    {
+        hash ^= Round(0, Read64(current));
+        hash  = RotateLeft(hash, 27) * PRIME1 + PRIME4;
+        current += 8;
+    }
+
+    if( current + 4 <= end )
+    {
+        hash ^= Read32(current) * PRIME1;
+        hash  = RotateLeft(hash, 23) * PRIME2 + PRIME3;
+        current += 4;
+    }
+
+    while( current < end )
+    {
+        hash ^= (*current) * PRIME5;
+        hash  = RotateLeft(hash, 11) * PRIME1;
+        ++current;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------
+const ContentHash HashFileContent(const std::string & filePath, const ContentHash seed)
+{
+    try
+    {
+        MappedFile file(filePath);
+        return HashContent(file.GetData(), file.GetSize(), seed);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
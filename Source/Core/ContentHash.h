@@ -0,0 +1,33 @@
+#ifndef CONTENTHASH_H
+#define CONTENTHASH_H
+
+// Standard Includes
+#include <cstddef>
+#include <string>
+
+//------------------------------------------------------------------------------------------
+// Fast 64 bit hashing of blocks of memory, so that resources can be identified by their content rather than their name
+//
+// The hash is XXH64, which runs at close to memory bandwidth. It is not cryptographic. Two different blocks are
+// only expected to collide once in around 2^32 resources, so resources with equal hashes are treated as equal.
+//
+
+typedef unsigned long long ContentHash;
+
+/**
+* Hashes a block of memory
+*
+* @param data     - First byte of the block. May be NULL if numBytes is 0.
+* @param numBytes - Size of the block in bytes
+* @param seed     - Starting value, which can be the hash of something else to combine the two
+**/
+const ContentHash HashContent(const void * data, const size_t numBytes, const ContentHash seed = 0);
+
+/**
+* Hashes the entire contents of a file
+*
+* @throws BaseException - If the file could not be opened
+**/
+const ContentHash HashFileContent(const std::string & filePath, const ContentHash seed = 0);
+
+#endif // CONTENTHASH_H
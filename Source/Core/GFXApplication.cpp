@@ -14,21 +14,27 @@
 //-----------------------------------------------------------------------------
 GFXApplication::GFXApplication(const std::string & title)
     :
-    BaseWindow          (),
-    m_dxgiFactory       (nullptr),
-    m_device            (nullptr),
-    m_swapChain         (nullptr),
-    m_backBuffer        (nullptr),
-    m_renderTargetView  (nullptr),
-    m_depthStencil      (nullptr),
-    m_depthStencilState (nullptr),
-    m_depthStencilView  (nullptr),
-    m_rasterizerState   (nullptr),
-    m_ignoreSizeChange  (false),
-    m_textureManager    (nullptr),
-    m_effectManager     (nullptr),
-    m_inputLayoutManager(nullptr),
-    m_renderQueue       (nullptr)
+    BaseWindow              (),
+    m_dxgiFactory           (nullptr),
+    m_device                (nullptr),
+    m_swapChain             (nullptr),
+    m_backBuffer            (nullptr),
+    m_renderTargetView      (nullptr),
+    m_depthStencil          (nullptr),
+    m_depthStencilState     (nullptr),
+    m_depthStencilView      (nullptr),
+    m_rasterizerState       (nullptr),
+    m_ignoreSizeChange      (false),
+    m_textureManager        (nullptr),
+    m_effectManager         (nullptr),
+    m_inputLayoutManager    (nullptr),
+    m_renderQueue           (nullptr),
+    m_threadPool            (nullptr),
+    m_bufferCache           (nullptr),
+    m_shapeCache            (nullptr),
+    m_modelStreamer         (nullptr),
+    m_modelStreamingBudget  (1.0),
+    m_textureStreamingBudget(1.0)
 {
     m_className = L"GFXApplication";
     m_title     = L"D3D Application";
@@ -40,6 +46,35 @@ GFXApplication::GFXApplication(const std::string & title)
 //-----------------------------------------------------------------------------
 GFXApplication::~GFXApplication()
 {
+    // Drop the background work that has not started, and finish what has, before the resources it may refer to are released
+    if( m_threadPool )
+    {
+        m_threadPool->CancelPendingTasks();
+        delete m_threadPool;
+        m_threadPool = NULL;
+    }
+
+    // Release the model streamer, along with any models that were not collected from it
+    if( m_modelStreamer )
+    {
+        delete m_modelStreamer;
+        m_modelStreamer = NULL;
+    }
+
+    // Release the buffer cache, which only holds weak references to the buffers
+    if( m_bufferCache )
+    {
+        delete m_bufferCache;
+        m_bufferCache = NULL;
+    }
+
+    // Release the shape cache's references to the buffers of generated shapes
+    if( m_shapeCache )
+    {
+        delete m_shapeCache;
+        m_shapeCache = NULL;
+    }
+
     // Release resources
     FreeResources();
 
@@ -382,6 +417,19 @@ void GFXApplication::Init(HINSTANCE instance,
 
     // Create the render queue
     m_renderQueue = new RenderQueue(*m_effectManager);
+
+    // Create worker threads, one for each hardware thread
+    m_threadPool = new ThreadPool();
+
+    // Create a cache so that models with the same contents share their buffers
+    m_bufferCache = new BufferCache(*m_device);
+
+    // Create a cache so that objects made from the same shape share its buffers
+    m_shapeCache = new ShapeCache(*m_device);
+
+    // Create the model streamer
+    m_modelStreamer = new ModelStreamer(*m_device, *m_inputLayoutManager, *m_textureManager, *m_effectManager, *m_threadPool);
+    m_modelStreamer->SetBufferCache(m_bufferCache);
 }
 
 //-----------------------------------------------------------------------------
@@ -421,6 +469,9 @@ int GFXApplication::Run()
 
         try
         {
+            // Finish loading models that were imported in the background, as far as the budget allows
+            m_modelStreamer->Update(m_modelStreamingBudget);
+
             // Any processing that must take place previous to render this frame
             PreRender();
          
@@ -429,6 +480,15 @@ int GFXApplication::Run()
             {
                 // Render
                 RenderLoop();
+
+                // Stream in the mip levels that the textures drawn this frame need, as far as the budget allows
+                if( m_textureManager->IsStreaming() )
+                {
+                    DXGI_SWAP_CHAIN_DESC swapChainDesc;
+                    m_swapChain->GetDesc(&swapChainDesc);
+
+                    m_textureManager->UpdateStreaming(swapChainDesc.BufferDesc.Height, m_textureStreamingBudget);
+                }
             }
 
             // Any processing that must take place after rendering this frame
@@ -457,6 +517,18 @@ int GFXApplication::Run()
 }
 
 
+//-------------------------------------------------------------------------------
+void GFXApplication::SetModelStreamingBudget(const double milliseconds)
+{
+    m_modelStreamingBudget = milliseconds;
+}
+
+//-------------------------------------------------------------------------------
+void GFXApplication::SetTextureStreamingBudget(const double milliseconds)
+{
+    m_textureStreamingBudget = milliseconds;
+}
+
 //-------------------------------------------------------------------------------
 double GFXApplication::GetTotalTime() const
 {
@@ -3,12 +3,16 @@
 
 // EngineX Includes
 #include "GFXAppTimer.h"
+#include "ThreadPool.h"
 #include "DisplayModeEnumerator.h"
 #include "DisplayMode.h"
 #include "Graphics\Textures\TextureManager.h"
 #include "Graphics\Effects\EffectManager.h"
+#include "Graphics\3D\BufferCache.h"
 #include "Graphics\3D\InputLayoutManager.h"
+#include "Graphics\3D\ModelStreamer.h"
 #include "Graphics\3D\RenderQueue.h"
+#include "Graphics\3D\ShapeCache.h"
 
 // Common Lib Includes
 #include "BaseWindow.h"
@@ -62,6 +66,22 @@ public:
    */
    virtual int Run();
 
+   /**
+   * Sets how much time, in milliseconds, each frame may spend creating the D3D resources of models loaded in the background
+   *
+   * Defaults to 1. At least one PolygonSet is created each frame, if any are waiting, regardless of the budget.
+   **/
+   void SetModelStreamingBudget(const double milliseconds);
+
+   /**
+   * Sets how much time, in milliseconds, each frame may spend creating streamed textures again with the mip levels
+   * they need. How much video memory they may take up is set on the TextureManager (see TextureManager::SetStreamingBudget).
+   *
+   * Defaults to 1. At least one texture is made more detailed each frame, if any are waiting, regardless of the budget.
+   * A frame spends up to the model and the texture budgets together.
+   **/
+   void SetTextureStreamingBudget(const double milliseconds);
+
 protected:
 	
    /**
@@ -132,6 +152,12 @@ protected:
    EffectManager *            m_effectManager;      // Contains and manages D3D Effects along with variables shared amongst them
    InputLayoutManager *       m_inputLayoutManager; // Contains and manages D3D Input Layouts
    RenderQueue *              m_renderQueue;        // Contains objects to be rendered and handles sorting them
+   ThreadPool *               m_threadPool;         // Worker threads for loading resources in the background
+   BufferCache *              m_bufferCache;        // Shares vertex and index buffers between models with the same contents
+   ShapeCache *               m_shapeCache;         // Shares the buffers of generated shapes between objects made from the same shape
+   ModelStreamer *            m_modelStreamer;      // Loads models in the background and finishes them a little each frame
+   double                     m_modelStreamingBudget;   // Milliseconds each frame may spend finishing models loaded in the background
+   double                     m_textureStreamingBudget; // Milliseconds each frame may spend making streamed textures more detailed
 
    bool                       m_keystates[256];     // True if a key is down, false if up. Indices correspond to windows virtual keycodes.
 
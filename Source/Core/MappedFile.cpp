@@ -0,0 +1,179 @@
+
+// Project Includes
+#include "MappedFile.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// OS Includes
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------------------
+MappedFile::MappedFile(const std::string & filePath)
+    :
+    m_filePath(filePath),
+    m_data    (NULL),
+    m_size    (0),
+#ifdef _WIN32
+    m_file    (INVALID_HANDLE_VALUE),
+    m_mapping (NULL)
+#else
+    m_file    (-1)
+#endif
+{
+#ifdef _WIN32
+    // Open the file
+    m_file = CreateFileA(filePath.c_str(),
+                         GENERIC_READ,
+                         FILE_SHARE_READ,
+                         NULL,
+                         OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                         NULL);
+
+    if( m_file == INVALID_HANDLE_VALUE )
+    {
+        std::string msg("Failed to open file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    LARGE_INTEGER fileSize;
+    if( !GetFileSizeEx(m_file, &fileSize) )
+    {
+        CloseHandle(m_file);
+
+        std::string msg("Failed to get the size of file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    // An empty file cannot be mapped, but it is not an error to open one
+    if( m_size == 0 )
+    {
+        return;
+    }
+
+    // Map the whole file
+    m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if( !m_mapping )
+    {
+        CloseHandle(m_file);
+
+        std::string msg("Failed to create a file mapping for file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    m_data = static_cast<const unsigned char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if( !m_data )
+    {
+        CloseHandle(m_mapping);
+        CloseHandle(m_file);
+
+        std::string msg("Failed to map a view of file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+#else
+    // Open the file
+    m_file = open(filePath.c_str(), O_RDONLY);
+
+    if( m_file == -1 )
+    {
+        std::string msg("Failed to open file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    struct stat fileStat;
+    if( fstat(m_file, &fileStat) != 0 )
+    {
+        close(m_file);
+
+        std::string msg("Failed to get the size of file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    m_size = static_cast<size_t>(fileStat.st_size);
+
+    // An empty file cannot be mapped, but it is not an error to open one
+    if( m_size == 0 )
+    {
+        return;
+    }
+
+    // Map the whole file
+    void * view = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+
+    if( view == MAP_FAILED )
+    {
+        close(m_file);
+
+        std::string msg("Failed to map file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    m_data = static_cast<const unsigned char *>(view);
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if( m_data )
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+    if( m_mapping )
+    {
+        CloseHandle(m_mapping);
+    }
+
+    if( m_file != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle(m_file);
+    }
+#else
+    if( m_data )
+    {
+        munmap(const_cast<unsigned char *>(m_data), m_size);
+    }
+
+    if( m_file != -1 )
+    {
+        close(m_file);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------------------
+const std::string & MappedFile::GetFilePath() const
+{
+    return m_filePath;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned char * MappedFile::GetData() const
+{
+    return m_data;
+}
+
+//------------------------------------------------------------------------------------------
+const size_t MappedFile::GetSize() const
+{
+    return m_size;
+}
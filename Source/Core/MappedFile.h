@@ -0,0 +1,80 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+// OS Includes
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Standard Includes
+#include <cstddef>
+#include <memory>
+#include <string>
+
+//------------------------------------------------------------------------------------------
+/**
+* Read only view of an entire file, mapped into the address space of the process
+*
+* The file contents are paged in by the OS as they are touched, so parsers can walk the
+* data in place instead of copying it through a stream one element at a time.
+**/
+class MappedFile
+{
+public:
+
+   typedef std::shared_ptr<MappedFile> SharedPtr;
+
+   /**
+   * Constructor
+   *
+   * @param filePath - Path to the file to map
+   *
+   * @throws BaseException - If the file could not be opened or mapped
+   **/
+   MappedFile(const std::string & filePath);
+
+   /**
+   * Deconstructor
+   **/
+   ~MappedFile();
+
+
+   /**
+   * Gets the path the file was mapped from
+   **/
+   const std::string & GetFilePath() const;
+
+   /**
+   * Gets a pointer to the first byte of the file
+   *
+   * NOTE - NULL if the file is empty
+   **/
+   const unsigned char * GetData() const;
+
+   /**
+   * Gets the size of the file in bytes
+   **/
+   const size_t GetSize() const;
+
+private:
+
+   /** No Copy allowed */
+   MappedFile(const MappedFile & rhs);
+
+   /** No assignment allowed */
+   MappedFile & operator = (const MappedFile & rhs);
+
+
+   std::string           m_filePath;   // Path the file was mapped from
+   const unsigned char * m_data;       // Start of the mapped view
+   size_t                m_size;       // Size of the mapped view in bytes
+
+#ifdef _WIN32
+   HANDLE                m_file;       // OS file handle
+   HANDLE                m_mapping;    // OS file mapping handle
+#else
+   int                   m_file;       // OS file descriptor
+#endif
+};
+
+#endif // MAPPEDFILE_H
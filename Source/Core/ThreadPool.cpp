@@ -0,0 +1,112 @@
+
+// Project Includes
+#include "ThreadPool.h"
+
+//------------------------------------------------------------------------------------------
+ThreadPool::ThreadPool(const unsigned numThreads)
+    :
+    m_stopping(false)
+{
+    unsigned count = numThreads;
+
+    if( count == 0 )
+    {
+        count = std::thread::hardware_concurrency();
+    }
+
+    if( count == 0 )
+    {
+        count = 1;
+    }
+
+    try
+    {
+        for(unsigned i = 0; i < count; ++i)
+        {
+            m_threads.push_back(std::thread(&ThreadPool::WorkerMain, this));
+        }
+    }
+    catch(...)
+    {
+        // The deconstructor will not run, so the threads that did start must be stopped here
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+
+        m_taskAvailable.notify_all();
+
+        for(std::vector<std::thread>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+        {
+            it->join();
+        }
+
+        throw;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_taskAvailable.notify_all();
+
+    for(std::vector<std::thread>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+    {
+        it->join();
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned ThreadPool::GetNumThreads() const
+{
+    return static_cast<unsigned>(m_threads.size());
+}
+
+//------------------------------------------------------------------------------------------
+void ThreadPool::CancelPendingTasks()
+{
+    std::deque<std::function<void()> > cancelled;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        cancelled.swap(m_tasks);
+    }
+
+    // The tasks, and whatever they hold, are released here rather than while the workers are locked out
+    cancelled.clear();
+}
+
+//------------------------------------------------------------------------------------------
+void ThreadPool::WorkerMain()
+{
+    while( true )
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while( !m_stopping && m_tasks.empty() )
+            {
+                m_taskAvailable.wait(lock);
+            }
+
+            // Tasks that were already submitted are still run when stopping
+            if( m_tasks.empty() )
+            {
+                return;
+            }
+
+            task = m_tasks.front();
+            m_tasks.pop_front();
+        }
+
+        // Exceptions are caught by the packaged task and passed on through its future
+        task();
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// Standard Includes
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+/**
+* Fixed number of worker threads that run tasks in the order they were submitted
+*
+* Tasks must not touch the D3D device or the managers that wrap it. Those belong to the thread that created them.
+**/
+class ThreadPool
+{
+public:
+
+   /**
+   * Constructor
+   *
+   * @param numThreads - Number of worker threads. If 0, one per hardware thread is created.
+   **/
+   ThreadPool(const unsigned numThreads = 0);
+
+   /**
+   * Deconstructor
+   *
+   * Waits for every task that was submitted to finish, unless it was cancelled (see CancelPendingTasks)
+   **/
+   ~ThreadPool();
+
+
+   /**
+   * Gets the number of worker threads
+   **/
+   const unsigned GetNumThreads() const;
+
+   /**
+   * Removes every task that is waiting for a worker, without running it
+   *
+   * Tasks already running on a worker are not interrupted. The futures of the removed tasks are made ready
+   * with a std::future_error of broken_promise, which their get() throws.
+   **/
+   void CancelPendingTasks();
+
+   /**
+   * Queues a task to be run on a worker thread
+   *
+   * @param task - Callable object taking no arguments
+   * @return     - Future for the result of the task. Exceptions thrown by the task are rethrown from its get().
+   **/
+   template<typename Task>
+   std::future<typename std::result_of<Task()>::type> Submit(Task task)
+   {
+      typedef typename std::result_of<Task()>::type Result;
+
+      // Packaged tasks cannot be copied, but std::function needs to be able to copy what it holds
+      std::shared_ptr<std::packaged_task<Result()> > packagedTask(new std::packaged_task<Result()>(task));
+      std::future<Result>                            future = packagedTask->get_future();
+
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         m_tasks.push_back([packagedTask]() { (*packagedTask)(); });
+      }
+
+      m_taskAvailable.notify_one();
+
+      return future;
+   }
+
+private:
+
+   /** No Copy allowed */
+   ThreadPool(const ThreadPool & rhs);
+
+   /** No assignment allowed */
+   ThreadPool & operator = (const ThreadPool & rhs);
+
+
+   /**
+   * Runs tasks until the pool is destroyed
+   **/
+   void WorkerMain();
+
+
+   std::vector<std::thread>           m_threads;         // Worker threads
+   std::deque<std::function<void()> > m_tasks;           // Tasks waiting for a worker
+   std::mutex                         m_mutex;           // Guards the tasks and the stopping flag
+   std::condition_variable            m_taskAvailable;   // Signaled when a task is queued or the pool is stopping
+   bool                               m_stopping;        // Whether the pool is being destroyed
+};
+
+#endif // THREADPOOL_H
@@ -55,6 +55,62 @@ Image2D::Image2D(ID3D10Device & device,
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
+    CreateQuads(D3DXVECTOR2(0.0f, 0.0f), D3DXVECTOR2(1.0f, 1.0f), rows, cols);
+}
+
+//-------------------------------------------------------------------
+Image2D::Image2D(ID3D10Device & device, 
+                 InputLayoutManager & inputLayoutManager,
+                 TextureManager & textureManager, 
+                 EffectManager & effectManager,
+                 const TextureAtlas & atlas,
+                 const std::string & regionName,
+                 unsigned rows,
+                 unsigned cols)
+    :
+    Transform           (),
+    m_device            (device),
+    m_inputLayoutManager(inputLayoutManager),
+    m_textureManager    (textureManager),
+    m_effectManager     (effectManager),
+    m_inputLayout       (nullptr),
+    m_textureName       (atlas.GetTextureName()),
+    m_numFrames         (rows * cols),
+    m_width             (0),
+    m_height            (0),
+    m_animationMode     (ANIMATION_MODE_NONE),
+    m_startFrameIndex   (0),
+    m_endFrameIndex     (0),
+    m_currentFrameIndex (0),
+    m_fps               (0)
+{
+    const AtlasRegion * region = NULL;
+
+    try
+    {
+        region = &(atlas.GetRegion(regionName));
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    m_width  = static_cast<float>(region->m_width / cols);
+    m_height = static_cast<float>(region->m_height / rows);
+
+    if(region->m_width % cols || region->m_height % rows)
+    {
+        std::string msg(regionName);
+        msg += " is not evenly divisible into the requested number of frames";
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    CreateQuads(region->m_texCoordMin, region->m_texCoordMax, rows, cols);
+}
+
+//-------------------------------------------------------------------
+void Image2D::CreateQuads(const D3DXVECTOR2 & texCoordMin, const D3DXVECTOR2 & texCoordMax, unsigned rows, unsigned cols)
+{
     // Create the effect
     Effect *    effect    = NULL;
     Technique * technique = NULL;
@@ -92,24 +148,24 @@ Image2D::Image2D(ID3D10Device & device,
     positionOffset.y = 0.5f * m_height; // Distance from origin on y axis used to generate vertex positions for a quad
 
     D3DXVECTOR2 textureOffset;
-    textureOffset.x = 1.0f / static_cast<float>(cols);	// How much to shift the texture coords for each frame horizontally
-    textureOffset.y = 1.0f / static_cast<float>(rows);	// How much to shift the texture coords for each frame vertically
+    textureOffset.x = (texCoordMax.x - texCoordMin.x) / static_cast<float>(cols);	// How much to shift the texture coords for each frame horizontally
+    textureOffset.y = (texCoordMax.y - texCoordMin.y) / static_cast<float>(rows);	// How much to shift the texture coords for each frame vertically
 
     for(unsigned currentRow = 0; currentRow < rows; ++currentRow)
     {
 	    for(unsigned currentColumn = 0; currentColumn < cols; ++currentColumn)
 	    {
             quadPositions.push_back(Position( -positionOffset.x, -positionOffset.y, 0.0f));
-            quadTexCoords.push_back(TexCoord2D( currentColumn * textureOffset.x, (currentRow + 1) * textureOffset.y));
+            quadTexCoords.push_back(TexCoord2D( texCoordMin.x + currentColumn * textureOffset.x, texCoordMin.y + (currentRow + 1) * textureOffset.y));
 
             quadPositions.push_back(Position( -positionOffset.x,  positionOffset.y, 0.0f));
-            quadTexCoords.push_back(TexCoord2D( currentColumn * textureOffset.x, currentRow * textureOffset.y));
+            quadTexCoords.push_back(TexCoord2D( texCoordMin.x + currentColumn * textureOffset.x, texCoordMin.y + currentRow * textureOffset.y));
 
             quadPositions.push_back(Position(  positionOffset.x, -positionOffset.y, 0.0f));
-            quadTexCoords.push_back(TexCoord2D( (currentColumn + 1) * textureOffset.x, (currentRow + 1) * textureOffset.y));
+            quadTexCoords.push_back(TexCoord2D( texCoordMin.x + (currentColumn + 1) * textureOffset.x, texCoordMin.y + (currentRow + 1) * textureOffset.y));
 
             quadPositions.push_back(Position(  positionOffset.x,  positionOffset.y, 0.0f));
-            quadTexCoords.push_back(TexCoord2D( (currentColumn + 1) * textureOffset.x, currentRow * textureOffset.y));
+            quadTexCoords.push_back(TexCoord2D( texCoordMin.x + (currentColumn + 1) * textureOffset.x, texCoordMin.y + currentRow * textureOffset.y));
 	    }
     }
 
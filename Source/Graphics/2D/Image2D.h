@@ -6,6 +6,7 @@
 #include "Graphics/3D/Buffers.h"
 #include "Graphics/3D/InputLayoutManager.h"
 #include "Graphics/Textures/TextureManager.h"
+#include "Graphics/Textures/TextureAtlas.h"
 #include "Graphics/Effects/EffectManager.h"
 #include "Graphics/Effects/Material.h"
 
@@ -68,6 +69,34 @@ public:
            const std::string & textureFilePath,
            unsigned rows,
            unsigned cols);
+
+   /**
+   * Constructor
+   *
+   * Creates an image from one region of a texture atlas. Every image created from the same atlas renders
+   * with the same texture bound, so a whole HUD can be drawn without switching textures.
+   * The quad will have a default width and height, in pixels, matching the dimensions of the region,
+   * or of a single frame if the region is divided into frames.
+   *
+   * @param device             -
+   * @param inputLayoutManager -
+   * @param textureManager     -
+   * @param effectManager      -
+   * @param atlas              - Atlas that holds the image
+   * @param regionName         - Name of the image in the atlas, which is its file name without the extension
+   * @param rows               - For images that contain more than 1 frame, how many rows of frames the region contains
+   * @param cols               - For images that contain more than 1 frame, how many columns of frames the region contains
+   *
+   * @throws BaseException - If image creation fails
+   **/
+   Image2D(ID3D10Device & device, 
+           InputLayoutManager & inputLayoutManager,
+           TextureManager & textureManager, 
+           EffectManager & effectManager,
+           const TextureAtlas & atlas,
+           const std::string & regionName,
+           unsigned rows,
+           unsigned cols);
    
    /**
    * Deconstructor
@@ -178,6 +207,19 @@ public:
 
 protected:
 
+   /**
+   * Creates the material, the quads for each frame, and the input layout, once the texture name and the
+   * size of each frame are known
+   *
+   * @param texCoordMin - Texture coordinates of the top left corner of the frames, as a whole
+   * @param texCoordMax - Texture coordinates of the bottom right corner of the frames, as a whole
+   * @param rows        - How many rows of frames there are
+   * @param cols        - How many columns of frames there are
+   *
+   * @throws BaseException - If the effect cannot be created
+   **/
+   void CreateQuads(const D3DXVECTOR2 & texCoordMin, const D3DXVECTOR2 & texCoordMax, unsigned rows, unsigned cols);
+
    /**
    * Calculates which frame of an animation is the current frame to render
    *
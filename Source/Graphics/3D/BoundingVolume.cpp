@@ -0,0 +1,148 @@
+
+// Project Includes
+#include "BoundingVolume.h"
+
+// Standard Includes
+#include <cmath>
+
+// SSE Includes
+#include <emmintrin.h>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    //--------------------------------------------------------------------------
+    /**
+    * Loads the 3 floats of a position into the low lanes of a register, with a zero in the last lane,
+    * without reading past the end of the position
+    **/
+    inline __m128 LoadPosition(const unsigned char * position)
+    {
+        const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(position)));
+        const __m128 z  = _mm_load_ss(reinterpret_cast<const float *>(position + 8));
+
+        return _mm_movelh_ps(xy, z);
+    }
+
+    //--------------------------------------------------------------------------
+    inline const D3DXVECTOR3 StorePosition(const __m128 position)
+    {
+        float components[4];
+        _mm_storeu_ps(components, position);
+
+        return D3DXVECTOR3(components[0], components[1], components[2]);
+    }
+}
+
+//------------------------------------------------------------------------------
+BoundingVolume::BoundingVolume()
+    :
+    m_boxMin      (0.0f, 0.0f, 0.0f),
+    m_boxMax      (0.0f, 0.0f, 0.0f),
+    m_sphereCenter(0.0f, 0.0f, 0.0f),
+    m_sphereRadius(-1.0f)
+{
+}
+
+//------------------------------------------------------------------------------
+const bool BoundingVolume::IsEmpty() const
+{
+    return m_sphereRadius < 0.0f;
+}
+
+//------------------------------------------------------------------------------
+void CalculateBoundingVolume(const unsigned char * positions,
+                             const unsigned numPositions,
+                             const unsigned stride,
+                             BoundingVolume & bounds)
+{
+    bounds = BoundingVolume();
+
+    if( !positions || numPositions == 0 )
+    {
+        return;
+    }
+
+    // Box
+    __m128 boxMin = LoadPosition(positions);
+    __m128 boxMax = boxMin;
+
+    for(unsigned i = 1; i < numPositions; ++i)
+    {
+        const __m128 position = LoadPosition(positions + static_cast<size_t>(i) * stride);
+
+        boxMin = _mm_min_ps(boxMin, position);
+        boxMax = _mm_max_ps(boxMax, position);
+    }
+
+    // Sphere around the center of the box, large enough to hold every position
+    const __m128 center = _mm_mul_ps(_mm_add_ps(boxMin, boxMax), _mm_set1_ps(0.5f));
+
+    __m128 radiusSquared = _mm_setzero_ps();
+
+    for(unsigned i = 0; i < numPositions; ++i)
+    {
+        const __m128 offset  = _mm_sub_ps(LoadPosition(positions + static_cast<size_t>(i) * stride), center);
+        const __m128 squared = _mm_mul_ps(offset, offset);
+
+        // x + y + z, in the lowest lane
+        const __m128 lengthSquared = _mm_add_ss(_mm_add_ss(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1))),
+                                                _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 2, 2, 2)));
+
+        radiusSquared = _mm_max_ss(radiusSquared, lengthSquared);
+    }
+
+    bounds.m_boxMin       = StorePosition(boxMin);
+    bounds.m_boxMax       = StorePosition(boxMax);
+    bounds.m_sphereCenter = StorePosition(center);
+    bounds.m_sphereRadius = _mm_cvtss_f32(_mm_sqrt_ss(radiusSquared));
+}
+
+//------------------------------------------------------------------------------
+void TransformBoundingVolume(const BoundingVolume & bounds,
+                             const D3DXMATRIX & transform,
+                             BoundingVolume & transformed)
+{
+    if( bounds.IsEmpty() )
+    {
+        transformed = BoundingVolume();
+        return;
+    }
+
+    // The box is transformed as its center and half extents, where each axis of the result
+    // gets as much of every extent as the rotation and scale carry onto it
+    const D3DXVECTOR3 center     = (bounds.m_boxMin + bounds.m_boxMax) * 0.5f;
+    const D3DXVECTOR3 halfExtent = (bounds.m_boxMax - bounds.m_boxMin) * 0.5f;
+
+    D3DXVECTOR3 transformedCenter;
+    D3DXVec3TransformCoord(&transformedCenter, &center, &transform);
+
+    D3DXVECTOR3 transformedHalfExtent;
+
+    for(unsigned column = 0; column < 3; ++column)
+    {
+        transformedHalfExtent[column] = fabsf(transform(0, column)) * halfExtent.x +
+                                        fabsf(transform(1, column)) * halfExtent.y +
+                                        fabsf(transform(2, column)) * halfExtent.z;
+    }
+
+    // The sphere grows by the largest scale along any axis
+    float maxScaleSquared = 0.0f;
+
+    for(unsigned row = 0; row < 3; ++row)
+    {
+        const D3DXVECTOR3 axis(transform(row, 0), transform(row, 1), transform(row, 2));
+        const float       lengthSquared = D3DXVec3LengthSq(&axis);
+
+        if( lengthSquared > maxScaleSquared )
+        {
+            maxScaleSquared = lengthSquared;
+        }
+    }
+
+    transformed.m_boxMin = transformedCenter - transformedHalfExtent;
+    transformed.m_boxMax = transformedCenter + transformedHalfExtent;
+
+    D3DXVec3TransformCoord(&transformed.m_sphereCenter, &bounds.m_sphereCenter, &transform);
+    transformed.m_sphereRadius = bounds.m_sphereRadius * sqrtf(maxScaleSquared);
+}
@@ -0,0 +1,65 @@
+#ifndef BOUNDINGVOLUME_H
+#define BOUNDINGVOLUME_H
+
+// DirectX Includes
+#include <d3dx10.h>
+
+//------------------------------------------------------------------------------
+// Axis aligned bounding boxes and bounding spheres
+//
+// Bounds are calculated once, in object space, when the vertices are loaded. Bounds in world space are derived
+// from those by transforming the box and sphere, rather than the vertices, so they are cheap enough to update
+// whenever the object moves. A transformed box is still axis aligned, so it is looser than the object space one.
+//
+
+/**
+* An axis aligned bounding box and a bounding sphere around the same geometry
+**/
+struct BoundingVolume
+{
+   /**
+   * Constructor
+   *
+   * By default, the volume is empty
+   **/
+   BoundingVolume();
+
+   /**
+   * Query whether or not the volume bounds nothing, as for geometry without any vertices or a position
+   **/
+   const bool IsEmpty() const;
+
+
+   D3DXVECTOR3 m_boxMin;         // Minimum corner of the box
+   D3DXVECTOR3 m_boxMax;         // Maximum corner of the box
+   D3DXVECTOR3 m_sphereCenter;
+   float       m_sphereRadius;   // Negative if the volume is empty
+};
+
+/**
+* Calculates the bounds of a set of positions
+*
+* The box is found using SSE. The sphere is centered on the box and is large enough to hold every position.
+*
+* @param positions    - The first position, 3 floats
+* @param numPositions - Number of positions
+* @param stride       - Size in bytes from one position to the next, such as the size of an interleaved vertex
+* @param bounds       - OUT - The bounds, or an empty volume if there are no positions
+**/
+void CalculateBoundingVolume(const unsigned char * positions,
+                             const unsigned numPositions,
+                             const unsigned stride,
+                             BoundingVolume & bounds);
+
+/**
+* Transforms bounds into another space, such as from object space to world space
+*
+* @param bounds      - The bounds to transform
+* @param transform   - Affine transform to apply, as the one a Transform builds
+* @param transformed - OUT - Box and sphere that hold the transformed ones. Empty if the bounds were empty.
+**/
+void TransformBoundingVolume(const BoundingVolume & bounds,
+                             const D3DXMATRIX & transform,
+                             BoundingVolume & transformed);
+
+#endif // BOUNDINGVOLUME_H
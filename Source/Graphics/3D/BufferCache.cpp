@@ -0,0 +1,235 @@
+
+// Project Includes
+#include "BufferCache.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cstring>
+
+//------------------------------------------------------------------------------------------
+namespace
+{
+    //--------------------------------------------------------------------------------------
+    /**
+    * Gets strong references to every buffer of an entry
+    *
+    * @return - false if any of them has been released, in which case the entry cannot be used
+    **/
+    const bool LockBuffers(const std::vector<Buffer::WeakPtr> & weakBuffers, std::vector<Buffer::SharedPtr> & buffers)
+    {
+        buffers.clear();
+
+        for(std::vector<Buffer::WeakPtr>::const_iterator it = weakBuffers.begin(); it != weakBuffers.end(); ++it)
+        {
+            Buffer::SharedPtr buffer = it->lock();
+
+            if( !buffer )
+            {
+                buffers.clear();
+                return false;
+            }
+
+            buffers.push_back(buffer);
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Query whether or not a D3D buffer holds exactly the given data
+    *
+    * The buffer is copied into a staging buffer to be read, which waits for the GPU. Only requests whose hash
+    * matches an entry pay for that.
+    **/
+    const bool HasContents(ID3D10Device & device, ID3D10Buffer & buffer, const void * data, const size_t size)
+    {
+        D3D10_BUFFER_DESC bufferDesc;
+        buffer.GetDesc(&bufferDesc);
+
+        if( bufferDesc.ByteWidth != size )
+        {
+            return false;
+        }
+
+        D3D10_BUFFER_DESC stagingDesc;
+        stagingDesc.Usage          = D3D10_USAGE_STAGING;
+        stagingDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ;
+        stagingDesc.BindFlags      = 0;
+        stagingDesc.ByteWidth      = bufferDesc.ByteWidth;
+        stagingDesc.MiscFlags      = 0;
+
+        ID3D10Buffer * staging = NULL;
+
+        // If it cannot be read back, it is not shared
+        if( FAILED(device.CreateBuffer(&stagingDesc, NULL, &staging)) )
+        {
+            return false;
+        }
+
+        device.CopyResource(staging, &buffer);
+
+        void * mapped = NULL;
+        bool   same   = false;
+
+        if( SUCCEEDED(staging->Map(D3D10_MAP_READ, 0, &mapped)) )
+        {
+            same = memcmp(mapped, data, size) == 0;
+            staging->Unmap();
+        }
+
+        staging->Release();
+        return same;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+bool BufferCache::Key::operator < (const Key & rhs) const
+{
+    if( m_hash != rhs.m_hash )
+    {
+        return m_hash < rhs.m_hash;
+    }
+
+    if( m_numElements != rhs.m_numElements )
+    {
+        return m_numElements < rhs.m_numElements;
+    }
+
+    return m_contentTypes < rhs.m_contentTypes;
+}
+
+//------------------------------------------------------------------------------------------
+BufferCache::BufferCache(ID3D10Device & device)
+    :
+    m_device   (device),
+    m_numHits  (0),
+    m_numMisses(0)
+{
+}
+
+//------------------------------------------------------------------------------------------
+BufferCache::~BufferCache()
+{
+}
+
+//------------------------------------------------------------------------------------------
+void BufferCache::GetInterleavedBuffers(const std::vector<BufferContentType> & contentTypes,
+                                        const void * data,
+                                        const unsigned numVertices,
+                                        std::vector<Buffer::SharedPtr> & buffers)
+{
+    unsigned vertexSize = 0;
+
+    for(std::vector<BufferContentType>::const_iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+    {
+        vertexSize += GetStride(*it);
+    }
+
+    const size_t size = static_cast<size_t>(vertexSize) * numVertices;
+
+    Key key;
+    key.m_hash         = HashContent(data, size);
+    key.m_numElements  = numVertices;
+    key.m_contentTypes = contentTypes;
+
+    // Share the buffers that already exist, if they really hold the same data. They all view one D3D buffer.
+    BufferMap::iterator it = m_buffers.find(key);
+
+    if( it != m_buffers.end() && LockBuffers(it->second, buffers) && 
+        HasContents(m_device, *buffers[0]->GetD3DBuffer(), data, size) )
+    {
+        ++m_numHits;
+        return;
+    }
+
+    // Create new ones, which replace any entry whose hash collided
+    RemoveExpired();
+
+    try
+    {
+        CreateInterleavedBuffers(m_device, contentTypes, data, numVertices, buffers);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    m_buffers[key] = std::vector<Buffer::WeakPtr>(buffers.begin(), buffers.end());
+    ++m_numMisses;
+}
+
+//------------------------------------------------------------------------------------------
+Buffer::SharedPtr BufferCache::GetIndexBuffer(const Index * indices, const unsigned numIndices)
+{
+    const size_t size = sizeof(Index) * static_cast<size_t>(numIndices);
+
+    Key key;
+    key.m_hash        = HashContent(indices, size);
+    key.m_numElements = numIndices;
+    key.m_contentTypes.push_back(INDEX);
+
+    // Share the buffer that already exists, if it really holds the same indices
+    std::vector<Buffer::SharedPtr> buffers;
+    BufferMap::iterator            it = m_buffers.find(key);
+
+    if( it != m_buffers.end() && LockBuffers(it->second, buffers) && 
+        HasContents(m_device, *buffers[0]->GetD3DBuffer(), indices, size) )
+    {
+        ++m_numHits;
+        return buffers[0];
+    }
+
+    // Create a new one, which replaces any entry whose hash collided
+    RemoveExpired();
+
+    Buffer::SharedPtr buffer;
+
+    try
+    {
+        buffer.reset(new Buffer(m_device, INDEX, indices, numIndices));
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    m_buffers[key] = std::vector<Buffer::WeakPtr>(1, buffer);
+    ++m_numMisses;
+
+    return buffer;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned BufferCache::GetNumHits() const
+{
+    return m_numHits;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned BufferCache::GetNumMisses() const
+{
+    return m_numMisses;
+}
+
+//------------------------------------------------------------------------------------------
+void BufferCache::RemoveExpired()
+{
+    BufferMap::iterator it = m_buffers.begin();
+
+    while( it != m_buffers.end() )
+    {
+        std::vector<Buffer::SharedPtr> buffers;
+
+        if( !LockBuffers(it->second, buffers) )
+        {
+            it = m_buffers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
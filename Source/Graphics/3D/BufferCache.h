@@ -0,0 +1,121 @@
+#ifndef BUFFERCACHE_H
+#define BUFFERCACHE_H
+
+// EngineX Includes
+#include "Core\ContentHash.h"
+#include "Graphics\3D\Buffers.h"
+
+// DirectX Includes
+#include <d3d10.h>
+
+// Standard Includes
+#include <map>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+/**
+* Creates vertex and index buffers, sharing one set of buffers between every request for the same contents
+*
+* Buffers are identified by a hash of their data (see ContentHash.h), along with their layout, so models that are
+* loaded several times, or from copies of the same file under different names, share their video memory.
+* When the hash matches, the buffer is read back and compared byte for byte before it is shared, so data whose
+* hash merely collides with another's gets buffers of its own.
+*
+* The cache only holds weak references. Buffers are released as usual once nothing else refers to them.
+* It must only be used from the thread that owns the device.
+**/
+class BufferCache
+{
+public:
+
+   /**
+   * Constructor
+   *
+   * @param device - D3D device the buffers are created on
+   **/
+   BufferCache(ID3D10Device & device);
+
+   /**
+   * Deconstructor
+   **/
+   ~BufferCache();
+
+
+   /**
+   * Gets a buffer for each content type of interleaved vertex data, creating them if there are none for
+   * the same data already (see CreateInterleavedBuffers)
+   *
+   * @param contentTypes - Content types making up one vertex, in the order they appear
+   * @param data         - Interleaved vertex data
+   * @param numVertices  - Number of vertices in the data
+   * @param buffers OUT  - One buffer per content type, all sharing the same D3D buffer
+   *
+   * @throws BaseException - If the buffers had to be created and creation failed
+   **/
+   void GetInterleavedBuffers(const std::vector<BufferContentType> & contentTypes,
+                              const void * data,
+                              const unsigned numVertices,
+                              std::vector<Buffer::SharedPtr> & buffers);
+
+   /**
+   * Gets an index buffer, creating it if there is none for the same indices already
+   *
+   * @param indices    - The indices
+   * @param numIndices - Number of indices
+   *
+   * @throws BaseException - If the buffer had to be created and creation failed
+   **/
+   Buffer::SharedPtr GetIndexBuffer(const Index * indices, const unsigned numIndices);
+
+   /**
+   * Gets the number of requests that were given buffers that already existed
+   **/
+   const unsigned GetNumHits() const;
+
+   /**
+   * Gets the number of requests that had to create their buffers
+   **/
+   const unsigned GetNumMisses() const;
+
+private:
+
+   /** No Copy allowed */
+   BufferCache(const BufferCache & rhs);
+
+   /** No assignment allowed */
+   BufferCache & operator = (const BufferCache & rhs);
+
+   /**
+   * Identifies the contents of a set of buffers
+   **/
+   struct Key
+   {
+      bool operator < (const Key & rhs) const;
+
+      ContentHash                    m_hash;           // Hash of the data
+      unsigned                       m_numElements;    // Number of vertices or indices
+      std::vector<BufferContentType> m_contentTypes;   // Layout of each vertex, or just INDEX
+   };
+
+   /**
+   * Removes the entries whose buffers have all been released
+   **/
+   void RemoveExpired();
+
+
+   ID3D10Device & m_device;
+
+   /**
+   * Buffers that were created
+   *
+   * Key   - contents of the buffers
+   * Value - the buffers, one per content type
+   **/
+   typedef std::map<Key, std::vector<Buffer::WeakPtr> > BufferMap;
+   BufferMap      m_buffers;
+
+   unsigned       m_numHits;
+   unsigned       m_numMisses;
+};
+
+#endif // BUFFERCACHE_H
@@ -25,11 +25,13 @@ const std::string ContentTypeToSemanticName(const BufferContentType & contentTyp
     {
         return "COLOR";
     }
-    else if( contentType == NORMAL )
+    else if( contentType == NORMAL ||
+             contentType == NORMAL16 )
     {
         return "NORMAL";
     }
-    else if( contentType == POSITION )
+    else if( contentType == POSITION ||
+             contentType == POSITION16 )
     {
         return "POSITION";
     }
@@ -47,7 +49,8 @@ const std::string ContentTypeToSemanticName(const BufferContentType & contentTyp
     }
     else if( contentType == TEXCOORD1D ||
             contentType == TEXCOORD2D ||
-            contentType == TEXCOORD3D )
+            contentType == TEXCOORD3D ||
+            contentType == TEXCOORD2D16 )
     {
         return "TEXCOORD";
     }
@@ -104,6 +107,24 @@ const DXGI_FORMAT GetFormat(const BufferContentType & contentType)
         return DXGI_FORMAT_R32G32B32A32_FLOAT;
     }
 
+    // 4 half floats
+    else if( contentType == POSITION16 )
+    {
+        return DXGI_FORMAT_R16G16B16A16_FLOAT;
+    }
+
+    // 2 signed normalized shorts
+    else if( contentType == NORMAL16 )
+    {
+        return DXGI_FORMAT_R16G16_SNORM;
+    }
+
+    // 2 unsigned normalized shorts
+    else if( contentType == TEXCOORD2D16 )
+    {
+        return DXGI_FORMAT_R16G16_UNORM;
+    }
+
     // Unknown
     else
     {
@@ -129,16 +150,22 @@ const unsigned GetFormatSize(const DXGI_FORMAT & format)
         return 12;
     }
 
-    if( format == DXGI_FORMAT_R32G32_FLOAT ||
-        format == DXGI_FORMAT_R32G32_UINT  ||
-        format == DXGI_FORMAT_R32G32_SINT )
+    if( format == DXGI_FORMAT_R32G32_FLOAT       ||
+        format == DXGI_FORMAT_R32G32_UINT        ||
+        format == DXGI_FORMAT_R32G32_SINT        ||
+        format == DXGI_FORMAT_R16G16B16A16_FLOAT ||
+        format == DXGI_FORMAT_R16G16B16A16_UNORM ||
+        format == DXGI_FORMAT_R16G16B16A16_SNORM )
     {
         return 8;
     }
 
-    if( format == DXGI_FORMAT_R32_FLOAT ||
-        format == DXGI_FORMAT_R32_UINT  ||
-        format == DXGI_FORMAT_R32_SINT )
+    if( format == DXGI_FORMAT_R32_FLOAT    ||
+        format == DXGI_FORMAT_R32_UINT     ||
+        format == DXGI_FORMAT_R32_SINT     ||
+        format == DXGI_FORMAT_R16G16_FLOAT ||
+        format == DXGI_FORMAT_R16G16_UNORM ||
+        format == DXGI_FORMAT_R16G16_SNORM )
     {
         return 4;
     }
@@ -195,6 +222,20 @@ const unsigned GetStride(const BufferContentType & contentType)
         return sizeof(D3DXMATRIX);
     }
 
+    // Quantized
+    else if( contentType == POSITION16 )
+    {
+        return sizeof(Position16);
+    }
+    else if( contentType == NORMAL16 )
+    {
+        return sizeof(Normal16);
+    }
+    else if( contentType == TEXCOORD2D16 )
+    {
+        return sizeof(TexCoord2D16);
+    }
+
     // Unknown
     else
     {
@@ -215,7 +256,9 @@ Buffer::Buffer(ID3D10Device & device,
     m_contentType(contentType),
     m_dynamic(dynamic),
     m_perInstance(perInstance),
-    m_numElements(static_cast<unsigned>(data.size()))
+    m_numElements(static_cast<unsigned>(data.size())),
+    m_byteOffset(0),
+    m_byteStride(GetStride(contentType))
 {
     // Check for sillyness
     if( sizeof(unsigned int) != GetStride(contentType) ||
@@ -231,42 +274,8 @@ Buffer::Buffer(ID3D10Device & device,
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    // Describe the vertex buffer
-    D3D10_BUFFER_DESC bufferDesc;
-
-    if( !dynamic )
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DEFAULT;
-        bufferDesc.CPUAccessFlags = 0;
-    }
-    else
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DYNAMIC;
-        bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-    }
-
-    if( contentType == INDEX )
-    {
-        bufferDesc.BindFlags      = D3D10_BIND_INDEX_BUFFER;   
-    }
-    else
-    {
-        bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
-    }
-
-    bufferDesc.ByteWidth      = static_cast<UINT>(sizeof(unsigned int) * data.size());
-    bufferDesc.MiscFlags      = 0;
-   
-    // Provide the data for the buffer
-    D3D10_SUBRESOURCE_DATA initData;
-    initData.pSysMem = &data[0];
-   
     // Create the buffer with the provided data
-    if( FAILED(m_device.CreateBuffer(&bufferDesc, &initData, &m_buffer)) )
-    {
-        const std::string msg("Failed to create buffer");
-        throw Common::Exception(__FILE__, __LINE__, msg);
-    }
+    CreateD3DBuffer(&data[0], static_cast<unsigned>(sizeof(unsigned int) * data.size()));
 }
 
 //---------------------------------------------------------------------------
@@ -281,7 +290,9 @@ Buffer::Buffer(ID3D10Device & device,
     m_contentType(contentType),
     m_dynamic(dynamic),
     m_perInstance(perInstance),
-    m_numElements(static_cast<unsigned>(data.size()))
+    m_numElements(static_cast<unsigned>(data.size())),
+    m_byteOffset(0),
+    m_byteStride(GetStride(contentType))
 {
     // Check for sillyness
     if( sizeof(float) != GetStride(contentType) ||
@@ -291,34 +302,8 @@ Buffer::Buffer(ID3D10Device & device,
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    // Describe the vertex buffer
-    D3D10_BUFFER_DESC bufferDesc;
-
-    if( !dynamic )
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DEFAULT;
-        bufferDesc.CPUAccessFlags = 0;
-    }
-    else
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DYNAMIC;
-        bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-    }
-
-    bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
-    bufferDesc.ByteWidth      = static_cast<UINT>(sizeof(float) * data.size());
-    bufferDesc.MiscFlags      = 0;
-   
-    // Provide the data for the buffer
-    D3D10_SUBRESOURCE_DATA initData;
-    initData.pSysMem = &data[0];
-   
     // Create the buffer with the provided data
-    if( FAILED(m_device.CreateBuffer(&bufferDesc, &initData, &m_buffer)) )
-    {
-        const std::string msg("Failed to create buffer");
-        throw Common::Exception(__FILE__, __LINE__, msg);
-    }
+    CreateD3DBuffer(&data[0], static_cast<unsigned>(sizeof(float) * data.size()));
 }
 
 //---------------------------------------------------------------------------
@@ -333,7 +318,9 @@ Buffer::Buffer(ID3D10Device & device,
     m_contentType(contentType),
     m_dynamic(dynamic),
     m_perInstance(perInstance),
-    m_numElements(static_cast<unsigned>(data.size()))
+    m_numElements(static_cast<unsigned>(data.size())),
+    m_byteOffset(0),
+    m_byteStride(GetStride(contentType))
 {
     // Check for sillyness
     if( sizeof(D3DXVECTOR2) != GetStride(contentType)      ||
@@ -343,34 +330,8 @@ Buffer::Buffer(ID3D10Device & device,
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    // Describe the vertex buffer
-    D3D10_BUFFER_DESC bufferDesc;
-
-    if( !dynamic )
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DEFAULT;
-        bufferDesc.CPUAccessFlags = 0;
-    }
-    else
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DYNAMIC;
-        bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-    }
-
-    bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
-    bufferDesc.ByteWidth      = static_cast<UINT>(sizeof(D3DXVECTOR2) * data.size());
-    bufferDesc.MiscFlags      = 0;
-   
-    // Provide the data for the buffer
-    D3D10_SUBRESOURCE_DATA initData;
-    initData.pSysMem = &data[0];
-   
     // Create the buffer with the provided data
-    if( FAILED(m_device.CreateBuffer(&bufferDesc, &initData, &m_buffer)) )
-    {
-        const std::string msg("Failed to create buffer");
-        throw Common::Exception(__FILE__, __LINE__, msg);
-    }
+    CreateD3DBuffer(&data[0], static_cast<unsigned>(sizeof(D3DXVECTOR2) * data.size()));
 }
 
 //---------------------------------------------------------------------------
@@ -385,7 +346,9 @@ Buffer::Buffer(ID3D10Device & device,
     m_contentType(contentType),
     m_dynamic(dynamic),
     m_perInstance(perInstance),
-    m_numElements(static_cast<unsigned>(data.size()))
+    m_numElements(static_cast<unsigned>(data.size())),
+    m_byteOffset(0),
+    m_byteStride(GetStride(contentType))
 {
     // Check for sillyness
     if( sizeof(D3DXVECTOR3) != GetStride(contentType)         ||
@@ -395,34 +358,8 @@ Buffer::Buffer(ID3D10Device & device,
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    // Describe the vertex buffer
-    D3D10_BUFFER_DESC bufferDesc;
-
-    if( !dynamic )
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DEFAULT;
-        bufferDesc.CPUAccessFlags = 0;
-    }
-    else
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DYNAMIC;
-        bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-    }
-
-    bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
-    bufferDesc.ByteWidth      = static_cast<UINT>(sizeof(D3DXVECTOR3) * data.size());
-    bufferDesc.MiscFlags      = 0;
-   
-    // Provide the data for the buffer
-    D3D10_SUBRESOURCE_DATA initData;
-    initData.pSysMem = &data[0];
-   
     // Create the buffer with the provided data
-    if( FAILED(m_device.CreateBuffer(&bufferDesc, &initData, &m_buffer)) )
-    {
-        const std::string msg("Failed to create buffer");
-        throw Common::Exception(__FILE__, __LINE__, msg);
-    }
+    CreateD3DBuffer(&data[0], static_cast<unsigned>(sizeof(D3DXVECTOR3) * data.size()));
 }
 
 //---------------------------------------------------------------------------
@@ -437,7 +374,9 @@ Buffer::Buffer(ID3D10Device & device,
     m_contentType(contentType),
     m_dynamic(dynamic),
     m_perInstance(perInstance),
-    m_numElements(static_cast<unsigned>(data.size()))
+    m_numElements(static_cast<unsigned>(data.size())),
+    m_byteOffset(0),
+    m_byteStride(GetStride(contentType))
 {
     // Check for sillyness
     if( sizeof(D3DXVECTOR4) != GetStride(contentType)            ||
@@ -447,34 +386,8 @@ Buffer::Buffer(ID3D10Device & device,
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    // Describe the vertex buffer
-    D3D10_BUFFER_DESC bufferDesc;
-
-    if( !dynamic )
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DEFAULT;
-        bufferDesc.CPUAccessFlags = 0;
-    }
-    else
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DYNAMIC;
-        bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-    }
-
-    bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
-    bufferDesc.ByteWidth      = static_cast<UINT>(sizeof(D3DXVECTOR4) * data.size());
-    bufferDesc.MiscFlags      = 0;
-   
-    // Provide the data for the buffer
-    D3D10_SUBRESOURCE_DATA initData;
-    initData.pSysMem = &data[0];
-
     // Create the buffer with the provided data
-    if( FAILED(m_device.CreateBuffer(&bufferDesc, &initData, &m_buffer)) )
-    {
-        const std::string msg("Failed to create buffer");
-        throw Common::Exception(__FILE__, __LINE__, msg);
-    }
+    CreateD3DBuffer(&data[0], static_cast<unsigned>(sizeof(D3DXVECTOR4) * data.size()));
 }
 
 //---------------------------------------------------------------------------
@@ -489,7 +402,9 @@ Buffer::Buffer(ID3D10Device & device,
     m_contentType(contentType),
     m_dynamic(dynamic),
     m_perInstance(perInstance),
-    m_numElements(static_cast<unsigned>(data.size()))
+    m_numElements(static_cast<unsigned>(data.size())),
+    m_byteOffset(0),
+    m_byteStride(GetStride(contentType))
 {   
     // Check for sillyness
     if( sizeof(D3DXCOLOR) != GetStride(contentType)              ||
@@ -499,34 +414,8 @@ Buffer::Buffer(ID3D10Device & device,
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    // Describe the vertex buffer
-    D3D10_BUFFER_DESC bufferDesc;
-
-    if( !dynamic )
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DEFAULT;
-        bufferDesc.CPUAccessFlags = 0;
-    }
-    else
-    {
-        bufferDesc.Usage          = D3D10_USAGE_DYNAMIC;
-        bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-    }
-
-    bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
-    bufferDesc.ByteWidth      = static_cast<UINT>(sizeof(D3DXCOLOR) * data.size());
-    bufferDesc.MiscFlags      = 0;
-   
-    // Provide the data for the buffer
-    D3D10_SUBRESOURCE_DATA initData;
-    initData.pSysMem = &data[0];
-   
     // Create the buffer with the provided data
-    if( FAILED(m_device.CreateBuffer(&bufferDesc, &initData, &m_buffer)) )
-    {
-        const std::string msg("Failed to create buffer");
-        throw Common::Exception(__FILE__, __LINE__, msg);
-    }
+    CreateD3DBuffer(&data[0], static_cast<unsigned>(sizeof(D3DXCOLOR) * data.size()));
 }
 
 //---------------------------------------------------------------------------
@@ -541,7 +430,9 @@ Buffer::Buffer(ID3D10Device & device,
     m_contentType(contentType),
     m_dynamic(dynamic),
     m_perInstance(perInstance),
-    m_numElements(static_cast<unsigned>(data.size()))
+    m_numElements(static_cast<unsigned>(data.size())),
+    m_byteOffset(0),
+    m_byteStride(GetStride(contentType))
     {
     // Check for sillyness
     if( sizeof(D3DXMATRIX) != GetStride(contentType)              ||
@@ -551,34 +442,80 @@ Buffer::Buffer(ID3D10Device & device,
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    // Describe the vertex buffer
-    D3D10_BUFFER_DESC bufferDesc;
+    // Create the buffer with the provided data
+    CreateD3DBuffer(&data[0], static_cast<unsigned>(sizeof(D3DXMATRIX) * data.size()));
+}
 
-    if( !dynamic )
+//---------------------------------------------------------------------------
+Buffer::Buffer(ID3D10Device & device,
+               const BufferContentType contentType,
+               const void * data,
+               const unsigned numElements,
+               const bool dynamic,
+               const bool perInstance)
+    :
+    m_device(device),
+    m_buffer(NULL),
+    m_contentType(contentType),
+    m_dynamic(dynamic),
+    m_perInstance(perInstance),
+    m_numElements(numElements),
+    m_byteOffset(0),
+    m_byteStride(GetStride(contentType))
+{
+    if( !data || !numElements )
     {
-        bufferDesc.Usage          = D3D10_USAGE_DEFAULT;
-        bufferDesc.CPUAccessFlags = 0;
+        const std::string msg("Cannot create a buffer without any data");
+        throw Common::Exception(__FILE__, __LINE__, msg);
     }
-    else
+
+    if( contentType == INDEX && perInstance )
     {
-        bufferDesc.Usage          = D3D10_USAGE_DYNAMIC;
-        bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
+        const std::string msg("An index buffer cannot be 'per instance'");
+        throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
-    bufferDesc.ByteWidth      = static_cast<UINT>(sizeof(D3DXMATRIX) * data.size());
-    bufferDesc.MiscFlags      = 0;
-   
-    // Provide the data for the buffer
-    D3D10_SUBRESOURCE_DATA initData;
-    initData.pSysMem = &data[0];
-   
     // Create the buffer with the provided data
-    if( FAILED(m_device.CreateBuffer(&bufferDesc, &initData, &m_buffer)) )
+    CreateD3DBuffer(data, m_byteStride * numElements);
+}
+
+//---------------------------------------------------------------------------
+Buffer::Buffer(ID3D10Device & device,
+               const BufferContentType contentType,
+               ID3D10Buffer * interleavedBuffer,
+               const unsigned numElements,
+               const unsigned byteOffset,
+               const unsigned byteStride)
+    :
+    m_device(device),
+    m_buffer(interleavedBuffer),
+    m_contentType(contentType),
+    m_dynamic(false),
+    m_perInstance(false),
+    m_numElements(numElements),
+    m_byteOffset(byteOffset),
+    m_byteStride(byteStride)
+{
+    if( !interleavedBuffer )
     {
-        const std::string msg("Failed to create buffer");
+        const std::string msg("Interleaved D3D buffer is NULL");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( contentType == INDEX )
+    {
+        const std::string msg("An index buffer cannot be interleaved with vertex data");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( byteOffset + GetStride(contentType) > byteStride )
+    {
+        const std::string msg("Interleaved element does not fit within the vertex stride");
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
+
+    // The D3D buffer is shared by every element of the interleaved data
+    m_buffer->AddRef();
 }
 
 //---------------------------------------------------------------------------
@@ -614,9 +551,139 @@ const unsigned Buffer::GetNumElements() const
     return m_numElements;
 }
 
+//---------------------------------------------------------------------------
+const unsigned Buffer::GetByteOffset() const
+{
+    return m_byteOffset;
+}
+
+//---------------------------------------------------------------------------
+const unsigned Buffer::GetByteStride() const
+{
+    return m_byteStride;
+}
+
 //---------------------------------------------------------------------------
 ID3D10Buffer * Buffer::GetD3DBuffer() const
 {
     return m_buffer;
 }
 
+//---------------------------------------------------------------------------
+const BoundingVolume & Buffer::GetBounds() const
+{
+    return m_bounds;
+}
+
+//---------------------------------------------------------------------------
+void Buffer::CreateD3DBuffer(const void * data, const unsigned numBytes)
+{
+    // Positions are only seen here, so bound them now rather than keeping a copy
+    if( m_contentType == POSITION )
+    {
+        CalculateBoundingVolume(static_cast<const unsigned char *>(data), m_numElements, m_byteStride, m_bounds);
+    }
+
+    // Describe the buffer
+    D3D10_BUFFER_DESC bufferDesc;
+
+    if( !m_dynamic )
+    {
+        bufferDesc.Usage          = D3D10_USAGE_DEFAULT;
+        bufferDesc.CPUAccessFlags = 0;
+    }
+    else
+    {
+        bufferDesc.Usage          = D3D10_USAGE_DYNAMIC;
+        bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
+    }
+
+    if( m_contentType == INDEX )
+    {
+        bufferDesc.BindFlags      = D3D10_BIND_INDEX_BUFFER;   
+    }
+    else
+    {
+        bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
+    }
+
+    bufferDesc.ByteWidth      = static_cast<UINT>(numBytes);
+    bufferDesc.MiscFlags      = 0;
+   
+    // Provide the data for the buffer
+    D3D10_SUBRESOURCE_DATA initData;
+    initData.pSysMem = data;
+   
+    // Create the buffer with the provided data
+    if( FAILED(m_device.CreateBuffer(&bufferDesc, &initData, &m_buffer)) )
+    {
+        const std::string msg("Failed to create buffer");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+}
+
+//---------------------------------------------------------------------------
+void CreateInterleavedBuffers(ID3D10Device & device,
+                              const std::vector<BufferContentType> & contentTypes,
+                              const void * data,
+                              const unsigned numVertices,
+                              std::vector<Buffer::SharedPtr> & buffers)
+{
+    buffers.clear();
+
+    if( contentTypes.empty() || !data || !numVertices )
+    {
+        const std::string msg("Cannot create interleaved buffers without any data");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Work out the size of one vertex
+    unsigned vertexStride = 0;
+
+    for(std::vector<BufferContentType>::const_iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+    {
+        vertexStride += GetStride(*it);
+    }
+
+    // Create one D3D buffer holding all of the data
+    D3D10_BUFFER_DESC bufferDesc;
+    bufferDesc.Usage          = D3D10_USAGE_IMMUTABLE;
+    bufferDesc.CPUAccessFlags = 0;
+    bufferDesc.BindFlags      = D3D10_BIND_VERTEX_BUFFER;
+    bufferDesc.ByteWidth      = static_cast<UINT>(vertexStride * numVertices);
+    bufferDesc.MiscFlags      = 0;
+
+    D3D10_SUBRESOURCE_DATA initData;
+    initData.pSysMem = data;
+
+    ID3D10Buffer * d3dBuffer = NULL;
+
+    if( FAILED(device.CreateBuffer(&bufferDesc, &initData, &d3dBuffer)) )
+    {
+        const std::string msg("Failed to create interleaved buffer");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Create a view of the D3D buffer for each content type
+    unsigned byteOffset = 0;
+
+    try
+    {
+        for(std::vector<BufferContentType>::const_iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+        {
+            Buffer::SharedPtr buffer(new Buffer(device, *it, d3dBuffer, numVertices, byteOffset, vertexStride));
+            buffers.push_back(buffer);
+
+            byteOffset += GetStride(*it);
+        }
+    }
+    catch(Common::Exception & e)
+    {
+        d3dBuffer->Release();
+        throw e;
+    }
+
+    // Each view holds its own reference
+    d3dBuffer->Release();
+}
+
@@ -2,6 +2,9 @@
 #ifndef BUFFERS_H
 #define BUFFERS_H
 
+// EngineX Includes
+#include "Graphics\3D\BoundingVolume.h"
+
 // DirectX Includes
 #include <d3d10.h>
 #include <dxgi.h>
@@ -32,6 +35,30 @@ typedef D3DXVECTOR3  TexCoord3D;       // Texture coordinates              float
 
 typedef unsigned int Index;            // Indices into vertex buffers      uint
 
+typedef D3DXVECTOR4_16F Position16;    // Quantized vertex position        float4, half floats with w = 1
+
+/**
+* Unit normal, octahedral encoded into two signed normalized 16 bit components    float2
+*
+* See EncodeOctahedralNormal in VertexQuantizer.h
+**/
+struct Normal16
+{
+   short x;
+   short y;
+};
+
+/**
+* Texture coordinates, scaled into two unsigned normalized 16 bit components     float2
+*
+* The scale and bias of a mesh are applied by its shader. See VertexQuantizer.h
+**/
+struct TexCoord2D16
+{
+   unsigned short u;
+   unsigned short v;
+};
+
 typedef D3DXMATRIX   Matrix;           // Transformation matrix            float4x4
 
 //------------------------------------------------------------------------------------------
@@ -61,6 +88,11 @@ enum BufferContentType
    // Correspond to custom semantics
    TRANSFORM,
 
+   // Quantized versions of the above, that correspond to the same semantics
+   POSITION16,
+   NORMAL16,
+   TEXCOORD2D16,
+
    NUM_BUFFER_CONTENT_TYPES
 };
 
@@ -89,6 +121,10 @@ const unsigned GetStride(const BufferContentType & contentType);
 //------------------------------------------------------------------------------------------
 /**
 * Wrapper for a D3D buffer
+*
+* A buffer either owns its D3D buffer outright, with its elements tightly packed, or refers to one
+* element of interleaved vertex data that several buffers share. In both cases GetByteOffset and
+* GetByteStride describe how to bind it to the input assembler.
 **/
 class Buffer
 {
@@ -174,6 +210,38 @@ public:
           const bool dynamic = false,
           const bool perInstance = false);
 
+   /**
+   * Creates a buffer for any content type directly from a contiguous block of memory
+   *
+   * The data is handed to D3D as is, without an intermediate copy, so it may point into a memory mapped file.
+   *
+   * @param data        - Tightly packed elements of the C++ type corresponding to the content type
+   * @param numElements - Number of elements the data contains
+   **/
+   Buffer(ID3D10Device & device,
+          const BufferContentType contentType,
+          const void * data,
+          const unsigned numElements,
+          const bool dynamic = false,
+          const bool perInstance = false);
+
+   /**
+   * Creates a buffer that refers to one element of interleaved vertex data held in a shared D3D buffer
+   *
+   * See CreateInterleavedBuffers
+   *
+   * @param interleavedBuffer - D3D buffer containing the interleaved data. A reference is added.
+   * @param numElements       - Number of vertices in the interleaved data
+   * @param byteOffset        - Offset in bytes of this element from the start of each vertex
+   * @param byteStride        - Size in bytes of one whole interleaved vertex
+   **/
+   Buffer(ID3D10Device & device,
+          const BufferContentType contentType,
+          ID3D10Buffer * interleavedBuffer,
+          const unsigned numElements,
+          const unsigned byteOffset,
+          const unsigned byteStride);
+
    /**
    * Destructor
    **/
@@ -200,13 +268,36 @@ public:
    **/
    const unsigned GetNumElements() const;
 
+   /**
+   * Get the offset, in bytes, to bind the D3D buffer with
+   **/
+   const unsigned GetByteOffset() const;
+
+   /**
+   * Get the stride, in bytes, to bind the D3D buffer with
+   **/
+   const unsigned GetByteStride() const;
+
    /**
    * Get the D3D buffer
    **/
    ID3D10Buffer * GetD3DBuffer() const;
 
+   /**
+   * Get the bounds, in object space, of the positions the buffer was created with
+   *
+   * Only buffers of POSITION content that were created from data have bounds. Others, including interleaved
+   * buffers, return an empty volume. The bounds are not updated if a dynamic buffer is written to.
+   **/
+   const BoundingVolume & GetBounds() const;
+
 private:
    
+   /**
+   * Creates the D3D buffer and fills it with the provided data
+   **/
+   void CreateD3DBuffer(const void * data, const unsigned numBytes);
+
    /** No Copy allowed */
    Buffer(const Buffer & rhs);
 
@@ -223,6 +314,30 @@ private:
    const bool              m_perInstance;   // Whether or not this buffer contains per instance data or per vertex data
 
    unsigned                m_numElements;   // Number of elements the buffer contains
+   unsigned                m_byteOffset;    // Offset in bytes of the first element in the D3D buffer
+   unsigned                m_byteStride;    // Distance in bytes between elements in the D3D buffer
+
+   BoundingVolume          m_bounds;        // Bounds of the positions the buffer was created with, if it holds positions
 };
 
+//------------------------------------------------------------------------------------------
+/**
+* Creates a single D3D vertex buffer from interleaved vertex data, and a Buffer for each content type in it
+*
+* The data is handed to D3D as is, so it may point straight into a memory mapped file. Each content type
+* is placed directly after the previous one within a vertex, in the order given.
+*
+* @param contentTypes - Content types making up one vertex, in the order they appear
+* @param data         - Interleaved vertex data
+* @param numVertices  - Number of vertices in the data
+* @param buffers OUT  - One buffer per content type, all sharing the same D3D buffer
+*
+* @throws BaseException - If the D3D buffer could not be created
+**/
+void CreateInterleavedBuffers(ID3D10Device & device,
+                              const std::vector<BufferContentType> & contentTypes,
+                              const void * data,
+                              const unsigned numVertices,
+                              std::vector<Buffer::SharedPtr> & buffers);
+
 #endif // BUFFERS_H
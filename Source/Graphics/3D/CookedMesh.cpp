@@ -0,0 +1,995 @@
+
+// Project Includes
+#include "CookedMesh.h"
+#include "MeshCodec.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <map>
+#include <sstream>
+
+// OS Includes
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+//------------------------------------------------------------------------------
+namespace
+{
+    //--------------------------------------------------------------------------
+    /**
+    * Gets the last time a file was written to
+    *
+    * @return - false if the file does not exist
+    **/
+    bool GetLastWriteTime(const std::string & filePath, unsigned long long & lastWriteTime)
+    {
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+        if( !GetFileAttributesExA(filePath.c_str(), GetFileExInfoStandard, &attributes) )
+        {
+            return false;
+        }
+
+        lastWriteTime = (static_cast<unsigned long long>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+                        attributes.ftLastWriteTime.dwLowDateTime;
+#else
+        struct stat fileStat;
+
+        if( stat(filePath.c_str(), &fileStat) != 0 )
+        {
+            return false;
+        }
+
+        lastWriteTime = static_cast<unsigned long long>(fileStat.st_mtime);
+#endif
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Rounds an offset up to the alignment of sections
+    **/
+    size_t AlignOffset(const size_t offset)
+    {
+        return (offset + COOKED_MESH_ALIGNMENT - 1) & ~static_cast<size_t>(COOKED_MESH_ALIGNMENT - 1);
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Copies a material channel into its record, adding its texture to the texture table if it is mapped
+    **/
+    void WriteChannelRecord(const MaterialChannelData & channel,
+                            std::map<std::string, unsigned> & textureIndices,
+                            std::vector<std::string> & textureFiles,
+                            CookedMaterialChannelRecord & record)
+    {
+        record.m_textureIndex = COOKED_MESH_NO_TEXTURE;
+        record.m_color[0]     = channel.m_color.r;
+        record.m_color[1]     = channel.m_color.g;
+        record.m_color[2]     = channel.m_color.b;
+        record.m_color[3]     = channel.m_color.a;
+
+        if( channel.m_mapped )
+        {
+            std::map<std::string, unsigned>::const_iterator it = textureIndices.find(channel.m_textureFile);
+
+            if( it == textureIndices.end() )
+            {
+                const unsigned textureIndex = static_cast<unsigned>(textureFiles.size());
+                it = textureIndices.insert(std::make_pair(channel.m_textureFile, textureIndex)).first;
+                textureFiles.push_back(channel.m_textureFile);
+            }
+
+            record.m_textureIndex = it->second;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Copies a material channel out of its record
+    **/
+    void ReadChannelRecord(const CookedMaterialChannelRecord & record,
+                           const std::vector<std::string> & textureFiles,
+                           MaterialChannelData & channel)
+    {
+        channel.m_color = D3DXCOLOR(record.m_color[0], record.m_color[1], record.m_color[2], record.m_color[3]);
+
+        if( record.m_textureIndex == COOKED_MESH_NO_TEXTURE )
+        {
+            channel.m_mapped = false;
+            channel.m_textureFile.clear();
+            return;
+        }
+
+        if( record.m_textureIndex >= textureFiles.size() )
+        {
+            std::ostringstream msg;
+            msg << "Material refers to texture " << record.m_textureIndex << ", but there are only " 
+                << textureFiles.size() << " textures";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        channel.m_mapped      = true;
+        channel.m_textureFile = textureFiles[record.m_textureIndex];
+    }
+
+    //--------------------------------------------------------------------------
+    void WriteCacheRecord(const VertexCacheStatistics & statistics, CookedVertexCacheRecord & record)
+    {
+        record.m_numTriangles    = statistics.m_numTriangles;
+        record.m_numVerticesUsed = statistics.m_numVerticesUsed;
+        record.m_numTransformed  = statistics.m_numTransformed;
+        record.m_acmr            = statistics.m_acmr;
+        record.m_atvr            = statistics.m_atvr;
+    }
+
+    //--------------------------------------------------------------------------
+    void ReadCacheRecord(const CookedVertexCacheRecord & record, VertexCacheStatistics & statistics)
+    {
+        statistics.m_numTriangles    = record.m_numTriangles;
+        statistics.m_numVerticesUsed = record.m_numVerticesUsed;
+        statistics.m_numTransformed  = record.m_numTransformed;
+        statistics.m_acmr            = record.m_acmr;
+        statistics.m_atvr            = record.m_atvr;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Records the settings a file is cooked with in its header
+    *
+    * @throws BaseException - If there are more level of detail ratios than can be cooked
+    **/
+    void WriteSettings(const CookedMeshSettings & settings, CookedMeshHeader & header)
+    {
+        if( settings.m_levelOfDetailRatios.size() > COOKED_MESH_MAX_LODS )
+        {
+            std::ostringstream msg;
+            msg << settings.m_levelOfDetailRatios.size() << " level of detail ratios were given. At most " 
+                << COOKED_MESH_MAX_LODS << " can be cooked.";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        header.m_settingsFlags = 0;
+
+        if( settings.m_quantizeVertices )
+        {
+            header.m_settingsFlags |= COOKED_SETTINGS_QUANTIZE_VERTICES;
+        }
+
+        if( settings.m_generateClusters )
+        {
+            header.m_settingsFlags |= COOKED_SETTINGS_GENERATE_CLUSTERS;
+        }
+
+        if( settings.m_generateTangentData )
+        {
+            header.m_settingsFlags |= COOKED_SETTINGS_GENERATE_TANGENTS;
+        }
+
+        header.m_numLevelOfDetailRatios = static_cast<unsigned>(settings.m_levelOfDetailRatios.size());
+
+        for(size_t i = 0; i < settings.m_levelOfDetailRatios.size(); ++i)
+        {
+            header.m_levelOfDetailRatios[i] = settings.m_levelOfDetailRatios[i];
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Query whether or not a file was cooked with the given settings
+    **/
+    bool HasSettings(const CookedMeshHeader & header, const CookedMeshSettings & settings)
+    {
+        CookedMeshHeader expected;
+        memset(&expected, 0, sizeof(expected));
+
+        if( settings.m_levelOfDetailRatios.size() > COOKED_MESH_MAX_LODS )
+        {
+            return false;
+        }
+
+        WriteSettings(settings, expected);
+
+        if( header.m_settingsFlags != expected.m_settingsFlags || header.m_numLevelOfDetailRatios != expected.m_numLevelOfDetailRatios )
+        {
+            return false;
+        }
+
+        for(unsigned i = 0; i < expected.m_numLevelOfDetailRatios; ++i)
+        {
+            if( header.m_levelOfDetailRatios[i] != expected.m_levelOfDetailRatios[i] )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Throws if any index of a polygon set read from a cooked mesh is out of range of its vertices
+    *
+    * @param what - Which indices they are, for the error message
+    **/
+    void ValidateIndices(const Index * indices, 
+                         const unsigned numIndices, 
+                         const unsigned numVertices, 
+                         const std::string & what,
+                         const std::string & cookedFilePath)
+    {
+        for(unsigned i = 0; i < numIndices; ++i)
+        {
+            if( indices[i] >= numVertices )
+            {
+                std::ostringstream msg;
+                msg << what << " index " << i << " refers to vertex " << indices[i] << ", but there are only " 
+                    << numVertices << " vertices, in cooked mesh: " << cookedFilePath;
+                throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+CookedMeshSettings::CookedMeshSettings()
+    :
+    m_quantizeVertices(false),
+    m_generateClusters(false),
+    m_generateTangentData(false)
+{
+}
+
+//------------------------------------------------------------------------------
+const std::string GetCookedMeshFilePath(const std::string & sourceFilePath)
+{
+    const size_t slash = sourceFilePath.find_last_of("\\/");
+    const size_t dot   = sourceFilePath.find_last_of('.');
+
+    if( dot == std::string::npos || (slash != std::string::npos && dot < slash) )
+    {
+        return sourceFilePath + ".exm";
+    }
+
+    return sourceFilePath.substr(0, dot) + ".exm";
+}
+
+//------------------------------------------------------------------------------
+const bool IsCookedMeshCurrent(const std::string & sourceFilePath, 
+                               const std::string & cookedFilePath,
+                               const CookedMeshSettings & settings)
+{
+    unsigned long long cookedTime = 0;
+
+    if( !GetLastWriteTime(cookedFilePath, cookedTime) )
+    {
+        return false;
+    }
+
+    unsigned long long sourceTime = 0;
+
+    if( GetLastWriteTime(sourceFilePath, sourceTime) && sourceTime > cookedTime )
+    {
+        return false;
+    }
+
+    // Check that it was cooked by this version, with the same settings
+    std::ifstream file(cookedFilePath.c_str(), std::ios::in | std::ios::binary);
+
+    CookedMeshHeader header;
+    memset(&header, 0, sizeof(header));
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    return file && header.m_magic == COOKED_MESH_MAGIC && header.m_version == COOKED_MESH_VERSION && 
+           HasSettings(header, settings);
+}
+
+//------------------------------------------------------------------------------
+void WriteCookedMesh(const std::string & cookedFilePath, 
+                     const std::vector<PolygonSetData> & polygonSets, 
+                     const CookedMeshSettings & settings,
+                     const bool compress)
+{
+    //-----
+    // Build the records and the texture table
+    std::map<std::string, unsigned>                 textureIndices;
+    std::vector<std::string>                        textureFiles;
+    std::vector<CookedPolygonSetRecord>             records(polygonSets.size());
+    std::vector<std::vector<CookedClusterRecord> >  clusterRecords(polygonSets.size());
+
+    for(size_t i = 0; i < polygonSets.size(); ++i)
+    {
+        const PolygonSetData &   polygonSet = polygonSets[i];
+        CookedPolygonSetRecord & record     = records[i];
+        memset(&record, 0, sizeof(record));
+
+        if( polygonSet.m_contentTypes.size() > COOKED_MESH_MAX_CONTENTS )
+        {
+            std::ostringstream msg;
+            msg << "Polygon set " << i << " has " << polygonSet.m_contentTypes.size() << " content types. At most " 
+                << COOKED_MESH_MAX_CONTENTS << " can be cooked.";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        // Polygon sets are merged after they are loaded, not before they are cooked (see SubmeshMerger.h)
+        if( !polygonSet.m_submeshes.empty() )
+        {
+            std::ostringstream msg;
+            msg << "Polygon set " << i << " has submeshes, which cannot be cooked.";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        if( polygonSet.m_levelsOfDetail.size() > COOKED_MESH_MAX_LODS )
+        {
+            std::ostringstream msg;
+            msg << "Polygon set " << i << " has " << polygonSet.m_levelsOfDetail.size() << " levels of detail. At most " 
+                << COOKED_MESH_MAX_LODS << " can be cooked.";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        record.m_numVertices     = polygonSet.m_numVertices;
+        record.m_numIndices      = polygonSet.m_numIndices;
+        record.m_numContentTypes = static_cast<unsigned>(polygonSet.m_contentTypes.size());
+
+        for(size_t j = 0; j < polygonSet.m_contentTypes.size(); ++j)
+        {
+            record.m_contentTypes[j] = polygonSet.m_contentTypes[j];
+        }
+
+        memcpy(record.m_boundsMin,    &polygonSet.m_bounds.m_boxMin,       sizeof(record.m_boundsMin));
+        memcpy(record.m_boundsMax,    &polygonSet.m_bounds.m_boxMax,       sizeof(record.m_boundsMax));
+        memcpy(record.m_sphereCenter, &polygonSet.m_bounds.m_sphereCenter, sizeof(record.m_sphereCenter));
+        record.m_sphereRadius = polygonSet.m_bounds.m_sphereRadius;
+
+        const MaterialData & material = polygonSet.m_material;
+
+        record.m_materialType     = material.m_materialType;
+        record.m_shaderType       = material.m_shaderType;
+        record.m_specularExponent = material.m_specularExponent;
+
+        WriteChannelRecord(material.m_ambient,  textureIndices, textureFiles, record.m_ambient);
+        WriteChannelRecord(material.m_emissive, textureIndices, textureFiles, record.m_emissive);
+        WriteChannelRecord(material.m_diffuse,  textureIndices, textureFiles, record.m_diffuse);
+        WriteChannelRecord(material.m_specular, textureIndices, textureFiles, record.m_specular);
+
+        WriteCacheRecord(polygonSet.m_optimizationReport.m_before, record.m_cacheBefore);
+        WriteCacheRecord(polygonSet.m_optimizationReport.m_after,  record.m_cacheAfter);
+
+        record.m_numLevelsOfDetail = static_cast<unsigned>(polygonSet.m_levelsOfDetail.size());
+
+        for(size_t j = 0; j < polygonSet.m_levelsOfDetail.size(); ++j)
+        {
+            record.m_levelOfDetailNumIndices[j] = polygonSet.m_levelsOfDetail[j].m_numIndices;
+            record.m_levelOfDetailErrors[j]     = polygonSet.m_levelsOfDetail[j].m_error;
+        }
+
+        const VertexQuantization & quantization = polygonSet.m_quantization;
+
+        record.m_positionScale = quantization.m_positionScale;
+        memcpy(record.m_positionBias, &quantization.m_positionBias, sizeof(record.m_positionBias));
+        memcpy(record.m_texCoordScale, &quantization.m_texCoordScale, sizeof(record.m_texCoordScale));
+        memcpy(record.m_texCoordBias,  &quantization.m_texCoordBias,  sizeof(record.m_texCoordBias));
+
+        record.m_numClusters = static_cast<unsigned>(polygonSet.m_clusters.size());
+        clusterRecords[i].resize(polygonSet.m_clusters.size());
+
+        for(size_t j = 0; j < polygonSet.m_clusters.size(); ++j)
+        {
+            const MeshCluster &   cluster       = polygonSet.m_clusters[j];
+            CookedClusterRecord & clusterRecord = clusterRecords[i][j];
+
+            clusterRecord.m_firstIndex   = cluster.m_firstIndex;
+            clusterRecord.m_numIndices   = cluster.m_numIndices;
+            clusterRecord.m_sphereRadius = cluster.m_sphereRadius;
+            clusterRecord.m_coneCutoff   = cluster.m_coneCutoff;
+            memcpy(clusterRecord.m_sphereCenter, &cluster.m_sphereCenter, sizeof(clusterRecord.m_sphereCenter));
+            memcpy(clusterRecord.m_coneAxis,     &cluster.m_coneAxis,     sizeof(clusterRecord.m_coneAxis));
+        }
+    }
+
+    std::string textureTable;
+    {
+        const unsigned numTextures = static_cast<unsigned>(textureFiles.size());
+        textureTable.append(reinterpret_cast<const char *>(&numTextures), sizeof(numTextures));
+
+        for(std::vector<std::string>::const_iterator it = textureFiles.begin(); it != textureFiles.end(); ++it)
+        {
+            textureTable.append(it->c_str(), it->size() + 1);
+        }
+    }
+
+    //-----
+    // Lay out the sections
+    std::vector<CookedMeshSection>        sections;
+    std::vector<const void *>             sectionData;
+    std::list<std::vector<unsigned char> > encodedData;
+
+    CookedMeshSection section;
+    section.m_type            = COOKED_SECTION_TEXTURES;
+    section.m_polygonSetIndex = 0;
+    section.m_size            = static_cast<unsigned>(textureTable.size());
+    sections.push_back(section);
+    sectionData.push_back(textureTable.data());
+
+    for(size_t i = 0; i < polygonSets.size(); ++i)
+    {
+        const PolygonSetData & polygonSet = polygonSets[i];
+
+        section.m_polygonSetIndex = static_cast<unsigned>(i);
+
+        section.m_type = COOKED_SECTION_POLYGONSET;
+        section.m_size = sizeof(CookedPolygonSetRecord);
+        sections.push_back(section);
+        sectionData.push_back(&records[i]);
+
+        if( compress )
+        {
+            encodedData.push_back(std::vector<unsigned char>());
+            EncodeVertices(polygonSet.GetVertexData(), polygonSet.m_numVertices, polygonSet.GetVertexSize(), encodedData.back());
+
+            section.m_type = COOKED_SECTION_ENCODED_VERTICES;
+            section.m_size = static_cast<unsigned>(encodedData.back().size());
+            sections.push_back(section);
+            sectionData.push_back(encodedData.back().empty() ? NULL : &encodedData.back()[0]);
+
+            encodedData.push_back(std::vector<unsigned char>());
+            EncodeIndices(polygonSet.GetIndexData(), polygonSet.m_numIndices, encodedData.back());
+
+            section.m_type = COOKED_SECTION_ENCODED_INDICES;
+            section.m_size = static_cast<unsigned>(encodedData.back().size());
+            sections.push_back(section);
+            sectionData.push_back(encodedData.back().empty() ? NULL : &encodedData.back()[0]);
+
+            for(unsigned j = 0; j < polygonSet.m_levelsOfDetail.size(); ++j)
+            {
+                encodedData.push_back(std::vector<unsigned char>());
+                EncodeIndices(polygonSet.GetLevelOfDetailIndexData(j), polygonSet.m_levelsOfDetail[j].m_numIndices, encodedData.back());
+
+                section.m_type = COOKED_SECTION_ENCODED_LOD_INDICES;
+                section.m_size = static_cast<unsigned>(encodedData.back().size());
+                sections.push_back(section);
+                sectionData.push_back(encodedData.back().empty() ? NULL : &encodedData.back()[0]);
+            }
+        }
+        else
+        {
+            const size_t vertexDataSize = static_cast<size_t>(polygonSet.m_numVertices) * polygonSet.GetVertexSize();
+
+            if( vertexDataSize > 0xFFFFFFFF )
+            {
+                std::ostringstream msg;
+                msg << "Polygon set " << i << " has " << vertexDataSize << " bytes of vertices. Sections of at most "
+                    << 0xFFFFFFFF << " bytes can be cooked.";
+                throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+
+            section.m_type = COOKED_SECTION_VERTICES;
+            section.m_size = static_cast<unsigned>(vertexDataSize);
+            sections.push_back(section);
+            sectionData.push_back(polygonSet.GetVertexData());
+
+            section.m_type = COOKED_SECTION_INDICES;
+            section.m_size = polygonSet.m_numIndices * sizeof(Index);
+            sections.push_back(section);
+            sectionData.push_back(polygonSet.GetIndexData());
+
+            for(unsigned j = 0; j < polygonSet.m_levelsOfDetail.size(); ++j)
+            {
+                section.m_type = COOKED_SECTION_LOD_INDICES;
+                section.m_size = polygonSet.m_levelsOfDetail[j].m_numIndices * sizeof(Index);
+                sections.push_back(section);
+                sectionData.push_back(polygonSet.GetLevelOfDetailIndexData(j));
+            }
+        }
+
+        if( !clusterRecords[i].empty() )
+        {
+            section.m_type = COOKED_SECTION_CLUSTERS;
+            section.m_size = static_cast<unsigned>(clusterRecords[i].size() * sizeof(CookedClusterRecord));
+            sections.push_back(section);
+            sectionData.push_back(&clusterRecords[i][0]);
+        }
+    }
+
+    size_t offset = AlignOffset(sizeof(CookedMeshHeader) + sections.size() * sizeof(CookedMeshSection));
+
+    for(std::vector<CookedMeshSection>::iterator it = sections.begin(); it != sections.end(); ++it)
+    {
+        it->m_offset = static_cast<unsigned>(offset);
+        offset = AlignOffset(offset + it->m_size);
+    }
+
+    CookedMeshHeader header;
+    memset(&header, 0, sizeof(header));
+    WriteSettings(settings, header);
+    header.m_magic       = COOKED_MESH_MAGIC;
+    header.m_version     = COOKED_MESH_VERSION;
+    header.m_fileSize    = static_cast<unsigned>(offset);
+    header.m_numSections = static_cast<unsigned>(sections.size());
+
+    //-----
+    // Assemble the file in memory and write it in one go
+    std::vector<char> contents(offset, 0);
+
+    memcpy(&contents[0], &header, sizeof(header));
+    memcpy(&contents[sizeof(header)], &sections[0], sections.size() * sizeof(CookedMeshSection));
+
+    for(size_t i = 0; i < sections.size(); ++i)
+    {
+        if( sections[i].m_size )
+        {
+            memcpy(&contents[sections[i].m_offset], sectionData[i], sections[i].m_size);
+        }
+    }
+
+    std::ofstream file(cookedFilePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(&contents[0], contents.size());
+
+    if( !file )
+    {
+        std::string msg("Failed to write cooked mesh file: ");
+        msg += cookedFilePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+}
+
+//------------------------------------------------------------------------------
+void ReadCookedMesh(const std::string & cookedFilePath, std::vector<PolygonSetData> & polygonSets)
+{
+    polygonSets.clear();
+
+    MappedFile::SharedPtr file(new MappedFile(cookedFilePath));
+
+    const unsigned char * data = file->GetData();
+    const size_t          size = file->GetSize();
+
+    //-----
+    // Header
+    CookedMeshHeader header;
+
+    if( size < sizeof(header) )
+    {
+        std::string msg("File is too small to be a cooked mesh: ");
+        msg += cookedFilePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    memcpy(&header, data, sizeof(header));
+
+    if( header.m_magic != COOKED_MESH_MAGIC )
+    {
+        std::string msg("File is not a cooked mesh: ");
+        msg += cookedFilePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( header.m_version != COOKED_MESH_VERSION )
+    {
+        std::ostringstream msg;
+        msg << "Cooked mesh " << cookedFilePath << " is version " << header.m_version 
+            << ", but version " << COOKED_MESH_VERSION << " is required";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    if( header.m_fileSize != size || 
+        header.m_numSections > (size - sizeof(header)) / sizeof(CookedMeshSection) )
+    {
+        std::string msg("Cooked mesh is truncated or corrupt: ");
+        msg += cookedFilePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    //-----
+    // Sections
+    std::vector<CookedMeshSection> sections(header.m_numSections);
+
+    if( !sections.empty() )
+    {
+        memcpy(&sections[0], data + sizeof(header), sections.size() * sizeof(CookedMeshSection));
+    }
+
+    std::vector<std::string> textureFiles;
+    unsigned                 numPolygonSets = 0;
+
+    for(std::vector<CookedMeshSection>::const_iterator it = sections.begin(); it != sections.end(); ++it)
+    {
+        if( it->m_offset > size || it->m_size > size - it->m_offset || it->m_offset % COOKED_MESH_ALIGNMENT != 0 )
+        {
+            std::ostringstream msg;
+            msg << "Section at offset " << it->m_offset << " of size " << it->m_size 
+                << " does not fit in cooked mesh: " << cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        if( it->m_type == COOKED_SECTION_POLYGONSET && it->m_polygonSetIndex >= numPolygonSets )
+        {
+            numPolygonSets = it->m_polygonSetIndex + 1;
+        }
+    }
+
+    polygonSets.resize(numPolygonSets);
+
+    for(std::vector<CookedMeshSection>::const_iterator it = sections.begin(); it != sections.end(); ++it)
+    {
+        const unsigned char * sectionData = data + it->m_offset;
+
+        switch( it->m_type )
+        {
+            case COOKED_SECTION_TEXTURES:
+            {
+                unsigned numTextures = 0;
+                size_t   position    = sizeof(numTextures);
+
+                if( it->m_size >= sizeof(numTextures) )
+                {
+                    memcpy(&numTextures, sectionData, sizeof(numTextures));
+                }
+
+                for(unsigned i = 0; i < numTextures; ++i)
+                {
+                    const void * terminator = position < it->m_size ? memchr(sectionData + position, 0x00, it->m_size - position) : NULL;
+
+                    if( !terminator )
+                    {
+                        std::string msg("Texture table is corrupt in cooked mesh: ");
+                        msg += cookedFilePath;
+                        throw Common::Exception(__FILE__, __LINE__, msg);
+                    }
+
+                    const char * name = reinterpret_cast<const char *>(sectionData + position);
+                    textureFiles.push_back(std::string(name));
+                    position += textureFiles.back().size() + 1;
+                }
+
+                break;
+            }
+
+            case COOKED_SECTION_POLYGONSET:
+            {
+                if( it->m_size != sizeof(CookedPolygonSetRecord) )
+                {
+                    std::string msg("Polygon set record has the wrong size in cooked mesh: ");
+                    msg += cookedFilePath;
+                    throw Common::Exception(__FILE__, __LINE__, msg);
+                }
+
+                break;
+            }
+
+            case COOKED_SECTION_VERTICES:
+            case COOKED_SECTION_INDICES:
+            case COOKED_SECTION_LOD_INDICES:
+            case COOKED_SECTION_CLUSTERS:
+            case COOKED_SECTION_ENCODED_VERTICES:
+            case COOKED_SECTION_ENCODED_INDICES:
+            case COOKED_SECTION_ENCODED_LOD_INDICES:
+            {
+                if( it->m_polygonSetIndex >= numPolygonSets )
+                {
+                    std::string msg("Vertices or indices belong to a missing polygon set in cooked mesh: ");
+                    msg += cookedFilePath;
+                    throw Common::Exception(__FILE__, __LINE__, msg);
+                }
+
+                break;
+            }
+
+            default:
+            {
+                // Sections from newer versions that are not understood are skipped
+                break;
+            }
+        }
+    }
+
+    //-----
+    // Polygon sets
+    std::vector<bool> haveRecord(numPolygonSets, false);
+
+    for(std::vector<CookedMeshSection>::const_iterator it = sections.begin(); it != sections.end(); ++it)
+    {
+        if( it->m_type != COOKED_SECTION_POLYGONSET )
+        {
+            continue;
+        }
+
+        CookedPolygonSetRecord record;
+        memcpy(&record, data + it->m_offset, sizeof(record));
+
+        if( record.m_numContentTypes > COOKED_MESH_MAX_CONTENTS )
+        {
+            std::string msg("Polygon set has too many content types in cooked mesh: ");
+            msg += cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        if( record.m_numLevelsOfDetail > COOKED_MESH_MAX_LODS )
+        {
+            std::string msg("Polygon set has too many levels of detail in cooked mesh: ");
+            msg += cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        if( record.m_numClusters > record.m_numIndices / 3 )
+        {
+            std::string msg("Polygon set has more clusters than triangles in cooked mesh: ");
+            msg += cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        if( !(record.m_positionScale > 0.0f) || !(record.m_texCoordScale[0] > 0.0f) || !(record.m_texCoordScale[1] > 0.0f) )
+        {
+            std::string msg("Polygon set has an invalid vertex quantization in cooked mesh: ");
+            msg += cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        if( haveRecord[it->m_polygonSetIndex] )
+        {
+            std::ostringstream msg;
+            msg << "Polygon set " << it->m_polygonSetIndex << " has more than one record in cooked mesh: " << cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        PolygonSetData & polygonSet = polygonSets[it->m_polygonSetIndex];
+        haveRecord[it->m_polygonSetIndex] = true;
+
+        for(unsigned i = 0; i < record.m_numContentTypes; ++i)
+        {
+            if( record.m_contentTypes[i] >= NUM_BUFFER_CONTENT_TYPES || record.m_contentTypes[i] == INDEX )
+            {
+                std::string msg("Polygon set has an invalid content type in cooked mesh: ");
+                msg += cookedFilePath;
+                throw Common::Exception(__FILE__, __LINE__, msg);
+            }
+
+            polygonSet.m_contentTypes.push_back(static_cast<BufferContentType>(record.m_contentTypes[i]));
+        }
+
+        polygonSet.m_numVertices = record.m_numVertices;
+        polygonSet.m_numIndices  = record.m_numIndices;
+        polygonSet.m_mappedFile  = file;
+
+        memcpy(&polygonSet.m_bounds.m_boxMin,       record.m_boundsMin,    sizeof(record.m_boundsMin));
+        memcpy(&polygonSet.m_bounds.m_boxMax,       record.m_boundsMax,    sizeof(record.m_boundsMax));
+        memcpy(&polygonSet.m_bounds.m_sphereCenter, record.m_sphereCenter, sizeof(record.m_sphereCenter));
+        polygonSet.m_bounds.m_sphereRadius = record.m_sphereRadius;
+
+        MaterialData & material = polygonSet.m_material;
+
+        material.m_materialType     = record.m_materialType;
+        material.m_shaderType       = record.m_shaderType;
+        material.m_specularExponent = record.m_specularExponent;
+
+        ReadChannelRecord(record.m_ambient,  textureFiles, material.m_ambient);
+        ReadChannelRecord(record.m_emissive, textureFiles, material.m_emissive);
+        ReadChannelRecord(record.m_diffuse,  textureFiles, material.m_diffuse);
+        ReadChannelRecord(record.m_specular, textureFiles, material.m_specular);
+
+        ReadCacheRecord(record.m_cacheBefore, polygonSet.m_optimizationReport.m_before);
+        ReadCacheRecord(record.m_cacheAfter,  polygonSet.m_optimizationReport.m_after);
+        polygonSet.m_optimizationReport.m_numLeftoverIndices = record.m_numIndices % 3;
+
+        polygonSet.m_levelsOfDetail.resize(record.m_numLevelsOfDetail);
+
+        for(unsigned i = 0; i < record.m_numLevelsOfDetail; ++i)
+        {
+            polygonSet.m_levelsOfDetail[i].m_numIndices = record.m_levelOfDetailNumIndices[i];
+            polygonSet.m_levelsOfDetail[i].m_error      = record.m_levelOfDetailErrors[i];
+        }
+
+        VertexQuantization & quantization = polygonSet.m_quantization;
+
+        quantization.m_positionScale = record.m_positionScale;
+        memcpy(&quantization.m_positionBias,  record.m_positionBias,  sizeof(record.m_positionBias));
+        memcpy(&quantization.m_texCoordScale, record.m_texCoordScale, sizeof(record.m_texCoordScale));
+        memcpy(&quantization.m_texCoordBias,  record.m_texCoordBias,  sizeof(record.m_texCoordBias));
+
+        polygonSet.m_clusters.resize(record.m_numClusters);
+    }
+
+    //-----
+    // Point each polygon set at its vertices and indices, which must be exactly the size the record says,
+    // or decode them if they are compressed
+    std::vector<bool>     haveVertices(numPolygonSets, false);
+    std::vector<bool>     haveIndices(numPolygonSets, false);
+    std::vector<unsigned> numLevelsOfDetail(numPolygonSets, 0);
+    std::vector<bool>     haveClusters(numPolygonSets, false);
+    std::vector<unsigned> numMappedSections(numPolygonSets, 0);
+
+    for(std::vector<CookedMeshSection>::const_iterator it = sections.begin(); it != sections.end(); ++it)
+    {
+        if( it->m_type != COOKED_SECTION_VERTICES            && 
+            it->m_type != COOKED_SECTION_INDICES             && 
+            it->m_type != COOKED_SECTION_LOD_INDICES         &&
+            it->m_type != COOKED_SECTION_CLUSTERS            &&
+            it->m_type != COOKED_SECTION_ENCODED_VERTICES    &&
+            it->m_type != COOKED_SECTION_ENCODED_INDICES     &&
+            it->m_type != COOKED_SECTION_ENCODED_LOD_INDICES )
+        {
+            continue;
+        }
+
+        PolygonSetData & polygonSet = polygonSets[it->m_polygonSetIndex];
+
+        // There is one of each for a polygon set, apart from its levels of detail
+        const bool isVertices = it->m_type == COOKED_SECTION_VERTICES || it->m_type == COOKED_SECTION_ENCODED_VERTICES;
+        const bool isIndices  = it->m_type == COOKED_SECTION_INDICES  || it->m_type == COOKED_SECTION_ENCODED_INDICES;
+
+        if( (isVertices && haveVertices[it->m_polygonSetIndex]) ||
+            (isIndices  && haveIndices[it->m_polygonSetIndex])  ||
+            (it->m_type == COOKED_SECTION_CLUSTERS && haveClusters[it->m_polygonSetIndex]) )
+        {
+            std::ostringstream msg;
+            msg << "Polygon set " << it->m_polygonSetIndex << " has more than one section of type " << it->m_type 
+                << " in cooked mesh: " << cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        if( it->m_type == COOKED_SECTION_ENCODED_VERTICES )
+        {
+            try
+            {
+                DecodeVertices(data + it->m_offset, it->m_size, polygonSet.m_numVertices, polygonSet.GetVertexSize(), polygonSet.m_vertices);
+            }
+            catch(Common::Exception & e)
+            {
+                throw e;
+            }
+
+            haveVertices[it->m_polygonSetIndex] = true;
+            continue;
+        }
+
+        if( it->m_type == COOKED_SECTION_ENCODED_INDICES )
+        {
+            try
+            {
+                DecodeIndices(data + it->m_offset, it->m_size, polygonSet.m_numIndices, polygonSet.m_indices);
+            }
+            catch(Common::Exception & e)
+            {
+                throw e;
+            }
+
+            haveIndices[it->m_polygonSetIndex] = true;
+            continue;
+        }
+
+        size_t expectedSize = 0;
+
+        if( it->m_type == COOKED_SECTION_VERTICES )
+        {
+            expectedSize                    = static_cast<size_t>(polygonSet.m_numVertices) * polygonSet.GetVertexSize();
+            polygonSet.m_mappedVertexOffset = it->m_offset;
+            haveVertices[it->m_polygonSetIndex] = true;
+            ++numMappedSections[it->m_polygonSetIndex];
+        }
+        else if( it->m_type == COOKED_SECTION_INDICES )
+        {
+            expectedSize                    = static_cast<size_t>(polygonSet.m_numIndices) * sizeof(Index);
+            polygonSet.m_mappedIndexOffset  = it->m_offset;
+            haveIndices[it->m_polygonSetIndex] = true;
+            ++numMappedSections[it->m_polygonSetIndex];
+        }
+        else if( it->m_type == COOKED_SECTION_CLUSTERS )
+        {
+            // Clusters are small, so they are copied out of the file
+            expectedSize = polygonSet.m_clusters.size() * sizeof(CookedClusterRecord);
+
+            if( it->m_size == expectedSize )
+            {
+                for(size_t i = 0; i < polygonSet.m_clusters.size(); ++i)
+                {
+                    CookedClusterRecord clusterRecord;
+                    memcpy(&clusterRecord, data + it->m_offset + i * sizeof(CookedClusterRecord), sizeof(clusterRecord));
+
+                    if( clusterRecord.m_numIndices % 3 != 0 || 
+                        clusterRecord.m_firstIndex > polygonSet.m_numIndices ||
+                        clusterRecord.m_numIndices > polygonSet.m_numIndices - clusterRecord.m_firstIndex )
+                    {
+                        std::ostringstream msg;
+                        msg << "Polygon set " << it->m_polygonSetIndex << " has a cluster outside of its indices, in cooked mesh: " 
+                            << cookedFilePath;
+                        throw Common::Exception(__FILE__, __LINE__, msg.str());
+                    }
+
+                    MeshCluster & cluster = polygonSet.m_clusters[i];
+
+                    cluster.m_firstIndex   = clusterRecord.m_firstIndex;
+                    cluster.m_numIndices   = clusterRecord.m_numIndices;
+                    cluster.m_sphereRadius = clusterRecord.m_sphereRadius;
+                    cluster.m_coneCutoff   = clusterRecord.m_coneCutoff;
+                    memcpy(&cluster.m_sphereCenter, clusterRecord.m_sphereCenter, sizeof(clusterRecord.m_sphereCenter));
+                    memcpy(&cluster.m_coneAxis,     clusterRecord.m_coneAxis,     sizeof(clusterRecord.m_coneAxis));
+                }
+            }
+
+            haveClusters[it->m_polygonSetIndex] = true;
+        }
+        else
+        {
+            // Levels of detail are in order
+            unsigned & level = numLevelsOfDetail[it->m_polygonSetIndex];
+
+            if( level >= polygonSet.m_levelsOfDetail.size() )
+            {
+                std::ostringstream msg;
+                msg << "Polygon set " << it->m_polygonSetIndex << " has more levels of detail than its record says, in cooked mesh: " 
+                    << cookedFilePath;
+                throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+
+            PolygonSetData::LevelOfDetail & levelOfDetail = polygonSet.m_levelsOfDetail[level];
+            ++level;
+
+            if( it->m_type == COOKED_SECTION_ENCODED_LOD_INDICES )
+            {
+                try
+                {
+                    DecodeIndices(data + it->m_offset, it->m_size, levelOfDetail.m_numIndices, levelOfDetail.m_indices);
+                }
+                catch(Common::Exception & e)
+                {
+                    throw e;
+                }
+
+                continue;
+            }
+
+            expectedSize = static_cast<size_t>(levelOfDetail.m_numIndices) * sizeof(Index);
+            levelOfDetail.m_mappedIndexOffset = it->m_offset;
+            ++numMappedSections[it->m_polygonSetIndex];
+        }
+
+        if( it->m_size != expectedSize )
+        {
+            std::ostringstream msg;
+            msg << "Section at offset " << it->m_offset << " is " << it->m_size << " bytes, but " << expectedSize 
+                << " bytes were expected, in cooked mesh: " << cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+    }
+
+    for(unsigned i = 0; i < numPolygonSets; ++i)
+    {
+        if( !haveRecord[i] || !haveVertices[i] || !haveIndices[i] || 
+            numLevelsOfDetail[i] != polygonSets[i].m_levelsOfDetail.size() ||
+            haveClusters[i] != !polygonSets[i].m_clusters.empty() )
+        {
+            std::ostringstream msg;
+            msg << "Polygon set " << i << " is incomplete in cooked mesh: " << cookedFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        // Every index, at every level of detail, must refer to one of the vertices
+        const PolygonSetData & polygonSet = polygonSets[i];
+
+        std::ostringstream what;
+        what << "Polygon set " << i;
+        ValidateIndices(polygonSet.GetIndexData(), polygonSet.m_numIndices, polygonSet.m_numVertices, what.str(), cookedFilePath);
+
+        for(unsigned level = 0; level < polygonSet.m_levelsOfDetail.size(); ++level)
+        {
+            std::ostringstream levelWhat;
+            levelWhat << "Polygon set " << i << " level of detail " << level;
+            ValidateIndices(polygonSet.GetLevelOfDetailIndexData(level), polygonSet.m_levelsOfDetail[level].m_numIndices, 
+                            polygonSet.m_numVertices, levelWhat.str(), cookedFilePath);
+        }
+
+        // Nothing is left in the file if it was all decoded
+        if( numMappedSections[i] == 0 )
+        {
+            polygonSets[i].m_mappedFile.reset();
+        }
+    }
+}
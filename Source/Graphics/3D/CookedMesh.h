@@ -0,0 +1,219 @@
+#ifndef COOKEDMESH_H
+#define COOKEDMESH_H
+
+// EngineX Includes
+#include "Graphics\3D\PolygonSetData.h"
+
+// Standard Includes
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Cooked meshes are PolygonSetData written out exactly as they are needed at load time, so that loading
+// them is a matter of mapping the file and pointing D3D at the vertices and indices where they lie.
+//
+// File layout, all values little endian:
+//
+//    CookedMeshHeader
+//    CookedMeshSection[numSections]
+//    Section data, each section starting on a 16 byte boundary
+//
+// Sections:
+//
+//    TEXTURES    - u32 number of textures, followed by that many null terminated file names.
+//                  Materials refer to textures by their index in this table.
+//    POLYGONSET  - CookedPolygonSetRecord
+//    VERTICES    - Interleaved vertices of a polygon set, quantized if its content types are (see VertexQuantizer.h)
+//    INDICES     - Indices of a polygon set, 4 bytes each
+//    LOD_INDICES - Indices of a level of detail of a polygon set, 4 bytes each, into the same vertices.
+//                  The levels of a polygon set appear in order, finest first.
+//    CLUSTERS    - CookedClusterRecord for each cluster of a polygon set, if it was clustered (see MeshClusterer.h)
+//
+//    ENCODED_VERTICES, ENCODED_INDICES, ENCODED_LOD_INDICES
+//                - The same as VERTICES, INDICES and LOD_INDICES, compressed (see MeshCodec.h). They are decoded
+//                  into memory when the file is read, rather than used where they lie in the file.
+//
+// Content types are stored as BufferContentType values, so the version must be bumped whenever that enum changes.
+//
+// The header also records the import settings the file was cooked with (see CookedMeshSettings). A cooked mesh
+// is only used in place of its source file when those match the settings it is being imported with.
+//
+
+const unsigned COOKED_MESH_MAGIC        = 0x4D435845;   // "EXCM"
+const unsigned COOKED_MESH_VERSION      = 6;
+const unsigned COOKED_MESH_ALIGNMENT    = 16;
+const unsigned COOKED_MESH_MAX_CONTENTS = 16;
+const unsigned COOKED_MESH_MAX_LODS     = 8;
+const unsigned COOKED_MESH_NO_TEXTURE   = 0xFFFFFFFF;
+
+enum CookedMeshSectionType
+{
+   COOKED_SECTION_TEXTURES = 0,
+   COOKED_SECTION_POLYGONSET,
+   COOKED_SECTION_VERTICES,
+   COOKED_SECTION_INDICES,
+   COOKED_SECTION_LOD_INDICES,
+   COOKED_SECTION_CLUSTERS,
+   COOKED_SECTION_ENCODED_VERTICES,
+   COOKED_SECTION_ENCODED_INDICES,
+   COOKED_SECTION_ENCODED_LOD_INDICES
+};
+
+enum CookedMeshSettingsFlags
+{
+   COOKED_SETTINGS_QUANTIZE_VERTICES = 1 << 0,
+   COOKED_SETTINGS_GENERATE_CLUSTERS = 1 << 1,
+   COOKED_SETTINGS_GENERATE_TANGENTS = 1 << 2
+};
+
+struct CookedMeshHeader
+{
+   unsigned m_magic;
+   unsigned m_version;
+   unsigned m_fileSize;                // Size of the whole file, in bytes
+   unsigned m_numSections;
+
+   unsigned m_settingsFlags;           // CookedMeshSettingsFlags the file was cooked with
+   unsigned m_numLevelOfDetailRatios;
+   float    m_levelOfDetailRatios[COOKED_MESH_MAX_LODS];
+};
+
+struct CookedMeshSection
+{
+   unsigned m_type;                    // CookedMeshSectionType
+   unsigned m_polygonSetIndex;         // Which polygon set the section belongs to, if any
+   unsigned m_offset;                  // Offset of the section from the start of the file
+   unsigned m_size;                    // Size of the section, in bytes
+};
+
+struct CookedMaterialChannelRecord
+{
+   unsigned m_textureIndex;            // Index into the texture table, or COOKED_MESH_NO_TEXTURE if unmapped
+   float    m_color[4];
+};
+
+struct CookedVertexCacheRecord
+{
+   unsigned m_numTriangles;
+   unsigned m_numVerticesUsed;
+   unsigned m_numTransformed;
+   float    m_acmr;
+   float    m_atvr;
+};
+
+struct CookedPolygonSetRecord
+{
+   unsigned                    m_numVertices;
+   unsigned                    m_numIndices;
+   unsigned                    m_numContentTypes;
+   unsigned                    m_contentTypes[COOKED_MESH_MAX_CONTENTS];
+
+   float                       m_boundsMin[3];
+   float                       m_boundsMax[3];
+   float                       m_sphereCenter[3];
+   float                       m_sphereRadius;
+
+   unsigned                    m_materialType;
+   unsigned                    m_shaderType;
+   CookedMaterialChannelRecord m_ambient;
+   CookedMaterialChannelRecord m_emissive;
+   CookedMaterialChannelRecord m_diffuse;
+   CookedMaterialChannelRecord m_specular;
+   float                       m_specularExponent;
+
+   CookedVertexCacheRecord     m_cacheBefore;
+   CookedVertexCacheRecord     m_cacheAfter;
+
+   unsigned                    m_numLevelsOfDetail;
+   unsigned                    m_levelOfDetailNumIndices[COOKED_MESH_MAX_LODS];
+   float                       m_levelOfDetailErrors[COOKED_MESH_MAX_LODS];
+
+   float                       m_positionScale;          // VertexQuantization, the identity if the vertices are not quantized
+   float                       m_positionBias[3];
+   float                       m_texCoordScale[2];
+   float                       m_texCoordBias[2];
+
+   unsigned                    m_numClusters;
+};
+
+struct CookedClusterRecord
+{
+   unsigned m_firstIndex;
+   unsigned m_numIndices;
+   float    m_sphereCenter[3];
+   float    m_sphereRadius;
+   float    m_coneAxis[3];
+   float    m_coneCutoff;
+};
+
+/**
+* Import settings that change what is cooked, as set on a PolygonSetImporter
+**/
+struct CookedMeshSettings
+{
+   /**
+   * Constructor
+   *
+   * By default, nothing is generated and the vertices are not quantized
+   **/
+   CookedMeshSettings();
+
+
+   std::vector<float> m_levelOfDetailRatios;   // Fraction of the triangles each generated level of detail keeps
+   bool               m_quantizeVertices;
+   bool               m_generateClusters;
+   bool               m_generateTangentData;
+};
+
+/**
+* Gets the path of the cooked mesh that belongs next to a source mesh file
+*
+* The cooked file has the same path, with its extension replaced by ".exm"
+**/
+const std::string GetCookedMeshFilePath(const std::string & sourceFilePath);
+
+/**
+* Query whether or not a cooked mesh can be used in place of its source file
+*
+* A cooked mesh is current if it exists, was written by this version of the engine with the same settings, 
+* and is not older than the source file. If the source file does not exist, the cooked mesh is used on its own,
+* as long as it was cooked with the same settings.
+*
+* @param settings - Settings the mesh is being imported with
+**/
+const bool IsCookedMeshCurrent(const std::string & sourceFilePath, 
+                               const std::string & cookedFilePath,
+                               const CookedMeshSettings & settings);
+
+/**
+* Writes polygon sets to a cooked mesh file
+*
+* @param cookedFilePath - Path of the file to write
+* @param polygonSets    - Polygon sets to write
+* @param settings       - Settings the polygon sets were imported with, recorded in the header
+* @param compress       - Whether or not to compress the vertices and indices. A compressed file is smaller to read
+*                         from disk, but has to be decoded into memory rather than used where it lies.
+*
+* @throws BaseException - If the polygon sets cannot be represented or the file cannot be written
+**/
+void WriteCookedMesh(const std::string & cookedFilePath, 
+                     const std::vector<PolygonSetData> & polygonSets, 
+                     const CookedMeshSettings & settings,
+                     const bool compress = false);
+
+/**
+* Reads polygon sets from a cooked mesh file
+*
+* The file is mapped and stays mapped for as long as any of the polygon sets that were read refer to it.
+* Their vertices and indices are not copied, unless they were compressed, in which case they are decoded into memory.
+*
+* Every index, level of detail index and cluster is checked against the polygon set it belongs to, 
+* so a corrupt file throws rather than being drawn.
+*
+* @throws BaseException - If the file cannot be mapped or is not a valid cooked mesh
+**/
+void ReadCookedMesh(const std::string & cookedFilePath, std::vector<PolygonSetData> & polygonSets);
+
+
+
+#endif // COOKEDMESH_H
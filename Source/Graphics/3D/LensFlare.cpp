@@ -44,20 +44,35 @@ LensFlare::LensFlare(ID3D10Device & device,
     m_occlusionQuery(NULL),
     m_occlusionQueryActive(false)
 {
-    // Load the textures
-    std::string flare1TextureName;
-    std::string flare2TextureName;
-    std::string flare3TextureName;
+    // Pack the glow and flare images into one atlas
+    std::vector<std::string> textureFilePaths;
+    textureFilePaths.push_back(glowTextureFilePath);
+    textureFilePaths.push_back(flare1TextureFilePath);
+    textureFilePaths.push_back(flare2TextureFilePath);
+    textureFilePaths.push_back(flare3TextureFilePath);
 
-    RemoveExtFromFilename(glowTextureFilePath, m_glowTextureName);
-    RemoveExtFromFilename(flare1TextureFilePath, flare1TextureName);
-    RemoveExtFromFilename(flare2TextureFilePath, flare2TextureName);
-    RemoveExtFromFilename(flare3TextureFilePath, flare3TextureName);
+    std::string atlasName;
+    RemoveExtFromFilename(glowTextureFilePath, atlasName);
+    atlasName += "Atlas";
 
-    m_textureManager.CreateTextureFromFile(m_glowTextureName, glowTextureFilePath);
-    m_textureManager.CreateTextureFromFile(flare1TextureName, flare1TextureFilePath);
-    m_textureManager.CreateTextureFromFile(flare2TextureName, flare2TextureFilePath);
-    m_textureManager.CreateTextureFromFile(flare3TextureName, flare3TextureFilePath);
+    try
+    {
+        m_atlas.reset(new TextureAtlas(m_device, m_textureManager, atlasName, textureFilePaths));
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    std::vector<const AtlasRegion *> regions;
+
+    for(std::vector<std::string>::const_iterator it = textureFilePaths.begin(); it != textureFilePaths.end(); ++it)
+    {
+        std::string regionName;
+        RemoveExtFromFilename(*it, regionName);
+
+        regions.push_back(&(m_atlas->GetRegion(regionName)));
+    }
 
     // Create the effects
     Technique * occlusionTechnique = NULL;
@@ -89,18 +104,21 @@ LensFlare::LensFlare(ID3D10Device & device,
         m_occlusionMaterial = m_effect->CreateMaterial();
         m_occlusionMaterial->SetFloat4("diffuseColor", static_cast<D3DXVECTOR4>(D3DXCOLOR( 1.0f, 1.0f, 1.0f, 1.0f)));
 
-        // Glow material properties are dynamic and will be set as it is rendered
+        // Glow and flare colors are dynamic and will be set as they are rendered
+        // Both sample the atlas, so the texture stays bound from the glow through the last flare
         m_glowMaterial = m_effect->CreateMaterial();
+        m_glowMaterial->SetTextureName("diffuseTexture", m_atlas->GetTextureName());
 
-        // Flare material properties are dynamic and will be set as they are rendered
         m_flareMaterial = m_effect->CreateMaterial();
+        m_flareMaterial->SetTextureName("diffuseTexture", m_atlas->GetTextureName());
     }
     catch(Common::Exception & e)
     {
         throw e;
     }
 
-    // Create an occlusion query rectangle shape
+    // Create a quad for each image, textured with its region of the atlas
+    // The occlusion query uses the positions of the first
     //
     // NOTE - vertices are defined in counter clockwise order, instead of clockwise,
     //        because the projection into 2D screen space flips the quad in the Y
@@ -108,15 +126,21 @@ LensFlare::LensFlare(ID3D10Device & device,
     std::vector<Position>   quadPositions;
     std::vector<TexCoord2D> quadTexCoords;
 
-    quadPositions.push_back(Position( -0.5f, -0.5f, 0.0f));
-    quadPositions.push_back(Position(  0.5f, -0.5f, 0.0f));
-    quadPositions.push_back(Position( -0.5f,  0.5f, 0.0f));
-    quadPositions.push_back(Position(  0.5f,  0.5f, 0.0f));
-
-    quadTexCoords.push_back(TexCoord2D( 0.0f,  0.0f));
-    quadTexCoords.push_back(TexCoord2D( 1.0f,  0.0f));
-    quadTexCoords.push_back(TexCoord2D( 0.0f,  1.0f));
-    quadTexCoords.push_back(TexCoord2D( 1.0f,  1.0f));
+    for(std::vector<const AtlasRegion *>::const_iterator it = regions.begin(); it != regions.end(); ++it)
+    {
+        const D3DXVECTOR2 & texCoordMin = (*it)->m_texCoordMin;
+        const D3DXVECTOR2 & texCoordMax = (*it)->m_texCoordMax;
+
+        quadPositions.push_back(Position( -0.5f, -0.5f, 0.0f));
+        quadPositions.push_back(Position(  0.5f, -0.5f, 0.0f));
+        quadPositions.push_back(Position( -0.5f,  0.5f, 0.0f));
+        quadPositions.push_back(Position(  0.5f,  0.5f, 0.0f));
+
+        quadTexCoords.push_back(TexCoord2D( texCoordMin.x, texCoordMin.y));
+        quadTexCoords.push_back(TexCoord2D( texCoordMax.x, texCoordMin.y));
+        quadTexCoords.push_back(TexCoord2D( texCoordMin.x, texCoordMax.y));
+        quadTexCoords.push_back(TexCoord2D( texCoordMax.x, texCoordMax.y));
+    }
    
     m_positionBuffer = Buffer::SharedPtr(new Buffer(m_device, POSITION,   quadPositions, false));
     m_texCoordBuffer = Buffer::SharedPtr(new Buffer(m_device, TEXCOORD2D, quadTexCoords, false));
@@ -157,22 +181,27 @@ LensFlare::LensFlare(ID3D10Device & device,
     }
 
     // Init the flare circle datas
-    float flare1Scale = static_cast<float>(m_textureManager.GetTexture(flare1TextureName).GetWidth());
-    float flare2Scale = static_cast<float>(m_textureManager.GetTexture(flare2TextureName).GetWidth());
-    float flare3Scale = static_cast<float>(m_textureManager.GetTexture(flare3TextureName).GetWidth());
-
-    m_flares.push_back(Flare(-0.5f, flare1Scale * 0.7f, D3DXCOLOR( 0.196078f, 0.019608f, 0.196078f, 1.0f), flare1TextureName));
-    m_flares.push_back(Flare( 0.3f, flare1Scale * 0.4f, D3DXCOLOR( 0.392156f, 1.000000f, 0.784314f, 1.0f), flare1TextureName));
-    m_flares.push_back(Flare( 1.2f, flare1Scale * 1.0f, D3DXCOLOR( 0.392156f, 0.196078f, 0.196078f, 1.0f), flare1TextureName));
-    m_flares.push_back(Flare( 1.5f, flare1Scale * 1.5f, D3DXCOLOR( 0.196078f, 0.392156f, 0.196078f, 1.0f), flare1TextureName));
-
-    m_flares.push_back(Flare(-0.3f, flare2Scale * 0.7f, D3DXCOLOR( 0.784314f, 0.196078f, 0.196078f, 1.0f), flare2TextureName));
-    m_flares.push_back(Flare( 0.6f, flare2Scale * 0.9f, D3DXCOLOR( 0.196078f, 0.392156f, 0.196078f, 1.0f), flare2TextureName));
-    m_flares.push_back(Flare( 0.7f, flare2Scale * 0.4f, D3DXCOLOR( 0.196078f, 0.784314f, 0.784314f, 1.0f), flare2TextureName));
-
-    m_flares.push_back(Flare(-0.7f, flare3Scale * 0.7f, D3DXCOLOR( 0.196078f, 0.392156f, 0.019608f, 1.0f), flare3TextureName));
-    m_flares.push_back(Flare( 0.0f, flare3Scale * 0.6f, D3DXCOLOR( 0.019608f, 0.019608f, 0.019608f, 1.0f), flare3TextureName));
-    m_flares.push_back(Flare( 2.0f, flare3Scale * 1.4f, D3DXCOLOR( 0.019608f, 0.196078f, 0.392156f, 1.0f), flare3TextureName));
+    // Each image has a quad of 4 vertices, the glow's first
+    const unsigned flare1StartVertex = 4;
+    const unsigned flare2StartVertex = 8;
+    const unsigned flare3StartVertex = 12;
+
+    float flare1Scale = static_cast<float>(regions[1]->m_width);
+    float flare2Scale = static_cast<float>(regions[2]->m_width);
+    float flare3Scale = static_cast<float>(regions[3]->m_width);
+
+    m_flares.push_back(Flare(-0.5f, flare1Scale * 0.7f, D3DXCOLOR( 0.196078f, 0.019608f, 0.196078f, 1.0f), flare1StartVertex));
+    m_flares.push_back(Flare( 0.3f, flare1Scale * 0.4f, D3DXCOLOR( 0.392156f, 1.000000f, 0.784314f, 1.0f), flare1StartVertex));
+    m_flares.push_back(Flare( 1.2f, flare1Scale * 1.0f, D3DXCOLOR( 0.392156f, 0.196078f, 0.196078f, 1.0f), flare1StartVertex));
+    m_flares.push_back(Flare( 1.5f, flare1Scale * 1.5f, D3DXCOLOR( 0.196078f, 0.392156f, 0.196078f, 1.0f), flare1StartVertex));
+
+    m_flares.push_back(Flare(-0.3f, flare2Scale * 0.7f, D3DXCOLOR( 0.784314f, 0.196078f, 0.196078f, 1.0f), flare2StartVertex));
+    m_flares.push_back(Flare( 0.6f, flare2Scale * 0.9f, D3DXCOLOR( 0.196078f, 0.392156f, 0.196078f, 1.0f), flare2StartVertex));
+    m_flares.push_back(Flare( 0.7f, flare2Scale * 0.4f, D3DXCOLOR( 0.196078f, 0.784314f, 0.784314f, 1.0f), flare2StartVertex));
+
+    m_flares.push_back(Flare(-0.7f, flare3Scale * 0.7f, D3DXCOLOR( 0.196078f, 0.392156f, 0.019608f, 1.0f), flare3StartVertex));
+    m_flares.push_back(Flare( 0.0f, flare3Scale * 0.6f, D3DXCOLOR( 0.019608f, 0.019608f, 0.019608f, 1.0f), flare3StartVertex));
+    m_flares.push_back(Flare( 2.0f, flare3Scale * 1.4f, D3DXCOLOR( 0.019608f, 0.196078f, 0.392156f, 1.0f), flare3StartVertex));
 }
 
 
@@ -333,7 +362,6 @@ void LensFlare::RenderGlow(const D3DXVECTOR2 & lightPosition)
    D3DXMatrixMultiply(&world, &matScale, &matTranslation);
    
    m_glowMaterial->SetFloat4("diffuseColor", D3DXVECTOR4(1.0f, 1.0f, 1.0f, m_occlusionAlpha));
-   m_glowMaterial->SetTextureName("diffuseTexture", m_glowTextureName);
 
    try
    {
@@ -412,7 +440,6 @@ void LensFlare::RenderFlares(const D3DXVECTOR2 & lightPosition, const D3DXVECTOR
       D3DXCOLOR flareColor = it->m_color;
       flareColor.a *= m_occlusionAlpha; 
       m_flareMaterial->SetFloat4("diffuseColor", static_cast<D3DXVECTOR4>(flareColor));
-      m_flareMaterial->SetTextureName("diffuseTexture", it->m_textureName);
       
       try
       {
@@ -428,7 +455,7 @@ void LensFlare::RenderFlares(const D3DXVECTOR2 & lightPosition, const D3DXVECTOR
       m_flarePass->Apply();
 
       // Draw the flare
-      m_device.Draw(4, 0);
+      m_device.Draw(4, it->m_startVertex);
    }
 
 /*
@@ -468,11 +495,11 @@ void LensFlare::RenderFlares(const D3DXVECTOR2 & lightPosition, const D3DXVECTOR
 }
 
 //---------------------------------------------------------------------------
-LensFlare::Flare::Flare(float position, float scale, const D3DXCOLOR & color, const std::string & textureName)
+LensFlare::Flare::Flare(float position, float scale, const D3DXCOLOR & color, unsigned startVertex)
    :
 m_position(position),
 m_scale(scale),
 m_color(color),
-m_textureName(textureName)
+m_startVertex(startVertex)
 {         
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Graphics/3D/Buffers.h"
 #include "Graphics/3D/InputLayoutManager.h"
 #include "Graphics/Textures/TextureManager.h"
+#include "Graphics/Textures/TextureAtlas.h"
 #include "Graphics/Effects/EffectManager.h"
 #include "Graphics/Effects/Effect.h"
 #include "Graphics/Effects/Material.h"
@@ -15,6 +16,7 @@
 #include <d3dx10.h>
 
 // Standard Includes
+#include <memory>
 #include <vector>
 
 //-----------------------------------------------------------------------
@@ -24,6 +26,9 @@ public:
 
    /**
    * Constructor
+   *
+   * The glow and flare images are packed into one texture atlas, so the glow and every flare render with
+   * the same texture bound
    **/
    LensFlare(ID3D10Device & device, 
              InputLayoutManager & inputLayoutManager,
@@ -66,7 +71,7 @@ private:
    const float                    m_glowSize;
    const float                    m_querySize;
    D3DXVECTOR3                    m_lightPosition;        // Position of the light source in the 3D world
-   std::string                    m_glowTextureName;
+   std::auto_ptr<TextureAtlas>    m_atlas;                // Glow and flare images, packed into one texture
 
    ID3D10Device &                 m_device;               // DirectX device
    InputLayoutManager &           m_inputLayoutManager;   // Contains and creates input layouts for shaders
@@ -74,8 +79,8 @@ private:
    EffectManager &                m_effectManager;        // Effect pool that contains all effects
    Effect *                       m_effect;               // Effect used to render the lens flare
 
-   Buffer::SharedPtr              m_positionBuffer;       // Vertex buffer containing quad positions
-   Buffer::SharedPtr              m_texCoordBuffer;       // Vertex buffer containing quad texture coordinates
+   Buffer::SharedPtr              m_positionBuffer;       // Vertex buffer containing a quad for the glow, then one for each flare image
+   Buffer::SharedPtr              m_texCoordBuffer;       // Vertex buffer containing the texture coordinates of each image's region of the atlas
 
    ID3D10InputLayout *            m_occlusionInputLayout; // DirectX description of the vertex buffer used for the occlusion query 
    std::auto_ptr<Material>        m_occlusionMaterial;    // Effect variable states to use when rendering the occlusion query
@@ -94,12 +99,12 @@ private:
 
    struct Flare
    {
-      Flare(float position, float scale, const D3DXCOLOR & color, const std::string & textureName);
+      Flare(float position, float scale, const D3DXCOLOR & color, unsigned startVertex);
      
       float       m_position;     // Zero is centered on light source. One is center of screen
       float       m_scale;
       D3DXCOLOR   m_color;
-      std::string m_textureName;
+      unsigned    m_startVertex;  // First vertex of the quad textured with the flare's image
    };
 
    std::vector<Flare> m_flares;
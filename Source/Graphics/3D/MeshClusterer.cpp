@@ -0,0 +1,579 @@
+
+// Project Includes
+#include "MeshClusterer.h"
+#include "PolygonSetData.h"
+#include "VertexQuantizer.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    /**
+    * How much a triangle facing away from the cluster costs, compared to a new vertex, when growing a cluster
+    **/
+    const float NORMAL_WEIGHT = 8.0f;
+
+    /**
+    * Cosine of the widest angle, between the average normal of a cluster and a triangle, at which the triangle may join
+    *
+    * Keeping the normals within about 45 degrees of each other leaves a cone that culls from about a quarter of
+    * the directions it can be seen from. Faceted meshes end up with clusters smaller than the limits allow.
+    **/
+    const float MIN_JOIN_DOT = 0.7f;
+
+    /**
+    * Cosine of the widest angle, between the cone axis and a normal, a cone may have and still cull
+    *
+    * A cluster that wide is almost never entirely backfacing, so it is not worth testing.
+    **/
+    const float MIN_CONE_DOT = 0.1f;
+
+    //--------------------------------------------------------------------------
+    /**
+    * Groups vertices that share a position, so that clusters grow across seams in the texture coordinates and normals
+    *
+    * @param positions - Position of each vertex
+    * @param canonical - OUT - For each vertex, the first vertex with the same position
+    **/
+    void GroupByPosition(const std::vector<Position> & positions, std::vector<unsigned> & canonical)
+    {
+        const unsigned numVertices = static_cast<unsigned>(positions.size());
+
+        std::vector<unsigned> order(numVertices);
+
+        for(unsigned i = 0; i < numVertices; ++i)
+        {
+            order[i] = i;
+        }
+
+        std::sort(order.begin(), order.end(), [&positions](const unsigned a, const unsigned b)
+        {
+            const Position & pa = positions[a];
+            const Position & pb = positions[b];
+
+            if( pa.x != pb.x ) return pa.x < pb.x;
+            if( pa.y != pb.y ) return pa.y < pb.y;
+            if( pa.z != pb.z ) return pa.z < pb.z;
+            return a < b;
+        });
+
+        canonical.resize(numVertices);
+
+        for(size_t first = 0; first < order.size(); )
+        {
+            size_t last = first + 1;
+
+            while( last < order.size() && positions[order[last]] == positions[order[first]] )
+            {
+                ++last;
+            }
+
+            for(size_t i = first; i < last; ++i)
+            {
+                canonical[order[i]] = order[first];
+            }
+
+            first = last;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Gets a key that orders clusters along a curve that winds over the directions their cones face
+    *
+    * The axis is mapped onto a square with the octahedral encoding and the key is the Morton code of where it lands.
+    * Clusters whose cones never cull come last.
+    **/
+    unsigned GetDirectionKey(const MeshCluster & cluster)
+    {
+        if( cluster.m_coneCutoff >= 1.0f )
+        {
+            return 0xFFFFFFFF;
+        }
+
+        const D3DXVECTOR2 encoded = EncodeOctahedral(cluster.m_coneAxis);
+
+        const unsigned x = static_cast<unsigned>((encoded.x * 0.5f + 0.5f) * 255.0f + 0.5f);
+        const unsigned y = static_cast<unsigned>((encoded.y * 0.5f + 0.5f) * 255.0f + 0.5f);
+
+        unsigned key = 0;
+
+        for(int bit = 7; bit >= 0; --bit)
+        {
+            key = (key << 2) | (((x >> bit) & 1) << 1) | ((y >> bit) & 1);
+        }
+
+        return key;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Calculates the bounding sphere and normal cone of a cluster
+    *
+    * @param positions       - Position of each vertex
+    * @param triangleNormals - Unit normal of each triangle, or zero if it is degenerate
+    * @param indices         - All the indices
+    * @param triangles       - The triangles in the cluster
+    * @param cluster         - IN/OUT - Gets its bounds
+    **/
+    void CalculateClusterBounds(const std::vector<Position> & positions,
+                                const std::vector<D3DXVECTOR3> & triangleNormals,
+                                const std::vector<Index> & indices,
+                                const std::vector<unsigned> & triangles,
+                                MeshCluster & cluster)
+    {
+        // Sphere around the center of the box, large enough to hold every vertex
+        D3DXVECTOR3 boundsMin( FLT_MAX,  FLT_MAX,  FLT_MAX);
+        D3DXVECTOR3 boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+        for(std::vector<unsigned>::const_iterator it = triangles.begin(); it != triangles.end(); ++it)
+        {
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                const Position & position = positions[indices[*it * 3 + k]];
+                D3DXVec3Minimize(&boundsMin, &boundsMin, &position);
+                D3DXVec3Maximize(&boundsMax, &boundsMax, &position);
+            }
+        }
+
+        cluster.m_sphereCenter = (boundsMin + boundsMax) * 0.5f;
+
+        float radiusSquared = 0.0f;
+
+        for(std::vector<unsigned>::const_iterator it = triangles.begin(); it != triangles.end(); ++it)
+        {
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                const D3DXVECTOR3 offset = positions[indices[*it * 3 + k]] - cluster.m_sphereCenter;
+                radiusSquared = std::max<float>(radiusSquared, D3DXVec3LengthSq(&offset));
+            }
+        }
+
+        cluster.m_sphereRadius = sqrtf(radiusSquared);
+
+        // Cone around the average normal, wide enough to hold every normal
+        D3DXVECTOR3 axis(0.0f, 0.0f, 0.0f);
+
+        for(std::vector<unsigned>::const_iterator it = triangles.begin(); it != triangles.end(); ++it)
+        {
+            axis += triangleNormals[*it];
+        }
+
+        cluster.m_coneAxis   = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+        cluster.m_coneCutoff = 1.0f;
+
+        if( D3DXVec3LengthSq(&axis) < FLT_MIN )
+        {
+            return;
+        }
+
+        D3DXVec3Normalize(&axis, &axis);
+
+        float minDot = 1.0f;
+
+        for(std::vector<unsigned>::const_iterator it = triangles.begin(); it != triangles.end(); ++it)
+        {
+            const D3DXVECTOR3 & normal = triangleNormals[*it];
+
+            // Degenerate triangles cover nothing, so they do not widen the cone
+            if( D3DXVec3LengthSq(&normal) > 0.0f )
+            {
+                minDot = std::min<float>(minDot, D3DXVec3Dot(&normal, &axis));
+            }
+        }
+
+        cluster.m_coneAxis = axis;
+
+        if( minDot > MIN_CONE_DOT )
+        {
+            cluster.m_coneCutoff = sqrtf(1.0f - minDot * minDot);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+MeshCluster::MeshCluster()
+    :
+    m_firstIndex  (0),
+    m_numIndices  (0),
+    m_sphereCenter(0.0f, 0.0f, 0.0f),
+    m_sphereRadius(0.0f),
+    m_coneAxis    (0.0f, 0.0f, 0.0f),
+    m_coneCutoff  (1.0f)
+{
+}
+
+//------------------------------------------------------------------------------
+void BuildClusters(const std::vector<Position> & positions,
+                   std::vector<Index> & indices,
+                   std::vector<MeshCluster> & clusters,
+                   const unsigned maxVertices,
+                   const unsigned maxTriangles)
+{
+    clusters.clear();
+
+    if( indices.size() % 3 != 0 )
+    {
+        const std::string msg("The number of indices is not a multiple of 3");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( maxVertices < 3 || maxTriangles < 1 )
+    {
+        const std::string msg("A cluster must be able to hold at least one triangle");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    const unsigned numVertices  = static_cast<unsigned>(positions.size());
+    const unsigned numTriangles = static_cast<unsigned>(indices.size() / 3);
+
+    for(std::vector<Index>::const_iterator it = indices.begin(); it != indices.end(); ++it)
+    {
+        if( *it >= numVertices )
+        {
+            std::stringstream msg;
+            msg << "Index " << *it << " is out of range of " << numVertices << " vertices";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+    }
+
+    if( numTriangles == 0 )
+    {
+        return;
+    }
+
+    //-----
+    // Normal of each triangle
+    std::vector<D3DXVECTOR3> triangleNormals(numTriangles);
+
+    for(unsigned i = 0; i < numTriangles; ++i)
+    {
+        const Position &  a = positions[indices[i * 3 + 0]];
+        const D3DXVECTOR3 ab = positions[indices[i * 3 + 1]] - a;
+        const D3DXVECTOR3 ac = positions[indices[i * 3 + 2]] - a;
+
+        // Front faces are clockwise, in a left handed coordinate system, so this faces out of the front
+        D3DXVECTOR3 normal;
+        D3DXVec3Cross(&normal, &ab, &ac);
+
+        if( D3DXVec3LengthSq(&normal) > FLT_MIN )
+        {
+            D3DXVec3Normalize(&normal, &normal);
+        }
+        else
+        {
+            normal = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+        }
+
+        triangleNormals[i] = normal;
+    }
+
+    //-----
+    // Triangles around each position, so clusters can grow across seams
+    std::vector<unsigned> canonical;
+    GroupByPosition(positions, canonical);
+
+    std::vector<unsigned> adjacencyOffsets(numVertices + 1, 0);
+    std::vector<unsigned> adjacency(indices.size());
+
+    for(size_t i = 0; i < indices.size(); ++i)
+    {
+        ++adjacencyOffsets[canonical[indices[i]] + 1];
+    }
+
+    for(unsigned i = 0; i < numVertices; ++i)
+    {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
+
+    {
+        std::vector<unsigned> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+        for(size_t i = 0; i < indices.size(); ++i)
+        {
+            adjacency[fill[canonical[indices[i]]]++] = static_cast<unsigned>(i / 3);
+        }
+    }
+
+    //-----
+    // Grow the clusters
+    const unsigned NONE = 0xFFFFFFFF;
+
+    std::vector<bool>     used(numTriangles, false);
+    std::vector<unsigned> vertexCluster(numVertices, NONE);      // Which cluster last took each vertex
+    std::vector<unsigned> candidateCluster(numTriangles, NONE);  // Which cluster last considered each triangle
+    std::vector<unsigned> candidates;
+    std::vector<unsigned> clusterTriangles;
+    std::vector<Index>    reordered;
+    unsigned              nextSeed = 0;
+
+    reordered.reserve(indices.size());
+
+    while( true )
+    {
+        while( nextSeed < numTriangles && used[nextSeed] )
+        {
+            ++nextSeed;
+        }
+
+        if( nextSeed == numTriangles )
+        {
+            break;
+        }
+
+        const unsigned clusterIndex = static_cast<unsigned>(clusters.size());
+        unsigned       numClusterVertices = 0;
+        D3DXVECTOR3    normalSum(0.0f, 0.0f, 0.0f);
+
+        clusterTriangles.clear();
+        candidates.clear();
+        candidates.push_back(nextSeed);
+        candidateCluster[nextSeed] = clusterIndex;
+
+        while( clusterTriangles.size() < maxTriangles )
+        {
+            // Pick the candidate that adds the fewest vertices and faces most like the cluster
+            D3DXVECTOR3 axis = normalSum;
+
+            if( D3DXVec3LengthSq(&axis) > FLT_MIN )
+            {
+                D3DXVec3Normalize(&axis, &axis);
+            }
+
+            size_t   best        = candidates.size();
+            float    bestCost    = FLT_MAX;
+            unsigned bestNewVertices = 0;
+
+            for(size_t i = 0; i < candidates.size(); ++i)
+            {
+                const unsigned triangle = candidates[i];
+
+                unsigned newVertices = 0;
+
+                for(unsigned k = 0; k < 3; ++k)
+                {
+                    const Index vertex = indices[triangle * 3 + k];
+
+                    // Count each new vertex once, even if the triangle refers to it twice
+                    if( vertexCluster[vertex] != clusterIndex &&
+                        (k < 1 || indices[triangle * 3] != vertex) &&
+                        (k < 2 || indices[triangle * 3 + 1] != vertex) )
+                    {
+                        ++newVertices;
+                    }
+                }
+
+                if( numClusterVertices + newVertices > maxVertices )
+                {
+                    continue;
+                }
+
+                const float normalDot = D3DXVec3Dot(&triangleNormals[triangle], &axis);
+
+                if( !clusterTriangles.empty() && normalDot < MIN_JOIN_DOT )
+                {
+                    continue;
+                }
+
+                const float cost = static_cast<float>(newVertices) + NORMAL_WEIGHT * (1.0f - normalDot);
+
+                if( cost < bestCost )
+                {
+                    best            = i;
+                    bestCost        = cost;
+                    bestNewVertices = newVertices;
+                }
+            }
+
+            if( best == candidates.size() )
+            {
+                break;
+            }
+
+            // Take it
+            const unsigned triangle = candidates[best];
+            candidates[best] = candidates.back();
+            candidates.pop_back();
+
+            used[triangle] = true;
+            clusterTriangles.push_back(triangle);
+            numClusterVertices += bestNewVertices;
+            normalSum          += triangleNormals[triangle];
+
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                const Index vertex = indices[triangle * 3 + k];
+                vertexCluster[vertex] = clusterIndex;
+
+                // Its neighbors become candidates
+                const unsigned position = canonical[vertex];
+
+                for(unsigned j = adjacencyOffsets[position]; j < adjacencyOffsets[position + 1]; ++j)
+                {
+                    const unsigned neighbor = adjacency[j];
+
+                    if( !used[neighbor] && candidateCluster[neighbor] != clusterIndex )
+                    {
+                        candidateCluster[neighbor] = clusterIndex;
+                        candidates.push_back(neighbor);
+                    }
+                }
+            }
+
+            // A piece of the mesh that is used up continues with the next triangle in order, which is likely nearby
+            if( candidates.empty() )
+            {
+                while( nextSeed < numTriangles && used[nextSeed] )
+                {
+                    ++nextSeed;
+                }
+
+                if( nextSeed == numTriangles )
+                {
+                    break;
+                }
+
+                candidates.push_back(nextSeed);
+                candidateCluster[nextSeed] = clusterIndex;
+            }
+        }
+
+        // Keep the order the triangles had, which was optimized for the vertex cache
+        std::sort(clusterTriangles.begin(), clusterTriangles.end());
+
+        MeshCluster cluster;
+        cluster.m_firstIndex = static_cast<unsigned>(reordered.size());
+        cluster.m_numIndices = static_cast<unsigned>(clusterTriangles.size() * 3);
+
+        CalculateClusterBounds(positions, triangleNormals, indices, clusterTriangles, cluster);
+
+        for(std::vector<unsigned>::const_iterator it = clusterTriangles.begin(); it != clusterTriangles.end(); ++it)
+        {
+            reordered.insert(reordered.end(), indices.begin() + *it * 3, indices.begin() + *it * 3 + 3);
+        }
+
+        clusters.push_back(cluster);
+    }
+
+    //-----
+    // Order the clusters by the direction they face, so that the clusters culled from any one direction
+    // tend to be next to each other, and those that are drawn can be drawn with fewer calls
+    std::vector<unsigned> order(clusters.size());
+    std::vector<unsigned> keys(clusters.size());
+
+    for(unsigned i = 0; i < clusters.size(); ++i)
+    {
+        order[i] = i;
+        keys[i]  = GetDirectionKey(clusters[i]);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&keys](const unsigned a, const unsigned b)
+    {
+        return keys[a] < keys[b];
+    });
+
+    std::vector<MeshCluster> sortedClusters;
+    sortedClusters.reserve(clusters.size());
+    indices.clear();
+
+    for(std::vector<unsigned>::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+        MeshCluster cluster = clusters[*it];
+
+        indices.insert(indices.end(), reordered.begin() + cluster.m_firstIndex, reordered.begin() + cluster.m_firstIndex + cluster.m_numIndices);
+        cluster.m_firstIndex = static_cast<unsigned>(indices.size()) - cluster.m_numIndices;
+
+        sortedClusters.push_back(cluster);
+    }
+
+    clusters.swap(sortedClusters);
+}
+
+//------------------------------------------------------------------------------
+void GenerateClusters(PolygonSetData & polygonSet)
+{
+    // Find where the position is in each vertex
+    unsigned          positionOffset = 0;
+    BufferContentType positionType   = NUM_BUFFER_CONTENT_TYPES;
+
+    for(std::vector<BufferContentType>::const_iterator it = polygonSet.m_contentTypes.begin(); it != polygonSet.m_contentTypes.end(); ++it)
+    {
+        if( *it == POSITION || *it == POSITION16 )
+        {
+            positionType = *it;
+            break;
+        }
+
+        positionOffset += GetStride(*it);
+    }
+
+    if( positionType == NUM_BUFFER_CONTENT_TYPES )
+    {
+        const std::string msg("Cannot cluster vertices without a position");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // The indices are about to be reordered, so they cannot stay in the mapped file
+    polygonSet.CopyFromMappedFile();
+
+    // Gather the positions, in object space
+    const unsigned             vertexSize   = polygonSet.GetVertexSize();
+    const unsigned char *      vertex       = polygonSet.GetVertexData() + positionOffset;
+    const VertexQuantization & quantization = polygonSet.m_quantization;
+
+    std::vector<Position> positions(polygonSet.m_numVertices);
+
+    for(unsigned i = 0; i < polygonSet.m_numVertices; ++i)
+    {
+        if( positionType == POSITION )
+        {
+            memcpy(&positions[i], vertex + static_cast<size_t>(i) * vertexSize, sizeof(Position));
+        }
+        else
+        {
+            Position16 quantized;
+            memcpy(&quantized, vertex + static_cast<size_t>(i) * vertexSize, sizeof(Position16));
+
+            float decoded[4];
+            D3DXFloat16To32Array(decoded, &quantized.x, 4);
+
+            positions[i] = D3DXVECTOR3(decoded[0], decoded[1], decoded[2]) * quantization.m_positionScale + quantization.m_positionBias;
+        }
+    }
+
+    try
+    {
+        BuildClusters(positions, polygonSet.m_indices, polygonSet.m_clusters);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//------------------------------------------------------------------------------
+const bool IsClusterBackfacing(const MeshCluster & cluster, const D3DXVECTOR3 & cameraPosition)
+{
+    // Every triangle faces away if every direction from the camera into the sphere is within
+    // 90 degrees, less the width of the cone, of the axis
+    const D3DXVECTOR3 toCenter = cluster.m_sphereCenter - cameraPosition;
+
+    return D3DXVec3Dot(&toCenter, &cluster.m_coneAxis) >=
+           cluster.m_coneCutoff * D3DXVec3Length(&toCenter) + cluster.m_sphereRadius;
+}
+
+//------------------------------------------------------------------------------
+const bool IsClusterBackfacingOrthographic(const MeshCluster & cluster, const D3DXVECTOR3 & viewDirection)
+{
+    // A cone that never culls has a cutoff of 1, which no unit vectors can exceed
+    return cluster.m_coneCutoff < 1.0f && D3DXVec3Dot(&viewDirection, &cluster.m_coneAxis) >= cluster.m_coneCutoff;
+}
@@ -0,0 +1,96 @@
+#ifndef MESHCLUSTERER_H
+#define MESHCLUSTERER_H
+
+// EngineX Includes
+#include "Graphics\3D\Buffers.h"
+
+// DirectX Includes
+#include <d3dx10.h>
+
+// Standard Includes
+#include <vector>
+
+struct PolygonSetData;
+
+//------------------------------------------------------------------------------
+// Partitioning of indexed triangle lists into small clusters that can be culled on their own
+//
+// Triangles are gathered into clusters greedily. Each cluster starts from the first triangle that is not in one yet,
+// in the order the vertex cache optimizer left them, and grows across shared vertices, preferring triangles that
+// add the fewest new vertices and that face the same way as the cluster so far. Triangles that face too far away
+// from the rest are left for another cluster. The indices are then reordered so that each cluster is a contiguous 
+// range, keeping the optimized order within it, and can be drawn with DrawIndexed. The clusters themselves are
+// ordered by the direction they face, so that those visible from any one direction tend to be next to each other.
+//
+// Each cluster gets a bounding sphere, for culling against the view frustum, and a cone that holds the normals of
+// all its triangles, for culling clusters that face entirely away from the camera. Clusters whose normals are spread
+// too far apart to ever be entirely backfacing get a cone that never culls.
+//
+
+const unsigned CLUSTER_MAX_VERTICES  = 64;
+const unsigned CLUSTER_MAX_TRIANGLES = 124;
+
+/**
+* A contiguous range of an index buffer, with the bounds needed to cull it
+**/
+struct MeshCluster
+{
+   /**
+   * Constructor
+   **/
+   MeshCluster();
+
+
+   unsigned    m_firstIndex;     // Where the cluster starts in the index buffer
+   unsigned    m_numIndices;
+   D3DXVECTOR3 m_sphereCenter;   // Bounding sphere, in object space
+   float       m_sphereRadius;
+   D3DXVECTOR3 m_coneAxis;       // Average direction the triangles face, in object space
+   float       m_coneCutoff;     // Sine of the angle between the axis and the furthest normal, or 1 if the cone never culls
+};
+
+/**
+* Splits an indexed triangle list into clusters and reorders the indices so that each cluster is a contiguous range
+*
+* @param positions    - Position of each vertex
+* @param indices      - IN/OUT - Indexed triangle list, reordered a cluster at a time
+* @param clusters     - OUT - The clusters, in the order they appear in the indices
+* @param maxVertices  - Most unique vertices a cluster may refer to
+* @param maxTriangles - Most triangles a cluster may have
+*
+* @throws BaseException - If the number of indices is not a multiple of 3, an index is out of range,
+*                         or the limits are too small to hold a triangle
+**/
+void BuildClusters(const std::vector<Position> & positions,
+                   std::vector<Index> & indices,
+                   std::vector<MeshCluster> & clusters,
+                   const unsigned maxVertices = CLUSTER_MAX_VERTICES,
+                   const unsigned maxTriangles = CLUSTER_MAX_TRIANGLES);
+
+/**
+* Splits the indices of a polygon set into clusters, stored in the polygon set
+*
+* Vertices and indices that lie in a mapped file are copied into memory first. Quantized positions are decoded,
+* so that the bounds are in object space.
+*
+* @throws BaseException - If the vertices have no POSITION or POSITION16, or the indices are invalid
+**/
+void GenerateClusters(PolygonSetData & polygonSet);
+
+/**
+* Query whether or not every triangle of a cluster faces away from a camera
+*
+* @param cluster        - The cluster
+* @param cameraPosition - Position of the camera, in object space
+**/
+const bool IsClusterBackfacing(const MeshCluster & cluster, const D3DXVECTOR3 & cameraPosition);
+
+/**
+* Query whether or not every triangle of a cluster faces away from a camera with an orthographic projection
+*
+* @param cluster       - The cluster
+* @param viewDirection - Unit direction the camera looks in, in object space
+**/
+const bool IsClusterBackfacingOrthographic(const MeshCluster & cluster, const D3DXVECTOR3 & viewDirection);
+
+#endif // MESHCLUSTERER_H
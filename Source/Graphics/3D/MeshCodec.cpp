@@ -0,0 +1,464 @@
+// Project Includes
+#include "MeshCodec.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    // Number of vertices coded together, a multiple of the group size
+    const unsigned VERTEX_BLOCK_SIZE = 256;
+
+    // Number of bytes of a stream that share a bit width
+    const unsigned GROUP_SIZE = 16;
+
+    // Longest a variable length 32 bit integer can be, in bytes
+    const unsigned MAX_VARINT_SIZE = 5;
+
+    //--------------------------------------------------------------------------
+    /**
+    * Maps a difference to an unsigned value, such that small differences either way give small values
+    **/
+    inline unsigned ZigZag(const unsigned difference)
+    {
+        return (difference & 0x80000000) ? ~(difference << 1) : (difference << 1);
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Undoes ZigZag
+    **/
+    inline unsigned UnZigZag(const unsigned value)
+    {
+        return (value >> 1) ^ (0U - (value & 1));
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Writes a variable length integer, 7 bits a byte, lowest first, with the high bit set on all but the last byte
+    **/
+    inline void WriteVarint(unsigned value, std::vector<unsigned char> & encoded)
+    {
+        while( value >= 0x80 )
+        {
+            encoded.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+
+        encoded.push_back(static_cast<unsigned char>(value));
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Reads a variable length integer
+    *
+    * @return - Position after the integer, or NULL if it runs past the end, is too long, or does not fit in 32 bits
+    **/
+    inline const unsigned char * ReadVarint(const unsigned char * position, const unsigned char * end, unsigned & value)
+    {
+        value = 0;
+
+        for(unsigned i = 0; i < MAX_VARINT_SIZE; ++i)
+        {
+            if( position == end )
+            {
+                return NULL;
+            }
+
+            const unsigned byte = *position++;
+
+            // The last byte only has the top 4 bits of 32 to give, so anything more is corrupt
+            if( i == MAX_VARINT_SIZE - 1 && (byte & 0xF0) )
+            {
+                return NULL;
+            }
+
+            value |= (byte & 0x7F) << (7 * i);
+
+            if( !(byte & 0x80) )
+            {
+                return position;
+            }
+        }
+
+        return NULL;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Gets the number of bytes of group headers a stream of a block has, at 2 bits a group
+    **/
+    inline unsigned GetHeaderSize(const unsigned numGroups)
+    {
+        return (numGroups + 3) / 4;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Packs one byte stream of a block
+    *
+    * @param bytes     - Bytes of the stream, padded with zeros to a whole number of groups
+    * @param numGroups - Number of groups
+    **/
+    void EncodeByteStream(const unsigned char * bytes, const unsigned numGroups, std::vector<unsigned char> & encoded)
+    {
+        // Group headers come first, 2 bits a group, saying how many bits each byte of the group takes
+        const size_t headerOffset = encoded.size();
+        encoded.resize(encoded.size() + GetHeaderSize(numGroups), 0);
+
+        for(unsigned group = 0; group < numGroups; ++group)
+        {
+            const unsigned char * groupBytes = bytes + group * GROUP_SIZE;
+            const unsigned char   largest    = *std::max_element(groupBytes, groupBytes + GROUP_SIZE);
+
+            unsigned mode = 3;
+
+            if( largest == 0 )
+            {
+                mode = 0;
+            }
+            else if( largest < 4 )
+            {
+                mode = 1;
+            }
+            else if( largest < 16 )
+            {
+                mode = 2;
+            }
+
+            encoded[headerOffset + group / 4] |= static_cast<unsigned char>(mode << ((group % 4) * 2));
+
+            switch( mode )
+            {
+                case 1:
+                {
+                    for(unsigned i = 0; i < GROUP_SIZE; i += 4)
+                    {
+                        encoded.push_back(static_cast<unsigned char>(groupBytes[i] | (groupBytes[i + 1] << 2) | (groupBytes[i + 2] << 4) | (groupBytes[i + 3] << 6)));
+                    }
+
+                    break;
+                }
+
+                case 2:
+                {
+                    for(unsigned i = 0; i < GROUP_SIZE; i += 2)
+                    {
+                        encoded.push_back(static_cast<unsigned char>(groupBytes[i] | (groupBytes[i + 1] << 4)));
+                    }
+
+                    break;
+                }
+
+                case 3:
+                {
+                    encoded.insert(encoded.end(), groupBytes, groupBytes + GROUP_SIZE);
+                    break;
+                }
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Unpacks one byte stream of a block into its byte of each word
+    *
+    * @param shift - Position of the byte in the words, in bits
+    * @param words - IN/OUT - Words of the block, a whole number of groups, that the stream is added to
+    *
+    * @return - Position after the stream, or NULL if it runs past the end
+    **/
+    const unsigned char * DecodeByteStream(const unsigned char * position,
+                                           const unsigned char * end,
+                                           const unsigned numGroups,
+                                           const unsigned shift,
+                                           unsigned * words)
+    {
+        const unsigned headerSize = GetHeaderSize(numGroups);
+
+        if( static_cast<size_t>(end - position) < headerSize )
+        {
+            return NULL;
+        }
+
+        const unsigned char * header = position;
+        position += headerSize;
+
+        for(unsigned group = 0; group < numGroups; ++group)
+        {
+            unsigned *     groupWords = words + group * GROUP_SIZE;
+            const unsigned mode       = (header[group / 4] >> ((group % 4) * 2)) & 3;
+
+            // Mode 1 takes 4 bytes, mode 2 takes 8, and mode 3 takes 16
+            const size_t dataSize = mode ? (static_cast<size_t>(2) << mode) : 0;
+
+            if( static_cast<size_t>(end - position) < dataSize )
+            {
+                return NULL;
+            }
+
+            switch( mode )
+            {
+                case 1:
+                {
+                    for(unsigned i = 0; i < GROUP_SIZE; i += 4)
+                    {
+                        const unsigned packed = *position++;
+
+                        groupWords[i]     |= (packed & 3)        << shift;
+                        groupWords[i + 1] |= ((packed >> 2) & 3) << shift;
+                        groupWords[i + 2] |= ((packed >> 4) & 3) << shift;
+                        groupWords[i + 3] |= (packed >> 6)       << shift;
+                    }
+
+                    break;
+                }
+
+                case 2:
+                {
+                    for(unsigned i = 0; i < GROUP_SIZE; i += 2)
+                    {
+                        const unsigned packed = *position++;
+
+                        groupWords[i]     |= (packed & 15) << shift;
+                        groupWords[i + 1] |= (packed >> 4) << shift;
+                    }
+
+                    break;
+                }
+
+                case 3:
+                {
+                    for(unsigned i = 0; i < GROUP_SIZE; ++i)
+                    {
+                        groupWords[i] |= static_cast<unsigned>(position[i]) << shift;
+                    }
+
+                    position += GROUP_SIZE;
+                    break;
+                }
+            }
+        }
+
+        return position;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Checks that a vertex size can be coded a word at a time
+    **/
+    void CheckVertexSize(const unsigned vertexSize)
+    {
+        if( vertexSize == 0 || vertexSize % 4 != 0 )
+        {
+            std::ostringstream msg;
+            msg << "Cannot code vertices of size " << vertexSize << ". The size must be a multiple of 4 bytes.";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void EncodeIndices(const Index * indices,
+                   const unsigned numIndices,
+                   std::vector<unsigned char> & encoded)
+{
+    encoded.clear();
+    encoded.reserve(numIndices + numIndices / 4);
+
+    // The next vertex that has not been referenced yet
+    Index next = 0;
+
+    for(unsigned i = 0; i < numIndices; ++i)
+    {
+        const Index index = indices[i];
+
+        WriteVarint(ZigZag(next - index), encoded);
+
+        if( index >= next )
+        {
+            next = index + 1;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void DecodeIndices(const unsigned char * encoded,
+                   const size_t encodedSize,
+                   const unsigned numIndices,
+                   std::vector<Index> & indices)
+{
+    // Every index takes at least a byte, which also keeps a corrupt count from allocating too much
+    if( numIndices > encodedSize )
+    {
+        std::ostringstream msg;
+        msg << numIndices << " indices cannot have been compressed into " << encodedSize << " bytes";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    indices.resize(numIndices);
+
+    const unsigned char * position = encoded;
+    const unsigned char * end      = encoded + encodedSize;
+    Index                 next     = 0;
+
+    for(unsigned i = 0; i < numIndices; ++i)
+    {
+        unsigned value = 0;
+        position = ReadVarint(position, end, value);
+
+        if( !position )
+        {
+            std::ostringstream msg;
+            msg << "Compressed indices are truncated or corrupt at index " << i;
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        const Index index = next - UnZigZag(value);
+        indices[i] = index;
+
+        if( index >= next )
+        {
+            next = index + 1;
+        }
+    }
+
+    if( position != end )
+    {
+        std::ostringstream msg;
+        msg << "Compressed indices have " << (end - position) << " bytes left over";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+}
+
+//------------------------------------------------------------------------------
+void EncodeVertices(const unsigned char * vertices,
+                    const unsigned numVertices,
+                    const unsigned vertexSize,
+                    std::vector<unsigned char> & encoded)
+{
+    CheckVertexSize(vertexSize);
+
+    encoded.clear();
+    encoded.reserve(static_cast<size_t>(numVertices) * vertexSize / 2);
+
+    const unsigned        numWords = vertexSize / 4;
+    std::vector<unsigned> previous(numWords, 0);
+    unsigned              differences[VERTEX_BLOCK_SIZE];
+    unsigned char         bytes[VERTEX_BLOCK_SIZE];
+
+    for(unsigned first = 0; first < numVertices; first += VERTEX_BLOCK_SIZE)
+    {
+        const unsigned blockSize = std::min<unsigned>(VERTEX_BLOCK_SIZE, numVertices - first);
+        const unsigned numGroups = (blockSize + GROUP_SIZE - 1) / GROUP_SIZE;
+
+        for(unsigned word = 0; word < numWords; ++word)
+        {
+            // Predict each word from the same word of the vertex before it
+            const unsigned char * source = vertices + static_cast<size_t>(first) * vertexSize + word * 4;
+
+            for(unsigned i = 0; i < blockSize; ++i, source += vertexSize)
+            {
+                unsigned value = 0;
+                memcpy(&value, source, 4);
+
+                differences[i] = ZigZag(value - previous[word]);
+                previous[word] = value;
+            }
+
+            std::fill(differences + blockSize, differences + numGroups * GROUP_SIZE, 0);
+
+            // One stream per byte of the word, lowest first
+            for(unsigned byte = 0; byte < 4; ++byte)
+            {
+                for(unsigned i = 0; i < numGroups * GROUP_SIZE; ++i)
+                {
+                    bytes[i] = static_cast<unsigned char>(differences[i] >> (byte * 8));
+                }
+
+                EncodeByteStream(bytes, numGroups, encoded);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void DecodeVertices(const unsigned char * encoded,
+                    const size_t encodedSize,
+                    const unsigned numVertices,
+                    const unsigned vertexSize,
+                    std::vector<unsigned char> & vertices)
+{
+    CheckVertexSize(vertexSize);
+
+    // Every stream of every block has its group headers, however well it packs,
+    // which also keeps a corrupt count from allocating too much
+    const unsigned numFullBlocks = numVertices / VERTEX_BLOCK_SIZE;
+    const unsigned lastBlockSize = numVertices % VERTEX_BLOCK_SIZE;
+    const size_t   minSize       = static_cast<size_t>(vertexSize) *
+                                   (static_cast<size_t>(numFullBlocks) * GetHeaderSize(VERTEX_BLOCK_SIZE / GROUP_SIZE) +
+                                    GetHeaderSize((lastBlockSize + GROUP_SIZE - 1) / GROUP_SIZE));
+
+    if( encodedSize < minSize )
+    {
+        std::ostringstream msg;
+        msg << numVertices << " vertices of size " << vertexSize << " cannot have been compressed into " << encodedSize << " bytes";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    vertices.resize(static_cast<size_t>(numVertices) * vertexSize);
+
+    const unsigned char * position = encoded;
+    const unsigned char * end      = encoded + encodedSize;
+    const unsigned        numWords = vertexSize / 4;
+    std::vector<unsigned> previous(numWords, 0);
+    unsigned              differences[VERTEX_BLOCK_SIZE];
+
+    for(unsigned first = 0; first < numVertices; first += VERTEX_BLOCK_SIZE)
+    {
+        const unsigned blockSize = std::min<unsigned>(VERTEX_BLOCK_SIZE, numVertices - first);
+        const unsigned numGroups = (blockSize + GROUP_SIZE - 1) / GROUP_SIZE;
+
+        for(unsigned word = 0; word < numWords; ++word)
+        {
+            std::fill(differences, differences + numGroups * GROUP_SIZE, 0);
+
+            for(unsigned byte = 0; byte < 4; ++byte)
+            {
+                position = DecodeByteStream(position, end, numGroups, byte * 8, differences);
+
+                if( !position )
+                {
+                    std::ostringstream msg;
+                    msg << "Compressed vertices are truncated or corrupt at vertex " << first;
+                    throw Common::Exception(__FILE__, __LINE__, msg.str());
+                }
+            }
+
+            // Undo the prediction
+            unsigned char * destination = &vertices[static_cast<size_t>(first) * vertexSize + word * 4];
+            unsigned        value       = previous[word];
+
+            for(unsigned i = 0; i < blockSize; ++i, destination += vertexSize)
+            {
+                value += UnZigZag(differences[i]);
+                memcpy(destination, &value, 4);
+            }
+
+            previous[word] = value;
+        }
+    }
+
+    if( position != end )
+    {
+        std::ostringstream msg;
+        msg << "Compressed vertices have " << (end - position) << " bytes left over";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+}
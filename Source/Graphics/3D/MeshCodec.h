@@ -0,0 +1,86 @@
+#ifndef MESHCODEC_H
+#define MESHCODEC_H
+
+// EngineX Includes
+#include "Graphics\3D\Buffers.h"
+
+// Standard Includes
+#include <cstddef>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Lossless compression of vertices and indices, for cooked meshes that are smaller on disk (see CookedMesh.h)
+//
+// Indices are coded against the next vertex that has not been referenced yet. Once the vertices have been
+// reordered for vertex fetch (see MeshOptimizer.h), that is where most indices point, and the rest point back
+// at vertices used a few triangles ago. Each difference is zigzag coded and written as a variable length integer,
+// so most indices take one byte.
+//
+// Vertices are predicted from the vertex before them, one 4 byte word at a time. The differences are zigzag
+// coded, split into a stream per byte of the vertex, and each stream is packed in groups of 16, using 0, 2, 4
+// or 8 bits a byte, whichever is the fewest that holds every byte of the group. Attributes that change
+// slowly from one vertex to the next leave the high bytes of their differences at zero, which cost almost nothing.
+//
+// Decoding is a single pass over the data with no tables, and it is thread safe, so files can be decoded
+// on several threads at once.
+//
+
+/**
+* Compresses indices
+*
+* @param indices     - Indices of a triangle list
+* @param numIndices  - Number of indices
+* @param encoded     - OUT - The compressed indices
+**/
+void EncodeIndices(const Index * indices,
+                   const unsigned numIndices,
+                   std::vector<unsigned char> & encoded);
+
+/**
+* Decompresses indices that were compressed by EncodeIndices
+*
+* @param encoded     - The compressed indices
+* @param encodedSize - Size in bytes of the compressed indices
+* @param numIndices  - Number of indices that were compressed
+* @param indices     - OUT - The indices
+*
+* @throws BaseException - If the compressed indices are truncated or corrupt
+**/
+void DecodeIndices(const unsigned char * encoded,
+                   const size_t encodedSize,
+                   const unsigned numIndices,
+                   std::vector<Index> & indices);
+
+/**
+* Compresses interleaved vertices
+*
+* @param vertices    - Interleaved vertices
+* @param numVertices - Number of vertices
+* @param vertexSize  - Size in bytes of one vertex. Must be a multiple of 4.
+* @param encoded     - OUT - The compressed vertices
+*
+* @throws BaseException - If the vertex size is not a multiple of 4
+**/
+void EncodeVertices(const unsigned char * vertices,
+                    const unsigned numVertices,
+                    const unsigned vertexSize,
+                    std::vector<unsigned char> & encoded);
+
+/**
+* Decompresses interleaved vertices that were compressed by EncodeVertices
+*
+* @param encoded     - The compressed vertices
+* @param encodedSize - Size in bytes of the compressed vertices
+* @param numVertices - Number of vertices that were compressed
+* @param vertexSize  - Size in bytes of one vertex
+* @param vertices    - OUT - The interleaved vertices
+*
+* @throws BaseException - If the vertex size is not a multiple of 4, or the compressed vertices are truncated or corrupt
+**/
+void DecodeVertices(const unsigned char * encoded,
+                    const size_t encodedSize,
+                    const unsigned numVertices,
+                    const unsigned vertexSize,
+                    std::vector<unsigned char> & vertices);
+
+#endif // MESHCODEC_H
@@ -0,0 +1,492 @@
+
+// Project Includes
+#include "MeshOptimizer.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+// OS Includes
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+//------------------------------------------------------------------------------
+namespace
+{
+    // Tuning values from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    const unsigned CACHE_SIZE          = 32;      // Size of the LRU cache that is modelled
+    const unsigned MAX_VALENCE_SCORED  = 64;      // Valences above this score the same as this
+    const float    CACHE_DECAY_POWER   = 1.5f;
+    const float    LAST_TRIANGLE_SCORE = 0.75f;
+    const float    VALENCE_BOOST_SCALE = 2.0f;
+    const float    VALENCE_BOOST_POWER = 0.5f;
+
+    const Index    NO_INDEX            = 0xFFFFFFFF;
+
+    //--------------------------------------------------------------------------
+    /**
+    * Precomputed vertex scores, indexed by position in the LRU cache and by the number of triangles 
+    * that still use the vertex
+    **/
+    class VertexScoreTable
+    {
+    public:
+
+        VertexScoreTable()
+        {
+            for(unsigned i = 0; i < CACHE_SIZE; ++i)
+            {
+                if( i < 3 )
+                {
+                    // The vertices of the last triangle are scored lower on purpose, so the same 
+                    // triangle strip is not continued forever
+                    m_cacheScores[i] = LAST_TRIANGLE_SCORE;
+                }
+                else
+                {
+                    const float scaler = 1.0f / static_cast<float>(CACHE_SIZE - 3);
+                    m_cacheScores[i]   = powf(1.0f - static_cast<float>(i - 3) * scaler, CACHE_DECAY_POWER);
+                }
+            }
+
+            m_valenceScores[0] = 0.0f;
+
+            for(unsigned i = 1; i <= MAX_VALENCE_SCORED; ++i)
+            {
+                // Boost vertices with few triangles left, so that lone triangles do not get left behind
+                m_valenceScores[i] = VALENCE_BOOST_SCALE * powf(static_cast<float>(i), -VALENCE_BOOST_POWER);
+            }
+        }
+
+        float GetScore(const int cachePosition, const unsigned numActiveTriangles) const
+        {
+            if( numActiveTriangles == 0 )
+            {
+                // No triangle needs this vertex anymore
+                return -1.0f;
+            }
+
+            float score = cachePosition < 0 ? 0.0f : m_cacheScores[cachePosition];
+            score += m_valenceScores[numActiveTriangles < MAX_VALENCE_SCORED ? numActiveTriangles : MAX_VALENCE_SCORED];
+
+            return score;
+        }
+
+    private:
+
+        float m_cacheScores[CACHE_SIZE];
+        float m_valenceScores[MAX_VALENCE_SCORED + 1];
+    };
+
+    //--------------------------------------------------------------------------
+    /**
+    * Throws if any index is out of range
+    **/
+    void ValidateIndices(const std::vector<Index> & indices, const unsigned numVertices)
+    {
+        for(size_t i = 0; i < indices.size(); ++i)
+        {
+            if( indices[i] >= numVertices )
+            {
+                std::ostringstream msg;
+                msg << "Index " << i << " refers to vertex " << indices[i] << ", but there are only " << numVertices << " vertices";
+                throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Warns that some indices do not make up a whole triangle, which is a sign the source file was malformed
+    **/
+    void WarnOfLeftoverIndices(const size_t numIndices)
+    {
+#ifdef _WIN32
+        std::ostringstream msg;
+        msg << "Warning: " << numIndices % 3 << " of " << numIndices << " indices are left over after the last whole "
+            << "triangle. They were left at the end, unoptimized.\n";
+        OutputDebugStringA(msg.str().c_str());
+#else
+        (void)numIndices;
+#endif
+    }
+}
+
+//------------------------------------------------------------------------------
+VertexCacheStatistics::VertexCacheStatistics()
+    :
+    m_numTriangles   (0),
+    m_numVerticesUsed(0),
+    m_numTransformed (0),
+    m_acmr           (0.0f),
+    m_atvr           (0.0f)
+{
+}
+
+//------------------------------------------------------------------------------
+MeshOptimizationReport::MeshOptimizationReport()
+    :
+    m_numLeftoverIndices(0)
+{
+}
+
+//------------------------------------------------------------------------------
+const VertexCacheStatistics AnalyzeVertexCache(const std::vector<Index> & indices,
+                                               const unsigned numVertices,
+                                               const unsigned cacheSize)
+{
+    ValidateIndices(indices, numVertices);
+
+    VertexCacheStatistics statistics;
+
+    if( indices.empty() || cacheSize == 0 )
+    {
+        return statistics;
+    }
+
+    // A vertex is in the FIFO cache if it was last inserted no more than cacheSize insertions ago
+    std::vector<unsigned> insertedAt(numVertices, 0);
+    std::vector<bool>     used(numVertices, false);
+    unsigned              numInsertions = 0;
+
+    for(size_t i = 0; i < indices.size(); ++i)
+    {
+        const Index vertex = indices[i];
+
+        if( !used[vertex] )
+        {
+            used[vertex] = true;
+            ++statistics.m_numVerticesUsed;
+        }
+
+        if( insertedAt[vertex] == 0 || numInsertions - insertedAt[vertex] >= cacheSize )
+        {
+            ++numInsertions;
+            insertedAt[vertex] = numInsertions;
+        }
+    }
+
+    statistics.m_numTriangles   = static_cast<unsigned>(indices.size() / 3);
+    statistics.m_numTransformed = numInsertions;
+
+    if( statistics.m_numTriangles )
+    {
+        statistics.m_acmr = static_cast<float>(numInsertions) / static_cast<float>(statistics.m_numTriangles);
+    }
+
+    statistics.m_atvr = static_cast<float>(numInsertions) / static_cast<float>(statistics.m_numVerticesUsed);
+
+    return statistics;
+}
+
+//------------------------------------------------------------------------------
+void OptimizeVertexCache(std::vector<Index> & indices, const unsigned numVertices)
+{
+    ValidateIndices(indices, numVertices);
+
+    // Indices after the last whole triangle are not part of any triangle, so they stay at the end as they are
+    const size_t   numTriangleIndices = indices.size() - indices.size() % 3;
+    const unsigned numTriangles       = static_cast<unsigned>(numTriangleIndices / 3);
+
+    if( numTriangles < 2 )
+    {
+        return;
+    }
+
+    static const VertexScoreTable scoreTable;
+
+    // Build the triangles each vertex is used by
+    //
+    // The triangles of vertex v are stored in vertexTriangles at [triangleOffsets[v], triangleOffsets[v] + numActive[v]).
+    // Triangles that have been output are swapped to the end of that range and the active count is reduced.
+    std::vector<unsigned> numActive(numVertices, 0);
+
+    for(size_t i = 0; i < numTriangleIndices; ++i)
+    {
+        ++numActive[indices[i]];
+    }
+
+    std::vector<unsigned> triangleOffsets(numVertices, 0);
+    unsigned              offset = 0;
+
+    for(unsigned v = 0; v < numVertices; ++v)
+    {
+        triangleOffsets[v] = offset;
+        offset += numActive[v];
+    }
+
+    std::vector<unsigned> vertexTriangles(numTriangleIndices);
+    std::vector<unsigned> filled(numVertices, 0);
+
+    for(unsigned t = 0; t < numTriangles; ++t)
+    {
+        for(unsigned corner = 0; corner < 3; ++corner)
+        {
+            const Index v = indices[t * 3 + corner];
+            vertexTriangles[triangleOffsets[v] + filled[v]] = t;
+            ++filled[v];
+        }
+    }
+
+    // Initial scores
+    std::vector<int>   cachePositions(numVertices, -1);
+    std::vector<float> vertexScores(numVertices);
+
+    for(unsigned v = 0; v < numVertices; ++v)
+    {
+        vertexScores[v] = scoreTable.GetScore(-1, numActive[v]);
+    }
+
+    std::vector<float> triangleScores(numTriangles);
+    std::vector<bool>  triangleAdded(numTriangles, false);
+
+    unsigned bestTriangle = 0;
+
+    for(unsigned t = 0; t < numTriangles; ++t)
+    {
+        triangleScores[t] = vertexScores[indices[t * 3]] + 
+                            vertexScores[indices[t * 3 + 1]] + 
+                            vertexScores[indices[t * 3 + 2]];
+
+        if( triangleScores[t] > triangleScores[bestTriangle] )
+        {
+            bestTriangle = t;
+        }
+    }
+
+    // Output triangles one at a time, always choosing the best scoring triangle that uses a vertex in the cache
+    std::vector<Index> optimized;
+    optimized.reserve(indices.size());
+
+    Index    cache[CACHE_SIZE + 3];
+    Index    newCache[CACHE_SIZE + 3];
+    unsigned cacheCount         = 0;
+    unsigned nextInputTriangle  = 0;
+
+    for(unsigned numOutput = 0; numOutput < numTriangles; ++numOutput)
+    {
+        // When no triangle in the cache is worth anything, carry on from the next unused triangle in input order
+        if( bestTriangle == NO_INDEX )
+        {
+            while( triangleAdded[nextInputTriangle] )
+            {
+                ++nextInputTriangle;
+            }
+
+            bestTriangle = nextInputTriangle;
+        }
+
+        const Index * triangle = &indices[bestTriangle * 3];
+
+        optimized.push_back(triangle[0]);
+        optimized.push_back(triangle[1]);
+        optimized.push_back(triangle[2]);
+        triangleAdded[bestTriangle] = true;
+
+        // Remove the triangle from the active triangles of its vertices
+        for(unsigned corner = 0; corner < 3; ++corner)
+        {
+            const Index v     = triangle[corner];
+            unsigned *  first = &vertexTriangles[triangleOffsets[v]];
+            unsigned    last  = numActive[v] - 1;
+
+            for(unsigned i = 0; i <= last; ++i)
+            {
+                if( first[i] == bestTriangle )
+                {
+                    first[i]    = first[last];
+                    first[last] = bestTriangle;
+                    break;
+                }
+            }
+
+            --numActive[v];
+        }
+
+        // The vertices of the triangle move to the front of the LRU cache
+        unsigned newCacheCount = 0;
+
+        newCache[newCacheCount++] = triangle[0];
+        newCache[newCacheCount++] = triangle[1];
+        newCache[newCacheCount++] = triangle[2];
+
+        for(unsigned i = 0; i < cacheCount; ++i)
+        {
+            const Index v = cache[i];
+
+            if( v != triangle[0] && v != triangle[1] && v != triangle[2] )
+            {
+                newCache[newCacheCount++] = v;
+            }
+        }
+
+        // Rescore every vertex that is in, or just fell out of, the cache and pass the change on to its triangles
+        bestTriangle = NO_INDEX;
+        float bestScore = -1.0f;
+
+        for(unsigned i = 0; i < newCacheCount; ++i)
+        {
+            const Index v = newCache[i];
+
+            cachePositions[v] = i < CACHE_SIZE ? static_cast<int>(i) : -1;
+
+            const float score = scoreTable.GetScore(cachePositions[v], numActive[v]);
+            const float delta = score - vertexScores[v];
+            vertexScores[v]   = score;
+
+            const unsigned * triangles = &vertexTriangles[triangleOffsets[v]];
+
+            for(unsigned j = 0; j < numActive[v]; ++j)
+            {
+                triangleScores[triangles[j]] += delta;
+            }
+        }
+
+        // Only triangles of vertices still in the cache are candidates for the next triangle
+        for(unsigned i = 0; i < newCacheCount && i < CACHE_SIZE; ++i)
+        {
+            const Index      v         = newCache[i];
+            const unsigned * triangles = &vertexTriangles[triangleOffsets[v]];
+
+            for(unsigned j = 0; j < numActive[v]; ++j)
+            {
+                if( triangleScores[triangles[j]] > bestScore )
+                {
+                    bestScore    = triangleScores[triangles[j]];
+                    bestTriangle = triangles[j];
+                }
+            }
+        }
+
+        cacheCount = newCacheCount < CACHE_SIZE ? newCacheCount : CACHE_SIZE;
+        memcpy(cache, newCache, cacheCount * sizeof(Index));
+    }
+
+    optimized.insert(optimized.end(), indices.begin() + numTriangleIndices, indices.end());
+    indices.swap(optimized);
+}
+
+//------------------------------------------------------------------------------
+const unsigned OptimizeVertexFetch(std::vector<Index> & indices,
+                                   const unsigned numVertices,
+                                   std::vector<Index> & remap)
+{
+    ValidateIndices(indices, numVertices);
+
+    remap.assign(numVertices, NO_INDEX);
+    unsigned numNewVertices = 0;
+
+    for(size_t i = 0; i < indices.size(); ++i)
+    {
+        Index & index = indices[i];
+
+        if( remap[index] == NO_INDEX )
+        {
+            remap[index] = numNewVertices++;
+        }
+
+        index = remap[index];
+    }
+
+    return numNewVertices;
+}
+
+//------------------------------------------------------------------------------
+void RemapInterleavedVertices(std::vector<unsigned char> & vertexData,
+                              const unsigned vertexSize,
+                              const std::vector<Index> & remap,
+                              const unsigned numNewVertices)
+{
+    std::vector<unsigned char> remapped(static_cast<size_t>(numNewVertices) * vertexSize);
+    const size_t               numVertices = vertexData.size() / vertexSize;
+
+    for(size_t i = 0; i < remap.size() && i < numVertices; ++i)
+    {
+        if( remap[i] != NO_INDEX )
+        {
+            memcpy(&remapped[static_cast<size_t>(remap[i]) * vertexSize], &vertexData[i * vertexSize], vertexSize);
+        }
+    }
+
+    vertexData.swap(remapped);
+}
+
+//------------------------------------------------------------------------------
+const MeshOptimizationReport OptimizeMesh(std::vector<unsigned char> & vertexData,
+                                          const unsigned vertexSize,
+                                          std::vector<Index> & indices)
+{
+    MeshOptimizationReport report;
+
+    if( indices.empty() || vertexSize == 0 )
+    {
+        return report;
+    }
+
+    const unsigned numVertices = static_cast<unsigned>(vertexData.size() / vertexSize);
+
+    report.m_before             = AnalyzeVertexCache(indices, numVertices);
+    report.m_numLeftoverIndices = static_cast<unsigned>(indices.size() % 3);
+
+    if( report.m_numLeftoverIndices )
+    {
+        WarnOfLeftoverIndices(indices.size());
+    }
+
+    OptimizeVertexCache(indices, numVertices);
+
+    std::vector<Index> remap;
+    const unsigned     numNewVertices = OptimizeVertexFetch(indices, numVertices, remap);
+    RemapInterleavedVertices(vertexData, vertexSize, remap, numNewVertices);
+
+    report.m_after = AnalyzeVertexCache(indices, numNewVertices);
+
+    return report;
+}
+
+//------------------------------------------------------------------------------
+const MeshOptimizationReport OptimizeMesh(std::vector<Position> & positions,
+                                          std::vector<TexCoord2D> & texCoords,
+                                          std::vector<Normal> & normals,
+                                          std::vector<Index> & indices)
+{
+    MeshOptimizationReport report;
+
+    if( indices.empty() )
+    {
+        return report;
+    }
+
+    if( texCoords.size() != positions.size() || normals.size() != positions.size() )
+    {
+        const std::string msg("Cannot optimize a mesh whose vertex streams have different numbers of elements");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    const unsigned numVertices = static_cast<unsigned>(positions.size());
+
+    report.m_before             = AnalyzeVertexCache(indices, numVertices);
+    report.m_numLeftoverIndices = static_cast<unsigned>(indices.size() % 3);
+
+    if( report.m_numLeftoverIndices )
+    {
+        WarnOfLeftoverIndices(indices.size());
+    }
+
+    OptimizeVertexCache(indices, numVertices);
+
+    std::vector<Index> remap;
+    const unsigned     numNewVertices = OptimizeVertexFetch(indices, numVertices, remap);
+    RemapVertices(positions, remap, numNewVertices);
+    RemapVertices(texCoords, remap, numNewVertices);
+    RemapVertices(normals, remap, numNewVertices);
+
+    report.m_after = AnalyzeVertexCache(indices, numNewVertices);
+
+    return report;
+}
@@ -0,0 +1,147 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+// EngineX Includes
+#include "Graphics\3D\Buffers.h"
+
+// Standard Includes
+#include <cstddef>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Optimizations for indexed triangle lists, so that the GPU transforms and fetches as few vertices as possible
+//
+// The usual order of operations is OptimizeVertexCache, which reorders triangles, followed by OptimizeVertexFetch, 
+// which reorders vertices to match. OptimizeMesh does both and reports the effect.
+//
+
+/**
+* Measure of how well an index list uses a post-transform vertex cache
+**/
+struct VertexCacheStatistics
+{
+   VertexCacheStatistics();
+
+   unsigned m_numTriangles;       // Number of triangles in the index list
+   unsigned m_numVerticesUsed;    // Number of unique vertices referenced by the index list
+   unsigned m_numTransformed;     // Number of times a vertex had to be transformed
+   float    m_acmr;               // Average cache miss ratio. Vertices transformed per triangle. Lower is better, 3 is worst.
+   float    m_atvr;               // Average transformed vertex ratio. Vertices transformed per vertex used. 1 is ideal.
+};
+
+/**
+* Statistics of a mesh before and after it was optimized
+**/
+struct MeshOptimizationReport
+{
+   MeshOptimizationReport();
+
+   VertexCacheStatistics m_before;
+   VertexCacheStatistics m_after;
+   unsigned              m_numLeftoverIndices;   // Indices after the last whole triangle, left where they were. 0 unless the source was malformed.
+};
+
+/**
+* Simulates a FIFO post-transform vertex cache to measure how well an index list uses it
+*
+* @param indices     - Indexed triangle list
+* @param numVertices - Number of vertices the indices refer to
+* @param cacheSize   - Number of entries in the simulated cache
+*
+* @throws BaseException - If an index is out of range
+**/
+const VertexCacheStatistics AnalyzeVertexCache(const std::vector<Index> & indices,
+                                               const unsigned numVertices,
+                                               const unsigned cacheSize = 16);
+
+/**
+* Reorders the triangles of an indexed triangle list so that vertices are reused while still in the post-transform cache
+*
+* Uses Tom Forsyth's linear-speed vertex cache optimisation, which does not depend on the exact size of the cache.
+* If the number of indices is not a multiple of 3, the whole triangles are reordered and the indices left over
+* stay at the end, as they were.
+*
+* @param indices     - IN/OUT - Indexed triangle list
+* @param numVertices - Number of vertices the indices refer to
+*
+* @throws BaseException - If an index is out of range
+**/
+void OptimizeVertexCache(std::vector<Index> & indices, const unsigned numVertices);
+
+/**
+* Builds a remap of vertices to the order they are first referenced by an index list and rewrites the indices to match
+*
+* Vertices that are never referenced are dropped. Apply the remap to the vertex data with RemapVertices or
+* RemapInterleavedVertices.
+*
+* @param indices     - IN/OUT - Indexed triangle list
+* @param numVertices - Number of vertices the indices refer to
+* @param remap       - OUT - New index of each old vertex, or 0xFFFFFFFF if it was dropped
+* @return            - Number of vertices after the remap
+*
+* @throws BaseException - If an index is out of range
+**/
+const unsigned OptimizeVertexFetch(std::vector<Index> & indices,
+                                   const unsigned numVertices,
+                                   std::vector<Index> & remap);
+
+/**
+* Reorders interleaved vertices according to a remap built by OptimizeVertexFetch
+**/
+void RemapInterleavedVertices(std::vector<unsigned char> & vertexData,
+                              const unsigned vertexSize,
+                              const std::vector<Index> & remap,
+                              const unsigned numNewVertices);
+
+/**
+* Reorders one stream of vertex data according to a remap built by OptimizeVertexFetch
+**/
+template<typename T>
+void RemapVertices(std::vector<T> & vertices,
+                   const std::vector<Index> & remap,
+                   const unsigned numNewVertices)
+{
+   std::vector<T> remapped(numNewVertices);
+
+   for(size_t i = 0; i < remap.size() && i < vertices.size(); ++i)
+   {
+      if( remap[i] != 0xFFFFFFFF )
+      {
+         remapped[remap[i]] = vertices[i];
+      }
+   }
+
+   vertices.swap(remapped);
+}
+
+/**
+* Optimizes an indexed triangle list made of interleaved vertices for the vertex cache and for vertex fetch
+*
+* Indices after the last whole triangle are kept, and counted in the report. On Windows, a warning is also written
+* to the debugger output, as that is a sign the source file was malformed.
+*
+* @param vertexData - IN/OUT - Interleaved vertices
+* @param vertexSize - Size in bytes of one vertex
+* @param indices    - IN/OUT - Indexed triangle list
+*
+* @throws BaseException - If the indices are not a valid triangle list for the vertices
+**/
+const MeshOptimizationReport OptimizeMesh(std::vector<unsigned char> & vertexData,
+                                          const unsigned vertexSize,
+                                          std::vector<Index> & indices);
+
+/**
+* Optimizes an indexed triangle list, such as one created by GenerateSphere, for the vertex cache and for vertex fetch
+*
+* Meshes without indices, such as the triangle strip created by GenerateQuad, are left as they are.
+*
+* @throws BaseException - If the indices are not a valid triangle list for the vertices
+**/
+const MeshOptimizationReport OptimizeMesh(std::vector<Position> & positions,
+                                          std::vector<TexCoord2D> & texCoords,
+                                          std::vector<Normal> & normals,
+                                          std::vector<Index> & indices);
+
+
+
+#endif // MESHOPTIMIZER_H
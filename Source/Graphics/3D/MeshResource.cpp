@@ -0,0 +1,552 @@
+
+#include "MeshResource.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <sstream>
+
+//----------------------------------------------------------------------------------------------------------------------
+MeshResource::Submesh::Submesh(const unsigned firstIndex, const unsigned numIndices, const Material & material)
+    :
+    m_firstIndex(firstIndex),
+    m_numIndices(numIndices),
+    m_material  (material)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MeshResource::MeshResource(EffectManager & effectManager,
+                           InputLayoutManager & inputLayoutManager,
+                           const std::vector<Buffer::SharedPtr> & buffers,
+                           const D3D10_PRIMITIVE_TOPOLOGY topology)
+    :
+    m_effectManager     (effectManager),
+    m_inputLayoutManager(inputLayoutManager),
+    m_primitiveTopology (topology),
+    m_positionsQuantized(false),
+    m_texCoordDequantization(1.0f, 1.0f, 0.0f, 0.0f)
+{
+    D3DXMatrixIdentity(&m_positionDequantization);
+
+    // Store the buffers
+    for( std::vector<Buffer::SharedPtr>::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+    {
+        // At render time, the PolygonSet can be drawn using indices or with a regular draw call
+        // If an index buffer is provided then we know to draw this PolygonSet using indices
+        // A check will be made at render time to see if an index buffer has been set or not
+        //
+        // Seperate the vertex buffers from the index buffer, if an index buffer was provided
+        if( (*it)->GetContentType() == INDEX )
+        {
+            if( m_indexBuffer )
+            {
+                const std::string msg("Only one index buffer is permitted");
+                throw Common::Exception(__FILE__, __LINE__, msg);
+            }
+
+            m_indexBuffer = (*it);
+            continue;
+        }
+
+        // Currently, per instance data is not supported using this class
+        if( (*it)->IsPerInstance() )
+        {
+            const std::string msg("Currently, per instance data is not supported using this class");
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        m_vertexBuffers.push_back(*it);
+    }
+
+    // Check that we have at least one vertex buffer
+    if( m_vertexBuffers.empty() )
+    {
+        const std::string msg("No vertex buffer was provided");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Check that all vertex buffers have the same number of elements
+    unsigned numVertices = m_vertexBuffers[0]->GetNumElements();
+
+    for(std::vector<Buffer::SharedPtr>::const_iterator it = m_vertexBuffers.begin(); it != m_vertexBuffers.end(); ++it)
+    {
+        if( (*it)->GetNumElements() != numVertices )
+        {
+            const std::string msg("Not all vertex buffers, containing per vertex data, contain the same number of elements");
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+    }
+
+    // Bound the geometry by its positions, if the buffer holding them knows their bounds
+    for(std::vector<Buffer::SharedPtr>::const_iterator it = m_vertexBuffers.begin(); it != m_vertexBuffers.end(); ++it)
+    {
+        if( (*it)->GetContentType() == POSITION )
+        {
+            m_bounds = (*it)->GetBounds();
+            break;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MeshResource::MeshResource(const MeshResource & rhs)
+    :
+    m_effectManager         (rhs.m_effectManager),
+    m_inputLayoutManager    (rhs.m_inputLayoutManager),
+    m_vertexBuffers         (rhs.m_vertexBuffers),
+    m_indexBuffer           (rhs.m_indexBuffer),
+    m_primitiveTopology     (rhs.m_primitiveTopology),
+    m_bounds                (rhs.m_bounds),
+    m_levelOfDetailBuffers  (rhs.m_levelOfDetailBuffers),
+    m_levelOfDetailErrors   (rhs.m_levelOfDetailErrors),
+    m_clusters              (rhs.m_clusters),
+    m_submeshes             (rhs.m_submeshes),
+    m_positionsQuantized    (rhs.m_positionsQuantized),
+    m_positionDequantization(rhs.m_positionDequantization),
+    m_texCoordDequantization(rhs.m_texCoordDequantization),
+    m_perPassInfo           (rhs.m_perPassInfo)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MeshResource::~MeshResource()
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshResource::SetLevelsOfDetail(const std::vector<Buffer::SharedPtr> & indexBuffers,
+                                     const std::vector<float> & errors)
+{
+    if( !m_indexBuffer )
+    {
+        const std::string msg("Levels of detail require the full detail geometry to have an index buffer");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( !m_submeshes.empty() )
+    {
+        const std::string msg("Levels of detail cannot be combined with submeshes");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( indexBuffers.size() != errors.size() )
+    {
+        const std::string msg("Each level of detail requires an error");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    for(std::vector<Buffer::SharedPtr>::const_iterator it = indexBuffers.begin(); it != indexBuffers.end(); ++it)
+    {
+        if( (*it)->GetContentType() != INDEX )
+        {
+            const std::string msg("A level of detail was provided that is not an index buffer");
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+    }
+
+    m_levelOfDetailBuffers = indexBuffers;
+    m_levelOfDetailErrors  = errors;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshResource::SetClusters(const std::vector<MeshCluster> & clusters)
+{
+    if( !m_indexBuffer )
+    {
+        const std::string msg("Clusters require the geometry to have an index buffer");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( !m_submeshes.empty() )
+    {
+        const std::string msg("Clusters cannot be combined with submeshes");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    const unsigned numIndices = m_indexBuffer->GetNumElements();
+
+    for(std::vector<MeshCluster>::const_iterator it = clusters.begin(); it != clusters.end(); ++it)
+    {
+        if( it->m_firstIndex > numIndices || it->m_numIndices > numIndices - it->m_firstIndex )
+        {
+            const std::string msg("A cluster was provided that lies outside of the index buffer");
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+    }
+
+    m_clusters = clusters;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshResource::SetSubmeshes(const std::vector<Submesh> & submeshes)
+{
+    if( !m_indexBuffer )
+    {
+        const std::string msg("Submeshes require the geometry to have an index buffer");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( !m_levelOfDetailBuffers.empty() || !m_clusters.empty() )
+    {
+        const std::string msg("Submeshes cannot be combined with levels of detail or clusters");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    const unsigned numIndices = m_indexBuffer->GetNumElements();
+
+    for(std::vector<Submesh>::const_iterator it = submeshes.begin(); it != submeshes.end(); ++it)
+    {
+        if( it->m_firstIndex > numIndices || it->m_numIndices > numIndices - it->m_firstIndex )
+        {
+            const std::string msg("A submesh was provided that lies outside of the index buffer");
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+    }
+
+    m_submeshes = submeshes;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshResource::SetPositionDequantization(const float scale, const D3DXVECTOR3 & bias)
+{
+    D3DXMATRIX scaling;
+    D3DXMATRIX translation;
+
+    D3DXMatrixScaling(&scaling, scale, scale, scale);
+    D3DXMatrixTranslation(&translation, bias.x, bias.y, bias.z);
+
+    m_positionDequantization = scaling * translation;
+    m_positionsQuantized     = true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshResource::SetTexCoordDequantization(const D3DXVECTOR2 & scale, const D3DXVECTOR2 & bias)
+{
+    m_texCoordDequantization = D3DXVECTOR4(scale.x, scale.y, bias.x, bias.y);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MeshResource::PerPassInfo MeshResource::GetPerPassInfo(const std::string & effectName, const std::string & techniqueName) const
+{
+    const std::pair<std::string, std::string> key(effectName, techniqueName);
+
+    PerPassInfoMap::const_iterator it = m_perPassInfo.find(key);
+
+    if( it != m_perPassInfo.end() )
+    {
+        return it->second;
+    }
+
+    // Validate the buffers against the technique, the first time it is asked for
+    std::shared_ptr<std::vector<PassInfo> > perPassInfo(new std::vector<PassInfo>());
+
+    try
+    {
+        CreatePerPassInfo(effectName, techniqueName, *perPassInfo);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    m_perPassInfo[key] = perPassInfo;
+
+    return perPassInfo;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::vector<Buffer::SharedPtr> & MeshResource::GetVertexBuffers() const
+{
+    return m_vertexBuffers;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const Buffer::SharedPtr & MeshResource::GetIndexBuffer() const
+{
+    return m_indexBuffer;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const D3D10_PRIMITIVE_TOPOLOGY MeshResource::GetPrimitiveTopology() const
+{
+    return m_primitiveTopology;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const BoundingVolume & MeshResource::GetBounds() const
+{
+    return m_bounds;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::vector<Buffer::SharedPtr> & MeshResource::GetLevelOfDetailBuffers() const
+{
+    return m_levelOfDetailBuffers;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::vector<float> & MeshResource::GetLevelOfDetailErrors() const
+{
+    return m_levelOfDetailErrors;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::vector<MeshCluster> & MeshResource::GetClusters() const
+{
+    return m_clusters;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::vector<MeshResource::Submesh> & MeshResource::GetSubmeshes() const
+{
+    return m_submeshes;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const bool MeshResource::IsPositionQuantized() const
+{
+    return m_positionsQuantized;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const D3DXMATRIX & MeshResource::GetPositionDequantization() const
+{
+    return m_positionDequantization;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const D3DXVECTOR4 & MeshResource::GetTexCoordDequantization() const
+{
+    return m_texCoordDequantization;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshResource::CreatePerPassInfo(const std::string & effectName,
+                                     const std::string & techniqueName,
+                                     std::vector<PassInfo> & perPassInfo) const
+{
+    perPassInfo.clear();
+
+    // Validate the buffers against the technique
+    Technique * technique = NULL;
+
+    try
+    {
+        Effect & effect = m_effectManager.GetChildEffect(effectName);
+        technique       = &(effect.GetTechnique(techniqueName));
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    // Go through each pass of the technique
+    for(unsigned passIndex = 0; passIndex < technique->GetNumPasses(); ++passIndex)
+    {
+        Pass * pass = NULL;                         // The pass we are verifying
+        std::vector<unsigned> vertexBufferIndices;  // Indices to vertex buffers that fulfill requirements of this pass
+
+        try
+        {
+            pass = &(technique->GetPass(passIndex));
+        }
+        catch(Common::Exception & e)
+        {
+            throw e;
+        }
+
+        // Make a copy of the requirements, describing the vertex data a technique expects.
+        // A requirement will be removed when it is matched with a vertex buffer
+        std::vector<D3D10_SIGNATURE_PARAMETER_DESC> requirements;
+        requirements = pass->GetSignatureParamDescs();
+
+        // Make a copy of the available buffer indices
+        // An index will be removed when it is matched with a requirement
+        std::vector<unsigned> availableIndices;
+
+        for(unsigned i = 0; i < m_vertexBuffers.size(); ++i)
+        {
+            availableIndices.push_back(i);
+        }
+
+        // Keeps track of which slot the provided buffer will take
+        // I simply increment this for every buffer I provide
+        unsigned inputSlot = 0;
+
+        // This map will keep track of the last semantic index of each provided buffer
+        // This way I can keep track of what semantic index is being provided and if it matches
+        // the requested semantic index.
+        //
+        // key- semantic name
+        // value - number of times that semantic has already been provided
+        std::map<std::string, unsigned> providedSemantics;
+
+        // This vector is used to build the input layout
+        // It holds descriptions of what each buffer contains, as we provide each buffer
+        std::vector<InputElementDescription> inputElementDescs;
+
+        // Go though the requirements and look for a match from the provided buffers
+        while( !requirements.empty() )
+        {
+            // Get the first requirement
+            std::string semanticName  = requirements.front().SemanticName;
+            unsigned    semanticIndex = requirements.front().SemanticIndex;
+
+            // Check that the requested semantic index matches what we have provided so far
+            if( semanticIndex )
+            {
+            std::map<std::string, unsigned>::iterator it = providedSemantics.end();
+
+            if( !providedSemantics.empty() )
+            {
+                it = providedSemantics.find(semanticName);
+            }
+
+            if( it == providedSemantics.end() ||
+                it->second != semanticIndex - 1 )
+            {
+                const std::string msg = "A semantic has been requested by the technique with an index that does not "
+                                        "match how many times the semantic has been provided already."
+                                        "Check vertex buffer inputs to effect: " + effectName + " "
+                                        "technique: " + techniqueName + ", and that vertex buffers were provided by "
+                                        "the application in the correct order.";  // phew what an error message!
+                throw Common::Exception(__FILE__, __LINE__, msg);
+            }
+            }
+
+            // Search for a provided buffer with a matching semantic name
+            int  index;
+            bool found = false;
+
+            for(std::vector<unsigned>::iterator itAvailableIndex = availableIndices.begin();
+                itAvailableIndex != availableIndices.end(); ++itAvailableIndex)
+            {
+            index = (*itAvailableIndex);
+
+            // Check if the content type the buffer offers matches the semantic name we are looking for
+            if( ContentTypeToSemanticName(m_vertexBuffers[index]->GetContentType()) == semanticName )
+            {
+                // Found a match
+                found = true;
+
+                // Remove the index from available indices for future searched
+                availableIndices.erase(itAvailableIndex);
+
+                break;
+            }
+            }
+
+            if( !found )
+            {
+            // Cannot provide the vertex buffer type required by the technique
+            std::stringstream msg;
+            msg << "The provided vertexs buffers do not contain a vertex buffer type required "
+                << "by the chosen technique."
+                << "\nSemanticName: " << semanticName;
+
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+
+            // We have a match
+
+            // Store the index to the vertex buffer fulfilling the requirement
+            vertexBufferIndices.push_back(index);
+
+            // Create an input element description
+            std::vector<InputElementDescription> thisElementDesc;
+
+            InputElementDescription::GetInputElementDesc(thisElementDesc,
+                                                        m_vertexBuffers[index]->GetContentType(),
+                                                        semanticIndex,
+                                                        inputSlot,
+                                                        m_vertexBuffers[index]->IsPerInstance());
+
+            // Store the input element description
+            inputElementDescs.insert(inputElementDescs.end(), thisElementDesc.begin(), thisElementDesc.end());
+
+            // Remove requirement
+            unsigned numRequirementsToRemove = static_cast<unsigned>(thisElementDesc.size());
+
+            requirements.erase(requirements.begin(), requirements.begin() + numRequirementsToRemove);
+
+            // Increment the input slot for the next vertex buffer
+            ++inputSlot;
+
+            // Increment the semantic index for vertex buffers with the same semantic
+            providedSemantics[semanticName] = semanticIndex;
+        }
+
+        // Get or create an input layout that matches this input element description
+        ID3D10InputLayout * inputLayout = m_inputLayoutManager.GetInputLayout(inputElementDescs, *pass);
+
+        // Gather the D3D buffers, offsets, and strides
+        //
+        // Buffers that share interleaved data are bound to their own slot, at the offset of their element
+        std::vector<ID3D10Buffer *> d3dBuffers;
+        std::vector<unsigned>       offsets;
+        std::vector<unsigned>       strides;
+
+        for(std::vector<unsigned>::iterator it = vertexBufferIndices.begin(); it != vertexBufferIndices.end(); ++it)
+        {
+            unsigned index = *it;
+            d3dBuffers.push_back(m_vertexBuffers[index]->GetD3DBuffer());
+            offsets.push_back(m_vertexBuffers[index]->GetByteOffset());
+            strides.push_back(m_vertexBuffers[index]->GetByteStride());
+        }
+
+        // Calculate how many vertices will be drawn this pass
+        unsigned numVertices = m_vertexBuffers[vertexBufferIndices[0]]->GetNumElements();
+
+        // Store the filled out pass info
+        PassInfo passInfo(pass, vertexBufferIndices, d3dBuffers, offsets, strides, inputLayout, numVertices);
+        perPassInfo.push_back(passInfo);
+   }
+}
+
+//------------------------------------------------------------------------------------------
+MeshResource::PassInfo::PassInfo(Pass * pass,
+                                 const std::vector<unsigned> & vertexBufferIndices,
+                                 const std::vector<ID3D10Buffer *> & d3dBuffers,
+                                 const std::vector<unsigned> & offsets,
+                                 const std::vector<unsigned> & strides,
+                                 ID3D10InputLayout * inputLayout,
+                                 unsigned numVertices)
+    :
+    m_pass               (pass),
+    m_vertexBufferIndices(vertexBufferIndices),
+    m_d3dBuffers         (d3dBuffers),
+    m_offsets            (offsets),
+    m_strides            (strides),
+    m_inputLayout        (inputLayout),
+    m_numVertices        (numVertices)
+{
+}
+
+//------------------------------------------------------------------------------------------
+MeshResource::PassInfo::PassInfo(const PassInfo & rhs)
+    :
+    m_pass               (rhs.m_pass),
+    m_vertexBufferIndices(rhs.m_vertexBufferIndices),
+    m_d3dBuffers         (rhs.m_d3dBuffers),
+    m_offsets            (rhs.m_offsets),
+    m_strides            (rhs.m_strides),
+    m_inputLayout        (rhs.m_inputLayout),
+    m_numVertices        (rhs.m_numVertices)
+{
+}
+
+//------------------------------------------------------------------------------------------
+MeshResource::PassInfo & MeshResource::PassInfo::operator = (const PassInfo & rhs)
+{
+    m_pass                = rhs.m_pass;
+    m_vertexBufferIndices = rhs.m_vertexBufferIndices;
+    m_d3dBuffers          = rhs.m_d3dBuffers;
+    m_offsets             = rhs.m_offsets;
+    m_strides             = rhs.m_strides;
+    m_inputLayout         = rhs.m_inputLayout;
+    m_numVertices         = rhs.m_numVertices;
+
+    return *this;
+}
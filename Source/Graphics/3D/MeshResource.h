@@ -0,0 +1,219 @@
+#ifndef MESHRESOURCE_H
+#define MESHRESOURCE_H
+
+// EngineX Includes
+#include "Graphics\3D\BoundingVolume.h"
+#include "Graphics\3D\Buffers.h"
+#include "Graphics\3D\InputLayoutManager.h"
+#include "Graphics\3D\MeshClusterer.h"
+#include "Graphics\Effects\EffectManager.h"
+#include "Graphics\Effects\Effect.h"
+#include "Graphics\Effects\Material.h"
+
+// DirectX Includes
+#include <d3d10.h>
+#include <d3dx10.h>
+
+// Standard Includes
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+/**
+* The geometry of a polygon set, shared between every polygon set drawn with it
+*
+* Holds the buffers, along with the levels of detail, clusters, and submeshes that refer to them, and the
+* information needed to bind the buffers to each pass of a technique. That information is worked out, and the
+* buffers validated against the technique, the first time a technique is asked for. Every polygon set using the
+* same mesh resource and technique after that shares it, so copying a polygon set costs no validation at all.
+*
+* A mesh resource is not changed once it is shared. PolygonSet copies it before changing it, if any other
+* polygon set refers to it. It must only be used from the thread that owns the device.
+**/
+class MeshResource
+{
+public:
+
+   typedef std::shared_ptr<MeshResource> SharedPtr;
+
+   /**
+   * A range of the index buffer that is drawn with a material of its own
+   **/
+   struct Submesh
+   {
+      /**
+      * Constructor
+      **/
+      Submesh(const unsigned firstIndex, const unsigned numIndices, const Material & material);
+
+
+      unsigned m_firstIndex;   // Where the submesh starts in the index buffer
+      unsigned m_numIndices;
+      Material m_material;     // Material the range is drawn with, in place of the polygon set's own
+   };
+
+   /**
+   * Container for data needed to render a single pass
+   **/
+   struct PassInfo
+   {
+      PassInfo(Pass * pass,
+               const std::vector<unsigned> & vertexBufferIndices,
+               const std::vector<ID3D10Buffer *> & d3dBuffers,
+               const std::vector<unsigned> & offsets,
+               const std::vector<unsigned> & strides,
+               ID3D10InputLayout * inputLayout,
+               const unsigned numVertices);
+
+      PassInfo(const PassInfo & rhs);
+      PassInfo & operator = (const PassInfo & rhs);
+
+      // TODO - Pass and InputLayout are candidates for a shared pointer
+
+      Pass *                      m_pass;                   // A single pass from a technique
+      std::vector<unsigned>       m_vertexBufferIndices;    // Which buffers provide the data required for the pass
+      std::vector<ID3D10Buffer *> m_d3dBuffers;             // D3D buffers of those, in the order they are bound
+      std::vector<unsigned>       m_offsets;                // For each vertex buffer, how many bytes in to start from
+      std::vector<unsigned>       m_strides;                // For each vertex buffer, the size in bytes of one element
+      ID3D10InputLayout *         m_inputLayout;            // Input layout used for a specific pass
+      unsigned                    m_numVertices;            // Number of vertices to draw this pass
+   };
+
+   /**
+   * Information needed to render each pass of a technique
+   **/
+   typedef std::shared_ptr<const std::vector<PassInfo> > PerPassInfo;
+
+   /**
+   * Constructor
+   *
+   * The local bounds are taken from the POSITION buffer. They are left empty if it does not know them,
+   * as for interleaved buffers.
+   *
+   * @param buffers  - Vertex buffers, and at most one index buffer
+   * @param topology - How the vertices are assembled into primitives
+   *
+   * @throws BaseException - If there is no vertex buffer, more than one index buffer, a buffer of per instance data,
+   *                         or vertex buffers that do not all hold the same number of vertices
+   **/
+   MeshResource(EffectManager & effectManager,
+                InputLayoutManager & inputLayoutManager,
+                const std::vector<Buffer::SharedPtr> & buffers,
+                const D3D10_PRIMITIVE_TOPOLOGY topology);
+
+   /**
+   * Copy Constructor
+   *
+   * The copy shares the buffers, and the information for the techniques already asked for.
+   **/
+   MeshResource(const MeshResource & rhs);
+
+   /**
+   * Deconstructor
+   **/
+   ~MeshResource();
+
+
+   /**
+   * Sets simplified versions of the geometry (see PolygonSet::SetLevelsOfDetail)
+   *
+   * @throws BaseException - If there is no index buffer, a buffer is not an index buffer,
+   *                         there is not one error for each buffer, or there are submeshes set
+   **/
+   void SetLevelsOfDetail(const std::vector<Buffer::SharedPtr> & indexBuffers,
+                          const std::vector<float> & errors);
+
+   /**
+   * Sets clusters of the index buffer (see PolygonSet::SetClusters)
+   *
+   * @throws BaseException - If there is no index buffer, a cluster lies outside of it, or there are submeshes set
+   **/
+   void SetClusters(const std::vector<MeshCluster> & clusters);
+
+   /**
+   * Splits the index buffer into submeshes (see PolygonSet::SetSubmeshes)
+   *
+   * @throws BaseException - If there is no index buffer, a submesh lies outside of it,
+   *                         or there are levels of detail or clusters set
+   **/
+   void SetSubmeshes(const std::vector<Submesh> & submeshes);
+
+   /**
+   * Sets how to decode positions that were quantized (see PolygonSet::SetPositionDequantization)
+   **/
+   void SetPositionDequantization(const float scale, const D3DXVECTOR3 & bias);
+
+   /**
+   * Sets how to decode texture coordinates that were quantized (see PolygonSet::SetTexCoordDequantization)
+   **/
+   void SetTexCoordDequantization(const D3DXVECTOR2 & scale, const D3DXVECTOR2 & bias);
+
+
+   /**
+   * Gets the information needed to render each pass of a technique, working it out the first time it is asked for
+   *
+   * @throws BaseException - If the effect or technique does not exist, or the vertex buffers do not provide
+   *                         all of the data the technique requires
+   **/
+   PerPassInfo GetPerPassInfo(const std::string & effectName, const std::string & techniqueName) const;
+
+   const std::vector<Buffer::SharedPtr> & GetVertexBuffers() const;
+   const Buffer::SharedPtr &              GetIndexBuffer() const;
+   const D3D10_PRIMITIVE_TOPOLOGY         GetPrimitiveTopology() const;
+   const BoundingVolume &                 GetBounds() const;
+
+   const std::vector<Buffer::SharedPtr> & GetLevelOfDetailBuffers() const;
+   const std::vector<float> &             GetLevelOfDetailErrors() const;
+
+   const std::vector<MeshCluster> &       GetClusters() const;
+   const std::vector<Submesh> &           GetSubmeshes() const;
+
+   const bool                             IsPositionQuantized() const;
+   const D3DXMATRIX &                     GetPositionDequantization() const;
+   const D3DXVECTOR4 &                    GetTexCoordDequantization() const;
+
+private:
+
+   /** No assignment allowed */
+   MeshResource & operator = (const MeshResource & rhs);
+
+   /**
+   * Validates the buffers against a technique and works out how to bind them for each of its passes
+   **/
+   void CreatePerPassInfo(const std::string & effectName,
+                          const std::string & techniqueName,
+                          std::vector<PassInfo> & perPassInfo) const;
+
+
+   EffectManager &                 m_effectManager;       // Contains the effects that techniques are looked up in
+   InputLayoutManager &            m_inputLayoutManager;  // Contains and creates input layouts for shaders
+
+   std::vector<Buffer::SharedPtr>  m_vertexBuffers;       // All provided vertex buffers
+   Buffer::SharedPtr               m_indexBuffer;         // Index buffer, NULL if not indexed
+   D3D10_PRIMITIVE_TOPOLOGY        m_primitiveTopology;   // What kind of primitives the vertex buffer hold
+   BoundingVolume                  m_bounds;              // Bounds of the positions, if the POSITION buffer knows them
+
+   std::vector<Buffer::SharedPtr>  m_levelOfDetailBuffers;    // Index buffers of simplified versions of the geometry, finest first
+   std::vector<float>              m_levelOfDetailErrors;     // How far, in object space, each of those strays from the full detail geometry
+
+   std::vector<MeshCluster>        m_clusters;                // Ranges of the index buffer that can be culled on their own
+   std::vector<Submesh>            m_submeshes;               // Ranges of the index buffer with a material each, if split
+
+   bool                            m_positionsQuantized;      // Whether or not the positions need to be decoded
+   D3DXMATRIX                      m_positionDequantization;  // Decodes quantized positions into object space
+   D3DXVECTOR4                     m_texCoordDequantization;  // Decodes quantized texture coordinates, scale in xy and bias in zw
+
+   /**
+   * Information for each technique that was asked for
+   *
+   * Key   - effect name and technique name
+   * Value - information needed to render each pass of the technique
+   **/
+   typedef std::map<std::pair<std::string, std::string>, PerPassInfo> PerPassInfoMap;
+   mutable PerPassInfoMap          m_perPassInfo;
+};
+
+#endif // MESHRESOURCE_H
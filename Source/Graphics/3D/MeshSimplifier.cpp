@@ -0,0 +1,951 @@
+// Project Includes
+#include "MeshSimplifier.h"
+
+// EngineX Includes
+#include "Graphics\3D\MeshOptimizer.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    const double BORDER_WEIGHT   = 10.0;    // Weight of the planes that hold open borders in place, relative to the triangles
+    const double ATTRIBUTE_SCALE = 0.05;    // Fraction of the size of the mesh that moving costs as much as a unit of attribute difference
+    const double MIN_NORMAL_DOT  = 0.25;    // A collapse may not turn the normal of a triangle further than this cosine
+
+    //--------------------------------------------------------------------------
+    /**
+    * Symmetric 4x4 matrix that gives the sum of the weighted squared distances of a point to a set of planes
+    **/
+    struct Quadric
+    {
+        Quadric()
+        {
+            memset(m_coefficients, 0, sizeof(m_coefficients));
+        }
+
+        /**
+        * Quadric of the plane ax + by + cz + d = 0, where (a, b, c) is unit length
+        **/
+        Quadric(const double a, const double b, const double c, const double d, const double weight)
+        {
+            m_coefficients[0] = a * a * weight;
+            m_coefficients[1] = a * b * weight;
+            m_coefficients[2] = a * c * weight;
+            m_coefficients[3] = a * d * weight;
+            m_coefficients[4] = b * b * weight;
+            m_coefficients[5] = b * c * weight;
+            m_coefficients[6] = b * d * weight;
+            m_coefficients[7] = c * c * weight;
+            m_coefficients[8] = c * d * weight;
+            m_coefficients[9] = d * d * weight;
+        }
+
+        void Add(const Quadric & rhs)
+        {
+            for(unsigned i = 0; i < 10; ++i)
+            {
+                m_coefficients[i] += rhs.m_coefficients[i];
+            }
+        }
+
+        const double Evaluate(const Position & point) const
+        {
+            const double x = point.x;
+            const double y = point.y;
+            const double z = point.z;
+            const double * q = m_coefficients;
+
+            const double result = x * x * q[0] + 2.0 * x * y * q[1] + 2.0 * x * z * q[2] + 2.0 * x * q[3]
+                                + y * y * q[4] + 2.0 * y * z * q[5] + 2.0 * y * q[6]
+                                + z * z * q[7] + 2.0 * z * q[8]
+                                + q[9];
+
+            // Rounding can take it just below zero
+            return result > 0.0 ? result : 0.0;
+        }
+
+        double m_coefficients[10];   // a2, ab, ac, ad, b2, bc, bd, c2, cd, d2
+    };
+
+    //--------------------------------------------------------------------------
+    /**
+    * Moving one position onto another
+    **/
+    struct Collapse
+    {
+        unsigned m_from;
+        unsigned m_to;
+        double   m_cost;
+
+        const bool operator < (const Collapse & rhs) const
+        {
+            return m_cost < rhs.m_cost;
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    /**
+    * Finds where a type of content lies in an interleaved vertex
+    *
+    * @return The offset in bytes, or -1 if the vertex does not contain it
+    **/
+    const int FindContentOffset(const std::vector<BufferContentType> & contentTypes, const BufferContentType contentType)
+    {
+        unsigned offset = 0;
+
+        for(std::vector<BufferContentType>::const_iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+        {
+            if( *it == contentType )
+            {
+                return static_cast<int>(offset);
+            }
+
+            offset += GetStride(*it);
+        }
+
+        return -1;
+    }
+
+    //--------------------------------------------------------------------------
+    inline const unsigned long long MakeEdgeKey(const unsigned a, const unsigned b)
+    {
+        return a < b ? (static_cast<unsigned long long>(a) << 32) | b
+                     : (static_cast<unsigned long long>(b) << 32) | a;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Simplifies an indexed triangle list in place, one level after another
+    *
+    * Vertices that share a position are called wedges of that position, and the lowest numbered of them stands for
+    * the position. Quadrics, areas, and collapses are all in terms of those positions, while the index list refers
+    * to the wedges.
+    *
+    * Edges are collapsed in passes. Each pass gathers every edge, sorts them by cost, and collapses as many as
+    * needed, cheapest first, skipping any that touch the neighbourhood of one collapsed earlier in the same pass,
+    * so that every collapse can be checked against the mesh as it was at the start of the pass.
+    **/
+    class Simplifier
+    {
+    public:
+
+        Simplifier(const unsigned char * vertexData,
+                   const unsigned numVertices,
+                   const std::vector<BufferContentType> & contentTypes,
+                   const std::vector<Index> & indices);
+
+        /**
+        * Collapses edges until there are no more than the target number of indices, or no edge can be collapsed
+        **/
+        void Simplify(const size_t targetNumIndices);
+
+        const std::vector<Index> & GetIndices() const
+        {
+            return m_indices;
+        }
+
+        const float GetError() const
+        {
+            return static_cast<float>(m_error);
+        }
+
+    private:
+
+        const bool RunPass(const size_t targetNumIndices);
+
+        const double GetCollapseCost(const unsigned from, const unsigned to, const bool borderEdge) const;
+        const bool   IsCollapseValid(const unsigned from, const unsigned to, unsigned & numTrianglesRemoved);
+        void         ApplyCollapse(const unsigned from, const unsigned to);
+
+        const unsigned GetNumWedges(const unsigned position) const;
+        const unsigned FindMatchingWedge(const unsigned wedge, const unsigned position) const;
+        const double   GetAttributeDistanceSquared(const unsigned a, const unsigned b) const;
+
+        void GatherNeighbours(const unsigned position, std::vector<unsigned> & neighbours) const;
+
+        unsigned                   m_numVertices;
+        unsigned                   m_numAttributes;
+        std::vector<Position>      m_positions;           // Position of each vertex
+        std::vector<float>         m_attributes;          // Normal and texture coordinates of each vertex, m_numAttributes apiece
+        std::vector<unsigned>      m_canonical;           // Vertex that stands for the position of each vertex
+        std::vector<unsigned>      m_nextWedge;           // Next vertex at the same position, forming a loop
+
+        std::vector<Quadric>       m_quadrics;            // Error quadric of each position
+        std::vector<double>        m_areas;               // Area of the triangles merged into each position
+        std::vector<unsigned char> m_border;              // Whether each position lies on an open border
+        double                     m_attributeWeight;
+
+        std::vector<Index>         m_indices;             // Current index list
+        double                     m_error;               // Largest error of any collapse so far
+
+        // Per pass
+        std::vector<unsigned>      m_triangleOffsets;     // Where the triangles of each vertex start in m_triangles
+        std::vector<unsigned>      m_triangles;           // Triangles that use each vertex
+        std::vector<unsigned char> m_locked;              // Positions that may not take part in another collapse this pass
+        std::vector<Index>         m_remap;               // Vertex each vertex has been moved onto this pass
+        std::vector<unsigned>      m_moved;               // Vertices that have been moved this pass
+        std::vector<unsigned>      m_neighbours;
+        std::vector<unsigned>      m_otherNeighbours;
+    };
+
+    //--------------------------------------------------------------------------
+    Simplifier::Simplifier(const unsigned char * vertexData,
+                           const unsigned numVertices,
+                           const std::vector<BufferContentType> & contentTypes,
+                           const std::vector<Index> & indices)
+        :
+        m_numVertices    (numVertices),
+        m_numAttributes  (0),
+        m_attributeWeight(0.0),
+        m_indices        (indices),
+        m_error          (0.0)
+    {
+        const int positionOffset = FindContentOffset(contentTypes, POSITION);
+        const int normalOffset   = FindContentOffset(contentTypes, NORMAL);
+        const int texCoordOffset = FindContentOffset(contentTypes, TEXCOORD2D);
+
+        if( positionOffset < 0 )
+        {
+            const std::string msg("Cannot simplify vertices without a position");
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        if( m_indices.size() % 3 )
+        {
+            const std::string msg("Number of indices is not a multiple of 3");
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        for(std::vector<Index>::const_iterator it = m_indices.begin(); it != m_indices.end(); ++it)
+        {
+            if( *it >= numVertices )
+            {
+                std::stringstream msg;
+                msg << "Index " << *it << " is out of range of " << numVertices << " vertices";
+                throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+        }
+
+        // Split out the vertex components
+        unsigned vertexSize = 0;
+
+        for(std::vector<BufferContentType>::const_iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+        {
+            vertexSize += GetStride(*it);
+        }
+
+        m_numAttributes = (normalOffset >= 0 ? 3 : 0) + (texCoordOffset >= 0 ? 2 : 0);
+
+        m_positions.resize(numVertices);
+        m_attributes.resize(static_cast<size_t>(numVertices) * m_numAttributes);
+
+        for(unsigned i = 0; i < numVertices; ++i)
+        {
+            const unsigned char * vertex    = vertexData + static_cast<size_t>(i) * vertexSize;
+            float *               attribute = m_attributes.empty() ? NULL : &m_attributes[static_cast<size_t>(i) * m_numAttributes];
+
+            memcpy(&m_positions[i], vertex + positionOffset, sizeof(Position));
+
+            if( normalOffset >= 0 )
+            {
+                memcpy(attribute, vertex + normalOffset, sizeof(Normal));
+                attribute += 3;
+            }
+
+            if( texCoordOffset >= 0 )
+            {
+                memcpy(attribute, vertex + texCoordOffset, sizeof(TexCoord2D));
+            }
+        }
+
+        // Group the vertices by position
+        std::vector<unsigned> order(numVertices);
+
+        for(unsigned i = 0; i < numVertices; ++i)
+        {
+            order[i] = i;
+        }
+
+        const std::vector<Position> & positions = m_positions;
+
+        std::sort(order.begin(), order.end(), [&positions](const unsigned a, const unsigned b)
+        {
+            const Position & pa = positions[a];
+            const Position & pb = positions[b];
+
+            if( pa.x != pb.x ) return pa.x < pb.x;
+            if( pa.y != pb.y ) return pa.y < pb.y;
+            if( pa.z != pb.z ) return pa.z < pb.z;
+            return a < b;
+        });
+
+        m_canonical.resize(numVertices);
+        m_nextWedge.resize(numVertices);
+
+        for(size_t first = 0; first < order.size(); )
+        {
+            size_t last = first + 1;
+
+            while( last < order.size() && positions[order[last]] == positions[order[first]] )
+            {
+                ++last;
+            }
+
+            for(size_t i = first; i < last; ++i)
+            {
+                m_canonical[order[i]] = order[first];
+                m_nextWedge[order[i]] = order[i + 1 < last ? i + 1 : first];
+            }
+
+            first = last;
+        }
+
+        // Scale attribute differences to the size of the mesh, so the costs do not depend on its units
+        Position boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+        Position boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+        for(unsigned i = 0; i < numVertices; ++i)
+        {
+            D3DXVec3Minimize(&boundsMin, &boundsMin, &m_positions[i]);
+            D3DXVec3Maximize(&boundsMax, &boundsMax, &m_positions[i]);
+        }
+
+        if( numVertices )
+        {
+            const D3DXVECTOR3 extent = boundsMax - boundsMin;
+            m_attributeWeight = D3DXVec3LengthSq(&extent) * ATTRIBUTE_SCALE * ATTRIBUTE_SCALE;
+        }
+
+        // Quadric of each position from the planes of its triangles, weighted by their area
+        m_quadrics.resize(numVertices);
+        m_areas.assign(numVertices, 0.0);
+        m_border.assign(numVertices, 0);
+
+        std::vector<unsigned long long> edges;
+        edges.reserve(m_indices.size());
+
+        for(size_t i = 0; i < m_indices.size(); i += 3)
+        {
+            unsigned corners[3];
+
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                corners[k] = m_canonical[m_indices[i + k]];
+            }
+
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                if( corners[k] != corners[(k + 1) % 3] )
+                {
+                    edges.push_back(MakeEdgeKey(corners[k], corners[(k + 1) % 3]));
+                }
+            }
+
+            const Position & p0 = m_positions[corners[0]];
+            const Position & p1 = m_positions[corners[1]];
+            const Position & p2 = m_positions[corners[2]];
+
+            const double e1[3] = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+            const double e2[3] = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+            double       n[3]  = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+
+            const double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            if( length <= 0.0 )
+            {
+                continue;
+            }
+
+            n[0] /= length;
+            n[1] /= length;
+            n[2] /= length;
+
+            const double  area = length * 0.5;
+            const Quadric plane(n[0], n[1], n[2], -(n[0] * p0.x + n[1] * p0.y + n[2] * p0.z), area);
+
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                m_quadrics[corners[k]].Add(plane);
+                m_areas[corners[k]] += area;
+            }
+        }
+
+        std::sort(edges.begin(), edges.end());
+
+        // Edges used by a single triangle are on an open border. Hold them in place with a plane through the edge,
+        // perpendicular to the triangle.
+        for(size_t i = 0; i < m_indices.size(); i += 3)
+        {
+            unsigned corners[3];
+
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                corners[k] = m_canonical[m_indices[i + k]];
+            }
+
+            const Position & p0 = m_positions[corners[0]];
+            const D3DXVECTOR3 e1 = m_positions[corners[1]] - p0;
+            const D3DXVECTOR3 e2 = m_positions[corners[2]] - p0;
+            D3DXVECTOR3       normal;
+            D3DXVec3Cross(&normal, &e1, &e2);
+
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                const unsigned a = corners[k];
+                const unsigned b = corners[(k + 1) % 3];
+
+                if( a == b )
+                {
+                    continue;
+                }
+
+                const unsigned long long key = MakeEdgeKey(a, b);
+                const std::pair<std::vector<unsigned long long>::const_iterator,
+                                std::vector<unsigned long long>::const_iterator> range = std::equal_range(edges.begin(), edges.end(), key);
+
+                if( range.second - range.first != 1 )
+                {
+                    continue;
+                }
+
+                m_border[a] = 1;
+                m_border[b] = 1;
+
+                const D3DXVECTOR3 edge = m_positions[b] - m_positions[a];
+                D3DXVECTOR3       planeNormal;
+                D3DXVec3Cross(&planeNormal, &edge, &normal);
+
+                const double length = D3DXVec3Length(&planeNormal);
+
+                if( length <= 0.0 )
+                {
+                    continue;
+                }
+
+                const double  nx = planeNormal.x / length;
+                const double  ny = planeNormal.y / length;
+                const double  nz = planeNormal.z / length;
+                const Position & pa = m_positions[a];
+                const Quadric plane(nx, ny, nz, -(nx * pa.x + ny * pa.y + nz * pa.z), D3DXVec3LengthSq(&edge) * BORDER_WEIGHT);
+
+                m_quadrics[a].Add(plane);
+                m_quadrics[b].Add(plane);
+            }
+        }
+
+        m_remap.resize(numVertices);
+
+        for(unsigned i = 0; i < numVertices; ++i)
+        {
+            m_remap[i] = i;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    void Simplifier::Simplify(const size_t targetNumIndices)
+    {
+        while( m_indices.size() > targetNumIndices )
+        {
+            if( !RunPass(targetNumIndices) )
+            {
+                break;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    const bool Simplifier::RunPass(const size_t targetNumIndices)
+    {
+        // Triangles of each vertex
+        m_triangleOffsets.assign(static_cast<size_t>(m_numVertices) + 1, 0);
+
+        for(std::vector<Index>::const_iterator it = m_indices.begin(); it != m_indices.end(); ++it)
+        {
+            ++m_triangleOffsets[*it + 1];
+        }
+
+        for(unsigned i = 0; i < m_numVertices; ++i)
+        {
+            m_triangleOffsets[i + 1] += m_triangleOffsets[i];
+        }
+
+        m_triangles.resize(m_indices.size());
+
+        {
+            std::vector<unsigned> fill(m_triangleOffsets.begin(), m_triangleOffsets.end() - 1);
+
+            for(size_t i = 0; i < m_indices.size(); ++i)
+            {
+                m_triangles[fill[m_indices[i]]++] = static_cast<unsigned>(i / 3);
+            }
+        }
+
+        // Every edge, along with how many triangles use it
+        std::vector<unsigned long long> edges;
+        edges.reserve(m_indices.size());
+
+        for(size_t i = 0; i < m_indices.size(); i += 3)
+        {
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                const unsigned a = m_canonical[m_indices[i + k]];
+                const unsigned b = m_canonical[m_indices[i + (k + 1) % 3]];
+
+                if( a != b )
+                {
+                    edges.push_back(MakeEdgeKey(a, b));
+                }
+            }
+        }
+
+        std::sort(edges.begin(), edges.end());
+
+        // Cheapest direction of each edge
+        std::vector<Collapse> collapses;
+        collapses.reserve(edges.size() / 2);
+
+        for(size_t first = 0; first < edges.size(); )
+        {
+            size_t last = first + 1;
+
+            while( last < edges.size() && edges[last] == edges[first] )
+            {
+                ++last;
+            }
+
+            const unsigned a          = static_cast<unsigned>(edges[first] >> 32);
+            const unsigned b          = static_cast<unsigned>(edges[first] & 0xFFFFFFFF);
+            const bool     borderEdge = (last - first) == 1;
+
+            const double costAB = GetCollapseCost(a, b, borderEdge);
+            const double costBA = GetCollapseCost(b, a, borderEdge);
+
+            if( costAB < DBL_MAX || costBA < DBL_MAX )
+            {
+                Collapse collapse;
+                collapse.m_from = costAB <= costBA ? a : b;
+                collapse.m_to   = costAB <= costBA ? b : a;
+                collapse.m_cost = costAB <= costBA ? costAB : costBA;
+                collapses.push_back(collapse);
+            }
+
+            first = last;
+        }
+
+        std::sort(collapses.begin(), collapses.end());
+
+        // Collapse, cheapest first, until enough triangles are gone
+        m_locked.assign(m_numVertices, 0);
+
+        const size_t numTrianglesToRemove = (m_indices.size() - targetNumIndices + 2) / 3;
+        size_t       numTrianglesRemoved  = 0;
+
+        for(std::vector<Collapse>::const_iterator it = collapses.begin(); it != collapses.end(); ++it)
+        {
+            if( numTrianglesRemoved >= numTrianglesToRemove )
+            {
+                break;
+            }
+
+            if( m_locked[it->m_from] || m_locked[it->m_to] )
+            {
+                continue;
+            }
+
+            unsigned numRemoved = 0;
+
+            if( !IsCollapseValid(it->m_from, it->m_to, numRemoved) )
+            {
+                continue;
+            }
+
+            ApplyCollapse(it->m_from, it->m_to);
+            numTrianglesRemoved += numRemoved;
+        }
+
+        if( m_moved.empty() )
+        {
+            return false;
+        }
+
+        // Move the vertices and drop the triangles that have collapsed
+        size_t numIndices = 0;
+
+        for(size_t i = 0; i < m_indices.size(); i += 3)
+        {
+            const Index i0 = m_remap[m_indices[i]];
+            const Index i1 = m_remap[m_indices[i + 1]];
+            const Index i2 = m_remap[m_indices[i + 2]];
+
+            const unsigned c0 = m_canonical[i0];
+            const unsigned c1 = m_canonical[i1];
+            const unsigned c2 = m_canonical[i2];
+
+            if( c0 == c1 || c1 == c2 || c2 == c0 )
+            {
+                continue;
+            }
+
+            m_indices[numIndices++] = i0;
+            m_indices[numIndices++] = i1;
+            m_indices[numIndices++] = i2;
+        }
+
+        m_indices.resize(numIndices);
+
+        for(std::vector<unsigned>::const_iterator it = m_moved.begin(); it != m_moved.end(); ++it)
+        {
+            m_remap[*it] = *it;
+        }
+
+        m_moved.clear();
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    const double Simplifier::GetCollapseCost(const unsigned from, const unsigned to, const bool borderEdge) const
+    {
+        // Border positions may only slide along the border
+        if( m_border[from] && !borderEdge )
+        {
+            return DBL_MAX;
+        }
+
+        // Positions on a seam may only move onto positions with as many wedges, so each wedge has somewhere to go
+        const unsigned numWedges = GetNumWedges(from);
+
+        if( numWedges > 1 && GetNumWedges(to) < numWedges )
+        {
+            return DBL_MAX;
+        }
+
+        // Mean squared distance to the planes merged into the position, so small triangles are not moved further
+        // than large ones
+        const double area = m_areas[from];
+        double       cost = area > 0.0 ? m_quadrics[from].Evaluate(m_positions[to]) / area : 0.0;
+
+        if( m_numAttributes )
+        {
+            double   attributeCost = 0.0;
+            unsigned wedge         = from;
+
+            do
+            {
+                attributeCost += GetAttributeDistanceSquared(wedge, FindMatchingWedge(wedge, to));
+                wedge = m_nextWedge[wedge];
+            }
+            while( wedge != from );
+
+            cost += attributeCost * m_attributeWeight;
+        }
+
+        return cost;
+    }
+
+    //--------------------------------------------------------------------------
+    const bool Simplifier::IsCollapseValid(const unsigned from, const unsigned to, unsigned & numTrianglesRemoved)
+    {
+        numTrianglesRemoved = 0;
+
+        const Position & target = m_positions[to];
+        unsigned         wedge  = from;
+
+        do
+        {
+            for(unsigned t = m_triangleOffsets[wedge]; t < m_triangleOffsets[wedge + 1]; ++t)
+            {
+                const size_t triangle = static_cast<size_t>(m_triangles[t]) * 3;
+                unsigned     corners[3];
+                bool         hasTo = false;
+
+                for(unsigned k = 0; k < 3; ++k)
+                {
+                    corners[k] = m_canonical[m_indices[triangle + k]];
+                    hasTo      = hasTo || corners[k] == to;
+                }
+
+                // Triangles along the edge disappear
+                if( hasTo )
+                {
+                    ++numTrianglesRemoved;
+                    continue;
+                }
+
+                // The rest may not fold over
+                Position moved[3];
+
+                for(unsigned k = 0; k < 3; ++k)
+                {
+                    moved[k] = corners[k] == from ? target : m_positions[corners[k]];
+                }
+
+                const D3DXVECTOR3 e1      = m_positions[corners[1]] - m_positions[corners[0]];
+                const D3DXVECTOR3 e2      = m_positions[corners[2]] - m_positions[corners[0]];
+                const D3DXVECTOR3 movedE1 = moved[1] - moved[0];
+                const D3DXVECTOR3 movedE2 = moved[2] - moved[0];
+
+                D3DXVECTOR3 before;
+                D3DXVECTOR3 after;
+                D3DXVec3Cross(&before, &e1, &e2);
+                D3DXVec3Cross(&after, &movedE1, &movedE2);
+
+                const double dot    = D3DXVec3Dot(&before, &after);
+                const double limit  = MIN_NORMAL_DOT * D3DXVec3Length(&before) * D3DXVec3Length(&after);
+
+                if( dot <= limit )
+                {
+                    return false;
+                }
+            }
+
+            wedge = m_nextWedge[wedge];
+        }
+        while( wedge != from );
+
+        // The two ends may only share the neighbours on either side of the edge, or the surface would pinch
+        GatherNeighbours(from, m_neighbours);
+        GatherNeighbours(to, m_otherNeighbours);
+
+        unsigned numShared = 0;
+
+        for(std::vector<unsigned>::const_iterator it = m_neighbours.begin(); it != m_neighbours.end(); ++it)
+        {
+            if( std::find(m_otherNeighbours.begin(), m_otherNeighbours.end(), *it) != m_otherNeighbours.end() )
+            {
+                ++numShared;
+            }
+        }
+
+        return numShared <= 2;
+    }
+
+    //--------------------------------------------------------------------------
+    void Simplifier::ApplyCollapse(const unsigned from, const unsigned to)
+    {
+        const double area  = m_areas[from];
+        const double error = area > 0.0 ? sqrt(m_quadrics[from].Evaluate(m_positions[to]) / area) : 0.0;
+
+        if( error > m_error )
+        {
+            m_error = error;
+        }
+
+        // Move each wedge onto the matching wedge at the other end
+        unsigned wedge = from;
+
+        do
+        {
+            m_remap[wedge] = FindMatchingWedge(wedge, to);
+            m_moved.push_back(wedge);
+            wedge = m_nextWedge[wedge];
+        }
+        while( wedge != from );
+
+        m_quadrics[to].Add(m_quadrics[from]);
+        m_areas[to] += area;
+        m_border[to] = m_border[to] || m_border[from];
+
+        // The triangles around the position that moved have changed, so their positions have to wait for the next pass
+        GatherNeighbours(from, m_neighbours);
+
+        for(std::vector<unsigned>::const_iterator it = m_neighbours.begin(); it != m_neighbours.end(); ++it)
+        {
+            m_locked[*it] = 1;
+        }
+
+        m_locked[from] = 1;
+        m_locked[to]   = 1;
+    }
+
+    //--------------------------------------------------------------------------
+    const unsigned Simplifier::GetNumWedges(const unsigned position) const
+    {
+        unsigned numWedges = 0;
+        unsigned wedge     = position;
+
+        do
+        {
+            ++numWedges;
+            wedge = m_nextWedge[wedge];
+        }
+        while( wedge != position );
+
+        return numWedges;
+    }
+
+    //--------------------------------------------------------------------------
+    const unsigned Simplifier::FindMatchingWedge(const unsigned wedge, const unsigned position) const
+    {
+        unsigned best         = position;
+        double   bestDistance = DBL_MAX;
+        unsigned candidate    = position;
+
+        do
+        {
+            const double distance = GetAttributeDistanceSquared(wedge, candidate);
+
+            if( distance < bestDistance )
+            {
+                best         = candidate;
+                bestDistance = distance;
+            }
+
+            candidate = m_nextWedge[candidate];
+        }
+        while( candidate != position );
+
+        return best;
+    }
+
+    //--------------------------------------------------------------------------
+    const double Simplifier::GetAttributeDistanceSquared(const unsigned a, const unsigned b) const
+    {
+        if( !m_numAttributes )
+        {
+            return 0.0;
+        }
+
+        const float * attributeA = &m_attributes[static_cast<size_t>(a) * m_numAttributes];
+        const float * attributeB = &m_attributes[static_cast<size_t>(b) * m_numAttributes];
+        double        distance   = 0.0;
+
+        for(unsigned k = 0; k < m_numAttributes; ++k)
+        {
+            const double difference = attributeA[k] - attributeB[k];
+            distance += difference * difference;
+        }
+
+        return distance;
+    }
+
+    //--------------------------------------------------------------------------
+    void Simplifier::GatherNeighbours(const unsigned position, std::vector<unsigned> & neighbours) const
+    {
+        neighbours.clear();
+
+        unsigned wedge = position;
+
+        do
+        {
+            for(unsigned t = m_triangleOffsets[wedge]; t < m_triangleOffsets[wedge + 1]; ++t)
+            {
+                const size_t triangle = static_cast<size_t>(m_triangles[t]) * 3;
+
+                for(unsigned k = 0; k < 3; ++k)
+                {
+                    const unsigned corner = m_canonical[m_indices[triangle + k]];
+
+                    if( corner != position && std::find(neighbours.begin(), neighbours.end(), corner) == neighbours.end() )
+                    {
+                        neighbours.push_back(corner);
+                    }
+                }
+            }
+
+            wedge = m_nextWedge[wedge];
+        }
+        while( wedge != position );
+    }
+}
+
+//------------------------------------------------------------------------------
+void SimplifyMesh(const unsigned char * vertexData,
+                  const unsigned numVertices,
+                  const std::vector<BufferContentType> & contentTypes,
+                  const std::vector<Index> & indices,
+                  const std::vector<unsigned> & targetNumIndices,
+                  std::vector<std::vector<Index> > & levels,
+                  std::vector<float> & errors)
+{
+    levels.clear();
+    errors.clear();
+
+    Simplifier simplifier(vertexData, numVertices, contentTypes, indices);
+
+    for(std::vector<unsigned>::const_iterator it = targetNumIndices.begin(); it != targetNumIndices.end(); ++it)
+    {
+        simplifier.Simplify(*it);
+
+        levels.push_back(simplifier.GetIndices());
+        errors.push_back(simplifier.GetError());
+    }
+}
+
+//------------------------------------------------------------------------------
+void GenerateLevelsOfDetail(PolygonSetData & polygonSet, const std::vector<float> & ratios)
+{
+    polygonSet.m_levelsOfDetail.clear();
+
+    if( ratios.empty() || polygonSet.m_numIndices == 0 )
+    {
+        return;
+    }
+
+    // Index count of each level, rounded down to whole triangles
+    const unsigned     numTriangles = polygonSet.m_numIndices / 3;
+    std::vector<unsigned> targetNumIndices;
+    float              previousRatio = 1.0f;
+
+    for(std::vector<float>::const_iterator it = ratios.begin(); it != ratios.end(); ++it)
+    {
+        if( *it <= 0.0f || *it >= previousRatio )
+        {
+            std::stringstream msg;
+            msg << "Level of detail ratio " << *it << " is not between 0 and " << previousRatio;
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        previousRatio = *it;
+
+        const unsigned numTargetTriangles = static_cast<unsigned>(static_cast<float>(numTriangles) * *it);
+        targetNumIndices.push_back((numTargetTriangles ? numTargetTriangles : 1) * 3);
+    }
+
+    const Index *            indexData = polygonSet.GetIndexData();
+    const std::vector<Index> indices(indexData, indexData + polygonSet.m_numIndices);
+
+    std::vector<std::vector<Index> > levels;
+    std::vector<float>               errors;
+
+    try
+    {
+        SimplifyMesh(polygonSet.GetVertexData(), polygonSet.m_numVertices, polygonSet.m_contentTypes, indices,
+                     targetNumIndices, levels, errors);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    // Keep the levels that are coarser than the one before them
+    size_t previousNumIndices = indices.size();
+
+    for(size_t i = 0; i < levels.size(); ++i)
+    {
+        if( levels[i].empty() || levels[i].size() >= previousNumIndices )
+        {
+            continue;
+        }
+
+        previousNumIndices = levels[i].size();
+
+        PolygonSetData::LevelOfDetail level;
+        level.m_indices    = levels[i];
+        level.m_numIndices = static_cast<unsigned>(levels[i].size());
+        level.m_error      = errors[i];
+
+        OptimizeVertexCache(level.m_indices, polygonSet.m_numVertices);
+
+        polygonSet.m_levelsOfDetail.push_back(level);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+// EngineX Includes
+#include "Graphics\3D\Buffers.h"
+#include "Graphics\3D\PolygonSetData.h"
+
+// Standard Includes
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Simplification of indexed triangle lists for levels of detail
+//
+// Edges are collapsed, cheapest first, with the cost of moving one end onto the other measured by the quadric error
+// metric of Garland and Heckbert: the sum of squared distances to the planes of the triangles that have been merged
+// into that end, weighted by their area. Open borders are held in place by planes running along them, and the
+// difference in normal and texture coordinates between the vertices involved is added to the cost, so that
+// collapses across creases and UV seams come last.
+//
+// Only existing vertices are kept, so every level draws from the same vertex buffer and differs only in its indices.
+// Vertices at the same position with different attributes move together, each onto the matching vertex at the
+// other end, so seams do not open up.
+//
+
+/**
+* Simplifies an indexed triangle list into a chain of coarser index lists that use the same vertices
+*
+* Each level continues from the one before it, so the levels are nested and the work is done once.
+*
+* @param vertexData       - Interleaved vertices. Must contain a POSITION. A NORMAL and the first TEXCOORD2D
+*                           are preserved, if present.
+* @param numVertices      - Number of vertices
+* @param contentTypes     - What each vertex is made of, in order
+* @param indices          - Full detail indexed triangle list
+* @param targetNumIndices - Number of indices to simplify each level to, in decreasing order
+* @param levels           - OUT - Index list of each level. A level keeps more indices than its target if the
+*                           mesh could not be simplified any further without folding over.
+* @param errors           - OUT - Largest distance, in object space, each level strays from the full detail surface
+*
+* @throws BaseException - If there is no POSITION, the number of indices is not a multiple of 3, or an index is out of range
+**/
+void SimplifyMesh(const unsigned char * vertexData,
+                  const unsigned numVertices,
+                  const std::vector<BufferContentType> & contentTypes,
+                  const std::vector<Index> & indices,
+                  const std::vector<unsigned> & targetNumIndices,
+                  std::vector<std::vector<Index> > & levels,
+                  std::vector<float> & errors);
+
+/**
+* Generates levels of detail for a polygon set, replacing any it already has
+*
+* Levels that could not be simplified further than the level before them are left out. The index list of each
+* level is optimized for the vertex cache.
+*
+* @param polygonSet - IN/OUT - Polygon set to generate levels of detail for
+* @param ratios     - Fraction of the triangles of the full detail geometry each level keeps, in decreasing
+*                     order, such as 0.5, 0.25, 0.1
+*
+* @throws BaseException - If the ratios are not decreasing and between 0 and 1, or the polygon set cannot be simplified
+**/
+void GenerateLevelsOfDetail(PolygonSetData & polygonSet, const std::vector<float> & ratios);
+
+#endif // MESHSIMPLIFIER_H
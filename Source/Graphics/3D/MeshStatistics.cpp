@@ -0,0 +1,365 @@
+
+// Project Includes
+#include "MeshStatistics.h"
+#include "PolygonSetData.h"
+#include "VertexQuantizer.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    //--------------------------------------------------------------------------
+    /**
+    * Gathers the positions of a polygon set, in object space, decoding them if they were quantized
+    *
+    * @throws BaseException - If the vertices have no position
+    **/
+    void GatherPositions(const PolygonSetData & polygonSet, std::vector<Position> & positions)
+    {
+        // Find where the position is in each vertex
+        unsigned          positionOffset = 0;
+        BufferContentType positionType   = NUM_BUFFER_CONTENT_TYPES;
+
+        for(std::vector<BufferContentType>::const_iterator it = polygonSet.m_contentTypes.begin(); it != polygonSet.m_contentTypes.end(); ++it)
+        {
+            if( *it == POSITION || *it == POSITION16 )
+            {
+                positionType = *it;
+                break;
+            }
+
+            positionOffset += GetStride(*it);
+        }
+
+        if( positionType == NUM_BUFFER_CONTENT_TYPES )
+        {
+            const std::string msg("Cannot measure vertices without a position");
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        const unsigned             vertexSize   = polygonSet.GetVertexSize();
+        const unsigned char *      vertex       = polygonSet.GetVertexData() + positionOffset;
+        const VertexQuantization & quantization = polygonSet.m_quantization;
+
+        positions.resize(polygonSet.m_numVertices);
+
+        for(unsigned i = 0; i < polygonSet.m_numVertices; ++i)
+        {
+            if( positionType == POSITION )
+            {
+                memcpy(&positions[i], vertex + static_cast<size_t>(i) * vertexSize, sizeof(Position));
+            }
+            else
+            {
+                Position16 quantized;
+                memcpy(&quantized, vertex + static_cast<size_t>(i) * vertexSize, sizeof(Position16));
+
+                float decoded[4];
+                D3DXFloat16To32Array(decoded, &quantized.x, 4);
+
+                positions[i] = D3DXVECTOR3(decoded[0], decoded[1], decoded[2]) * quantization.m_positionScale + quantization.m_positionBias;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Query whether or not pixels that lie exactly on an edge belong to the triangle on this side of it
+    *
+    * The edge runs the other way in the triangle on the other side, so exactly one of the two gets them
+    * and they are not counted twice.
+    **/
+    const bool OwnsEdge(const float dx, const float dy)
+    {
+        return dy > 0.0f || (dy == 0.0f && dx < 0.0f);
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Rasterizes triangles, already projected into pixels, against a depth buffer
+    *
+    * @param screen      - Pixel x, pixel y, and depth of each vertex
+    * @param indices     - Indexed triangle list
+    * @param numIndices  - Number of indices
+    * @param frontFacing - Whether or not each triangle faces the view
+    * @param resolution  - Width and height of the depth buffer
+    * @param depthBuffer - IN/OUT - Depth of the nearest fragment so far at each pixel, FLT_MAX where there is none
+    * @return            - Number of fragments that passed the depth test
+    **/
+    const unsigned RasterizeTriangles(const std::vector<D3DXVECTOR3> & screen,
+                                      const Index * indices,
+                                      const unsigned numIndices,
+                                      const std::vector<bool> & frontFacing,
+                                      const unsigned resolution,
+                                      std::vector<float> & depthBuffer)
+    {
+        unsigned numShaded = 0;
+
+        for(unsigned triangle = 0; triangle * 3 + 2 < numIndices; ++triangle)
+        {
+            if( !frontFacing[triangle] )
+            {
+                continue;
+            }
+
+            D3DXVECTOR3 v0 = screen[indices[triangle * 3]];
+            D3DXVECTOR3 v1 = screen[indices[triangle * 3 + 1]];
+            D3DXVECTOR3 v2 = screen[indices[triangle * 3 + 2]];
+
+            // Wind every triangle the same way on screen, so that the edge functions are positive inside it
+            float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+
+            if( area == 0.0f )
+            {
+                continue;
+            }
+
+            if( area < 0.0f )
+            {
+                std::swap(v1, v2);
+                area = -area;
+            }
+
+            // Pixels whose centers lie within the bounding rectangle of the triangle
+            const int minX = std::max<int>(static_cast<int>(std::ceil(std::min<float>(v0.x, std::min<float>(v1.x, v2.x)) - 0.5f)), 0);
+            const int minY = std::max<int>(static_cast<int>(std::ceil(std::min<float>(v0.y, std::min<float>(v1.y, v2.y)) - 0.5f)), 0);
+            const int maxX = std::min<int>(static_cast<int>(std::floor(std::max<float>(v0.x, std::max<float>(v1.x, v2.x)) - 0.5f)), resolution - 1);
+            const int maxY = std::min<int>(static_cast<int>(std::floor(std::max<float>(v0.y, std::max<float>(v1.y, v2.y)) - 0.5f)), resolution - 1);
+
+            const bool owns0 = OwnsEdge(v2.x - v1.x, v2.y - v1.y);
+            const bool owns1 = OwnsEdge(v0.x - v2.x, v0.y - v2.y);
+            const bool owns2 = OwnsEdge(v1.x - v0.x, v1.y - v0.y);
+
+            for(int y = minY; y <= maxY; ++y)
+            {
+                const float py = static_cast<float>(y) + 0.5f;
+
+                for(int x = minX; x <= maxX; ++x)
+                {
+                    const float px = static_cast<float>(x) + 0.5f;
+
+                    // Each weight is the edge function of the edge opposite its vertex
+                    const float w0 = (v2.x - v1.x) * (py - v1.y) - (v2.y - v1.y) * (px - v1.x);
+                    const float w1 = (v0.x - v2.x) * (py - v2.y) - (v0.y - v2.y) * (px - v2.x);
+                    const float w2 = (v1.x - v0.x) * (py - v0.y) - (v1.y - v0.y) * (px - v0.x);
+
+                    if( w0 < 0.0f || w1 < 0.0f || w2 < 0.0f ||
+                        (w0 == 0.0f && !owns0) || (w1 == 0.0f && !owns1) || (w2 == 0.0f && !owns2) )
+                    {
+                        continue;
+                    }
+
+                    const float depth = (w0 * v0.z + w1 * v1.z + w2 * v2.z) / area;
+                    float &     depthAtPixel = depthBuffer[static_cast<size_t>(y) * resolution + x];
+
+                    if( depth < depthAtPixel )
+                    {
+                        depthAtPixel = depth;
+                        ++numShaded;
+                    }
+                }
+            }
+        }
+
+        return numShaded;
+    }
+}
+
+//------------------------------------------------------------------------------
+MeshStatistics::AttributeMemory::AttributeMemory(const BufferContentType contentType, const unsigned numBytes)
+    :
+    m_contentType(contentType),
+    m_numBytes(numBytes)
+{
+}
+
+//------------------------------------------------------------------------------
+MeshStatistics::MeshStatistics()
+    :
+    m_numVertices(0),
+    m_numTriangles(0),
+    m_numSourceVertices(0),
+    m_numWeldedVertices(0),
+    m_duplicateVertexRatio(0.0f),
+    m_overdraw(0.0f),
+    m_numPixelsCovered(0),
+    m_numFragmentsShaded(0),
+    m_vertexBytes(0),
+    m_indexBytes(0),
+    m_levelOfDetailIndexBytes(0)
+{
+}
+
+//------------------------------------------------------------------------------
+const MeshStatistics AnalyzeMesh(const PolygonSetData & polygonSet, const unsigned resolution)
+{
+    MeshStatistics statistics;
+
+    statistics.m_numVertices  = polygonSet.m_numVertices;
+    statistics.m_numTriangles = polygonSet.m_numIndices / 3;
+    statistics.m_bounds       = polygonSet.m_bounds;
+
+    // The source stored three vertices for every triangle, and the report made at import time counts the vertices
+    // those were welded into, before any were dropped by later steps
+    const VertexCacheStatistics & imported = polygonSet.m_optimizationReport.m_before;
+
+    if( imported.m_numTriangles > 0 )
+    {
+        statistics.m_numSourceVertices    = imported.m_numTriangles * 3;
+        statistics.m_numWeldedVertices    = imported.m_numVerticesUsed;
+        statistics.m_duplicateVertexRatio = 1.0f - static_cast<float>(imported.m_numVerticesUsed) / statistics.m_numSourceVertices;
+    }
+    else
+    {
+        statistics.m_numSourceVertices = polygonSet.m_numVertices;
+        statistics.m_numWeldedVertices = polygonSet.m_numVertices;
+    }
+
+    // Memory
+    for(std::vector<BufferContentType>::const_iterator it = polygonSet.m_contentTypes.begin(); it != polygonSet.m_contentTypes.end(); ++it)
+    {
+        statistics.m_attributeMemory.push_back(MeshStatistics::AttributeMemory(*it, GetStride(*it) * polygonSet.m_numVertices));
+    }
+
+    statistics.m_vertexBytes = polygonSet.GetVertexSize() * polygonSet.m_numVertices;
+    statistics.m_indexBytes  = polygonSet.m_numIndices * sizeof(Index);
+
+    for(std::vector<PolygonSetData::LevelOfDetail>::const_iterator it = polygonSet.m_levelsOfDetail.begin(); it != polygonSet.m_levelsOfDetail.end(); ++it)
+    {
+        statistics.m_levelOfDetailIndexBytes += it->m_numIndices * sizeof(Index);
+    }
+
+    // Vertex cache, of the indices as they are drawn
+    const Index * indices = polygonSet.GetIndexData();
+
+    try
+    {
+        statistics.m_vertexCache = AnalyzeVertexCache(std::vector<Index>(indices, indices + polygonSet.m_numIndices),
+                                                      polygonSet.m_numVertices);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    // Overdraw
+    std::vector<Position> positions;
+
+    try
+    {
+        GatherPositions(polygonSet, positions);
+        EstimateOverdraw(positions, indices, polygonSet.m_numIndices, polygonSet.m_bounds, resolution, statistics);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    return statistics;
+}
+
+//------------------------------------------------------------------------------
+void EstimateOverdraw(const std::vector<Position> & positions,
+                      const Index * indices,
+                      const unsigned numIndices,
+                      const BoundingVolume & bounds,
+                      const unsigned resolution,
+                      MeshStatistics & statistics)
+{
+    statistics.m_overdraw           = 0.0f;
+    statistics.m_numPixelsCovered   = 0;
+    statistics.m_numFragmentsShaded = 0;
+
+    for(unsigned i = 0; i < numIndices; ++i)
+    {
+        if( indices[i] >= positions.size() )
+        {
+            std::stringstream msg;
+            msg << "Index " << indices[i] << " is out of range of " << positions.size() << " vertices";
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+    }
+
+    if( bounds.IsEmpty() || resolution == 0 )
+    {
+        return;
+    }
+
+    const unsigned numTriangles = numIndices / 3;
+
+    // Face normals, unnormalized. Only their direction relative to each view matters.
+    std::vector<D3DXVECTOR3> normals(numTriangles);
+
+    for(unsigned triangle = 0; triangle < numTriangles; ++triangle)
+    {
+        const Position & p0 = positions[indices[triangle * 3]];
+        const Position & p1 = positions[indices[triangle * 3 + 1]];
+        const Position & p2 = positions[indices[triangle * 3 + 2]];
+
+        const D3DXVECTOR3 edge1 = p1 - p0;
+        const D3DXVECTOR3 edge2 = p2 - p0;
+
+        D3DXVec3Cross(&normals[triangle], &edge1, &edge2);
+    }
+
+    const float * boxMin = bounds.m_boxMin;
+    const float * boxMax = bounds.m_boxMax;
+
+    std::vector<D3DXVECTOR3> screen(positions.size());
+    std::vector<bool>        frontFacing(numTriangles);
+    std::vector<float>       depthBuffer;
+
+    // Look down each axis, from each direction
+    for(unsigned view = 0; view < 6; ++view)
+    {
+        const unsigned axis = view / 2;
+        const float    sign = (view % 2) ? -1.0f : 1.0f;
+
+        // The other two axes lie across the screen, scaled alike so that the mesh keeps its shape
+        const unsigned across = (axis + 1) % 3;
+        const unsigned down   = (axis + 2) % 3;
+        const float    extent = std::max<float>(boxMax[across] - boxMin[across], boxMax[down] - boxMin[down]);
+
+        if( !(extent > 0.0f) )
+        {
+            continue;
+        }
+
+        const float scale = static_cast<float>(resolution) / extent;
+
+        // Nearer fragments have smaller depths
+        for(size_t i = 0; i < positions.size(); ++i)
+        {
+            const float * p = positions[i];
+
+            screen[i] = D3DXVECTOR3((p[across] - boxMin[across]) * scale,
+                                    (p[down] - boxMin[down]) * scale,
+                                    p[axis] * sign);
+        }
+
+        // Triangles are clockwise from the front, so their normals point back along the view direction
+        for(unsigned triangle = 0; triangle < numTriangles; ++triangle)
+        {
+            frontFacing[triangle] = normals[triangle][axis] * sign < 0.0f;
+        }
+
+        depthBuffer.assign(static_cast<size_t>(resolution) * resolution, FLT_MAX);
+
+        statistics.m_numFragmentsShaded += RasterizeTriangles(screen, indices, numIndices, frontFacing, resolution, depthBuffer);
+        statistics.m_numPixelsCovered   += static_cast<unsigned>(depthBuffer.size() - std::count(depthBuffer.begin(), depthBuffer.end(), FLT_MAX));
+    }
+
+    if( statistics.m_numPixelsCovered > 0 )
+    {
+        statistics.m_overdraw = static_cast<float>(statistics.m_numFragmentsShaded) / statistics.m_numPixelsCovered;
+    }
+}
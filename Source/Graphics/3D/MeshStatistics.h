@@ -0,0 +1,102 @@
+#ifndef MESHSTATISTICS_H
+#define MESHSTATISTICS_H
+
+// EngineX Includes
+#include "Graphics\3D\BoundingVolume.h"
+#include "Graphics\3D\Buffers.h"
+#include "Graphics\3D\MeshOptimizer.h"
+
+// Standard Includes
+#include <vector>
+
+struct PolygonSetData;
+
+//------------------------------------------------------------------------------
+// Measurements of how much an imported mesh costs to store and to draw, without a device
+//
+// Both source formats store every triangle with vertices of its own, which are welded into indexed vertices when
+// they are imported. How many of the source vertices were duplicates is worked out from the optimization report
+// made at import time, which is kept in cooked meshes as well.
+//
+// Overdraw is estimated by rasterizing the mesh, in the order its triangles are drawn, from six fixed views looking
+// down each axis in each direction. Each view is an orthographic projection fitted to the bounds. Only triangles
+// facing the view are drawn, with a depth test, and every fragment that passes the depth test counts as shaded.
+//
+
+const unsigned OVERDRAW_RESOLUTION = 256;
+
+/**
+* Statistics of a single polygon set
+**/
+struct MeshStatistics
+{
+   /**
+   * Memory taken by one content type of the vertices
+   **/
+   struct AttributeMemory
+   {
+      /**
+      * Constructor
+      **/
+      AttributeMemory(const BufferContentType contentType, const unsigned numBytes);
+
+
+      BufferContentType m_contentType;
+      unsigned          m_numBytes;
+   };
+
+   /**
+   * Constructor
+   **/
+   MeshStatistics();
+
+
+   unsigned                     m_numVertices;              // Vertices after welding
+   unsigned                     m_numTriangles;
+   unsigned                     m_numSourceVertices;        // Vertices the source file stored, one for each corner of each triangle
+   unsigned                     m_numWeldedVertices;        // Vertices those were welded into
+   float                        m_duplicateVertexRatio;     // Fraction of the source vertices that were welded away as duplicates
+
+   VertexCacheStatistics        m_vertexCache;              // Of the indices as they are drawn, with a 16 entry FIFO cache
+   float                        m_overdraw;                 // Fragments shaded per pixel covered, over all of the views. 1 is ideal.
+   unsigned                     m_numPixelsCovered;         // Pixels covered, over all of the views
+   unsigned                     m_numFragmentsShaded;       // Fragments that passed the depth test, over all of the views
+
+   BoundingVolume               m_bounds;
+
+   std::vector<AttributeMemory> m_attributeMemory;          // One for each content type, in the order they are interleaved
+   unsigned                     m_vertexBytes;              // All of the vertices
+   unsigned                     m_indexBytes;               // Indices of the full detail geometry
+   unsigned                     m_levelOfDetailIndexBytes;  // Indices of all of the levels of detail
+};
+
+/**
+* Measures a polygon set
+*
+* @param polygonSet - The polygon set to measure, as imported or read from a cooked mesh
+* @param resolution - Width and height, in pixels, of each of the views overdraw is estimated from
+*
+* @throws BaseException - If the polygon set has no position, or an index is out of range
+**/
+const MeshStatistics AnalyzeMesh(const PolygonSetData & polygonSet, const unsigned resolution = OVERDRAW_RESOLUTION);
+
+/**
+* Estimates how many times each pixel covered by an indexed triangle list is shaded, when drawn in order
+*
+* @param positions  - Object space positions of the vertices
+* @param indices    - Indexed triangle list
+* @param numIndices - Number of indices
+* @param bounds     - Bounds of the positions, that each view is fitted to
+* @param resolution - Width and height, in pixels, of each view
+* @param statistics - OUT - m_overdraw, m_numPixelsCovered and m_numFragmentsShaded are set
+*
+* @throws BaseException - If an index is out of range
+**/
+void EstimateOverdraw(const std::vector<Position> & positions,
+                      const Index * indices,
+                      const unsigned numIndices,
+                      const BoundingVolume & bounds,
+                      const unsigned resolution,
+                      MeshStatistics & statistics);
+
+#endif // MESHSTATISTICS_H
@@ -0,0 +1,212 @@
+
+// Project Includes
+#include "ModelLoader.h"
+
+// Standard Includes
+#include <future>
+
+//---------------------------------------------------------------------------
+namespace
+{
+    //-----------------------------------------------------------------------
+    /**
+    * Imports one file on a worker thread
+    **/
+    class ImportTask
+    {
+    public:
+
+        ImportTask(PolygonSetParser & parser, const std::string & filepath, const bool generateTangentData)
+            :
+            m_parser             (&parser),
+            m_filepath           (filepath),
+            m_generateTangentData(generateTangentData)
+        {
+        }
+
+        std::vector<PolygonSetData> operator()() const
+        {
+            std::vector<PolygonSetData> polygonSets;
+            m_parser->ImportFile(m_filepath, polygonSets, m_generateTangentData);
+
+            return polygonSets;
+        }
+
+    private:
+
+        PolygonSetParser * m_parser;
+        std::string        m_filepath;
+        bool               m_generateTangentData;
+    };
+}
+
+//---------------------------------------------------------------------------
+ModelLoader::ModelLoader(ID3D10Device & device, 
+                         InputLayoutManager & inputLayoutManager,
+                         TextureManager & textureManager,
+                         EffectManager & effectManager,
+                         ThreadPool & threadPool)
+    :
+    m_device(device),
+    m_inputLayoutManager(inputLayoutManager),
+    m_textureManager(textureManager),
+    m_effectManager(effectManager),
+    m_threadPool(threadPool),
+    m_textureLoader(device, textureManager, threadPool),
+    m_quantizeVertices(false),
+    m_generateClusters(false),
+    m_mergeSubmeshes(false),
+    m_streamSourceFiles(false),
+    m_bufferCache(NULL)
+{
+}
+
+//---------------------------------------------------------------------------
+ModelLoader::~ModelLoader()
+{
+    ReleaseParsers();
+}
+
+//---------------------------------------------------------------------------
+void ModelLoader::LoadFiles(const std::vector<std::string> & filepaths,
+                            const bool generateTangentData)
+{
+    ReleaseParsers();
+
+    for(size_t i = 0; i < filepaths.size(); ++i)
+    {
+        m_parsers.push_back(new PolygonSetParser(m_device, m_inputLayoutManager, m_textureManager, m_effectManager));
+        m_parsers.back()->SetLevelOfDetailRatios(m_levelOfDetailRatios);
+        m_parsers.back()->SetQuantizeVertices(m_quantizeVertices);
+        m_parsers.back()->SetGenerateClusters(m_generateClusters);
+        m_parsers.back()->SetMergeSubmeshes(m_mergeSubmeshes);
+        m_parsers.back()->SetStreamSourceFiles(m_streamSourceFiles);
+        m_parsers.back()->SetBufferCache(m_bufferCache);
+    }
+
+    // Queue every file at once, so the workers stay busy while the device objects are created
+    std::vector<std::future<std::vector<PolygonSetData> > > imports;
+
+    for(size_t i = 0; i < filepaths.size(); ++i)
+    {
+        imports.push_back(m_threadPool.Submit(ImportTask(*m_parsers[i], filepaths[i], generateTangentData)));
+    }
+
+    try
+    {
+        // Start decoding the textures of each file as soon as it is imported, while the rest are still parsing
+        std::vector<std::vector<PolygonSetData> > polygonSets(imports.size());
+
+        for(size_t i = 0; i < imports.size(); ++i)
+        {
+            polygonSets[i] = imports[i].get();
+
+            std::vector<TextureDependency> textures;
+            m_parsers[i]->GetTextureDependencies(polygonSets[i], textures);
+
+            for(std::vector<TextureDependency>::const_iterator it = textures.begin(); it != textures.end(); ++it)
+            {
+                m_textureLoader.Request(it->m_textureName, it->m_textureFile);
+            }
+        }
+
+        m_textureLoader.Finish();
+
+        // Create the PolygonSets of each file on this thread, in order, now that their textures exist
+        for(size_t i = 0; i < polygonSets.size(); ++i)
+        {
+            m_parsers[i]->CreatePolygonSets(polygonSets[i]);
+            std::vector<PolygonSetData>().swap(polygonSets[i]);
+        }
+    }
+    catch(...)
+    {
+        // The parsers are still in use by the imports that have not finished
+        for(size_t i = 0; i < imports.size(); ++i)
+        {
+            if( imports[i].valid() )
+            {
+                imports[i].wait();
+            }
+        }
+
+        ReleaseParsers();
+        throw;
+    }
+}
+
+//---------------------------------------------------------------------------
+void ModelLoader::SetLevelOfDetailRatios(const std::vector<float> & ratios)
+{
+    m_levelOfDetailRatios = ratios;
+}
+
+//---------------------------------------------------------------------------
+void ModelLoader::SetQuantizeVertices(const bool quantizeVertices)
+{
+    m_quantizeVertices = quantizeVertices;
+}
+
+//---------------------------------------------------------------------------
+void ModelLoader::SetGenerateClusters(const bool generateClusters)
+{
+    m_generateClusters = generateClusters;
+}
+
+//---------------------------------------------------------------------------
+void ModelLoader::SetMergeSubmeshes(const bool mergeSubmeshes)
+{
+    m_mergeSubmeshes = mergeSubmeshes;
+}
+
+//---------------------------------------------------------------------------
+void ModelLoader::SetStreamSourceFiles(const bool streamSourceFiles)
+{
+    m_streamSourceFiles = streamSourceFiles;
+}
+
+//---------------------------------------------------------------------------
+void ModelLoader::SetBufferCache(BufferCache * bufferCache)
+{
+    m_bufferCache = bufferCache;
+}
+
+//---------------------------------------------------------------------------
+const unsigned ModelLoader::GetNumFiles() const
+{
+    return static_cast<unsigned>(m_parsers.size());
+}
+
+//---------------------------------------------------------------------------
+const unsigned ModelLoader::GetNumPolygonSets(const unsigned fileIndex) const
+{
+    if( fileIndex >= m_parsers.size() )
+    {
+        return 0;
+    }
+
+    return m_parsers[fileIndex]->GetNumPolygonSets();
+}
+
+//---------------------------------------------------------------------------
+std::auto_ptr<PolygonSet> ModelLoader::GetPolygonSet(const unsigned fileIndex, const unsigned index)
+{
+    if( fileIndex >= m_parsers.size() )
+    {
+        return std::auto_ptr<PolygonSet>(NULL);
+    }
+
+    return m_parsers[fileIndex]->GetPolygonSet(index);
+}
+
+//---------------------------------------------------------------------------
+void ModelLoader::ReleaseParsers()
+{
+    std::vector<PolygonSetParser *>::iterator it = m_parsers.begin();
+
+    while( !m_parsers.empty() )
+    {
+        delete (*it);
+        it = m_parsers.erase(it);
+    }
+}
@@ -0,0 +1,151 @@
+#ifndef MODELLOADER_H
+#define MODELLOADER_H
+
+// EngineX Includes
+#include "Core\ThreadPool.h"
+#include "Graphics\3D\PolygonSetParser.h"
+#include "Graphics\Textures\TextureLoader.h"
+
+// Standard Includes
+#include <memory>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// Loads a number of model files at once
+//
+// Reading, parsing, welding, and optimizing each file is done on the worker threads of a thread pool, with
+// as many files in flight as there are workers. As each file finishes, the textures its materials are mapped
+// to are queued for decoding on the workers as well, once for the whole batch. Creating the D3D buffers,
+// textures, and materials for the PolygonSets is done on the calling thread, which must own the device.
+//
+class ModelLoader
+{
+public:
+
+   /**
+   * Constructor
+   **/
+   ModelLoader(ID3D10Device & device, 
+               InputLayoutManager & inputLayoutManager, 
+               TextureManager & textureManager,
+               EffectManager & effectManager,
+               ThreadPool & threadPool);
+
+   /**
+   * Deconstructor
+   **/
+   virtual ~ModelLoader();
+
+
+   /**
+   * Loads a number of model files and creates their PolygonSets
+   *
+   * Replaces any PolygonSets that are currently stored.
+   *
+   * @param filepaths           - Paths to the binary files to load
+   * @param generateTangentData - If true, will calculate a tangent and bitangent for each vertex, in object space
+   *
+   * @throws - BaseException if any of the files could not be loaded. No PolygonSets are kept in that case.
+   **/
+   virtual void LoadFiles(const std::vector<std::string> & filepaths,
+                          const bool generateTangentData = false);
+
+   /**
+   * Sets the levels of detail to generate for each polygon set of the files loaded from now on, 
+   * on the worker threads (see PolygonSetParser::SetLevelOfDetailRatios)
+   *
+   * @param ratios - Fraction of the triangles of the full detail geometry each level keeps, in decreasing order
+   **/
+   virtual void SetLevelOfDetailRatios(const std::vector<float> & ratios);
+
+   /**
+   * Sets whether or not the vertices of the files loaded from now on are quantized, 
+   * on the worker threads (see PolygonSetParser::SetQuantizeVertices)
+   **/
+   virtual void SetQuantizeVertices(const bool quantizeVertices);
+
+   /**
+   * Sets whether or not the files loaded from now on are split into clusters, 
+   * on the worker threads (see PolygonSetParser::SetGenerateClusters)
+   **/
+   virtual void SetGenerateClusters(const bool generateClusters);
+
+   /**
+   * Sets whether or not the polygon sets of each file loaded from now on are merged into one with submeshes, 
+   * on the worker threads (see PolygonSetParser::SetMergeSubmeshes)
+   **/
+   virtual void SetMergeSubmeshes(const bool mergeSubmeshes);
+
+   /**
+   * Sets whether or not the files loaded from now on are read through a buffer rather than mapped, 
+   * on the worker threads (see PolygonSetParser::SetStreamSourceFiles)
+   **/
+   virtual void SetStreamSourceFiles(const bool streamSourceFiles);
+
+   /**
+   * Sets a cache that the files loaded from now on get their vertex and index buffers from,
+   * so that files with the same contents share them (see PolygonSetParser::SetBufferCache)
+   **/
+   virtual void SetBufferCache(BufferCache * bufferCache);
+
+   /**
+   * Get the number of files that were loaded by the last call to LoadFiles
+   **/
+   virtual const unsigned GetNumFiles() const;
+
+   /**
+   * Get the number of PolygonSet objects currently stored for a file
+   *
+   * @param fileIndex - Index of the file, in the order the files were given to LoadFiles
+   **/
+   virtual const unsigned GetNumPolygonSets(const unsigned fileIndex) const;
+
+   /**
+   * Get a PolygonSet object that was a result of the last load
+   *
+   * NOTE - This method results in the obtained PolygonSet object being removed from storage in the loader,
+   *        as the caller is now responsible for its lifetime management.
+   *
+   * @param fileIndex - Index of the file, in the order the files were given to LoadFiles
+   * @param index     - Index of the PolygonSet within the file
+   **/
+   virtual std::auto_ptr<PolygonSet> GetPolygonSet(const unsigned fileIndex, const unsigned index);
+
+private:
+
+   /** No Copy allowed */
+   ModelLoader(const ModelLoader & rhs);
+
+   /** No assignment allowed */
+   ModelLoader & operator = (const ModelLoader & rhs);
+
+
+   /**
+   * Release all the parsers, along with any PolygonSet objects they still store
+   **/
+   void ReleaseParsers();
+
+
+   ID3D10Device &                  m_device;
+   InputLayoutManager &            m_inputLayoutManager;
+   TextureManager &                m_textureManager;
+   EffectManager &                 m_effectManager;
+   ThreadPool &                    m_threadPool;
+   TextureLoader                   m_textureLoader;         // Decodes the textures of every file in a batch
+
+   /**
+   * One parser per file, as a parser may only be used by one thread at a time
+   * Each parser stores the PolygonSets of its file.
+   **/
+   std::vector<PolygonSetParser *> m_parsers;
+
+   std::vector<float>              m_levelOfDetailRatios;   // Levels of detail to generate for each polygon set
+   bool                            m_quantizeVertices;      // Whether or not to quantize the vertices of each polygon set
+   bool                            m_generateClusters;      // Whether or not to split each polygon set into clusters
+   bool                            m_mergeSubmeshes;        // Whether or not to merge the polygon sets of each file into one
+   bool                            m_streamSourceFiles;     // Whether or not to read each file through a buffer rather than map it
+   BufferCache *                   m_bufferCache;           // Where to get shared buffers from, if anywhere
+};
+
+#endif // MODELLOADER_H
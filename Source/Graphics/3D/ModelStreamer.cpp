@@ -0,0 +1,295 @@
+
+// Project Includes
+#include "ModelStreamer.h"
+
+// Standard Includes
+#include <chrono>
+
+//---------------------------------------------------------------------------
+namespace
+{
+    //-----------------------------------------------------------------------
+    /**
+    * Imports one file on a worker thread
+    *
+    * Holds on to the parser, so that it outlives the import even if the request is abandoned
+    **/
+    class ImportTask
+    {
+    public:
+
+        ImportTask(const std::shared_ptr<PolygonSetParser> & parser, const std::string & filepath, const bool generateTangentData)
+            :
+            m_parser             (parser),
+            m_filepath           (filepath),
+            m_generateTangentData(generateTangentData)
+        {
+        }
+
+        std::vector<PolygonSetData> operator()() const
+        {
+            std::vector<PolygonSetData> polygonSets;
+            m_parser->ImportFile(m_filepath, polygonSets, m_generateTangentData);
+
+            return polygonSets;
+        }
+
+    private:
+
+        std::shared_ptr<PolygonSetParser> m_parser;
+        std::string                       m_filepath;
+        bool                              m_generateTangentData;
+    };
+}
+
+//---------------------------------------------------------------------------
+StreamedModel::StreamedModel(const std::string & filepath, const std::shared_ptr<PolygonSetParser> & parser)
+    :
+    m_filepath  (filepath),
+    m_state     (STATE_LOADING),
+    m_parser    (parser),
+    m_imported  (false),
+    m_numCreated(0)
+{
+}
+
+//---------------------------------------------------------------------------
+const std::string & StreamedModel::GetFilePath() const
+{
+    return m_filepath;
+}
+
+//---------------------------------------------------------------------------
+const StreamedModel::State StreamedModel::GetState() const
+{
+    return m_state;
+}
+
+//---------------------------------------------------------------------------
+const bool StreamedModel::IsReady() const
+{
+    return m_state == STATE_READY;
+}
+
+//---------------------------------------------------------------------------
+void StreamedModel::RethrowError() const
+{
+    if( m_state == STATE_FAILED && m_error )
+    {
+        std::rethrow_exception(m_error);
+    }
+}
+
+//---------------------------------------------------------------------------
+const unsigned StreamedModel::GetNumPolygonSets() const
+{
+    if( m_state != STATE_READY )
+    {
+        return 0;
+    }
+
+    return m_parser->GetNumPolygonSets();
+}
+
+//---------------------------------------------------------------------------
+std::auto_ptr<PolygonSet> StreamedModel::GetPolygonSet(const unsigned index)
+{
+    if( m_state != STATE_READY )
+    {
+        return std::auto_ptr<PolygonSet>(NULL);
+    }
+
+    return m_parser->GetPolygonSet(index);
+}
+
+//---------------------------------------------------------------------------
+ModelStreamer::ModelStreamer(ID3D10Device & device, 
+                             InputLayoutManager & inputLayoutManager,
+                             TextureManager & textureManager,
+                             EffectManager & effectManager,
+                             ThreadPool & threadPool)
+    :
+    m_device(device),
+    m_inputLayoutManager(inputLayoutManager),
+    m_textureManager(textureManager),
+    m_effectManager(effectManager),
+    m_threadPool(threadPool),
+    m_textureLoader(device, textureManager, threadPool),
+    m_quantizeVertices(false),
+    m_generateClusters(false),
+    m_mergeSubmeshes(false),
+    m_streamSourceFiles(false),
+    m_bufferCache(NULL)
+{
+}
+
+//---------------------------------------------------------------------------
+ModelStreamer::~ModelStreamer()
+{
+}
+
+//---------------------------------------------------------------------------
+StreamedModel::SharedPtr ModelStreamer::RequestModel(const std::string & filepath,
+                                                     const bool generateTangentData)
+{
+    std::shared_ptr<PolygonSetParser> parser(new PolygonSetParser(m_device, m_inputLayoutManager, m_textureManager, m_effectManager));
+    StreamedModel::SharedPtr          model(new StreamedModel(filepath, parser));
+
+    parser->SetLevelOfDetailRatios(m_levelOfDetailRatios);
+    parser->SetQuantizeVertices(m_quantizeVertices);
+    parser->SetGenerateClusters(m_generateClusters);
+    parser->SetMergeSubmeshes(m_mergeSubmeshes);
+    parser->SetStreamSourceFiles(m_streamSourceFiles);
+    parser->SetBufferCache(m_bufferCache);
+
+    model->m_import = m_threadPool.Submit(ImportTask(parser, filepath, generateTangentData));
+    m_loading.push_back(model);
+
+    return model;
+}
+
+//---------------------------------------------------------------------------
+void ModelStreamer::SetLevelOfDetailRatios(const std::vector<float> & ratios)
+{
+    m_levelOfDetailRatios = ratios;
+}
+
+//---------------------------------------------------------------------------
+void ModelStreamer::SetQuantizeVertices(const bool quantizeVertices)
+{
+    m_quantizeVertices = quantizeVertices;
+}
+
+//---------------------------------------------------------------------------
+void ModelStreamer::SetGenerateClusters(const bool generateClusters)
+{
+    m_generateClusters = generateClusters;
+}
+
+//---------------------------------------------------------------------------
+void ModelStreamer::SetMergeSubmeshes(const bool mergeSubmeshes)
+{
+    m_mergeSubmeshes = mergeSubmeshes;
+}
+
+//---------------------------------------------------------------------------
+void ModelStreamer::SetStreamSourceFiles(const bool streamSourceFiles)
+{
+    m_streamSourceFiles = streamSourceFiles;
+}
+
+//---------------------------------------------------------------------------
+void ModelStreamer::SetBufferCache(BufferCache * bufferCache)
+{
+    m_bufferCache = bufferCache;
+}
+
+//---------------------------------------------------------------------------
+void ModelStreamer::Update(const double budgetMilliseconds)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const Clock::time_point start     = Clock::now();
+    bool                    didCreate = m_textureLoader.Update(budgetMilliseconds) > 0;
+
+    std::list<StreamedModel::SharedPtr>::iterator it = m_loading.begin();
+
+    while( it != m_loading.end() )
+    {
+        StreamedModel & model = **it;
+
+        // Collect the result of the import, if it has finished
+        if( !model.m_imported )
+        {
+            if( model.m_import.wait_for(std::chrono::seconds(0)) != std::future_status::ready )
+            {
+                ++it;
+                continue;
+            }
+
+            // Start decoding its textures
+            try
+            {
+                model.m_polygonSetDatas = model.m_import.get();
+                model.m_imported        = true;
+
+                model.m_parser->GetTextureDependencies(model.m_polygonSetDatas, model.m_textures);
+
+                for(std::vector<TextureDependency>::const_iterator itTexture = model.m_textures.begin(); itTexture != model.m_textures.end(); ++itTexture)
+                {
+                    m_textureLoader.Request(itTexture->m_textureName, itTexture->m_textureFile);
+                }
+            }
+            catch(...)
+            {
+                model.m_error = std::current_exception();
+                model.m_state = StreamedModel::STATE_FAILED;
+
+                it = m_loading.erase(it);
+                continue;
+            }
+        }
+
+        // Wait for its textures, so that none are loaded one at a time when its materials are created
+        bool texturesPending = false;
+
+        for(std::vector<TextureDependency>::const_iterator itTexture = model.m_textures.begin(); itTexture != model.m_textures.end(); ++itTexture)
+        {
+            if( m_textureLoader.IsPending(itTexture->m_textureName) )
+            {
+                texturesPending = true;
+                break;
+            }
+        }
+
+        if( texturesPending )
+        {
+            ++it;
+            continue;
+        }
+
+        // Create its PolygonSets, one at a time, while there is time left
+        while( model.m_numCreated < model.m_polygonSetDatas.size() )
+        {
+            if( didCreate )
+            {
+                const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+                if( elapsed.count() >= budgetMilliseconds )
+                {
+                    return;
+                }
+            }
+
+            try
+            {
+                model.m_parser->CreatePolygonSet(model.m_polygonSetDatas[model.m_numCreated]);
+            }
+            catch(...)
+            {
+                model.m_error = std::current_exception();
+                model.m_state = StreamedModel::STATE_FAILED;
+                break;
+            }
+
+            ++model.m_numCreated;
+            didCreate = true;
+        }
+
+        if( model.m_state != StreamedModel::STATE_FAILED )
+        {
+            model.m_state = StreamedModel::STATE_READY;
+        }
+
+        // The imported data, and any cooked mesh it maps, is no longer needed
+        std::vector<PolygonSetData>().swap(model.m_polygonSetDatas);
+
+        it = m_loading.erase(it);
+    }
+}
+
+//---------------------------------------------------------------------------
+const unsigned ModelStreamer::GetNumLoading() const
+{
+    return static_cast<unsigned>(m_loading.size());
+}
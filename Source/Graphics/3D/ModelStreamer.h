@@ -0,0 +1,222 @@
+#ifndef MODELSTREAMER_H
+#define MODELSTREAMER_H
+
+// EngineX Includes
+#include "Core\ThreadPool.h"
+#include "Graphics\3D\PolygonSetParser.h"
+#include "Graphics\Textures\TextureLoader.h"
+
+// Standard Includes
+#include <exception>
+#include <future>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+/**
+* Handle to a model that was requested from a ModelStreamer
+*
+* The handle is only updated by ModelStreamer::Update, on the thread that owns the device, 
+* so it must only be used on that thread.
+**/
+class StreamedModel
+{
+public:
+
+   typedef std::shared_ptr<StreamedModel> SharedPtr;
+
+   enum State
+   {
+      STATE_LOADING = 0,   // Still being imported, its textures are still being decoded, or its PolygonSets are still being created
+      STATE_READY,         // All of its PolygonSets have been created
+      STATE_FAILED         // Loading failed. RethrowError will throw the reason.
+   };
+
+   /**
+   * Constructor
+   *
+   * @param filepath - Path to the model file
+   * @param parser   - Parser that will import the file and store its PolygonSets
+   **/
+   StreamedModel(const std::string & filepath, const std::shared_ptr<PolygonSetParser> & parser);
+
+
+   /**
+   * Gets the path to the model file
+   **/
+   const std::string & GetFilePath() const;
+
+   /**
+   * Gets how far along loading is
+   **/
+   const State GetState() const;
+
+   /**
+   * Query whether or not loading has finished successfully and the PolygonSets can be obtained
+   **/
+   const bool IsReady() const;
+
+   /**
+   * Throws the exception that made loading fail. Does nothing if loading has not failed.
+   **/
+   void RethrowError() const;
+
+   /**
+   * Get the number of PolygonSet objects currently stored
+   *
+   * NOTE - 0 until the model is ready
+   **/
+   const unsigned GetNumPolygonSets() const;
+
+   /**
+   * Get a PolygonSet object of the model
+   *
+   * NOTE - This method results in the obtained PolygonSet object being removed from storage in the handle,
+   *        as the caller is now responsible for its lifetime management. NULL until the model is ready.
+   **/
+   std::auto_ptr<PolygonSet> GetPolygonSet(const unsigned index);
+
+private:
+
+   friend class ModelStreamer;
+
+   /** No Copy allowed */
+   StreamedModel(const StreamedModel & rhs);
+
+   /** No assignment allowed */
+   StreamedModel & operator = (const StreamedModel & rhs);
+
+
+   std::string                                     m_filepath;
+   State                                           m_state;
+   std::exception_ptr                              m_error;            // Why loading failed
+
+   std::shared_ptr<PolygonSetParser>               m_parser;           // Imports the file and stores the PolygonSets
+   std::future<std::vector<PolygonSetData> >       m_import;           // Result of importing the file on a worker thread
+   bool                                            m_imported;         // Whether the import result has been collected
+   std::vector<PolygonSetData>                     m_polygonSetDatas;  // Imported polygon sets
+   std::vector<TextureDependency>                  m_textures;         // Textures that are loaded before any PolygonSet is created
+   size_t                                          m_numCreated;       // How many of them have PolygonSets created for them
+};
+
+//---------------------------------------------------------------------------
+/**
+* Loads models without blocking the thread that renders
+*
+* Requested files are imported on the worker threads of a thread pool, and then the textures their materials are 
+* mapped to are decoded there, once for every model that uses them. The D3D buffers, textures, and materials 
+* are created by Update, which is meant to be called once a frame and does only as much as fits in a time budget.
+**/
+class ModelStreamer
+{
+public:
+
+   /**
+   * Constructor
+   **/
+   ModelStreamer(ID3D10Device & device, 
+                 InputLayoutManager & inputLayoutManager, 
+                 TextureManager & textureManager,
+                 EffectManager & effectManager,
+                 ThreadPool & threadPool);
+
+   /**
+   * Deconstructor
+   *
+   * Requests that are still loading are abandoned. Their handles never become ready.
+   **/
+   virtual ~ModelStreamer();
+
+
+   /**
+   * Starts loading a model file in the background
+   *
+   * @param filepath            - Path to the binary file to load
+   * @param generateTangentData - If true, will calculate a tangent and bitangent for each vertex, in object space
+   * @return                    - Handle that becomes ready in a later call to Update
+   **/
+   virtual StreamedModel::SharedPtr RequestModel(const std::string & filepath,
+                                                 const bool generateTangentData = false);
+
+   /**
+   * Sets the levels of detail to generate for each polygon set of the files loaded from now on, 
+   * on the worker threads (see PolygonSetParser::SetLevelOfDetailRatios)
+   *
+   * @param ratios - Fraction of the triangles of the full detail geometry each level keeps, in decreasing order
+   **/
+   virtual void SetLevelOfDetailRatios(const std::vector<float> & ratios);
+
+   /**
+   * Sets whether or not the vertices of the files loaded from now on are quantized, 
+   * on the worker threads (see PolygonSetParser::SetQuantizeVertices)
+   **/
+   virtual void SetQuantizeVertices(const bool quantizeVertices);
+
+   /**
+   * Sets whether or not the files loaded from now on are split into clusters, 
+   * on the worker threads (see PolygonSetParser::SetGenerateClusters)
+   **/
+   virtual void SetGenerateClusters(const bool generateClusters);
+
+   /**
+   * Sets whether or not the polygon sets of each file loaded from now on are merged into one with submeshes, 
+   * on the worker threads (see PolygonSetParser::SetMergeSubmeshes)
+   **/
+   virtual void SetMergeSubmeshes(const bool mergeSubmeshes);
+
+   /**
+   * Sets whether or not the files loaded from now on are read through a buffer rather than mapped, 
+   * on the worker threads (see PolygonSetParser::SetStreamSourceFiles)
+   **/
+   virtual void SetStreamSourceFiles(const bool streamSourceFiles);
+
+   /**
+   * Sets a cache that the files loaded from now on get their vertex and index buffers from,
+   * so that files with the same contents share them (see PolygonSetParser::SetBufferCache)
+   **/
+   virtual void SetBufferCache(BufferCache * bufferCache);
+
+   /**
+   * Creates the textures that have been decoded, and then the PolygonSets of models whose files have been imported
+   * and whose textures have all been created
+   *
+   * Textures and PolygonSets are created one at a time until the budget is used up. At least one is created each 
+   * call, if any are waiting, so that loading always progresses. Must be called on the thread that owns the device.
+   *
+   * @param budgetMilliseconds - Time, in milliseconds, that may be spent creating textures and PolygonSets
+   **/
+   virtual void Update(const double budgetMilliseconds);
+
+   /**
+   * Gets the number of requests that are still loading
+   **/
+   virtual const unsigned GetNumLoading() const;
+
+private:
+
+   /** No Copy allowed */
+   ModelStreamer(const ModelStreamer & rhs);
+
+   /** No assignment allowed */
+   ModelStreamer & operator = (const ModelStreamer & rhs);
+
+
+   ID3D10Device &                      m_device;
+   InputLayoutManager &                m_inputLayoutManager;
+   TextureManager &                    m_textureManager;
+   EffectManager &                     m_effectManager;
+   ThreadPool &                        m_threadPool;
+   TextureLoader                       m_textureLoader;         // Decodes the textures of every requested model
+
+   std::list<StreamedModel::SharedPtr> m_loading;               // Requests that are not ready or failed yet, oldest first
+   std::vector<float>                  m_levelOfDetailRatios;   // Levels of detail to generate for each polygon set
+   bool                                m_quantizeVertices;      // Whether or not to quantize the vertices of each polygon set
+   bool                                m_generateClusters;      // Whether or not to split each polygon set into clusters
+   bool                                m_mergeSubmeshes;        // Whether or not to merge the polygon sets of each file into one
+   bool                                m_streamSourceFiles;     // Whether or not to read each file through a buffer rather than map it
+   BufferCache *                       m_bufferCache;           // Where to get shared buffers from, if anywhere
+};
+
+#endif // MODELSTREAMER_H
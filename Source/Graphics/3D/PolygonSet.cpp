@@ -7,7 +7,19 @@
 
 // Standard Includes
 #include <algorithm>
-#include <sstream>
+#include <cmath>
+
+//----------------------------------------------------------------------------------------------------------------------
+namespace
+{
+    /**
+    * Fewest triangles, in a row, that culled clusters must have to be skipped
+    *
+    * Skipping fewer than that costs more, in draw calls, than drawing them.
+    **/
+    const unsigned MIN_CULLED_TRIANGLES = 32;
+}
+
 
 //----------------------------------------------------------------------------------------------------------------------
 PolygonSet::PolygonSet(ID3D10Device & device,
@@ -16,7 +28,8 @@ PolygonSet::PolygonSet(ID3D10Device & device,
                        const Renderable::RenderType renderType)
     :
     Renderable(device, effectManager, renderType),   
-    m_inputLayoutManager(inputLayoutManager)
+    m_inputLayoutManager(inputLayoutManager),
+    m_levelOfDetailTolerance(0.001f)
 {
 }
 
@@ -24,28 +37,18 @@ PolygonSet::PolygonSet(ID3D10Device & device,
 PolygonSet::PolygonSet(const PolygonSet & rhs)
     :
     Renderable(rhs),
-    m_inputLayoutManager(rhs.m_inputLayoutManager)
+    m_inputLayoutManager(rhs.m_inputLayoutManager),
+    m_mesh(rhs.m_mesh),
+    m_perPassInfo(rhs.m_perPassInfo),
+    m_levelOfDetailTolerance(rhs.m_levelOfDetailTolerance)
 {
-    std::vector<Buffer::SharedPtr> buffers(rhs.m_vertexBuffers);
-    buffers.push_back(rhs.m_indexBuffer);
-
-    try
-    {
-        // Copy the vertex and index buffers
-        //
-        // NOTE - Probably not the most efficient to recreate the per pass info again, but simpler.
-        //        Consider copying directly later.
-        SetBuffers(buffers, rhs.m_primitiveTopology);
+    // Share the geometry and the per pass info already worked out for it, rather than validating it again
+    m_effectName    = rhs.m_effectName;
+    m_techniqueName = rhs.m_techniqueName;
 
-        // Copy the effect
-        SetEffectName(rhs.m_effectName, rhs.m_techniqueName);
-
-        // Copy the material
-        SetMaterial(rhs.GetMaterial());
-    }
-    catch(Common::Exception & e)
+    if( rhs.m_material.get() )
     {
-        throw e;
+        m_material.reset(new Material(*rhs.m_material));
     }
 }
 
@@ -63,102 +66,168 @@ PolygonSet & PolygonSet::operator = (const PolygonSet & rhs)
         return *this;
     }
 
-    std::vector<Buffer::SharedPtr> buffers;
-    std::copy(rhs.m_vertexBuffers.begin(), rhs.m_vertexBuffers.end(), buffers.begin());
-    buffers.push_back(rhs.m_indexBuffer);
-
     try
     {
         this->Renderable::operator = (rhs);
-
-        // Copy the vertex and index buffers
-        //
-        // NOTE - Probably not the most efficient to recreate the per pass info again, but simpler.
-        //        Consider copying directly later.
-        SetBuffers(buffers, rhs.m_primitiveTopology);
-
-        // Copy the effect
-        SetEffectName(rhs.m_effectName, rhs.m_techniqueName);
-
-        // Copy the material
-        SetMaterial(rhs.GetMaterial());
     }
     catch(Common::Exception & e)
     {
         throw e;
     }
 
+    // Share the geometry and the per pass info already worked out for it, rather than validating it again
+    m_mesh                   = rhs.m_mesh;
+    m_perPassInfo            = rhs.m_perPassInfo;
+    m_levelOfDetailTolerance = rhs.m_levelOfDetailTolerance;
+    m_effectName             = rhs.m_effectName;
+    m_techniqueName          = rhs.m_techniqueName;
+
+    if( rhs.m_material.get() )
+    {
+        m_material.reset(new Material(*rhs.m_material));
+    }
+    else
+    {
+        m_material.reset();
+    }
+
     return *this;
 }
 
 //---------------------------------------------------------------------------
 void PolygonSet::SetBuffers(const std::vector<Buffer::SharedPtr> & buffers, const D3D10_PRIMITIVE_TOPOLOGY topology)
 {
-    // Release all the current buffers
-    m_vertexBuffers.clear();
-    m_indexBuffer.reset();
-
-    // Store the new buffers
-    for( std::vector<Buffer::SharedPtr>::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
-    {
-        // At render time, the PolygonSet can be drawn using indices or with a regular draw call
-        // If an index buffer is provided then we know to draw this PolygonSet using indices
-        // A check will be made at render time to see if an index buffer has been set or not
-        //
-        // Seperate the vertex buffers from the index buffer, if an index buffer was provided
-        if( (*it)->GetContentType() == INDEX )
-        {
-            if( m_indexBuffer )
-            {
-                const std::string msg("Only one index buffer is permitted");
-                throw Common::Exception(__FILE__, __LINE__, msg);
-            }
+    MeshResource::SharedPtr mesh;
 
-            m_indexBuffer = (*it);
-            continue;
-        }
+    try
+    {
+        mesh.reset(new MeshResource(m_effectManager, m_inputLayoutManager, buffers, topology));
+        SetMesh(mesh);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
 
-        // Currently, per instance data is not supported using this class
-        if( (*it)->IsPerInstance() )
-        {
-            const std::string msg("Currently, per instance data is not supported using this class");
-            throw Common::Exception(__FILE__, __LINE__, msg);
-        }
+//---------------------------------------------------------------------------
+void PolygonSet::SetMesh(const MeshResource::SharedPtr & mesh)
+{
+    if( !mesh )
+    {
+        const std::string msg("No mesh resource was provided");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    m_mesh = mesh;
 
-        m_vertexBuffers.push_back(*it);
+    SetLocalBounds(m_mesh->GetBounds());
+
+    // Validate the buffers against the technique, if a technique is set
+    try
+    {
+        UpdatePerPassInfo();
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
     }
+}
 
-    // Check that we have at least one vertex buffer
-    if( m_vertexBuffers.empty() )
+//---------------------------------------------------------------------------
+const MeshResource::SharedPtr & PolygonSet::GetMesh() const
+{
+    return m_mesh;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSet::SetLevelsOfDetail(const std::vector<Buffer::SharedPtr> & indexBuffers,
+                                   const std::vector<float> & errors)
+{
+    try
     {
-        const std::string msg("No vertex buffer was provided");
-        throw Common::Exception(__FILE__, __LINE__, msg);
+        GetUniqueMesh().SetLevelsOfDetail(indexBuffers, errors);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
     }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSet::SetLevelOfDetailTolerance(const float screenFraction)
+{
+    m_levelOfDetailTolerance = screenFraction;
+}
 
-    // Check that all vertex buffers have the same number of elements
-    unsigned numVertices = m_vertexBuffers[0]->GetNumElements();
+//---------------------------------------------------------------------------
+const unsigned PolygonSet::GetNumLevelsOfDetail() const
+{
+    return m_mesh ? static_cast<unsigned>(m_mesh->GetLevelOfDetailBuffers().size()) : 0;
+}
 
-    for(std::vector<Buffer::SharedPtr>::const_iterator it = m_vertexBuffers.begin(); it != m_vertexBuffers.end(); ++it)
+//---------------------------------------------------------------------------
+void PolygonSet::SetClusters(const std::vector<MeshCluster> & clusters)
+{
+    try
     {
-        if( (*it)->GetNumElements() != numVertices )
-        {
-            const std::string msg("Not all vertex buffers, containing per vertex data, contain the same number of elements");
-            throw Common::Exception(__FILE__, __LINE__, msg);
-        }
+        GetUniqueMesh().SetClusters(clusters);
     }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
 
-    // Validate the buffers against the technique, if a technique is set
+//---------------------------------------------------------------------------
+const unsigned PolygonSet::GetNumClusters() const
+{
+    return m_mesh ? static_cast<unsigned>(m_mesh->GetClusters().size()) : 0;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSet::SetSubmeshes(const std::vector<Submesh> & submeshes)
+{
     try
     {
-        CreatePerPassInfo();
+        GetUniqueMesh().SetSubmeshes(submeshes);
     }
     catch(Common::Exception & e)
     {
         throw e;
     }
+}
 
-    // Store the primitive topology
-    m_primitiveTopology = topology;
+//---------------------------------------------------------------------------
+const unsigned PolygonSet::GetNumSubmeshes() const
+{
+    return m_mesh ? static_cast<unsigned>(m_mesh->GetSubmeshes().size()) : 0;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSet::SetPositionDequantization(const float scale, const D3DXVECTOR3 & bias)
+{
+    try
+    {
+        GetUniqueMesh().SetPositionDequantization(scale, bias);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSet::SetTexCoordDequantization(const D3DXVECTOR2 & scale, const D3DXVECTOR2 & bias)
+{
+    try
+    {
+        GetUniqueMesh().SetTexCoordDequantization(scale, bias);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -169,7 +238,7 @@ void PolygonSet::SetEffectName(const std::string & effectName, const std::string
         Renderable::SetEffectName(effectName, techniqueName);
 
         // Validate the technique against the buffers, if the buffers are set
-        CreatePerPassInfo();
+        UpdatePerPassInfo();
     }
     catch(Common::Exception & e)
     {
@@ -181,7 +250,7 @@ void PolygonSet::SetEffectName(const std::string & effectName, const std::string
 void PolygonSet::Render()
 {
     // Check if the vertex buffers were validated against the technique
-    if( m_perPassInfo.empty() )
+    if( !m_perPassInfo || m_perPassInfo->empty() )
     {
         // Error, someone set the effect without a matching technique, or vica versa,
         // or one of them did not get set.
@@ -202,53 +271,111 @@ void PolygonSet::Render()
     //        This would be a possible optimization if tracking isn't as costly
 
     // Set the effect variables
+    Effect * effect = NULL;
+
     try
     {
-        Effect & effect = m_effectManager.GetChildEffect(m_effectName);
-        effect.SetWorldMatrix(GetTransform());
-        effect.SetMaterial(*m_material);
+        effect = &(m_effectManager.GetChildEffect(m_effectName));
+
+        if( m_mesh->IsPositionQuantized() )
+        {
+            effect->SetWorldMatrix(m_mesh->GetPositionDequantization() * GetTransform());
+        }
+        else
+        {
+            effect->SetWorldMatrix(GetTransform());
+        }
+
+        // Set every time, so that the decoding of the last quantized polygon set drawn does not carry over
+        effect->SetTexCoordDequantization(m_mesh->GetTexCoordDequantization());
+
+        effect->SetMaterial(*m_material);
     }
     catch(Common::Exception & e)
     {
         throw e;
     }
 
+    // Choose the level of detail
+    // Submeshes are ranges of the full detail indices, and are never combined with levels of detail
+    const MeshResource & mesh        = *m_mesh;
+    Buffer::SharedPtr    indexBuffer = mesh.GetSubmeshes().empty() ? SelectIndexBuffer() : mesh.GetIndexBuffer();
+
+    // Choose what parts of it to draw
+    m_drawRanges.clear();
+
+    if( indexBuffer && indexBuffer == mesh.GetIndexBuffer() && !mesh.GetClusters().empty() )
+    {
+        CullClusters();
+
+        if( m_drawRanges.empty() )
+        {
+            return;
+        }
+    }
+    else if( indexBuffer )
+    {
+        DrawRange range;
+        range.m_firstIndex = 0;
+        range.m_numIndices = indexBuffer->GetNumElements();
+        m_drawRanges.push_back(range);
+    }
+
+    // Tell the texture manager how much detail the textures need, now that it is known that they are drawn
+    RequestTextureDetail(*effect);
+
     // Tell the input assembler how to assemble the vertices into primitives
-    m_device.IASetPrimitiveTopology(m_primitiveTopology);
+    m_device.IASetPrimitiveTopology(mesh.GetPrimitiveTopology());
 
     // Render each pass
-    for(std::vector<PassInfo>::iterator itPassInfo = m_perPassInfo.begin(); itPassInfo != m_perPassInfo.end(); ++itPassInfo)
+    for(std::vector<MeshResource::PassInfo>::const_iterator itPassInfo = m_perPassInfo->begin(); itPassInfo != m_perPassInfo->end(); ++itPassInfo)
     {
         // Bind the input layout
         m_device.IASetInputLayout(itPassInfo->m_inputLayout);
 
         // Bind the vertex buffers the technique requires
-        std::vector<ID3D10Buffer *> vertexBuffers;
-      
-        for(std::vector<unsigned>::iterator itIndex = itPassInfo->m_vertexBufferIndices.begin();
-            itIndex != itPassInfo->m_vertexBufferIndices.end(); ++ itIndex)
-        {
-            vertexBuffers.push_back( m_vertexBuffers[*itIndex]->GetD3DBuffer() );
-        }
-
         m_device.IASetVertexBuffers(0, 
-                                    static_cast<UINT>(itPassInfo->m_vertexBufferIndices.size()),
-                                    &vertexBuffers[0], 
+                                    static_cast<UINT>(itPassInfo->m_d3dBuffers.size()),
+                                    &(itPassInfo->m_d3dBuffers[0]), 
                                     &(itPassInfo->m_strides[0]), 
                                     &(itPassInfo->m_offsets[0]));
 
         // Check if we are drawing using an index buffer
-        if( m_indexBuffer )
+        if( indexBuffer )
         {
             // Bind the index buffer
-            m_device.IASetIndexBuffer(m_indexBuffer->GetD3DBuffer(), GetFormat(INDEX), 0);
+            m_device.IASetIndexBuffer(indexBuffer->GetD3DBuffer(), GetFormat(INDEX), 0);
+
+            // Draw each submesh from the buffers already bound, applying the pass again with its material,
+            // which takes the place of the material of the polygon set (see SetSubmeshes)
+            if( !mesh.GetSubmeshes().empty() )
+            {
+                for(std::vector<Submesh>::const_iterator itSubmesh = mesh.GetSubmeshes().begin(); itSubmesh != mesh.GetSubmeshes().end(); ++itSubmesh)
+                {
+                    try
+                    {
+                        effect->SetMaterial(itSubmesh->m_material);
+                    }
+                    catch(Common::Exception & e)
+                    {
+                        throw e;
+                    }
+
+                    itPassInfo->m_pass->Apply();
+                    m_device.DrawIndexed(itSubmesh->m_numIndices, itSubmesh->m_firstIndex, 0);
+                }
+
+                continue;
+            }
 
             // Apply the pass
             itPassInfo->m_pass->Apply();
 
             // Draw
-            unsigned numIndices = m_indexBuffer->GetNumElements();
-            m_device.DrawIndexed(numIndices, 0, 0);
+            for(std::vector<DrawRange>::const_iterator itRange = m_drawRanges.begin(); itRange != m_drawRanges.end(); ++itRange)
+            {
+                m_device.DrawIndexed(itRange->m_numIndices, itRange->m_firstIndex, 0);
+            }
         }
         else
         {
@@ -262,7 +389,7 @@ void PolygonSet::Render()
 }
 
 //---------------------------------------------------------------------------
-void PolygonSet::CreatePerPassInfo()
+void PolygonSet::UpdatePerPassInfo()
 {
     // Clear the per pass info
     //
@@ -270,192 +397,234 @@ void PolygonSet::CreatePerPassInfo()
     // Allowing the client to make a call to change the buffers with the intention 
     // of setting the effect afterward, when an old effect is still set. The reverse
     // scenario is possible too. The Render method will need to check if this is empty.
-    m_perPassInfo.clear();
+    m_perPassInfo.reset();
 
     // If there are not vertex buffers or there is not technique set, we cannot validate
     // Validation will happen when all of the above are set
-    if( m_vertexBuffers.empty() || 
+    if( !m_mesh                 || 
         m_effectName.empty()    ||
         m_techniqueName.empty() )
     {
         return;
     }
-   
-    // Validate the buffers against the technique
-    Technique * technique = NULL;
 
     try
     {
-        Effect & effect = m_effectManager.GetChildEffect(m_effectName);
-        technique       = &(effect.GetTechnique(m_techniqueName));
+        m_perPassInfo = m_mesh->GetPerPassInfo(m_effectName, m_techniqueName);
     }
     catch(Common::Exception & e)
     {
         throw e;
     }
+}
 
-    // Go through each pass of the technique
-    for(unsigned passIndex = 0; passIndex < technique->GetNumPasses(); ++passIndex)
+//---------------------------------------------------------------------------
+MeshResource & PolygonSet::GetUniqueMesh()
+{
+    if( !m_mesh )
     {
-        Pass * pass = NULL;                         // The pass we are verifying
-        std::vector<unsigned> vertexBufferIndices;  // Indices to vertex buffers that fulfill requirements of this pass
-      
-        try
-        {
-            pass = &(technique->GetPass(passIndex)); 
-        }
-        catch(Common::Exception & e)
-        {
-            throw e;
-        }
+        const std::string msg("No buffers have been set");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
 
-        // Make a copy of the requirements, describing the vertex data a technique expects. 
-        // A requirement will be removed when it is matched with a vertex buffer
-        std::vector<D3D10_SIGNATURE_PARAMETER_DESC> requirements;
-        requirements = pass->GetSignatureParamDescs();
+    // Other polygon sets keep the geometry they share as it is
+    if( m_mesh.use_count() > 1 )
+    {
+        m_mesh.reset(new MeshResource(*m_mesh));
+    }
+
+    return *m_mesh;
+}
+
+//---------------------------------------------------------------------------
+const bool PolygonSet::GetScreenFractionPerUnit(float & screenFractionPerUnit)
+{
+    // Without bounds there is no telling how close the geometry is
+    const BoundingVolume & bounds = GetLocalBounds();
 
-        // Make a copy of the available buffer indices
-        // An index will be removed when it is matched with a requirement
-        std::vector<unsigned> availableIndices;
+    if( bounds.IsEmpty() )
+    {
+        return false;
+    }
 
-        for(unsigned i = 0; i < m_vertexBuffers.size(); ++i)
+    D3DXMATRIX view;
+    D3DXMATRIX projection;
+    m_effectManager.GetViewMatrix(view);
+    m_effectManager.GetProjectionMatrix(projection);
+
+    const D3DXVECTOR3 & scale    = GetScale();
+    const float         maxScale = std::max<float>(fabsf(scale.x), std::max<float>(fabsf(scale.y), fabsf(scale.z)));
+
+    // A perspective projection's _22 is the cotangent of half the vertical field of view, so the viewport is
+    // 2 * distance / _22 units high at a distance. The nearest point of the bounding sphere is used, so no
+    // part of the geometry is drawn coarser than allowed. An orthographic projection's _22 is 2 / height.
+    screenFractionPerUnit = 0.5f * projection._22 * maxScale;
+
+    if( projection._34 != 0.0f )
+    {
+        D3DXVECTOR3 worldCenter;
+        D3DXVECTOR3 viewCenter;
+        D3DXVec3TransformCoord(&worldCenter, &bounds.m_sphereCenter, &GetTransform());
+        D3DXVec3TransformCoord(&viewCenter, &worldCenter, &view);
+
+        const float distance = D3DXVec3Length(&viewCenter) - bounds.m_sphereRadius * maxScale;
+
+        // The camera is inside the bounding sphere
+        if( distance <= 0.0f )
         {
-            availableIndices.push_back(i);
+            return false;
         }
 
-        // Keeps track of which slot the provided buffer will take
-        // I simply increment this for every buffer I provide
-        unsigned inputSlot = 0;
-      
-        // This map will keep track of the last semantic index of each provided buffer
-        // This way I can keep track of what semantic index is being provided and if it matches
-        // the requested semantic index.
-        //
-        // key- semantic name
-        // value - number of times that semantic has already been provided
-        std::map<std::string, unsigned> providedSemantics;
-
-        // This vector is used to build the input layout
-        // It holds descriptions of what each buffer contains, as we provide each buffer
-        std::vector<InputElementDescription> inputElementDescs;
-
-        // Go though the requirements and look for a match from the provided buffers
-        while( !requirements.empty() )
-        {
-            // Get the first requirement
-            std::string semanticName  = requirements.front().SemanticName;
-            unsigned    semanticIndex = requirements.front().SemanticIndex; 
+        screenFractionPerUnit /= distance;
+    }
 
-            // Check that the requested semantic index matches what we have provided so far
-            if( semanticIndex )
-            {
-            std::map<std::string, unsigned>::iterator it = providedSemantics.end();
-            
-            if( !providedSemantics.empty() )
-            {
-                it = providedSemantics.find(semanticName);
-            }
+    return true;
+}
 
-            if( it == providedSemantics.end() || 
-                it->second != semanticIndex - 1 )
-            {
-                const std::string msg = "A semantic has been requested by the technique with an index that does not "
-                                        "match how many times the semantic has been provided already."
-                                        "Check vertex buffer inputs to effect: " + m_effectName + " "
-                                        "technique: " + m_techniqueName + ", and that vertex buffers were provided by "
-                                        "the application in the correct order.";  // phew what an error message!
-                throw Common::Exception(__FILE__, __LINE__, msg);
-            }
-            }
+//---------------------------------------------------------------------------
+void PolygonSet::RequestTextureDetail(Effect & effect)
+{
+    // Textures are taken to be stretched once across the bounding sphere. Up close, or without bounds, all of
+    // their detail is needed.
+    float screenFractionPerUnit = 0.0f;
+    float screenFraction        = 1.0f;
 
-            // Search for a provided buffer with a matching semantic name
-            int  index;
-            bool found = false;
+    if( GetScreenFractionPerUnit(screenFractionPerUnit) )
+    {
+        screenFraction = 2.0f * GetLocalBounds().m_sphereRadius * screenFractionPerUnit;
+    }
 
-            for(std::vector<unsigned>::iterator itAvailableIndex = availableIndices.begin();
-                itAvailableIndex != availableIndices.end(); ++itAvailableIndex)
-            {
-            index = (*itAvailableIndex);
+    effect.RequestTextureDetail(*m_material, screenFraction);
 
-            // Check if the content type the buffer offers matches the semantic name we are looking for
-            if( ContentTypeToSemanticName(m_vertexBuffers[index]->GetContentType()) == semanticName )
-            {
-                // Found a match
-                found = true;
+    for(std::vector<Submesh>::const_iterator itSubmesh = m_mesh->GetSubmeshes().begin(); itSubmesh != m_mesh->GetSubmeshes().end(); ++itSubmesh)
+    {
+        effect.RequestTextureDetail(itSubmesh->m_material, screenFraction);
+    }
+}
 
-                // Remove the index from available indices for future searched
-                availableIndices.erase(itAvailableIndex);
+//---------------------------------------------------------------------------
+Buffer::SharedPtr PolygonSet::SelectIndexBuffer()
+{
+    const MeshResource &                   mesh                 = *m_mesh;
+    const std::vector<Buffer::SharedPtr> & levelOfDetailBuffers = mesh.GetLevelOfDetailBuffers();
+    const std::vector<float> &             levelOfDetailErrors  = mesh.GetLevelOfDetailErrors();
 
-                break;
-            }
-            }
- 
-            if( !found )
-            {
-            // Cannot provide the vertex buffer type required by the technique
-            std::stringstream msg;
-            msg << "The provided vertexs buffers do not contain a vertex buffer type required "
-                << "by the chosen technique."
-                << "\nSemanticName: " << semanticName;
+    if( levelOfDetailBuffers.empty() || m_levelOfDetailTolerance <= 0.0f )
+    {
+        return mesh.GetIndexBuffer();
+    }
 
-            throw Common::Exception(__FILE__, __LINE__, msg.str());
-            }
+    // Fraction of the viewport height that one unit of object space error covers. Errors are scaled along with 
+    // the geometry. From inside the bounding sphere, any error could be seen.
+    float screenFractionPerUnit = 0.0f;
 
-            // We have a match
-         
-            // Store the index to the vertex buffer fulfilling the requirement         
-            vertexBufferIndices.push_back(index);
+    if( !GetScreenFractionPerUnit(screenFractionPerUnit) )
+    {
+        return mesh.GetIndexBuffer();
+    }
 
-            // Create an input element description
-            std::vector<InputElementDescription> thisElementDesc;
+    // Coarsest level that is within the tolerance
+    Buffer::SharedPtr indexBuffer = mesh.GetIndexBuffer();
 
-            InputElementDescription::GetInputElementDesc(thisElementDesc, 
-                                                        m_vertexBuffers[index]->GetContentType(), 
-                                                        semanticIndex,
-                                                        inputSlot,
-                                                        m_vertexBuffers[index]->IsPerInstance());
+    for(unsigned i = 0; i < levelOfDetailBuffers.size(); ++i)
+    {
+        if( levelOfDetailErrors[i] * screenFractionPerUnit > m_levelOfDetailTolerance )
+        {
+            break;
+        }
 
-            // Store the input element description
-            inputElementDescs.insert(inputElementDescs.end(), thisElementDesc.begin(), thisElementDesc.end());
+        indexBuffer = levelOfDetailBuffers[i];
+    }
 
-            // Remove requirement
-            unsigned numRequirementsToRemove = static_cast<unsigned>(thisElementDesc.size());
+    return indexBuffer;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSet::CullClusters()
+{
+    D3DXMATRIX view;
+    D3DXMATRIX projection;
+    m_effectManager.GetViewMatrix(view);
+    m_effectManager.GetProjectionMatrix(projection);
 
-            requirements.erase(requirements.begin(), requirements.begin() + numRequirementsToRemove);
+    // Cluster bounds are in object space, so the camera is brought into object space rather than the other way around
+    const D3DXMATRIX & world = GetTransform();
 
-            // Increment the input slot for the next vertex buffer
-            ++inputSlot;
+    const D3DXMATRIX worldView           = world * view;
+    const D3DXMATRIX worldViewProjection = worldView * projection;
 
-            // Increment the semantic index for vertex buffers with the same semantic
-            providedSemantics[semanticName] = semanticIndex;
+    // Planes of the view frustum, pointing inwards
+    const D3DXMATRIX & m = worldViewProjection;
+
+    D3DXPLANE planes[6] =
+    {
+        D3DXPLANE(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41),   // Left
+        D3DXPLANE(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41),   // Right
+        D3DXPLANE(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42),   // Bottom
+        D3DXPLANE(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42),   // Top
+        D3DXPLANE(m._13,         m._23,         m._33,         m._43),           // Near
+        D3DXPLANE(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43)    // Far
+    };
+
+    for(unsigned i = 0; i < 6; ++i)
+    {
+        D3DXPlaneNormalize(&planes[i], &planes[i]);
+    }
+
+    // Where the camera is and which way it looks
+    //
+    // A mirroring transform turns what the clusters consider backfacing around, so cones are not used then
+    D3DXMATRIX inverseWorldView;
+    D3DXMatrixIdentity(&inverseWorldView);
+
+    const bool useCones = D3DXMatrixInverse(&inverseWorldView, NULL, &worldView) != NULL && 
+                          D3DXMatrixDeterminant(&world) > 0.0f;
+
+    const bool  orthographic = projection._34 == 0.0f;
+    D3DXVECTOR3 cameraPosition(inverseWorldView._41, inverseWorldView._42, inverseWorldView._43);
+    D3DXVECTOR3 viewDirection (inverseWorldView._31, inverseWorldView._32, inverseWorldView._33);
+
+    if( useCones )
+    {
+        D3DXVec3Normalize(&viewDirection, &viewDirection);
+    }
+
+    // Gather the visible clusters into ranges, drawing through short runs of culled ones
+    const std::vector<MeshCluster> & clusters = m_mesh->GetClusters();
+
+    for(std::vector<MeshCluster>::const_iterator it = clusters.begin(); it != clusters.end(); ++it)
+    {
+        bool visible = true;
+
+        for(unsigned i = 0; i < 6 && visible; ++i)
+        {
+            visible = D3DXPlaneDotCoord(&planes[i], &it->m_sphereCenter) >= -it->m_sphereRadius;
         }
 
-        // Get or create an input layout that matches this input element description
-        ID3D10InputLayout * inputLayout = m_inputLayoutManager.GetInputLayout(inputElementDescs, *pass);
+        if( visible && useCones )
+        {
+            visible = orthographic ? !IsClusterBackfacingOrthographic(*it, viewDirection) 
+                                   : !IsClusterBackfacing(*it, cameraPosition);
+        }
 
-        // Calculate the offsets
-        std::vector<unsigned> offsets;
-        for(unsigned i = 0; i < vertexBufferIndices.size(); ++i)
+        if( !visible )
         {
-            offsets.push_back(0);
+            continue;
         }
 
-        // Calculate the strides
-        std::vector<unsigned> strides;
-        for(std::vector<unsigned>::iterator it = vertexBufferIndices.begin(); it != vertexBufferIndices.end(); ++it)
+        if( !m_drawRanges.empty() && 
+            it->m_firstIndex < m_drawRanges.back().m_firstIndex + m_drawRanges.back().m_numIndices + MIN_CULLED_TRIANGLES * 3 )
         {
-            unsigned index = *it;
-            unsigned stride = GetStride(m_vertexBuffers[index]->GetContentType());
-            strides.push_back(stride);
-        }      
-
-        // Calculate how many vertices will be drawn this pass
-        unsigned numVertices = m_vertexBuffers[vertexBufferIndices[0]]->GetNumElements(); 
-
-        // Store the filled out pass info
-        PassInfo passInfo(pass, vertexBufferIndices, offsets, strides, inputLayout, numVertices);
-        m_perPassInfo.push_back(passInfo);
-   }
+            m_drawRanges.back().m_numIndices = it->m_firstIndex + it->m_numIndices - m_drawRanges.back().m_firstIndex;
+        }
+        else
+        {
+            DrawRange range;
+            range.m_firstIndex = it->m_firstIndex;
+            range.m_numIndices = it->m_numIndices;
+            m_drawRanges.push_back(range);
+        }
+    }
 }
 
 //------------------------------------------------------------------------------------------
@@ -477,46 +646,3 @@ bool PolygonSet::CompareSigParamDescs::operator () (const D3D10_SIGNATURE_PARAME
 
     return false;
 }
-
-//------------------------------------------------------------------------------------------
-PolygonSet::PassInfo::PassInfo(Pass * pass,
-                               const std::vector<unsigned> & vertexBufferIndices,
-                               const std::vector<unsigned> & offsets,
-                               const std::vector<unsigned> & strides,
-                               ID3D10InputLayout * inputLayout,
-                               unsigned numVertices)
-    :
-    m_pass               (pass),
-    m_vertexBufferIndices(vertexBufferIndices),
-    m_offsets            (offsets),
-    m_strides            (strides),
-    m_inputLayout        (inputLayout),
-    m_numVertices        (numVertices)
-{
-}
-
-//------------------------------------------------------------------------------------------
-PolygonSet::PassInfo::PassInfo(const PassInfo & rhs)
-    :
-    m_pass               (rhs.m_pass),
-    m_vertexBufferIndices(rhs.m_vertexBufferIndices),
-    m_offsets            (rhs.m_offsets),
-    m_strides            (rhs.m_strides),
-    m_inputLayout        (rhs.m_inputLayout),
-    m_numVertices        (rhs.m_numVertices)
-{
-}
-
-//------------------------------------------------------------------------------------------
-PolygonSet::PassInfo & PolygonSet::PassInfo::operator = (const PassInfo & rhs)
-{
-    m_pass                = rhs.m_pass;
-    m_vertexBufferIndices = rhs.m_vertexBufferIndices;
-    m_offsets             = rhs.m_offsets;
-    m_strides             = rhs.m_strides;
-    m_inputLayout         = rhs.m_inputLayout;
-    m_numVertices         = rhs.m_numVertices;
-
-    return *this;
-}
-
@@ -7,6 +7,8 @@
 #include "Graphics\3D\Renderable.h"
 #include "Graphics\3D\Buffers.h"
 #include "Graphics\3D\InputLayoutManager.h"
+#include "Graphics\3D\MeshClusterer.h"
+#include "Graphics\3D\MeshResource.h"
 #include "Graphics\Effects\EffectManager.h"
 #include "Graphics\Effects\Effect.h"
 #include "Graphics\Effects\Material.h"
@@ -30,10 +32,20 @@
 *
 * If any additional processing is needed between render passes, the class will need to be derived 
 * from and the Render method modified to suit custom needs.
+*
+* The geometry is held in a MeshResource that copies of the polygon set share, along with the information
+* needed to bind it for their technique. A copy only has a transform and material of its own, so making many
+* instances of the same geometry costs no validation against the technique. Changing the geometry of a polygon
+* set that shares it first gives the polygon set a copy of its own.
 */
 class PolygonSet : public Renderable
 {
 public:
+
+   /**
+   * A range of the index buffer that is drawn with a material of its own
+   **/
+   typedef MeshResource::Submesh Submesh;
    
    /**
    * Constructor
@@ -51,7 +63,7 @@ public:
    /**
    * Copy Constructor
    *
-   * @throws BaseException - if setting of buffers, effect, or material fails
+   * The copy shares the geometry, and the information needed to bind it, with the original
    **/
    PolygonSet(const PolygonSet & rhs);
 
@@ -63,7 +75,7 @@ public:
    /**
    * Assignement Operator
    *
-   * @throws BaseException - if setting of buffers, effect, or material fails
+   * @throws BaseException - if the polygon sets were created with different devices or managers
    **/
    PolygonSet & operator = (const PolygonSet & rhs);
 
@@ -71,13 +83,123 @@ public:
    /**
    * Sets the buffers that contain the geometry data
    *
-   * @param buffers - 
+   * The local bounds are taken from the POSITION buffer. They are left empty if it does not know them, as for
+   * interleaved buffers, in which case they can be set with SetLocalBounds afterwards.
+   *
+   * @param buffers -
    * @param topology - 
    *
    * @throws BaseException - if the call failed. The exception will contain a more detailed error message.
    **/
    virtual void SetBuffers(const std::vector<Buffer::SharedPtr> & buffers, const D3D10_PRIMITIVE_TOPOLOGY topology);
 
+   /**
+   * Sets geometry that is shared with other polygon sets
+   *
+   * The local bounds are taken from the mesh resource. The mesh resource is not changed by the polygon set, 
+   * which takes a copy of its own before changing any of its geometry.
+   *
+   * @throws BaseException - if the mesh resource does not provide the data the technique that is set requires
+   **/
+   virtual void SetMesh(const MeshResource::SharedPtr & mesh);
+
+   /**
+   * Gets the geometry, to share with other polygon sets. NULL if no buffers have been set.
+   **/
+   const MeshResource::SharedPtr & GetMesh() const;
+
+   /**
+   * Sets simplified versions of the geometry, drawn in place of the index buffer when the polygon set is small on screen
+   *
+   * Each frame, the coarsest level whose error, projected onto the screen, is within the tolerance is drawn
+   * (see SetLevelOfDetailTolerance). Errors are projected from the nearest point of the bounding sphere of the
+   * local bounds, so the full detail geometry is drawn while those are not known. Setting the buffers again
+   * removes the levels of detail.
+   *
+   * @param indexBuffers - Index buffer of each level, from finest to coarsest, into the vertex buffers already set
+   * @param errors       - Largest distance, in object space, each level strays from the full detail geometry
+   *
+   * @throws BaseException - If there is no index buffer set, a buffer is not an index buffer, 
+   *                         there is not one error for each buffer, or there are submeshes set
+   **/
+   virtual void SetLevelsOfDetail(const std::vector<Buffer::SharedPtr> & indexBuffers,
+                                  const std::vector<float> & errors);
+
+   /**
+   * Sets how far a level of detail may stray from the full detail geometry on screen, 
+   * as a fraction of the height of the viewport
+   *
+   * Defaults to 0.001, about a pixel at 1080 lines. 0 always draws the full detail geometry.
+   **/
+   virtual void SetLevelOfDetailTolerance(const float screenFraction);
+
+   /**
+   * Gets the number of levels of detail, not counting the full detail geometry
+   **/
+   const unsigned GetNumLevelsOfDetail() const;
+
+   /**
+   * Sets clusters of the index buffer, so that the parts of the geometry that are outside of the view frustum 
+   * or that face entirely away from the camera are not drawn
+   *
+   * Clusters only apply when the full detail geometry is drawn. Setting the buffers again removes the clusters.
+   *
+   * @param clusters - Ranges of the index buffer, with their bounds in object space (see MeshClusterer.h)
+   *
+   * @throws BaseException - If there is no index buffer set, a cluster lies outside of it, or there are submeshes set
+   **/
+   virtual void SetClusters(const std::vector<MeshCluster> & clusters);
+
+   /**
+   * Gets the number of clusters the index buffer is split into, 0 if it is not
+   **/
+   const unsigned GetNumClusters() const;
+
+   /**
+   * Splits the index buffer into submeshes that are each drawn with their own material, 
+   * binding the buffers only once for all of them (see SubmeshMerger.h)
+   *
+   * Submeshes cannot be combined with levels of detail or clusters, which cover the whole of the index buffer.
+   * Setting the buffers again removes the submeshes. 
+   *
+   * NOTE - Each submesh is drawn with its own material, in place of the material of the polygon set, which is then
+   *        only used to sort it. SetMaterial does not change how the submeshes look. Set the submeshes again, with
+   *        new materials, to do that.
+   *
+   * @param submeshes - Ranges of the index buffer, with their materials
+   *
+   * @throws BaseException - If there is no index buffer set, a submesh lies outside of it, 
+   *                         or there are levels of detail or clusters set
+   **/
+   virtual void SetSubmeshes(const std::vector<Submesh> & submeshes);
+
+   /**
+   * Gets the number of submeshes the index buffer is split into, 0 if it is not
+   **/
+   const unsigned GetNumSubmeshes() const;
+
+   /**
+   * Sets how to decode positions that were quantized (see VertexQuantizer.h)
+   *
+   * The decoding is applied ahead of the transform, as part of the world matrix the effect is given.
+   * Setting the buffers again removes the decoding.
+   *
+   * @param scale - Uniform scale each quantized position is multiplied by
+   * @param bias  - Offset added to each position after it is scaled
+   **/
+   virtual void SetPositionDequantization(const float scale, const D3DXVECTOR3 & bias);
+
+   /**
+   * Sets how to decode texture coordinates that were quantized (see VertexQuantizer.h)
+   *
+   * The decoding belongs to the geometry rather than the material, so it is kept when the material is replaced.
+   * It is given to the effect each time the polygon set is rendered. Setting the buffers again removes the decoding.
+   *
+   * @param scale - Scale each quantized texture coordinate is multiplied by
+   * @param bias  - Offset added to each texture coordinate after it is scaled
+   **/
+   virtual void SetTexCoordDequantization(const D3DXVECTOR2 & scale, const D3DXVECTOR2 & bias);
+
    /**
    * Sets the effect to render
    *
@@ -99,10 +221,42 @@ public:
 protected:
 
    /**
-   * Recreates per pass info when buffers or the effect change.
-   * Also, performs the validation of the buffers against the technique that DirectX requires
+   * Looks up the per pass info when the geometry or the effect change.
+   * The mesh resource validates its buffers against each technique that DirectX requires, the first time it is used.
    **/
-   void CreatePerPassInfo();
+   void UpdatePerPassInfo();
+
+   /**
+   * Gets the mesh resource to change, copying it first if it is shared with other polygon sets
+   *
+   * @throws BaseException - if no buffers have been set
+   **/
+   MeshResource & GetUniqueMesh();
+
+   /**
+   * Gets the fraction of the viewport height that one unit of object space covers, at the nearest point of
+   * the bounding sphere of the local bounds
+   *
+   * @param screenFractionPerUnit - OUT - The fraction
+   * @return                      - false if the camera is inside the bounding sphere, so that anything is seen up close,
+   *                                or if the local bounds are not known
+   **/
+   const bool GetScreenFractionPerUnit(float & screenFractionPerUnit);
+
+   /**
+   * Tells the texture manager how large the textures of the materials are drawn, so that it can stream them
+   **/
+   void RequestTextureDetail(Effect & effect);
+
+   /**
+   * Chooses the index buffer to draw, from the levels of detail and how large the polygon set is on screen
+   **/
+   Buffer::SharedPtr SelectIndexBuffer();
+
+   /**
+   * Finds the ranges of the index buffer to draw, leaving out the clusters that cannot be seen
+   **/
+   void CullClusters();
 
    /**
    * Comparator used internally for sorting descriptions of vertex data a pass requires
@@ -112,37 +266,22 @@ protected:
       bool operator() (const D3D10_SIGNATURE_PARAMETER_DESC & lhs, const D3D10_SIGNATURE_PARAMETER_DESC & rhs);
    };
 
-   std::vector<Buffer::SharedPtr>  m_vertexBuffers;       // All provided vertex buffers
-   Buffer::SharedPtr               m_indexBuffer;         // Index buffer, NULL if not indexed
-   InputLayoutManager &            m_inputLayoutManager;  // Contains and creates input layouts for shaders
-   D3D10_PRIMITIVE_TOPOLOGY        m_primitiveTopology;   // What kind of primitives the vertex buffer hold
+   InputLayoutManager &            m_inputLayoutManager;      // Contains and creates input layouts for shaders
+   MeshResource::SharedPtr         m_mesh;                    // Geometry, shared with copies of the polygon set
+   MeshResource::PerPassInfo       m_perPassInfo;             // Information needed to render each pass, shared by every polygon set with the same geometry and technique
+
+   float                           m_levelOfDetailTolerance;  // Screen error allowed, as a fraction of the viewport height
 
    /**
-   * Container for data needed to render a single pass
+   * A range of the index buffer to draw
    **/
-   struct PassInfo
+   struct DrawRange
    {
-      PassInfo(Pass * pass,
-               const std::vector<unsigned> & vertexBufferIndices,
-               const std::vector<unsigned> & offsets,
-               const std::vector<unsigned> & strides,
-               ID3D10InputLayout * inputLayout,
-               const unsigned numVertices);
-
-      PassInfo(const PassInfo & rhs);
-      PassInfo & operator = (const PassInfo & rhs);
-
-      // TODO - Pass and InputLayout are candidates for a shared pointer
-
-      Pass *                    m_pass;                   // A single pass from a technique     
-      std::vector<unsigned>     m_vertexBufferIndices;    // Which buffers provide the data required for the pass
-      std::vector<unsigned>     m_offsets;                // For each vertex buffer, how many elements in to start from
-      std::vector<unsigned>     m_strides;                // For each vertex buffer, the size in bytes of one element
-      ID3D10InputLayout *       m_inputLayout;            // Input layout used for a specific pass
-      unsigned                  m_numVertices;            // Number of vertices to draw this pass
+      unsigned m_firstIndex;
+      unsigned m_numIndices;
    };
 
-   std::vector<PassInfo>        m_perPassInfo;            // Information needed to render each pass
+   std::vector<DrawRange>          m_drawRanges;              // Ranges of the clusters that were not culled this frame
 };
 
 #endif // POLYGONSET_H
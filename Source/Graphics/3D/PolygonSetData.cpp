@@ -0,0 +1,179 @@
+
+// Project Includes
+#include "PolygonSetData.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+MaterialChannelData::MaterialChannelData()
+    :
+    m_mapped     (false),
+    m_color      (0.0f, 0.0f, 0.0f, 0.0f),
+    m_textureFile("")
+{
+}
+
+//------------------------------------------------------------------------------
+MaterialData::MaterialData()
+    :
+    m_materialType    (0),
+    m_shaderType      (0),
+    m_specularExponent(0.0f)
+{
+}
+
+//------------------------------------------------------------------------------
+PolygonSetData::LevelOfDetail::LevelOfDetail()
+    :
+    m_numIndices       (0),
+    m_mappedIndexOffset(0),
+    m_error            (0.0f)
+{
+}
+
+//------------------------------------------------------------------------------
+PolygonSetData::Submesh::Submesh()
+    :
+    m_firstIndex(0),
+    m_numIndices(0)
+{
+}
+
+//------------------------------------------------------------------------------
+PolygonSetData::PolygonSetData()
+    :
+    m_numVertices       (0),
+    m_numIndices        (0),
+    m_mappedVertexOffset(0),
+    m_mappedIndexOffset (0)
+{
+}
+
+//------------------------------------------------------------------------------
+const unsigned PolygonSetData::GetVertexSize() const
+{
+    unsigned vertexSize = 0;
+
+    for(std::vector<BufferContentType>::const_iterator it = m_contentTypes.begin(); it != m_contentTypes.end(); ++it)
+    {
+        vertexSize += GetStride(*it);
+    }
+
+    return vertexSize;
+}
+
+//------------------------------------------------------------------------------
+const unsigned char * PolygonSetData::GetVertexData() const
+{
+    if( m_mappedFile && m_vertices.empty() )
+    {
+        return m_mappedFile->GetData() + m_mappedVertexOffset;
+    }
+
+    return m_vertices.empty() ? NULL : &m_vertices[0];
+}
+
+//------------------------------------------------------------------------------
+const Index * PolygonSetData::GetIndexData() const
+{
+    if( m_mappedFile && m_indices.empty() )
+    {
+        return reinterpret_cast<const Index *>(m_mappedFile->GetData() + m_mappedIndexOffset);
+    }
+
+    return m_indices.empty() ? NULL : &m_indices[0];
+}
+
+//------------------------------------------------------------------------------
+const Index * PolygonSetData::GetLevelOfDetailIndexData(const unsigned level) const
+{
+    const LevelOfDetail & levelOfDetail = m_levelsOfDetail.at(level);
+
+    if( m_mappedFile && levelOfDetail.m_indices.empty() )
+    {
+        return reinterpret_cast<const Index *>(m_mappedFile->GetData() + levelOfDetail.m_mappedIndexOffset);
+    }
+
+    return levelOfDetail.m_indices.empty() ? NULL : &levelOfDetail.m_indices[0];
+}
+
+//------------------------------------------------------------------------------
+const bool PolygonSetData::IsQuantized() const
+{
+    return std::find(m_contentTypes.begin(), m_contentTypes.end(), POSITION16) != m_contentTypes.end();
+}
+
+//------------------------------------------------------------------------------
+void PolygonSetData::CopyFromMappedFile()
+{
+    if( !m_mappedFile )
+    {
+        return;
+    }
+
+    // Some may have been decoded into memory already (see MeshCodec.h)
+    if( m_vertices.empty() )
+    {
+        const unsigned char * vertices = GetVertexData();
+        m_vertices.assign(vertices, vertices + static_cast<size_t>(m_numVertices) * GetVertexSize());
+    }
+
+    if( m_indices.empty() )
+    {
+        const Index * indices = GetIndexData();
+        m_indices.assign(indices, indices + m_numIndices);
+    }
+
+    for(unsigned i = 0; i < m_levelsOfDetail.size(); ++i)
+    {
+        LevelOfDetail & levelOfDetail = m_levelsOfDetail[i];
+
+        if( levelOfDetail.m_indices.empty() )
+        {
+            const Index * levelIndices = GetLevelOfDetailIndexData(i);
+            levelOfDetail.m_indices.assign(levelIndices, levelIndices + levelOfDetail.m_numIndices);
+            levelOfDetail.m_mappedIndexOffset = 0;
+        }
+    }
+
+    m_mappedFile.reset();
+    m_mappedVertexOffset = 0;
+    m_mappedIndexOffset  = 0;
+}
+
+//------------------------------------------------------------------------------
+void PolygonSetData::CalculateBounds()
+{
+    // Find where the position is in each vertex
+    unsigned positionOffset = 0;
+    bool     hasPosition    = false;
+
+    for(std::vector<BufferContentType>::const_iterator it = m_contentTypes.begin(); it != m_contentTypes.end(); ++it)
+    {
+        if( *it == POSITION )
+        {
+            hasPosition = true;
+            break;
+        }
+
+        positionOffset += GetStride(*it);
+    }
+
+    if( !hasPosition )
+    {
+        const std::string msg("Cannot calculate the bounds of vertices without a position");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( m_numVertices == 0 )
+    {
+        m_bounds = BoundingVolume();
+        return;
+    }
+
+    CalculateBoundingVolume(GetVertexData() + positionOffset, m_numVertices, GetVertexSize(), m_bounds);
+}
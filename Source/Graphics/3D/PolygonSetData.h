@@ -0,0 +1,188 @@
+#ifndef POLYGONSETDATA_H
+#define POLYGONSETDATA_H
+
+// EngineX Includes
+#include "Core\MappedFile.h"
+#include "Graphics\3D\BoundingVolume.h"
+#include "Graphics\3D\Buffers.h"
+#include "Graphics\3D\MeshClusterer.h"
+#include "Graphics\3D\MeshOptimizer.h"
+#include "Graphics\3D\VertexQuantizer.h"
+
+// DirectX Includes
+#include <d3d10.h>
+#include <dxgi.h>
+#include <d3dx10.h>
+
+// Standard Includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+/**
+* One channel of an imported material, which is either mapped to a texture file or is a solid color
+**/
+struct MaterialChannelData
+{
+   /**
+   * Constructor
+   *
+   * By default, the channel is unmapped and black
+   **/
+   MaterialChannelData();
+
+
+   bool        m_mapped;        // Whether or not the channel is mapped to a texture
+   D3DXCOLOR   m_color;         // Color of the channel, if it is not mapped
+   std::string m_textureFile;   // File name of the texture the channel is mapped to, if it is mapped
+};
+
+//------------------------------------------------------------------------------
+/**
+* Description of an imported material, before any effect, material, or texture has been created for it
+**/
+struct MaterialData
+{
+   /**
+   * Constructor
+   **/
+   MaterialData();
+
+
+   unsigned            m_materialType;       // Type of material it was exported from
+   unsigned            m_shaderType;         // Type of shader it was exported from
+   MaterialChannelData m_ambient;
+   MaterialChannelData m_emissive;
+   MaterialChannelData m_diffuse;
+   MaterialChannelData m_specular;
+   float               m_specularExponent;
+};
+
+//------------------------------------------------------------------------------
+/**
+* A texture that the material of an imported polygon set is mapped to
+*
+* Textures must be loaded by the time the PolygonSet is created, or they are loaded then, one at a time.
+**/
+struct TextureDependency
+{
+   std::string m_textureName;   // Name the material refers to the texture by
+   std::string m_textureFile;   // File name of the texture, in the texture manager's directory
+};
+
+//------------------------------------------------------------------------------
+/**
+* Everything needed to create a PolygonSet, without any D3D resources
+*
+* Vertices are interleaved, in the order of the content types, and drawn as an indexed triangle list.
+* The vertices, and each list of indices, are either held in memory by this object, or lie in a mapped file 
+* that this object keeps open. Whatever is held in memory is used in place of the file.
+**/
+struct PolygonSetData
+{
+   /**
+   * A simplified version of the geometry, drawn from the same vertices with its own indices
+   **/
+   struct LevelOfDetail
+   {
+      /**
+      * Constructor
+      **/
+      LevelOfDetail();
+
+
+      std::vector<Index> m_indices;             // Indices, when held in memory
+      unsigned           m_numIndices;
+      size_t             m_mappedIndexOffset;   // Offset of the indices in the mapped file, if they are not held in memory
+      float              m_error;               // Largest distance, in object space, it strays from the full detail surface
+   };
+
+   /**
+   * A range of the indices drawn with a material of its own, in a polygon set that several were merged into
+   **/
+   struct Submesh
+   {
+      /**
+      * Constructor
+      **/
+      Submesh();
+
+
+      unsigned     m_firstIndex;   // Where the submesh starts in the indices
+      unsigned     m_numIndices;
+      MaterialData m_material;
+   };
+
+   /**
+   * Constructor
+   **/
+   PolygonSetData();
+
+   /**
+   * Gets the size in bytes of one vertex, according to the content types
+   **/
+   const unsigned GetVertexSize() const;
+
+   /**
+   * Gets the interleaved vertices
+   **/
+   const unsigned char * GetVertexData() const;
+
+   /**
+   * Gets the indices
+   **/
+   const Index * GetIndexData() const;
+
+   /**
+   * Gets the indices of a level of detail
+   *
+   * @param level - Index into m_levelsOfDetail
+   **/
+   const Index * GetLevelOfDetailIndexData(const unsigned level) const;
+
+   /**
+   * Query whether or not the vertices have been quantized (see VertexQuantizer.h)
+   **/
+   const bool IsQuantized() const;
+
+   /**
+   * Copies any vertices and indices that lie in the mapped file into memory and closes the file,
+   * so that they can be changed
+   **/
+   void CopyFromMappedFile();
+
+   /**
+   * Calculates the bounding box and sphere from the positions of the vertices (see BoundingVolume.h)
+   *
+   * @throws BaseException - If there is no POSITION content, which includes vertices that have been quantized
+   **/
+   void CalculateBounds();
+
+
+   MaterialData                   m_material;             // Material of all of the indices, or of the first submesh if there are submeshes
+   std::vector<Submesh>           m_submeshes;            // Ranges of the indices with a material each, if polygon sets were merged
+
+   std::vector<BufferContentType> m_contentTypes;         // What each vertex is made of, in order
+   unsigned                       m_numVertices;
+   unsigned                       m_numIndices;
+
+   std::vector<unsigned char>     m_vertices;             // Interleaved vertices, when held in memory
+   std::vector<Index>             m_indices;              // Indices, when held in memory
+
+   MappedFile::SharedPtr          m_mappedFile;           // File the vertices and indices lie in, if they are not held in memory
+   size_t                         m_mappedVertexOffset;   // Offset of the vertices in the mapped file
+   size_t                         m_mappedIndexOffset;    // Offset of the indices in the mapped file
+
+   BoundingVolume                 m_bounds;               // Bounding box and sphere, in object space
+
+   std::vector<LevelOfDetail>     m_levelsOfDetail;       // Simplified versions of the geometry, from finest to coarsest
+
+   VertexQuantization             m_quantization;         // How to decode the vertices, if they are quantized
+
+   std::vector<MeshCluster>       m_clusters;             // Ranges of the indices that can be culled on their own, if clustered
+
+   MeshOptimizationReport         m_optimizationReport;   // Vertex cache statistics from when the data was imported
+};
+
+#endif // POLYGONSETDATA_H
@@ -0,0 +1,552 @@
+#include "PolygonSetImporter.h"
+
+// EngineX Includes
+#include "Core\BinaryCursor.h"
+#include "Core\BinaryFileReader.h"
+#include "Core\MappedFile.h"
+#include "Graphics\3D\CookedMesh.h"
+#include "Graphics\3D\MeshClusterer.h"
+#include "Graphics\3D\MeshSimplifier.h"
+#include "Graphics\3D\SubmeshMerger.h"
+#include "Graphics\3D\TangentFrames.h"
+#include "Graphics\3D\TextMeshParser.h"
+#include "Graphics\3D\VertexQuantizer.h"
+#include "Graphics\3D\VertexWelder.h"
+
+// Common Lib Includes
+#include "Exception.h"
+#include "StringUtility.h"
+
+// Standard Includes
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <ctype.h>
+
+//---------------------------------------------------------------------------
+namespace
+{
+    // Size in bytes of the buffer binary files are read through, when they are not mapped
+    const size_t READ_BUFFER_SIZE = 1 << 20;
+
+    // Most bytes of a triangle soup that are welded at once
+    const size_t WELD_CHUNK_SIZE = 1 << 18;
+}
+
+//---------------------------------------------------------------------------
+PolygonSetImporter::PolygonSetImporter()
+    :
+    m_quantizeVertices(false),
+    m_generateClusters(false),
+    m_mergeSubmeshes(false),
+    m_streamSourceFiles(false),
+    m_compressCookedMeshes(false),
+    m_materialParsed(false),
+    m_verticesParsed(false),
+    m_numVertices(0),
+    m_numUVSets(0)
+{
+}
+
+//---------------------------------------------------------------------------
+PolygonSetImporter::~PolygonSetImporter()
+{
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::ImportFile(const std::string & filepath,
+                                  std::vector<PolygonSetData> & polygonSets,
+                                  const bool generateTangentData)
+{
+    // Use the cooked mesh if there is one that was cooked with these settings, otherwise do all the work of importing the file
+    const std::string cookedFilepath = GetCookedMeshFilePath(filepath);
+
+    if( IsCookedMeshCurrent(filepath, cookedFilepath, GetCookedMeshSettings(generateTangentData)) )
+    {
+        ReadCookedMesh(cookedFilepath, polygonSets);
+    }
+    else
+    {
+        ParseSourceFile(filepath, polygonSets);
+    }
+
+    for(std::vector<PolygonSetData>::iterator it = polygonSets.begin(); it != polygonSets.end(); ++it)
+    {
+        GenerateLevelOfDetailData(*it);
+    }
+
+    if( generateTangentData )
+    {
+        for(std::vector<PolygonSetData>::iterator it = polygonSets.begin(); it != polygonSets.end(); ++it)
+        {
+            GenerateTangentData(*it);
+        }
+    }
+
+    for(std::vector<PolygonSetData>::iterator it = polygonSets.begin(); it != polygonSets.end(); ++it)
+    {
+        GenerateClusterData(*it);
+    }
+
+    // Merge what is left unclustered, so that each merged polygon set is quantized as a whole
+    if( m_mergeSubmeshes )
+    {
+        MergeSubmeshes(polygonSets);
+    }
+
+    // Quantize last, as everything above works on full precision vertices
+    for(std::vector<PolygonSetData>::iterator it = polygonSets.begin(); it != polygonSets.end(); ++it)
+    {
+        QuantizeVertexData(*it);
+    }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::CookFile(const std::string & filepath, const bool generateTangentData)
+{
+    std::vector<PolygonSetData> polygonSets;
+    ParseSourceFile(filepath, polygonSets);
+
+    // In the same order as ImportFile
+    for(std::vector<PolygonSetData>::iterator it = polygonSets.begin(); it != polygonSets.end(); ++it)
+    {
+        GenerateLevelOfDetailData(*it);
+
+        if( generateTangentData )
+        {
+            GenerateTangentData(*it);
+        }
+
+        GenerateClusterData(*it);
+        QuantizeVertexData(*it);
+    }
+
+    WriteCookedMesh(GetCookedMeshFilePath(filepath), polygonSets, GetCookedMeshSettings(generateTangentData), m_compressCookedMeshes);
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::SetLevelOfDetailRatios(const std::vector<float> & ratios)
+{
+    m_levelOfDetailRatios = ratios;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::SetQuantizeVertices(const bool quantizeVertices)
+{
+    m_quantizeVertices = quantizeVertices;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::SetGenerateClusters(const bool generateClusters)
+{
+    m_generateClusters = generateClusters;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::SetMergeSubmeshes(const bool mergeSubmeshes)
+{
+    m_mergeSubmeshes = mergeSubmeshes;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::SetStreamSourceFiles(const bool streamSourceFiles)
+{
+    m_streamSourceFiles = streamSourceFiles;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::SetCompressCookedMeshes(const bool compressCookedMeshes)
+{
+    m_compressCookedMeshes = compressCookedMeshes;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::ParseSourceFile(const std::string & filepath,
+                                       std::vector<PolygonSetData> & polygonSets)
+{
+    // Text meshes exported from Maya have a parser of their own
+    if( IsTextMeshFile(filepath) )
+    {
+        ParseTextMesh(filepath, polygonSets);
+        return;
+    }
+
+    try
+    {
+        if( m_streamSourceFiles )
+        {
+            BinaryFileReader reader(filepath, READ_BUFFER_SIZE);
+            ParseBinaryData(reader, filepath, polygonSets);
+        }
+        else
+        {
+            // The mapping only needs to live until the vertices have been welded out of it
+            MappedFile   file(filepath);
+            BinaryCursor cursor(file.GetData(), file.GetSize());
+
+            ParseBinaryData(cursor, filepath, polygonSets);
+        }
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::ParseBinaryData(BinaryReader & reader,
+                                       const std::string & filepath,
+                                       std::vector<PolygonSetData> & polygonSets)
+{
+    polygonSets.clear();
+
+    m_materialData   = MaterialData();
+    m_materialParsed = false;
+    m_verticesParsed = false;
+    m_numVertices    = 0;
+    m_numUVSets      = 0;
+    m_weldedVertices.clear();
+    m_weldedIndices.clear();
+
+    while( !reader.IsEnd() )
+    {
+        // Read in a data identifier (1 byte unsigned integral value)
+        unsigned int dataID = reader.ReadUInt8();
+
+        switch( dataID )
+        {
+            // Materials
+            case MATERIAL_START:
+            {
+                ParseMaterial(reader);
+                break;
+            }
+
+            // Vertices
+            case VERTICES_START:
+            {
+                ParseVertices(reader);
+                break;
+            }
+
+            // Signal's all data was parsed for one polygon set
+            case POLYGONSET_END:
+            {
+                BuildPolygonSetData(polygonSets);
+                break;
+            }
+     
+            // Unknown
+            default:
+            {
+                std::ostringstream msg;
+                msg << "Unknown data identifier encountered in file: " << filepath << " at offset " << (reader.GetPosition() - 1);
+
+                throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::ParseMaterial(BinaryReader & reader)
+{
+    // Release the current material
+    m_materialData   = MaterialData();
+    m_materialParsed = false;
+
+    // Get the material type (1 byte unsigned integral value)
+    m_materialData.m_materialType = reader.ReadUInt8();
+
+    // Check if we know how to parse this material type
+    if( m_materialData.m_materialType >= NUM_MATERIAL_TYPES )
+    {
+        const std::string msg("Unknown material type");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Get the shader type (1 byte unsigned integral value)
+    m_materialData.m_shaderType = reader.ReadUInt8();
+
+    // Check if we know how to parse this shader type
+    if( m_materialData.m_shaderType > NUM_SHADERTYPES )
+    {
+        const std::string msg("Unknown shader type");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Get each channel, which is either mapped to a texture or a color
+    ParseMaterialChannel(reader, m_materialData.m_ambient);
+    ParseMaterialChannel(reader, m_materialData.m_emissive);
+    ParseMaterialChannel(reader, m_materialData.m_diffuse);
+    ParseMaterialChannel(reader, m_materialData.m_specular);
+
+    // Get the specular exponent
+    m_materialData.m_specularExponent = reader.ReadFloat();
+
+    m_materialParsed = true;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::ParseMaterialChannel(BinaryReader & reader,
+                                            MaterialChannelData & channel)
+{
+    // Get whether or not the color is mapped to a texture (1 byte unsigned integral value)
+    channel.m_mapped = reader.ReadUInt8() != 0;
+
+    if( channel.m_mapped )
+    {
+        // Get the texture file name the color is mapped to
+        reader.ReadString(channel.m_textureFile);
+    }
+    else
+    {
+        // Get the color
+        channel.m_color.r = reader.ReadFloat();
+        channel.m_color.g = reader.ReadFloat();
+        channel.m_color.b = reader.ReadFloat();
+        channel.m_color.a = reader.ReadFloat();
+    }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::ParseVertices(BinaryReader & reader)
+{
+    // Get how many vertices to parse (4 byte unsigned integral value)
+    m_numVertices = reader.ReadUInt32();
+
+    // Get how many UVs each vertex has (1 byte unsigned integral value)
+    m_numUVSets = reader.ReadUInt8();
+
+    // Each vertex is a position, a normal, and a number of UVs, all of them floats
+    const size_t vertexSize = sizeof(Position) + sizeof(Normal) + m_numUVSets * sizeof(TexCoord2D);
+
+    if( m_numVertices > reader.GetRemaining() / vertexSize )
+    {
+        std::ostringstream msg;
+        msg << "Error parsing vertices. " << m_numVertices << " vertices were expected at offset " 
+            << reader.GetPosition() << ", but the file is too short to contain them";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    // Weld the triangle soup as it is read
+    //
+    // The exporter writes every corner of every triangle, so vertices shared between triangles are
+    // repeated. Only unique vertices are kept, and an index buffer is used to reference them.
+    VertexWelder   welder(static_cast<unsigned>(vertexSize), m_numVertices);
+    const unsigned verticesPerChunk = static_cast<unsigned>(std::max<size_t>(WELD_CHUNK_SIZE / vertexSize, 1));
+    unsigned       numWelded        = 0;
+
+    while( numWelded < m_numVertices )
+    {
+        const unsigned numChunkVertices = std::min<unsigned>(verticesPerChunk, m_numVertices - numWelded);
+
+        welder.AddVertices(reader.ReadBytes(numChunkVertices * vertexSize), numChunkVertices);
+        numWelded += numChunkVertices;
+    }
+
+    welder.TakeResult(m_weldedVertices, m_weldedIndices);
+    m_verticesParsed = true;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::BuildPolygonSetData(std::vector<PolygonSetData> & polygonSets)
+{
+    if( !m_verticesParsed || !m_materialParsed )
+    {
+        const std::string msg("A polygon set ended before both its material and vertices were parsed");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( m_numVertices == 0 )
+    {
+        const std::string msg("A polygon set has no vertices");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    polygonSets.push_back(PolygonSetData());
+    PolygonSetData & polygonSet = polygonSets.back();
+
+    polygonSet.m_material = m_materialData;
+
+    // Each vertex is a position, a normal, and then one TexCoord2D per UV set
+    polygonSet.m_contentTypes.push_back(POSITION);
+    polygonSet.m_contentTypes.push_back(NORMAL);
+
+    for(unsigned i = 0; i < m_numUVSets; ++i)
+    {
+        polygonSet.m_contentTypes.push_back(TEXCOORD2D);
+    }
+
+    const unsigned vertexSize = polygonSet.GetVertexSize();
+
+    polygonSet.m_vertices.swap(m_weldedVertices);
+    polygonSet.m_indices.swap(m_weldedIndices);
+
+    // Reorder for the post-transform vertex cache and then for vertex fetch
+    polygonSet.m_optimizationReport = OptimizeMesh(polygonSet.m_vertices, vertexSize, polygonSet.m_indices);
+
+    polygonSet.m_numVertices = static_cast<unsigned>(polygonSet.m_vertices.size() / vertexSize);
+    polygonSet.m_numIndices  = static_cast<unsigned>(polygonSet.m_indices.size());
+
+    polygonSet.CalculateBounds();
+
+    // The vertices have been consumed
+    m_weldedVertices.clear();
+    m_weldedIndices.clear();
+    m_verticesParsed = false;
+    m_numVertices    = 0;
+}
+
+//---------------------------------------------------------------------------
+const CookedMeshSettings PolygonSetImporter::GetCookedMeshSettings(const bool generateTangentData) const
+{
+    CookedMeshSettings settings;
+    settings.m_levelOfDetailRatios = m_levelOfDetailRatios;
+    settings.m_quantizeVertices    = m_quantizeVertices;
+    settings.m_generateClusters    = m_generateClusters;
+    settings.m_generateTangentData = generateTangentData;
+
+    return settings;
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::GenerateTangentData(PolygonSetData & polygonSet)
+{
+    if( std::find(polygonSet.m_contentTypes.begin(), polygonSet.m_contentTypes.end(), TANGENT) != polygonSet.m_contentTypes.end() )
+    {
+        return;
+    }
+
+    // Left over indices mean the source was malformed. The polygon set is drawn as it was imported.
+    if( polygonSet.m_optimizationReport.m_numLeftoverIndices )
+    {
+        return;
+    }
+
+    if( polygonSet.IsQuantized() )
+    {
+        const std::string msg("Cannot generate tangent data for vertices that have already been quantized");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // The vertices are about to be rebuilt, so they cannot stay in the mapped file
+    polygonSet.CopyFromMappedFile();
+
+    AddTangentFrames(polygonSet.m_vertices, polygonSet.m_contentTypes, polygonSet.m_indices);
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::GenerateLevelOfDetailData(PolygonSetData & polygonSet)
+{
+    // Quantized vertices came from a cooked mesh, which already had any levels of detail it is going to get
+    // Nor are they generated when indices were left over, as the source was malformed
+    if( m_levelOfDetailRatios.empty() || !polygonSet.m_levelsOfDetail.empty() || polygonSet.IsQuantized() ||
+        polygonSet.m_optimizationReport.m_numLeftoverIndices )
+    {
+        return;
+    }
+
+    try
+    {
+        GenerateLevelsOfDetail(polygonSet, m_levelOfDetailRatios);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::GenerateClusterData(PolygonSetData & polygonSet)
+{
+    if( !m_generateClusters || !polygonSet.m_clusters.empty() || polygonSet.m_optimizationReport.m_numLeftoverIndices )
+    {
+        return;
+    }
+
+    try
+    {
+        GenerateClusters(polygonSet);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::QuantizeVertexData(PolygonSetData & polygonSet)
+{
+    if( !m_quantizeVertices || polygonSet.IsQuantized() )
+    {
+        return;
+    }
+
+    // The vertices are about to be rebuilt, so they cannot stay in the mapped file
+    polygonSet.CopyFromMappedFile();
+
+    try
+    {
+        QuantizeVertices(polygonSet.m_vertices, polygonSet.m_contentTypes, polygonSet.m_numVertices, polygonSet.m_quantization);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//---------------------------------------------------------------------------
+void PolygonSetImporter::GetTextureDependencies(const std::vector<PolygonSetData> & polygonSets,
+                                              std::vector<TextureDependency> & dependencies) const
+{
+    // Gather the materials, including those of each submesh
+    std::vector<const MaterialData *> materials;
+
+    for(std::vector<PolygonSetData>::const_iterator itData = polygonSets.begin(); itData != polygonSets.end(); ++itData)
+    {
+        materials.push_back(&itData->m_material);
+
+        for(std::vector<PolygonSetData::Submesh>::const_iterator itSubmesh = itData->m_submeshes.begin(); itSubmesh != itData->m_submeshes.end(); ++itSubmesh)
+        {
+            materials.push_back(&itSubmesh->m_material);
+        }
+    }
+
+    for(std::vector<const MaterialData *>::const_iterator itMaterial = materials.begin(); itMaterial != materials.end(); ++itMaterial)
+    {
+        const MaterialChannelData * channels[] = { &(*itMaterial)->m_ambient,
+                                                   &(*itMaterial)->m_emissive,
+                                                   &(*itMaterial)->m_diffuse,
+                                                   &(*itMaterial)->m_specular };
+
+        for(size_t i = 0; i < sizeof(channels) / sizeof(channels[0]); ++i)
+        {
+            if( !channels[i]->m_mapped )
+            {
+                continue;
+            }
+
+            // Named the same way SetMaterialChannel names it
+            TextureDependency dependency;
+            dependency.m_textureFile = channels[i]->m_textureFile;
+            RemoveExtFromFilename(dependency.m_textureFile, dependency.m_textureName);
+
+            bool listed = false;
+
+            for(std::vector<TextureDependency>::const_iterator it = dependencies.begin(); it != dependencies.end(); ++it)
+            {
+                if( it->m_textureName == dependency.m_textureName )
+                {
+                    listed = true;
+                    break;
+                }
+            }
+
+            if( !listed )
+            {
+                dependencies.push_back(dependency);
+            }
+        }
+    }
+}
@@ -0,0 +1,305 @@
+#ifndef POLYGONSETIMPORTER_H
+#define POLYGONSETIMPORTER_H
+
+// EngineX Includes
+#include "Core\BinaryReader.h"
+#include "Graphics\3D\CookedMesh.h"
+#include "Graphics\3D\MeshOptimizer.h"
+#include "Graphics\3D\PolygonSetData.h"
+
+// Standard Includes
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// Imports binary files that were exported from 3DS Max using the EngineX export maxscript, into descriptions
+// of the polygon sets they contain, without creating any D3D resources (see PolygonSetData.h)
+//
+// The file is memory mapped and walked with a bounds checked cursor. Vertex data is laid out in the
+// file exactly as D3D expects interleaved vertices, so it is used in place. The exporter writes triangle
+// soups, which are welded into unique vertices and an index buffer. The triangles and vertices are then 
+// reordered for the post-transform vertex cache and for vertex fetch.
+//
+// Text meshes exported from Maya (see TextMeshParser.h) are recognized by their .txt extension and go through
+// the same welding and optimization.
+//
+// Levels of detail can be generated for each polygon set (see MeshSimplifier.h and SetLevelOfDetailRatios), 
+// the indices can be split into clusters that are culled on their own (see MeshClusterer.h and SetGenerateClusters),
+// and the vertices can be quantized into smaller formats (see VertexQuantizer.h and SetQuantizeVertices).
+//
+// All of that work can be done ahead of time with CookFile. When a current cooked mesh (see CookedMesh.h)
+// exists next to the file being imported, it is loaded instead and none of the above is repeated. A cooked mesh
+// is only current if it was cooked with the same settings as the importer has when the file is imported.
+//
+// Nothing here uses a device, so tools that only inspect or cook meshes can use it without one.
+// PolygonSetParser adds the creation of PolygonSets on top.
+//
+class PolygonSetImporter
+{
+public:
+
+   /**
+   * Constructor
+   **/
+   PolygonSetImporter();
+   
+   /**
+   * Deconstructor
+   **/
+   virtual ~PolygonSetImporter();
+
+
+   /**
+   * Loads descriptions of the polygon sets in a binary file, without creating any PolygonSets
+   *
+   * If a cooked mesh that is current exists next to the file, the cooked mesh is loaded instead. It is current only
+   * if it was cooked with the same settings as this importer has, and the same generateTangentData.
+   *
+   * NOTE - May be called on any thread, as long as no other thread is using the same importer at the time.
+   *
+   * @param filepath            - Path to the binary file to parse
+   * @param polygonSets         - OUT - Descriptions of the polygon sets in the file
+   * @param generateTangentData - If true, will calculate a tangent and bitangent for each vertex, in object space
+   *
+   * @throws - BaseException if there was a parsing error
+   **/
+   virtual void ImportFile(const std::string & filepath,
+                           std::vector<PolygonSetData> & polygonSets,
+                           const bool generateTangentData = false);
+
+   /**
+   * Lists the textures the materials of imported polygon sets are mapped to, so that they can be loaded 
+   * together before the PolygonSets are created, such as by a TextureLoader
+   *
+   * NOTE - Does not use the device or any of the managers, so it may be called on any thread
+   *
+   * @param polygonSets      - Descriptions of polygon sets, from ImportFile
+   * @param dependencies     - OUT - Each texture they are mapped to that is not in the list already is appended
+   **/
+   virtual void GetTextureDependencies(const std::vector<PolygonSetData> & polygonSets,
+                                       std::vector<TextureDependency> & dependencies) const;
+
+   /**
+   * Parses a binary file and writes the result to a cooked mesh next to it, without creating any PolygonSets
+   *
+   * The cooked mesh is used by ImportFile when it is given the same generateTangentData, and the importer
+   * has the same settings as when the file was cooked.
+   *
+   * @param filepath            - Path to the binary file to cook
+   * @param generateTangentData - If true, will calculate a tangent and bitangent for each vertex, in object space
+   *
+   * @throws - BaseException if there was a parsing error or the cooked mesh could not be written
+   **/
+   virtual void CookFile(const std::string & filepath, const bool generateTangentData = false);
+
+   /**
+   * Sets the levels of detail to generate for each polygon set, when a file is imported or cooked
+   *
+   * Polygon sets loaded from a cooked mesh that already has levels of detail keep those. 
+   * By default, none are generated.
+   *
+   * @param ratios - Fraction of the triangles of the full detail geometry each level keeps, in decreasing
+   *                 order, such as 0.5, 0.25, 0.1. Empty to generate none.
+   **/
+   virtual void SetLevelOfDetailRatios(const std::vector<float> & ratios);
+
+   /**
+   * Sets whether or not to quantize the vertices of each polygon set, when a file is imported or cooked
+   *
+   * Quantized polygon sets are rendered with the "RenderQuantized" technique. By default, vertices are not quantized.
+   **/
+   virtual void SetQuantizeVertices(const bool quantizeVertices);
+
+   /**
+   * Sets whether or not to split the indices of each polygon set into clusters, when a file is imported or cooked
+   *
+   * Clustered polygon sets skip drawing the clusters that are outside of the view frustum or that face entirely
+   * away from the camera. Polygon sets loaded from a cooked mesh that is already clustered stay clustered.
+   * By default, clusters are not generated.
+   **/
+   virtual void SetGenerateClusters(const bool generateClusters);
+
+   /**
+   * Sets whether or not to merge the polygon sets of a file that have the same vertex layout into one, 
+   * with a submesh per material, when a file is imported
+   *
+   * Merged polygon sets share one vertex and index buffer, bound once for all of their materials 
+   * (see SubmeshMerger.h). Polygon sets with levels of detail or clusters are not merged, and neither are those 
+   * loaded from a cooked mesh that is quantized. By default, polygon sets are not merged.
+   **/
+   virtual void SetMergeSubmeshes(const bool mergeSubmeshes);
+
+   /**
+   * Sets whether or not to read binary files through a buffer of fixed size, rather than mapping them, when a file
+   * is imported or cooked
+   *
+   * Either way, vertices are welded a part of the file at a time, so memory does not grow with the size of the
+   * triangle soup. Mapping a file uses as much address space as the file is large though, which a 32 bit process
+   * may not have to spare for a very large model. Reading is a little slower, so by default files are mapped.
+   **/
+   virtual void SetStreamSourceFiles(const bool streamSourceFiles);
+
+   /**
+   * Sets whether or not CookFile compresses the vertices and indices of the cooked meshes it writes (see MeshCodec.h)
+   *
+   * Compressed cooked meshes take less time to read from disk, and more to decode. By default, they are not compressed.
+   **/
+   virtual void SetCompressCookedMeshes(const bool compressCookedMeshes);
+
+protected:
+
+   enum DataID
+   {
+      MATERIAL_START = 0,
+      VERTICES_START,
+      POLYGONSET_END
+   };
+
+   enum MaterialType
+   {
+      MAX_STANDARD_MATERIAL  = 0,    // 3DS Max standard material 
+      NUM_MATERIAL_TYPES
+   };
+
+   enum ShaderType
+   {
+      MAX_ANISOTROPIC        = 0,    // 3DS Max anisotropic shader
+      MAX_BLINN,                     // 3DS Max blinn shader
+      MAX_METAL,                     // 3DS Max metal shader
+      MAX_MULTILAYER,                // 3DS Max multilayer shader
+      MAX_OREN_NAYAR_BLINN,          // 3DS Max oren nayar blinn shader
+      MAX_PHONG,                     // 3DS Max phong shader
+      MAX_STRAUSS,                   // 3DS Max straus shader
+      MAX_TRANSLUCENT,               // 3DS Max translucent shader
+      NUM_SHADERTYPES
+   };
+
+   /**
+   * Parses a binary file, or a text mesh, into descriptions of the polygon sets it contains
+   *
+   * @param filepath    - Path to the binary file to parse
+   * @param polygonSets - OUT - Welded and optimized polygon sets, which do not refer to the file
+   **/
+   virtual void ParseSourceFile(const std::string & filepath,
+                                std::vector<PolygonSetData> & polygonSets);
+
+   /**
+   * Parses binary data into descriptions of the polygon sets it contains
+   *
+   * @param reader      - Reader positioned at the start of the data
+   * @param filepath    - Path to the file the data came from, for error messages
+   * @param polygonSets - OUT - Welded and optimized polygon sets
+   **/
+   virtual void ParseBinaryData(BinaryReader & reader,
+                                const std::string & filepath,
+                                std::vector<PolygonSetData> & polygonSets);
+
+   /**
+   * Parse a material, after a MATERIAL_START data identifier was found
+   **/
+   virtual void ParseMaterial(BinaryReader & reader);
+
+   /**
+   * Parse one channel of a material, which is either mapped to a texture file or is a solid color
+   *
+   * @param channel OUT - The channel
+   **/
+   virtual void ParseMaterialChannel(BinaryReader & reader,
+                                     MaterialChannelData & channel);
+
+   /**
+   * Parse vertices, after a VERTICES_START data identifier was found
+   *
+   * The triangle soup is welded as it is read, a part at a time, so it is never held in memory as a whole.
+   **/
+   virtual void ParseVertices(BinaryReader & reader);
+
+
+   /**
+   * Describe a polygon set using the material and vertices parsed so far, after a POLYGONSET_END data identifier was found
+   *
+   * The welded vertices are optimized, and their bounds are calculated.
+   **/
+   virtual void BuildPolygonSetData(std::vector<PolygonSetData> & polygonSets);
+
+   /**
+   * Gets the settings that cooked meshes are written with, and have to have been written with to be used
+   **/
+   virtual const CookedMeshSettings GetCookedMeshSettings(const bool generateTangentData) const;
+
+   /**
+   * Adds a tangent and bitangent to each vertex of a polygon set, if it does not have them already
+   *
+   * Vertices and indices that lie in a mapped file are copied into memory first. Polygon sets with indices left
+   * over after their last whole triangle (see MeshOptimizationReport) are left as they are, here and below.
+   **/
+   virtual void GenerateTangentData(PolygonSetData & polygonSet);
+
+   /**
+   * Generates levels of detail for a polygon set, using the ratios that were set, if it does not have them already
+   **/
+   virtual void GenerateLevelOfDetailData(PolygonSetData & polygonSet);
+
+   /**
+   * Splits the indices of a polygon set into clusters, if clusters were requested and it does not have them already
+   *
+   * Vertices and indices that lie in a mapped file are copied into memory first.
+   **/
+   virtual void GenerateClusterData(PolygonSetData & polygonSet);
+
+   /**
+   * Quantizes the vertices of a polygon set, if quantization was requested and they are not quantized already
+   *
+   * Vertices and indices that lie in a mapped file are copied into memory first.
+   **/
+   virtual void QuantizeVertexData(PolygonSetData & polygonSet);
+
+   /**
+   * Fraction of the triangles each generated level of detail keeps
+   **/
+   std::vector<float>                    m_levelOfDetailRatios;
+
+   /**
+   * Whether or not to quantize the vertices of each polygon set
+   **/
+   bool                                  m_quantizeVertices;
+
+   /**
+   * Whether or not to split the indices of each polygon set into clusters
+   **/
+   bool                                  m_generateClusters;
+
+   /**
+   * Whether or not to merge the polygon sets of a file into one with submeshes
+   **/
+   bool                                  m_mergeSubmeshes;
+
+   /**
+   * Whether or not to read binary files through a buffer, rather than mapping them
+   **/
+   bool                                  m_streamSourceFiles;
+
+   /**
+   * Whether or not to compress the cooked meshes that are written
+   **/
+   bool                                  m_compressCookedMeshes;
+
+   /**
+   * Material of the current polygon set
+   **/
+   MaterialData                          m_materialData;
+   bool                                  m_materialParsed;
+
+   /**
+   * Welded vertices and indices of the current polygon set
+   *
+   * Each vertex is a position, a normal, and then one TexCoord2D per UV set
+   **/
+   std::vector<unsigned char>            m_weldedVertices;
+   std::vector<Index>                    m_weldedIndices;
+   bool                                  m_verticesParsed;
+   unsigned                              m_numVertices;
+   unsigned                              m_numUVSets;
+};
+
+#endif // POLYGONSETIMPORTER_H
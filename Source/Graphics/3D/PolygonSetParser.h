@@ -1,9 +1,12 @@
-
 #ifndef POLYGONSETPARSER_H
 #define POLYGONSETPARSER_H
 
 // EngineX Includes
+#include "Graphics\3D\BufferCache.h"
+#include "Graphics\3D\MeshOptimizer.h"
 #include "Graphics\3D\PolygonSet.h"
+#include "Graphics\3D\PolygonSetData.h"
+#include "Graphics\3D\PolygonSetImporter.h"
 #include "Graphics\3D\InputLayoutManager.h"
 #include "Graphics\Effects\EffectManager.h"
 
@@ -17,9 +20,14 @@
 #include <vector>
 
 //---------------------------------------------------------------------------
-// Parses binary files that were exported from 3DS Max using the EngineX export maxscript
+// Creates PolygonSets from binary files that were exported from 3DS Max using the EngineX export maxscript,
+// and from text meshes exported from Maya
+//
+// Files are imported into descriptions of their polygon sets by PolygonSetImporter (see PolygonSetImporter.h),
+// which does not need the device, and then a PolygonSet is created for each, along with its effect, textures,
+// and material.
 //
-class PolygonSetParser
+class PolygonSetParser : public PolygonSetImporter
 {
 public:
 
@@ -40,15 +48,44 @@ public:
    /**
    * Parses and creates PolygonSet objects from an binary file
    *
+   * If a cooked mesh that is current exists next to the file, the cooked mesh is loaded instead.
+   *
    * @param filepath                 - Path to the binary file to parse
-   * @param generateTangentData      - If true, will calculate per triangle tangent, bitangent, and normal, in object space 
-   *                                      and assign it to each vertex of a triangle
+   * @param generateTangentData      - If true, will calculate a tangent and bitangent for each vertex, in object space,
+   *                                      for use in normal mapping. See TangentFrames.h
    *
    * @throws - BaseException if there was a parsing error
    **/
    virtual void ParseFile(const std::string & filepath, 
                           const bool generateTangentData = false);
 
+   /**
+   * Creates and stores PolygonSet objects from descriptions of them, replacing those currently stored
+   *
+   * NOTE - Must be called on the thread that owns the device
+   *
+   * @throws - BaseException if a PolygonSet could not be created
+   **/
+   virtual void CreatePolygonSets(const std::vector<PolygonSetData> & polygonSets);
+
+   /**
+   * Creates a PolygonSet object from a description of one and adds it to those stored
+   *
+   * NOTE - Must be called on the thread that owns the device
+   *
+   * @throws - BaseException if the PolygonSet could not be created
+   **/
+   virtual void CreatePolygonSet(const PolygonSetData & polygonSetData);
+
+   /**
+   * Sets a cache to get vertex and index buffers from, so that polygon sets with the same contents share them
+   *
+   * By default, there is none and every polygon set gets its own buffers.
+   *
+   * @param bufferCache - The cache, which must outlive the polygon sets created, or NULL for none
+   **/
+   virtual void SetBufferCache(BufferCache * bufferCache);
+
    /**
    * Get the number of PolygonSet objects currently stored
    **/
@@ -62,50 +99,30 @@ public:
    **/
    virtual std::auto_ptr<PolygonSet> GetPolygonSet(const unsigned index);
 
-
-protected:
-
-   enum DataID
-   {
-      MATERIAL_START = 0,
-      VERTICES_START,
-      POLYGONSET_END
-   };
-
-   enum MaterialType
-   {
-      MAX_STANDARD_MATERIAL  = 0,    // 3DS Max standard material 
-      NUM_MATERIAL_TYPES
-   };
-
-   enum ShaderType
-   {
-      MAX_ANISOTROPIC        = 0,    // 3DS Max anisotropic shader
-      MAX_BLINN,                     // 3DS Max blinn shader
-      MAX_METAL,                     // 3DS Max metal shader
-      MAX_MULTILAYER,                // 3DS Max multilayer shader
-      MAX_OREN_NAYAR_BLINN,          // 3DS Max oren nayar blinn shader
-      MAX_PHONG,                     // 3DS Max phong shader
-      MAX_STRAUSS,                   // 3DS Max straus shader
-      MAX_TRANSLUCENT,               // 3DS Max translucent shader
-      NUM_SHADERTYPES
-   };
-
    /**
-   * Parse a material, after a MATERIAL_START data identifier was found
+   * Get how well a PolygonSet object that was a result of the last parse uses the vertex cache, 
+   * before and after it was optimized at import
+   *
+   * NOTE - Indexed the same as GetPolygonSet, so obtaining a PolygonSet removes its report as well
+   *
+   * @throws BaseException - If the index is out of range
    **/
-   virtual void ParseMaterial(std::ifstream & file);
+   virtual const MeshOptimizationReport & GetOptimizationReport(const unsigned index) const;
+
+
+protected:
 
    /**
-   * Parse vertices, after a VERTICES_START data identifier was found
+   * Create the effect, textures, and material a polygon set will be rendered with
    **/
-   virtual void ParseVertices(std::ifstream & file);
-
+   virtual std::auto_ptr<Material> CreateMaterial(const MaterialData & materialData);
 
    /**
-   * Create and allocate a PolygonSet object from the parsed data so far
+   * Sets a material channel to either a texture or a color
    **/
-   virtual void CreatePolygonSet(const bool generateTangentData);
+   virtual void SetMaterialChannel(Material & material,
+                                   const MaterialChannelData & channel,
+                                   const std::string & channelName);
 
 
    ID3D10Device &       m_device;
@@ -114,35 +131,23 @@ protected:
    EffectManager &      m_effectManager;
 
 
-   /**
-   *
-   **/
-   struct MaxStandardMaterialData
-   {
-	   ShaderType  m_shaderType;
-	
-	   bool        m_ambientMapped;
-	   D3DXCOLOR   m_ambientColor;
-      std::string m_ambientMappedFile;
-	
-	   bool        m_diffuseMapped;
-      D3DXCOLOR   m_diffuseColor;
-      std::string m_diffuseMappedFile;
-   };
-
-   std::vector<MaxStandardMaterialData> m_maxStandardMaterialDatas;
-
    std::string                           m_effectName;
    std::string                           m_techniqueName;
-   std::auto_ptr<Material>               m_material;
-   std::vector<Position>                 m_positions;
-   std::vector<Normal>                   m_normals;
-   std::vector<std::vector<TexCoord2D> > m_uvSets;
+
+   /**
+   * Where to get vertex and index buffers from, if they are shared
+   **/
+   BufferCache *                         m_bufferCache;
 
    /**
    * PolygonSets that were a result of the file
    **/
    std::vector<PolygonSet *> m_polygonSets;
+
+   /**
+   * Vertex cache statistics of each of the PolygonSets
+   **/
+   std::vector<MeshOptimizationReport> m_optimizationReports;
 };
 
 
@@ -213,21 +213,26 @@ RenderQueue::SortCriteria_Transparent::SortCriteria_Transparent(const D3DXMATRIX
 //----------------------------------------------------------------------------------------------------------------------
 bool RenderQueue::SortCriteria_Transparent::operator() (Renderable * lhs, Renderable * rhs) const
 {  
-    // Sort renderables by thier z coordinate in camera space
-    D3DXMATRIX worldView;
-    float z_lhs;
-    float z_rhs;
+    // Sort renderables by thier depth in camera space, farthest first
+    return GetNearestDepth(*lhs) > GetNearestDepth(*rhs);
+}
 
-    D3DXMatrixMultiply(&worldView, &(lhs->GetTransform()), &m_view);
-    z_lhs = lhs->GetPosition().z;
+//----------------------------------------------------------------------------------------------------------------------
+const float RenderQueue::SortCriteria_Transparent::GetNearestDepth(Renderable & renderable) const
+{
+    const BoundingVolume & bounds = renderable.GetWorldBounds();
 
-    D3DXMatrixMultiply(&worldView, &(rhs->GetTransform()), &m_view);
-    z_rhs = rhs->GetPosition().z;
-   
-    if( z_lhs < z_rhs )
+    D3DXVECTOR3 center = renderable.GetPosition();
+    float       radius = 0.0f;
+
+    if( !bounds.IsEmpty() )
     {
-        return true;
+        center = bounds.m_sphereCenter;
+        radius = bounds.m_sphereRadius;
     }
 
-    return false;
-}
\ No newline at end of file
+    D3DXVECTOR3 viewCenter;
+    D3DXVec3TransformCoord(&viewCenter, &center, &m_view);
+
+    return viewCenter.z - radius;
+}
@@ -73,7 +73,9 @@ protected:
    };
 
    /**
-   * Sorting criteria for opaque type renderables
+   * Sorting criteria for transparent type renderables
+   *
+   * Renderables are drawn back to front, by the depth in camera space of the nearest point of their world bounds
    **/
    struct SortCriteria_Transparent
    {
@@ -81,6 +83,12 @@ protected:
 
       bool operator () (Renderable * lhs,
                         Renderable * rhs) const;
+
+      /**
+      * Gets the depth in camera space of the nearest point of a renderable's world bounds,
+      * or of its position if it has no bounds
+      **/
+      const float GetNearestDepth(Renderable & renderable) const;
       
       const D3DXMATRIX m_view;
    };
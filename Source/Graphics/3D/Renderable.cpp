@@ -13,7 +13,8 @@ Renderable::Renderable(ID3D10Device & device,
     Transform      (),
     m_device       (device),
     m_effectManager(effectManager),
-    m_renderType   (renderType)
+    m_renderType   (renderType),
+    m_worldBoundsNeedUpdated(true)
 {
 }
 
@@ -28,7 +29,10 @@ Renderable::Renderable(const Renderable & rhs)
     Transform      (rhs),
     m_device       (rhs.m_device),
     m_effectManager(rhs.m_effectManager),
-    m_renderType   (rhs.m_renderType)
+    m_renderType   (rhs.m_renderType),
+    m_localBounds  (rhs.m_localBounds),
+    m_worldBounds  (rhs.m_worldBounds),
+    m_worldBoundsNeedUpdated(rhs.m_worldBoundsNeedUpdated)
 {
 }
 
@@ -49,7 +53,10 @@ Renderable & Renderable::operator = (const Renderable & rhs)
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    m_renderType    = rhs.m_renderType;
+    m_renderType             = rhs.m_renderType;
+    m_localBounds            = rhs.m_localBounds;
+    m_worldBounds            = rhs.m_worldBounds;
+    m_worldBoundsNeedUpdated = rhs.m_worldBoundsNeedUpdated;
 
     return *this;
 }
@@ -133,3 +140,37 @@ void Renderable::SetMaterial(const Material & material)
     m_material.reset(new Material(material));
 }
 
+//---------------------------------------------------------------------------
+const BoundingVolume & Renderable::GetLocalBounds() const
+{
+    return m_localBounds;
+}
+
+//---------------------------------------------------------------------------
+void Renderable::SetLocalBounds(const BoundingVolume & bounds)
+{
+    m_localBounds            = bounds;
+    m_worldBoundsNeedUpdated = true;
+}
+
+//---------------------------------------------------------------------------
+const BoundingVolume & Renderable::GetWorldBounds()
+{
+    // Bring the transform up to date first, which flags the bounds if it changed
+    const D3DXMATRIX & transform = GetTransform();
+
+    if( m_worldBoundsNeedUpdated )
+    {
+        TransformBoundingVolume(m_localBounds, transform, m_worldBounds);
+        m_worldBoundsNeedUpdated = false;
+    }
+
+    return m_worldBounds;
+}
+
+//---------------------------------------------------------------------------
+void Renderable::Update()
+{
+    Transform::Update();
+    m_worldBoundsNeedUpdated = true;
+}
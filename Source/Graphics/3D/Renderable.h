@@ -4,6 +4,7 @@
 #define RENDERABLE_H
 
 // EngineX Includes
+#include "Graphics\3D\BoundingVolume.h"
 #include "Graphics\3D\Transform.h"
 #include "Graphics\Effects\EffectManager.h"
 
@@ -119,10 +120,41 @@ public:
    * @param material -
    **/
    virtual void SetMaterial(const Material & material);
+
+
+   /**
+   * Gets the bounds of the object, in object space
+   *
+   * @returns - An empty volume if the extent of the object is not known
+   **/
+   virtual const BoundingVolume & GetLocalBounds() const;
+
+   /**
+   * Sets the bounds of the object, in object space
+   *
+   * @param bounds - Bounds of the geometry before it is transformed, or an empty volume if they are not known
+   **/
+   virtual void SetLocalBounds(const BoundingVolume & bounds);
+
+   /**
+   * Gets the bounds of the object, in world space
+   *
+   * They are derived from the object space bounds and the transform, and are only recalculated after either 
+   * has changed, so they are cheap to query every frame, for culling, sorting, or picking.
+   *
+   * @returns - An empty volume if the extent of the object is not known
+   **/
+   virtual const BoundingVolume & GetWorldBounds();
    
 
 protected:
 
+   /**
+   * Updates the transform matrix, and flags the world space bounds to be updated along with it
+   **/
+   virtual void Update();
+
+
    RenderType                      m_renderType;         // Determines how to queue renderables (see Renderqueue.h)
 
    ID3D10Device &                  m_device;             // D3D device
@@ -132,6 +164,10 @@ protected:
    std::string                     m_techniqueName;      // Name of the technique to use when rendering
    std::auto_ptr<Material>         m_material;           // Material hold all effect variable values to use when rendering
 
+   BoundingVolume                  m_localBounds;        // Extent of the object, in object space
+   BoundingVolume                  m_worldBounds;        // Extent of the object, in world space, as of the last update
+   bool                            m_worldBoundsNeedUpdated; // Whether or not the world space bounds are out of date
+
 
 
 private:
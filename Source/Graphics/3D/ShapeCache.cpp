@@ -0,0 +1,193 @@
+// Project Includes
+#include "ShapeCache.h"
+
+// EngineX Includes
+#include "Graphics\3D\MeshOptimizer.h"
+#include "Graphics\3D\Shapes.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cstring>
+
+//------------------------------------------------------------------------------------------
+bool ShapeCache::Key::operator < (const Key & rhs) const
+{
+    if( m_shapeType != rhs.m_shapeType )
+    {
+        return m_shapeType < rhs.m_shapeType;
+    }
+
+    // Compared by their bits, so that a NaN does not compare equal to every other size
+    const int sizeOrder = memcmp(m_size, rhs.m_size, sizeof(m_size));
+
+    if( sizeOrder != 0 )
+    {
+        return sizeOrder < 0;
+    }
+
+    if( m_segments != rhs.m_segments )
+    {
+        return m_segments < rhs.m_segments;
+    }
+
+    return m_flipNormals < rhs.m_flipNormals;
+}
+
+//------------------------------------------------------------------------------------------
+ShapeCache::ShapeCache(ID3D10Device & device)
+    :
+    m_device   (device),
+    m_numHits  (0),
+    m_numMisses(0)
+{
+}
+
+//------------------------------------------------------------------------------------------
+ShapeCache::~ShapeCache()
+{
+}
+
+//------------------------------------------------------------------------------------------
+void ShapeCache::GetSphere(const float radius,
+                           const unsigned segments,
+                           const bool flipNormals,
+                           std::vector<Buffer::SharedPtr> & buffers)
+{
+    Key key;
+    key.m_shapeType   = SHAPE_SPHERE;
+    key.m_size[0]     = radius;
+    key.m_size[1]     = 0.0f;
+    key.m_segments    = segments;
+    key.m_flipNormals = flipNormals;
+
+    if( Find(key, buffers) )
+    {
+        return;
+    }
+
+    std::vector<Position>   positions;
+    std::vector<TexCoord2D> texCoords;
+    std::vector<Normal>     normals;
+    std::vector<Index>      indices;
+
+    try
+    {
+        GenerateSphere(positions, texCoords, normals, indices, radius, segments, flipNormals);
+
+        // Paid once per sphere, rather than once per object drawn with it
+        OptimizeMesh(positions, texCoords, normals, indices);
+
+        Add(key, positions, texCoords, normals, indices, buffers);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void ShapeCache::GetQuad(const D3DXVECTOR2 & dimensions,
+                         std::vector<Buffer::SharedPtr> & buffers)
+{
+    Key key;
+    key.m_shapeType   = SHAPE_QUAD;
+    key.m_size[0]     = dimensions.x;
+    key.m_size[1]     = dimensions.y;
+    key.m_segments    = 0;
+    key.m_flipNormals = false;
+
+    if( Find(key, buffers) )
+    {
+        return;
+    }
+
+    std::vector<Position>   positions;
+    std::vector<TexCoord2D> texCoords;
+    std::vector<Normal>     normals;
+    std::vector<Index>      indices;
+
+    try
+    {
+        GenerateQuad(positions, texCoords, normals, indices, dimensions);
+        Add(key, positions, texCoords, normals, indices, buffers);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void ShapeCache::Clear()
+{
+    m_shapes.clear();
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned ShapeCache::GetNumShapes() const
+{
+    return static_cast<unsigned>(m_shapes.size());
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned ShapeCache::GetNumHits() const
+{
+    return m_numHits;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned ShapeCache::GetNumMisses() const
+{
+    return m_numMisses;
+}
+
+//------------------------------------------------------------------------------------------
+const bool ShapeCache::Find(const Key & key, std::vector<Buffer::SharedPtr> & buffers)
+{
+    ShapeMap::const_iterator it = m_shapes.find(key);
+
+    if( it == m_shapes.end() )
+    {
+        return false;
+    }
+
+    buffers = it->second;
+    ++m_numHits;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+void ShapeCache::Add(const Key & key,
+                     const std::vector<Position> & positions,
+                     const std::vector<TexCoord2D> & texCoords,
+                     const std::vector<Normal> & normals,
+                     const std::vector<Index> & indices,
+                     std::vector<Buffer::SharedPtr> & buffers)
+{
+    std::vector<Buffer::SharedPtr> created;
+
+    try
+    {
+        created.push_back(Buffer::SharedPtr(new Buffer(m_device, POSITION, positions)));
+        created.push_back(Buffer::SharedPtr(new Buffer(m_device, TEXCOORD2D, texCoords)));
+        created.push_back(Buffer::SharedPtr(new Buffer(m_device, NORMAL, normals)));
+
+        // Shapes drawn as strips have no indices
+        if( !indices.empty() )
+        {
+            created.push_back(Buffer::SharedPtr(new Buffer(m_device, INDEX, indices)));
+        }
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    m_shapes[key] = created;
+    ++m_numMisses;
+
+    buffers.swap(created);
+}
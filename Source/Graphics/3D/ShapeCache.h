@@ -0,0 +1,151 @@
+#ifndef SHAPECACHE_H
+#define SHAPECACHE_H
+
+// EngineX Includes
+#include "Graphics\3D\Buffers.h"
+
+// DirectX Includes
+#include <d3d10.h>
+#include <d3dx10.h>
+
+// Standard Includes
+#include <map>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+/**
+* Generates shapes (see Shapes.h) and creates buffers for them, once for each set of parameters
+*
+* Every request for a shape with the same parameters shares the same buffers, so creating many objects out of the
+* same sphere or quad costs no generation or upload after the first. The buffers are static, so they cannot be
+* written to by any of the objects sharing them. Spheres are optimized for the vertex cache and vertex fetch
+* (see MeshOptimizer.h) before their buffers are created.
+*
+* The cache holds on to every shape it created until it is cleared or destroyed, so that the next request
+* for one finds it, even if nothing was using it in between. It must only be used from the thread that owns the device.
+**/
+class ShapeCache
+{
+public:
+
+   /**
+   * Constructor
+   *
+   * @param device - D3D device the buffers are created on
+   **/
+   ShapeCache(ID3D10Device & device);
+
+   /**
+   * Deconstructor
+   **/
+   ~ShapeCache();
+
+
+   /**
+   * Gets the buffers of a sphere, generating it if there is none with the same parameters already (see GenerateSphere)
+   *
+   * @param buffers OUT - A POSITION, TEXCOORD2D, NORMAL, and INDEX buffer, to be drawn as a triangle list
+   *
+   * @throws BaseException - If the parameters do not make a sphere, or the buffers had to be created and creation failed
+   **/
+   void GetSphere(const float radius,
+                  const unsigned segments,
+                  const bool flipNormals,
+                  std::vector<Buffer::SharedPtr> & buffers);
+
+   /**
+   * Gets the buffers of a quad, generating it if there is none with the same dimensions already (see GenerateQuad)
+   *
+   * @param buffers OUT - A POSITION, TEXCOORD2D, and NORMAL buffer, to be drawn as a triangle strip
+   *
+   * @throws BaseException - If the buffers had to be created and creation failed
+   **/
+   void GetQuad(const D3DXVECTOR2 & dimensions,
+                std::vector<Buffer::SharedPtr> & buffers);
+
+   /**
+   * Releases the cache's references to every shape
+   *
+   * Buffers that are still in use stay alive until they are released, but are no longer handed out.
+   **/
+   void Clear();
+
+   /**
+   * Gets the number of shapes held
+   **/
+   const unsigned GetNumShapes() const;
+
+   /**
+   * Gets the number of requests that were given a shape that already existed
+   **/
+   const unsigned GetNumHits() const;
+
+   /**
+   * Gets the number of requests that had to generate their shape
+   **/
+   const unsigned GetNumMisses() const;
+
+private:
+
+   /** No Copy allowed */
+   ShapeCache(const ShapeCache & rhs);
+
+   /** No assignment allowed */
+   ShapeCache & operator = (const ShapeCache & rhs);
+
+   /**
+   * Kinds of shape
+   **/
+   enum ShapeType
+   {
+      SHAPE_SPHERE = 0,
+      SHAPE_QUAD
+   };
+
+   /**
+   * Identifies a shape by its kind and every parameter it was generated with
+   **/
+   struct Key
+   {
+      bool operator < (const Key & rhs) const;
+
+      ShapeType m_shapeType;
+      float     m_size[2];       // Radius of a sphere, or dimensions of a quad
+      unsigned  m_segments;      // Segments of a sphere
+      bool      m_flipNormals;   // Whether or not the normals of a sphere point inwards
+   };
+
+   /**
+   * Looks up a shape
+   *
+   * @return - false if there is no shape for the key
+   **/
+   const bool Find(const Key & key, std::vector<Buffer::SharedPtr> & buffers);
+
+   /**
+   * Creates the buffers of a shape and adds them to those held
+   **/
+   void Add(const Key & key,
+            const std::vector<Position> & positions,
+            const std::vector<TexCoord2D> & texCoords,
+            const std::vector<Normal> & normals,
+            const std::vector<Index> & indices,
+            std::vector<Buffer::SharedPtr> & buffers);
+
+
+   ID3D10Device & m_device;
+
+   /**
+   * Shapes that were created
+   *
+   * Key   - kind and parameters of the shape
+   * Value - its buffers, in the order they are handed out
+   **/
+   typedef std::map<Key, std::vector<Buffer::SharedPtr> > ShapeMap;
+   ShapeMap       m_shapes;
+
+   unsigned       m_numHits;
+   unsigned       m_numMisses;
+};
+
+#endif // SHAPECACHE_H
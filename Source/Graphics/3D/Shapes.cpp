@@ -7,9 +7,13 @@
 #include "Exception.h"
 
 // Standard Includes
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
+// SSE Includes
+#include <emmintrin.h>
+
 //------------------------------------------------------------------------------
 void GenerateSphere(std::vector<Position> & positions,
                     std::vector<TexCoord2D> & texCoords,
@@ -46,132 +50,123 @@ void GenerateSphere(std::vector<Position> & positions,
     //  \     /   Middle rings contain an extra vertex at the same position as the start point to allow texture to be wrapped.
     //   1 _ 2    Top and Botton rings do not contain the extra vertex
 
-    // Start with an empty vectors of data
-    positions.clear();
-    texCoords.clear();
-    normals.clear();
-
-    // Check min divisions = 3
-    if( segments < 3 )
+    // Check min divisions = 4, as fewer leaves no middle ring to join the caps to
+    if( segments < 4 )
     {
-        std::ostringstream msg("Sphere requires a minimum of 3 segments to be classified as a sphere at all.");
-        msg << " segments param: " << segments;
+        std::ostringstream msg;
+        msg << "Sphere requires a minimum of 4 segments to be classified as a sphere at all."
+            << " segments param: " << segments;
 
         throw Common::Exception(__FILE__, __LINE__, msg.str());
     }
 
     // Check radius > 0
-    if( radius <= 0.0f )
+    if( !(radius > 0.0f) )
     {
-        std::ostringstream msg("Sphere requires a radius greater than zero.");
-        msg << " radius param: " << radius;
+        std::ostringstream msg;
+        msg << "Sphere requires a radius greater than zero."
+            << " radius param: " << radius;
 
         throw Common::Exception(__FILE__, __LINE__, msg.str());
     }
 
-    // Generate geometry
-    Position   position;
-    Normal     normal;
-    TexCoord2D texCoord;
+    const unsigned divisionsH = segments;
+    const unsigned divisionsV = segments / 2 + 1;
+
+    const float incrementU = 1.0f / static_cast<float>(divisionsH);
+    const float incrementV = 1.0f / static_cast<float>(divisionsV - 1);
 
-    unsigned divisionsH = segments;
-    unsigned divisionsV = segments / 2 + 1;
+    // Size everything up front, two caps of divisionsH points and the middle rings with an extra point each
+    const unsigned numPoints  = 2 * divisionsH + (divisionsV - 2) * (divisionsH + 1); 
+    const unsigned numIndices = 6 * divisionsH * (divisionsV - 2);
 
-    float incrementU = 1.0f / static_cast<float>(divisionsH);
-    float incrementV = 1.0f / static_cast<float>(divisionsV - 1);
+    positions.resize(numPoints);
+    texCoords.resize(numPoints);
+    normals.resize(numPoints);
+    indices.resize(numIndices);
+
+    const float normalSign = flipNormals ? -1.0f : 1.0f;
 
     // Top Ring
     for(unsigned i = 0; i < divisionsH; ++i)
     {
-        normal.x =  0.0f;
-        normal.y =  1.0f;
-        normal.z =  0.0f;
-      
-        position = normal * radius;
-
-        texCoord.x = incrementU * static_cast<float>(i);
-        texCoord.y = 0.0f;
-
-        if( flipNormals )
-        {
-            normal *= -1.0f;
-        }
-
-        positions.push_back(position);
-        texCoords.push_back(texCoord);
-        normals.push_back(normal);
+        positions[i] = Position(0.0f, radius, 0.0f);
+        texCoords[i] = TexCoord2D(incrementU * static_cast<float>(i), 0.0f);
+        normals[i]   = Normal(0.0f, normalSign, 0.0f);
     }
 
     // Middle Rings
+    //
+    // Every ring is the same circle scaled, so the circle and its texture coordinates are worked out once, 
+    // padded to a multiple of 4 so that the rings can be filled in 4 points at a time
     float angleV = static_cast<float>(D3DX_PI / static_cast<double>(divisionsV - 1));
     float angleH = static_cast<float>(2.0 * D3DX_PI / static_cast<double>(divisionsH));
 
+    const unsigned     paddedH = (divisionsH + 3) & ~3U;
+    std::vector<float> circleX(paddedH, 0.0f);
+    std::vector<float> circleZ(paddedH, 0.0f);
+
+    for(unsigned i = 0; i < divisionsH; ++i)
+    {
+        circleX[i] = cos(static_cast<float>(D3DX_PI) + static_cast<float>(i) * angleH);
+        circleZ[i] = sin(static_cast<float>(D3DX_PI) + static_cast<float>(i) * angleH);
+    }
+
+    const __m128 radius4     = _mm_set1_ps(radius);
+    const __m128 normalSign4 = _mm_set1_ps(normalSign);
+    unsigned     ringStart   = divisionsH;
+
     for(unsigned j = 1; j < divisionsV - 1; ++j)
     {
         float y          = cos(static_cast<float>(j) * angleV);
         float ringRadius = sin(static_cast<float>(j) * angleV);
+        float v          = static_cast<float>(j) * incrementV;
 
-        for(unsigned i = 0; i < divisionsH; ++i)
+        const __m128 ringRadius4 = _mm_set1_ps(ringRadius);
+
+        for(unsigned i = 0; i < divisionsH; i += 4)
         {
-            normal.x = ringRadius * cos(static_cast<float>(D3DX_PI) + static_cast<float>(i) * angleH);
-            normal.y = y;
-            normal.z = ringRadius * sin(static_cast<float>(D3DX_PI) + static_cast<float>(i) * angleH);
+            const __m128 normalX = _mm_mul_ps(ringRadius4, _mm_loadu_ps(&circleX[i]));
+            const __m128 normalZ = _mm_mul_ps(ringRadius4, _mm_loadu_ps(&circleZ[i]));
+
+            float x[4];
+            float z[4];
+            float positionX[4];
+            float positionZ[4];
 
-            position = normal * radius;
+            _mm_storeu_ps(x,         _mm_mul_ps(normalX, normalSign4));
+            _mm_storeu_ps(z,         _mm_mul_ps(normalZ, normalSign4));
+            _mm_storeu_ps(positionX, _mm_mul_ps(normalX, radius4));
+            _mm_storeu_ps(positionZ, _mm_mul_ps(normalZ, radius4));
 
-            texCoord.x = static_cast<float>(i) * incrementU;
-            texCoord.y = static_cast<float>(j) * incrementV;
+            const unsigned count = std::min<unsigned>(4, divisionsH - i);
 
-            if( flipNormals )
+            for(unsigned k = 0; k < count; ++k)
             {
-            normal *= -1.0f;
-            }
+                const unsigned point = ringStart + i + k;
 
-            positions.push_back(position);
-            texCoords.push_back(texCoord);
-            normals.push_back(normal);
+                positions[point] = Position(positionX[k], y * radius, positionZ[k]);
+                texCoords[point] = TexCoord2D(static_cast<float>(i + k) * incrementU, v);
+                normals[point]   = Normal(x[k], y * normalSign, z[k]);
+            }
         }
 
         // Need an extra vertex at same position as the first to wrap the texture around the sphere
-        normal.x = ringRadius * -1.0f;
-        normal.y = y;
-        normal.z = 0.0f;
-
-        position = normal * radius;
-
-        texCoord.x = 1.0f;
-        texCoord.y = static_cast<float>(j) * incrementV;
+        const unsigned wrapPoint = ringStart + divisionsH;
 
-        if( flipNormals )
-        {
-            normal *= -1.0f;
-        }
+        positions[wrapPoint] = Position(ringRadius * -1.0f * radius, y * radius, 0.0f);
+        texCoords[wrapPoint] = TexCoord2D(1.0f, v);
+        normals[wrapPoint]   = Normal(ringRadius * -1.0f * normalSign, y * normalSign, 0.0f);
 
-        positions.push_back(position);
-        texCoords.push_back(texCoord);
-        normals.push_back(normal);
+        ringStart += divisionsH + 1;
     }
 
     // Bottom Ring
     for(unsigned i = 0; i < divisionsH; ++i)
     {
-        normal.x =  0.0f;
-        normal.y = -1.0f;
-        normal.z =  0.0f;
-
-        position = normal * radius;
-
-        texCoord.x = incrementU * static_cast<float>(i);
-        texCoord.y = 1.0f;
-
-        if( flipNormals )
-        {
-            normal *= -1.0f;
-        }
-
-        positions.push_back(position);
-        texCoords.push_back(texCoord);
-        normals.push_back(normal);
+        positions[ringStart + i] = Position(0.0f, -radius, 0.0f);
+        texCoords[ringStart + i] = TexCoord2D(incrementU * static_cast<float>(i), 1.0f);
+        normals[ringStart + i]   = Normal(0.0f, -normalSign, 0.0f);
     }
 
     // At this point we have:
@@ -183,71 +178,43 @@ void GenerateSphere(std::vector<Position> & positions,
     // Each ring starts at the left and circles counter clockwise
 
     // Generate indices
-   
+    //
+    // Flipping the normals also flips the winding, by swapping the last two corners of each triangle
+    const unsigned second = flipNormals ? 2 : 1;
+    const unsigned third  = flipNormals ? 1 : 2;
+    Index *        index  = &indices[0];
+
     // Positive Y cap
-    for(unsigned i = 0; i < divisionsH; ++i)
+    for(unsigned i = 0; i < divisionsH; ++i, index += 3)
     {
-        if( !flipNormals )
-        {
-            indices.push_back(divisionsH + i);
-            indices.push_back(i);
-            indices.push_back(divisionsH + i + 1);
-        }
-        else
-        {
-            indices.push_back(divisionsH + i);
-            indices.push_back(divisionsH + i + 1);
-            indices.push_back(i);
-        }
+        index[0]      = divisionsH + i;
+        index[second] = i;
+        index[third]  = divisionsH + i + 1;
     }
 
     // Inner Rings
-    unsigned numPoints = 2 * divisionsH + (divisionsV - 2) * (divisionsH + 1); 
-
     for(unsigned ringA = divisionsH; ringA < numPoints - 2 * divisionsH - 1; ringA+= divisionsH + 1)
     {
         unsigned ringB = ringA + (divisionsH + 1);
 
-        for(unsigned i = 0; i < divisionsH; ++i)
+        for(unsigned i = 0; i < divisionsH; ++i, index += 6)
         {
-            if( !flipNormals )
-            {
-            indices.push_back(ringA + i);
-            indices.push_back(ringA + i + 1);
-            indices.push_back(ringB + i);
-
-            indices.push_back(ringA + i + 1);
-            indices.push_back(ringB + i + 1);
-            indices.push_back(ringB + i);
-            }
-            else
-            {
-            indices.push_back(ringA + i);
-            indices.push_back(ringB + i);
-            indices.push_back(ringA + i + 1);
+            index[0]          = ringA + i;
+            index[second]     = ringA + i + 1;
+            index[third]      = ringB + i;
 
-            indices.push_back(ringA + i + 1);
-            indices.push_back(ringB + i);
-            indices.push_back(ringB + i + 1);
-            }
+            index[3]          = ringA + i + 1;
+            index[3 + second] = ringB + i + 1;
+            index[3 + third]  = ringB + i;
         }
     }
 
     // Negative Y cap
-    for(unsigned i = 0; i < segments; ++i)
+    for(unsigned i = 0; i < segments; ++i, index += 3)
     {
-        if( !flipNormals )
-        {
-            indices.push_back(numPoints - segments * 2 - 1 + i);
-            indices.push_back(numPoints - segments * 2 + i);
-            indices.push_back(numPoints - segments + i);
-        }
-        else
-        {
-            indices.push_back(numPoints - segments * 2 - 1 + i);
-            indices.push_back(numPoints - segments + i);
-            indices.push_back(numPoints - segments * 2 + i);
-        }
+        index[0]      = numPoints - segments * 2 - 1 + i;
+        index[second] = numPoints - segments * 2 + i;
+        index[third]  = numPoints - segments + i;
     }
 }
 
@@ -263,6 +230,9 @@ void GenerateQuad(std::vector<Position> & positions,
     texCoords.clear();
     normals.clear();
 
+    // A triangle strip of 4 vertices needs no indices
+    indices.clear();
+
     // Create the quad
     float x = 0.5f * dimensions.x;
     float y = 0.5f * dimensions.y;
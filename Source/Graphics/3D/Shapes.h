@@ -16,6 +16,11 @@
 
 /**
 * Creates a sphere as an indexed triangle list
+*
+* The outputs are resized to exactly the number of points and indices of the sphere, replacing anything they held.
+* To share one sphere between many objects, rather than generating it for each, see ShapeCache.h
+*
+* @throws BaseException - If there are less than 4 segments, or the radius is not greater than zero
 **/
 void GenerateSphere(std::vector<Position> & positions,
                     std::vector<TexCoord2D> & texCoords,
@@ -27,6 +32,8 @@ void GenerateSphere(std::vector<Position> & positions,
 
 /**
 * Creates a quad as a triangle strip
+*
+* The indices are left empty, as the strip does not need any
 **/
 void GenerateQuad(std::vector<Position> & positions,
                   std::vector<TexCoord2D> & texCoords,
@@ -0,0 +1,153 @@
+
+// Project Includes
+#include "SubmeshMerger.h"
+#include "PolygonSetData.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <utility>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    //--------------------------------------------------------------------------
+    /**
+    * Adds the statistics of one index list to those of others, as if they were one
+    **/
+    void AddStatistics(VertexCacheStatistics & total, const VertexCacheStatistics & statistics)
+    {
+        total.m_numTriangles    += statistics.m_numTriangles;
+        total.m_numVerticesUsed += statistics.m_numVerticesUsed;
+        total.m_numTransformed  += statistics.m_numTransformed;
+
+        total.m_acmr = total.m_numTriangles    ? static_cast<float>(total.m_numTransformed) / total.m_numTriangles    : 0.0f;
+        total.m_atvr = total.m_numVerticesUsed ? static_cast<float>(total.m_numTransformed) / total.m_numVerticesUsed : 0.0f;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Appends the vertices and indices of a polygon set to a merged one, as one submesh,
+    * or as several if it has submeshes already
+    **/
+    void AppendSubmeshes(PolygonSetData & merged, const PolygonSetData & polygonSet)
+    {
+        const unsigned        baseVertex = merged.m_numVertices;
+        const unsigned        baseIndex  = merged.m_numIndices;
+        const unsigned char * vertices   = polygonSet.GetVertexData();
+        const Index *         indices    = polygonSet.GetIndexData();
+
+        merged.m_vertices.insert(merged.m_vertices.end(),
+                                 vertices,
+                                 vertices + static_cast<size_t>(polygonSet.m_numVertices) * polygonSet.GetVertexSize());
+
+        merged.m_indices.reserve(merged.m_indices.size() + polygonSet.m_numIndices);
+
+        for(unsigned i = 0; i < polygonSet.m_numIndices; ++i)
+        {
+            merged.m_indices.push_back(indices[i] + baseVertex);
+        }
+
+        merged.m_numVertices += polygonSet.m_numVertices;
+        merged.m_numIndices  += polygonSet.m_numIndices;
+
+        // Keep the material of each range
+        if( polygonSet.m_submeshes.empty() )
+        {
+            PolygonSetData::Submesh submesh;
+            submesh.m_firstIndex = baseIndex;
+            submesh.m_numIndices = polygonSet.m_numIndices;
+            submesh.m_material   = polygonSet.m_material;
+
+            merged.m_submeshes.push_back(submesh);
+        }
+        else
+        {
+            for(std::vector<PolygonSetData::Submesh>::const_iterator it = polygonSet.m_submeshes.begin(); it != polygonSet.m_submeshes.end(); ++it)
+            {
+                merged.m_submeshes.push_back(*it);
+                merged.m_submeshes.back().m_firstIndex += baseIndex;
+            }
+        }
+
+        AddStatistics(merged.m_optimizationReport.m_before, polygonSet.m_optimizationReport.m_before);
+        AddStatistics(merged.m_optimizationReport.m_after,  polygonSet.m_optimizationReport.m_after);
+    }
+}
+
+//------------------------------------------------------------------------------
+const bool CanMergeSubmeshes(const PolygonSetData & polygonSet)
+{
+    return polygonSet.m_numIndices > 0            &&
+           polygonSet.m_numIndices % 3 == 0       &&
+           polygonSet.m_levelsOfDetail.empty()    &&
+           polygonSet.m_clusters.empty()          &&
+           !polygonSet.IsQuantized();
+}
+
+//------------------------------------------------------------------------------
+const unsigned MergeSubmeshes(std::vector<PolygonSetData> & polygonSets)
+{
+    std::vector<PolygonSetData> result;
+    std::vector<bool>           merged(polygonSets.size(), false);
+    unsigned                    numMergedAway = 0;
+
+    for(size_t i = 0; i < polygonSets.size(); ++i)
+    {
+        if( merged[i] )
+        {
+            continue;
+        }
+
+        // Find the polygon sets after this one that it can share buffers with
+        std::vector<size_t> group(1, i);
+
+        if( CanMergeSubmeshes(polygonSets[i]) )
+        {
+            for(size_t j = i + 1; j < polygonSets.size(); ++j)
+            {
+                if( !merged[j]                                                   &&
+                    CanMergeSubmeshes(polygonSets[j])                            &&
+                    polygonSets[j].m_contentTypes == polygonSets[i].m_contentTypes )
+                {
+                    group.push_back(j);
+                    merged[j] = true;
+                }
+            }
+        }
+
+        if( group.size() == 1 )
+        {
+            result.push_back(std::move(polygonSets[i]));
+            continue;
+        }
+
+        // Append them all to a new polygon set
+        PolygonSetData mergedSet;
+        mergedSet.m_contentTypes = polygonSets[i].m_contentTypes;
+
+        for(std::vector<size_t>::const_iterator it = group.begin(); it != group.end(); ++it)
+        {
+            AppendSubmeshes(mergedSet, polygonSets[*it]);
+        }
+
+        mergedSet.m_material = mergedSet.m_submeshes.front().m_material;
+
+        try
+        {
+            mergedSet.CalculateBounds();
+        }
+        catch(Common::Exception & e)
+        {
+            throw e;
+        }
+
+        result.push_back(std::move(mergedSet));
+        numMergedAway += static_cast<unsigned>(group.size() - 1);
+    }
+
+    polygonSets.swap(result);
+
+    return numMergedAway;
+}
@@ -0,0 +1,41 @@
+#ifndef SUBMESHMERGER_H
+#define SUBMESHMERGER_H
+
+// Standard Includes
+#include <vector>
+
+struct PolygonSetData;
+
+//------------------------------------------------------------------------------
+// Merging of the polygon sets of a model that differ only in material, so that they share one vertex and index buffer
+//
+// A model exported with several materials is made of one polygon set per material, and drawing each of them binds
+// buffers of its own. Polygon sets with the same vertex layout are appended to each other instead, with their
+// indices rebased onto the combined vertices. Each keeps its material as a submesh, a contiguous range of the
+// combined indices that is drawn with its own DrawIndexed call (see PolygonSet::SetSubmeshes).
+//
+// Polygon sets with levels of detail or clusters are left as they are, as those cover the whole of one polygon
+// set's indices. So are polygon sets whose vertices are quantized, as each has its own decoding, and polygon sets
+// with indices left over after their last whole triangle, which would shift the triangles of those after them.
+//
+
+/**
+* Query whether or not a polygon set can be merged with others
+**/
+const bool CanMergeSubmeshes(const PolygonSetData & polygonSet);
+
+/**
+* Merges the polygon sets that have the same vertex layout into one, with a submesh for each of them
+*
+* Vertices and indices that lie in a mapped file are copied into the merged polygon set. Its bounds are calculated
+* again, and its optimization report is the total of those merged.
+*
+* @param polygonSets - IN/OUT - Polygon sets of one model. A merged polygon set takes the place of the first one
+*                      that was merged into it, and the rest keep their order.
+* @return            - Number of polygon sets that were merged away
+*
+* @throws BaseException - If the bounds of a merged polygon set cannot be calculated
+**/
+const unsigned MergeSubmeshes(std::vector<PolygonSetData> & polygonSets);
+
+#endif // SUBMESHMERGER_H
@@ -0,0 +1,494 @@
+
+// Project Includes
+#include "TangentFrames.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cfloat>
+#include <cstring>
+#include <sstream>
+
+// SSE Includes
+#include <emmintrin.h>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    //--------------------------------------------------------------------------
+    /**
+    * Vertex attributes one float component per stream, so that four vertices can be loaded into a register at once
+    *
+    * Every stream is padded with zeros to a multiple of four vertices. The tangent and bitangent streams
+    * accumulate the weighted triangle frames before they are turned into the final frames.
+    **/
+    struct FrameStreams
+    {
+        explicit FrameStreams(const unsigned numVertices)
+            :
+            m_numVertices(numVertices)
+        {
+            const size_t paddedSize = (static_cast<size_t>(numVertices) + 3) & ~static_cast<size_t>(3);
+
+            for(unsigned k = 0; k < 3; ++k)
+            {
+                m_position[k].assign(paddedSize, 0.0f);
+                m_normal[k].assign(paddedSize, 0.0f);
+                m_tangent[k].assign(paddedSize, 0.0f);
+                m_biTangent[k].assign(paddedSize, 0.0f);
+            }
+
+            m_texCoord[0].assign(paddedSize, 0.0f);
+            m_texCoord[1].assign(paddedSize, 0.0f);
+        }
+
+        unsigned           m_numVertices;
+        std::vector<float> m_position[3];
+        std::vector<float> m_texCoord[2];
+        std::vector<float> m_normal[3];
+        std::vector<float> m_tangent[3];
+        std::vector<float> m_biTangent[3];
+    };
+
+    //--------------------------------------------------------------------------
+    inline __m128 Select(const __m128 mask, const __m128 ifTrue, const __m128 ifFalse)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+    }
+
+    //--------------------------------------------------------------------------
+    inline __m128 Dot3(const __m128 ax, const __m128 ay, const __m128 az,
+                       const __m128 bx, const __m128 by, const __m128 bz)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * 1 / sqrt(x) where x is large enough for that to be meaningful, otherwise 0
+    **/
+    inline __m128 SafeInverseSqrt(const __m128 x)
+    {
+        const __m128 valid = _mm_cmpgt_ps(x, _mm_set1_ps(FLT_MIN));
+        return _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(x, _mm_set1_ps(FLT_MIN)))));
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Arc cosine of values in [-1, 1], accurate to within 7e-5 radians
+    *
+    * Abramowitz and Stegun 4.4.45, reflected for negative values
+    **/
+    inline __m128 Acos(const __m128 x)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+        const __m128 a        = _mm_andnot_ps(signMask, x);
+
+        __m128 poly = _mm_set1_ps(-0.0187293f);
+        poly = _mm_add_ps(_mm_mul_ps(poly, a), _mm_set1_ps( 0.0742610f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, a), _mm_set1_ps(-0.2121144f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, a), _mm_set1_ps( 1.5707288f));
+
+        const __m128 result = _mm_mul_ps(poly, _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), a)));
+
+        return Select(negative, _mm_sub_ps(_mm_set1_ps(3.14159265f), result), result);
+    }
+
+    //--------------------------------------------------------------------------
+    inline __m128 Gather(const std::vector<float> & stream, const Index * lanes)
+    {
+        return _mm_setr_ps(stream[lanes[0]], stream[lanes[1]], stream[lanes[2]], stream[lanes[3]]);
+    }
+
+    //--------------------------------------------------------------------------
+    void ValidateIndices(const std::vector<Index> & indices, const unsigned numVertices)
+    {
+        if( indices.size() % 3 != 0 )
+        {
+            std::ostringstream msg;
+            msg << "An indexed triangle list must have a multiple of 3 indices. Number of indices: " << indices.size();
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+        for(size_t i = 0; i < indices.size(); ++i)
+        {
+            if( indices[i] >= numVertices )
+            {
+                std::ostringstream msg;
+                msg << "Index " << i << " refers to vertex " << indices[i] << ", but there are only " << numVertices << " vertices";
+                throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Accumulates the angle weighted tangent and bitangent of every triangle at each of its corners, four triangles at a time
+    **/
+    void AccumulateTriangleFrames(FrameStreams & streams, const std::vector<Index> & indices)
+    {
+        const size_t numTriangles = indices.size() / 3;
+        const __m128 signMask     = _mm_set1_ps(-0.0f);
+        const __m128 zero         = _mm_setzero_ps();
+        const __m128 one          = _mm_set1_ps(1.0f);
+
+        for(size_t first = 0; first < numTriangles; first += 4)
+        {
+            const unsigned numLanes = numTriangles - first < 4 ? static_cast<unsigned>(numTriangles - first) : 4;
+
+            // Gather the corners of up to four triangles. Unused lanes repeat vertex 0 and are never scattered.
+            Index corners[3][4] = { {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0} };
+
+            for(unsigned lane = 0; lane < numLanes; ++lane)
+            {
+                const Index * triangle = &indices[(first + lane) * 3];
+
+                corners[0][lane] = triangle[0];
+                corners[1][lane] = triangle[1];
+                corners[2][lane] = triangle[2];
+            }
+
+            __m128 p[3][3];
+            __m128 uv[3][2];
+
+            for(unsigned c = 0; c < 3; ++c)
+            {
+                p[c][0]  = Gather(streams.m_position[0], corners[c]);
+                p[c][1]  = Gather(streams.m_position[1], corners[c]);
+                p[c][2]  = Gather(streams.m_position[2], corners[c]);
+                uv[c][0] = Gather(streams.m_texCoord[0], corners[c]);
+                uv[c][1] = Gather(streams.m_texCoord[1], corners[c]);
+            }
+
+            // Edges
+            const __m128 e1x = _mm_sub_ps(p[1][0], p[0][0]);
+            const __m128 e1y = _mm_sub_ps(p[1][1], p[0][1]);
+            const __m128 e1z = _mm_sub_ps(p[1][2], p[0][2]);
+            const __m128 e2x = _mm_sub_ps(p[2][0], p[0][0]);
+            const __m128 e2y = _mm_sub_ps(p[2][1], p[0][1]);
+            const __m128 e2z = _mm_sub_ps(p[2][2], p[0][2]);
+            const __m128 e3x = _mm_sub_ps(p[2][0], p[1][0]);
+            const __m128 e3y = _mm_sub_ps(p[2][1], p[1][1]);
+            const __m128 e3z = _mm_sub_ps(p[2][2], p[1][2]);
+
+            const __m128 du1 = _mm_sub_ps(uv[1][0], uv[0][0]);
+            const __m128 dv1 = _mm_sub_ps(uv[1][1], uv[0][1]);
+            const __m128 du2 = _mm_sub_ps(uv[2][0], uv[0][0]);
+            const __m128 dv2 = _mm_sub_ps(uv[2][1], uv[0][1]);
+
+            // Tangent and bitangent of the triangle
+            //
+            // Only their directions are needed, so rather than dividing by the determinant of the texture
+            // coordinate deltas, they take its sign. Triangles without texture area contribute nothing.
+            const __m128 det     = _mm_sub_ps(_mm_mul_ps(du1, dv2), _mm_mul_ps(du2, dv1));
+            const __m128 detSign = _mm_and_ps(det, signMask);
+
+            __m128 tx = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e1x, dv2), _mm_mul_ps(e2x, dv1)), detSign);
+            __m128 ty = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e1y, dv2), _mm_mul_ps(e2y, dv1)), detSign);
+            __m128 tz = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e1z, dv2), _mm_mul_ps(e2z, dv1)), detSign);
+            __m128 bx = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e2x, du1), _mm_mul_ps(e1x, du2)), detSign);
+            __m128 by = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e2y, du1), _mm_mul_ps(e1y, du2)), detSign);
+            __m128 bz = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(e2z, du1), _mm_mul_ps(e1z, du2)), detSign);
+
+            const __m128 tInvLength = SafeInverseSqrt(Dot3(tx, ty, tz, tx, ty, tz));
+            const __m128 bInvLength = SafeInverseSqrt(Dot3(bx, by, bz, bx, by, bz));
+
+            tx = _mm_mul_ps(tx, tInvLength);
+            ty = _mm_mul_ps(ty, tInvLength);
+            tz = _mm_mul_ps(tz, tInvLength);
+            bx = _mm_mul_ps(bx, bInvLength);
+            by = _mm_mul_ps(by, bInvLength);
+            bz = _mm_mul_ps(bz, bInvLength);
+
+            // Angle at each corner
+            const __m128 invLength1 = SafeInverseSqrt(Dot3(e1x, e1y, e1z, e1x, e1y, e1z));
+            const __m128 invLength2 = SafeInverseSqrt(Dot3(e2x, e2y, e2z, e2x, e2y, e2z));
+            const __m128 invLength3 = SafeInverseSqrt(Dot3(e3x, e3y, e3z, e3x, e3y, e3z));
+
+            const __m128 cos0 =            _mm_mul_ps(Dot3(e1x, e1y, e1z, e2x, e2y, e2z), _mm_mul_ps(invLength1, invLength2));
+            const __m128 cos1 = _mm_xor_ps(_mm_mul_ps(Dot3(e1x, e1y, e1z, e3x, e3y, e3z), _mm_mul_ps(invLength1, invLength3)), signMask);
+            const __m128 cos2 =            _mm_mul_ps(Dot3(e2x, e2y, e2z, e3x, e3y, e3z), _mm_mul_ps(invLength2, invLength3));
+
+            // Triangles without texture area or with a zero length edge get no weight
+            const __m128 valid = _mm_and_ps(_mm_cmpneq_ps(det, zero),
+                                 _mm_and_ps(_mm_cmpgt_ps(invLength1, zero),
+                                 _mm_and_ps(_mm_cmpgt_ps(invLength2, zero), _mm_cmpgt_ps(invLength3, zero))));
+
+            const __m128 minusOne = _mm_set1_ps(-1.0f);
+
+            float weights[3][4];
+            _mm_storeu_ps(weights[0], _mm_and_ps(valid, Acos(_mm_min_ps(_mm_max_ps(cos0, minusOne), one))));
+            _mm_storeu_ps(weights[1], _mm_and_ps(valid, Acos(_mm_min_ps(_mm_max_ps(cos1, minusOne), one))));
+            _mm_storeu_ps(weights[2], _mm_and_ps(valid, Acos(_mm_min_ps(_mm_max_ps(cos2, minusOne), one))));
+
+            float tangent[3][4];
+            float biTangent[3][4];
+            _mm_storeu_ps(tangent[0], tx);
+            _mm_storeu_ps(tangent[1], ty);
+            _mm_storeu_ps(tangent[2], tz);
+            _mm_storeu_ps(biTangent[0], bx);
+            _mm_storeu_ps(biTangent[1], by);
+            _mm_storeu_ps(biTangent[2], bz);
+
+            // Scatter to the corners
+            //
+            // Triangles in the same group can share vertices, so this part is done one corner at a time
+            for(unsigned lane = 0; lane < numLanes; ++lane)
+            {
+                for(unsigned c = 0; c < 3; ++c)
+                {
+                    const Index vertex = corners[c][lane];
+                    const float weight = weights[c][lane];
+
+                    for(unsigned k = 0; k < 3; ++k)
+                    {
+                        streams.m_tangent[k][vertex]   += tangent[k][lane] * weight;
+                        streams.m_biTangent[k][vertex] += biTangent[k][lane] * weight;
+                    }
+                }
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Turns the accumulated frames into an orthonormal tangent and bitangent per vertex, four vertices at a time
+    *
+    * The tangent is made perpendicular to the normal, or is any direction perpendicular to the normal if nothing
+    * was accumulated. The bitangent is the cross product of the normal and tangent, pointing the same way as the
+    * accumulated bitangent.
+    **/
+    void OrthogonalizeFrames(FrameStreams & streams)
+    {
+        const size_t paddedSize = streams.m_normal[0].size();
+        const __m128 signMask   = _mm_set1_ps(-0.0f);
+        const __m128 zero       = _mm_setzero_ps();
+
+        for(size_t i = 0; i < paddedSize; i += 4)
+        {
+            __m128 nx = _mm_loadu_ps(&streams.m_normal[0][i]);
+            __m128 ny = _mm_loadu_ps(&streams.m_normal[1][i]);
+            __m128 nz = _mm_loadu_ps(&streams.m_normal[2][i]);
+
+            const __m128 nInvLength = SafeInverseSqrt(Dot3(nx, ny, nz, nx, ny, nz));
+            nx = _mm_mul_ps(nx, nInvLength);
+            ny = _mm_mul_ps(ny, nInvLength);
+            nz = _mm_mul_ps(nz, nInvLength);
+
+            __m128 tx = _mm_loadu_ps(&streams.m_tangent[0][i]);
+            __m128 ty = _mm_loadu_ps(&streams.m_tangent[1][i]);
+            __m128 tz = _mm_loadu_ps(&streams.m_tangent[2][i]);
+
+            const __m128 bx = _mm_loadu_ps(&streams.m_biTangent[0][i]);
+            const __m128 by = _mm_loadu_ps(&streams.m_biTangent[1][i]);
+            const __m128 bz = _mm_loadu_ps(&streams.m_biTangent[2][i]);
+
+            // Gram-Schmidt
+            const __m128 nDotT = Dot3(nx, ny, nz, tx, ty, tz);
+            tx = _mm_sub_ps(tx, _mm_mul_ps(nx, nDotT));
+            ty = _mm_sub_ps(ty, _mm_mul_ps(ny, nDotT));
+            tz = _mm_sub_ps(tz, _mm_mul_ps(nz, nDotT));
+
+            // Fall back to the normal crossed with whichever of X or Y it is furthest from
+            const __m128 useX      = _mm_cmplt_ps(_mm_andnot_ps(signMask, nx), _mm_set1_ps(0.9f));
+            const __m128 fallbackX = Select(useX, zero, _mm_xor_ps(nz, signMask));
+            const __m128 fallbackY = Select(useX, nz, zero);
+            const __m128 fallbackZ = Select(useX, _mm_xor_ps(ny, signMask), nx);
+
+            const __m128 degenerate = _mm_cmple_ps(Dot3(tx, ty, tz, tx, ty, tz), _mm_set1_ps(1e-12f));
+            tx = Select(degenerate, fallbackX, tx);
+            ty = Select(degenerate, fallbackY, ty);
+            tz = Select(degenerate, fallbackZ, tz);
+
+            const __m128 tInvLength = SafeInverseSqrt(Dot3(tx, ty, tz, tx, ty, tz));
+            tx = _mm_mul_ps(tx, tInvLength);
+            ty = _mm_mul_ps(ty, tInvLength);
+            tz = _mm_mul_ps(tz, tInvLength);
+
+            // Bitangent, flipped where the texture is mirrored
+            __m128 cx = _mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(nz, ty));
+            __m128 cy = _mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(nx, tz));
+            __m128 cz = _mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(ny, tx));
+
+            const __m128 flip = _mm_and_ps(_mm_cmplt_ps(Dot3(cx, cy, cz, bx, by, bz), zero), signMask);
+            cx = _mm_xor_ps(cx, flip);
+            cy = _mm_xor_ps(cy, flip);
+            cz = _mm_xor_ps(cz, flip);
+
+            _mm_storeu_ps(&streams.m_tangent[0][i], tx);
+            _mm_storeu_ps(&streams.m_tangent[1][i], ty);
+            _mm_storeu_ps(&streams.m_tangent[2][i], tz);
+            _mm_storeu_ps(&streams.m_biTangent[0][i], cx);
+            _mm_storeu_ps(&streams.m_biTangent[1][i], cy);
+            _mm_storeu_ps(&streams.m_biTangent[2][i], cz);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    void GenerateFrames(FrameStreams & streams, const std::vector<Index> & indices)
+    {
+        ValidateIndices(indices, streams.m_numVertices);
+        AccumulateTriangleFrames(streams, indices);
+        OrthogonalizeFrames(streams);
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Finds where a content type is in each interleaved vertex
+    *
+    * @return - Whether the content type was found
+    **/
+    bool FindContentOffset(const std::vector<BufferContentType> & contentTypes,
+                           const BufferContentType contentType,
+                           unsigned & offset)
+    {
+        offset = 0;
+
+        for(std::vector<BufferContentType>::const_iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+        {
+            if( *it == contentType )
+            {
+                return true;
+            }
+
+            offset += GetStride(*it);
+        }
+
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void GenerateTangentFrames(const std::vector<Position> & positions,
+                           const std::vector<TexCoord2D> & texCoords,
+                           const std::vector<Normal> & normals,
+                           const std::vector<Index> & indices,
+                           std::vector<Tangent> & tangents,
+                           std::vector<BiTangent> & biTangents)
+{
+    if( texCoords.size() != positions.size() || normals.size() != positions.size() )
+    {
+        std::ostringstream msg;
+        msg << "Cannot generate tangent frames for vertex streams of different sizes. Positions: " << positions.size()
+            << " Texture coordinates: " << texCoords.size() << " Normals: " << normals.size();
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    const unsigned numVertices = static_cast<unsigned>(positions.size());
+    FrameStreams   streams(numVertices);
+
+    for(unsigned i = 0; i < numVertices; ++i)
+    {
+        streams.m_position[0][i] = positions[i].x;
+        streams.m_position[1][i] = positions[i].y;
+        streams.m_position[2][i] = positions[i].z;
+        streams.m_texCoord[0][i] = texCoords[i].x;
+        streams.m_texCoord[1][i] = texCoords[i].y;
+        streams.m_normal[0][i]   = normals[i].x;
+        streams.m_normal[1][i]   = normals[i].y;
+        streams.m_normal[2][i]   = normals[i].z;
+    }
+
+    GenerateFrames(streams, indices);
+
+    tangents.resize(numVertices);
+    biTangents.resize(numVertices);
+
+    for(unsigned i = 0; i < numVertices; ++i)
+    {
+        tangents[i].x   = streams.m_tangent[0][i];
+        tangents[i].y   = streams.m_tangent[1][i];
+        tangents[i].z   = streams.m_tangent[2][i];
+        biTangents[i].x = streams.m_biTangent[0][i];
+        biTangents[i].y = streams.m_biTangent[1][i];
+        biTangents[i].z = streams.m_biTangent[2][i];
+    }
+}
+
+//------------------------------------------------------------------------------
+void AddTangentFrames(std::vector<unsigned char> & vertexData,
+                      std::vector<BufferContentType> & contentTypes,
+                      const std::vector<Index> & indices)
+{
+    unsigned positionOffset = 0;
+    unsigned normalOffset   = 0;
+    unsigned texCoordOffset = 0;
+    unsigned tangentOffset  = 0;
+
+    if( FindContentOffset(contentTypes, TANGENT, tangentOffset) )
+    {
+        return;
+    }
+
+    if( !FindContentOffset(contentTypes, POSITION,   positionOffset) ||
+        !FindContentOffset(contentTypes, NORMAL,     normalOffset)   ||
+        !FindContentOffset(contentTypes, TEXCOORD2D, texCoordOffset) )
+    {
+        const std::string msg("Generating tangent frames requires vertices with a position, a normal, and texture coordinates");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    unsigned vertexSize = 0;
+
+    for(std::vector<BufferContentType>::const_iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+    {
+        vertexSize += GetStride(*it);
+    }
+
+    const unsigned numVertices = static_cast<unsigned>(vertexData.size() / vertexSize);
+    FrameStreams   streams(numVertices);
+
+    // Split the vertices into streams
+    float components[3];
+
+    for(unsigned i = 0; i < numVertices; ++i)
+    {
+        const unsigned char * vertex = &vertexData[static_cast<size_t>(i) * vertexSize];
+
+        memcpy(components, vertex + positionOffset, sizeof(Position));
+        streams.m_position[0][i] = components[0];
+        streams.m_position[1][i] = components[1];
+        streams.m_position[2][i] = components[2];
+
+        memcpy(components, vertex + normalOffset, sizeof(Normal));
+        streams.m_normal[0][i] = components[0];
+        streams.m_normal[1][i] = components[1];
+        streams.m_normal[2][i] = components[2];
+
+        memcpy(components, vertex + texCoordOffset, sizeof(TexCoord2D));
+        streams.m_texCoord[0][i] = components[0];
+        streams.m_texCoord[1][i] = components[1];
+    }
+
+    GenerateFrames(streams, indices);
+
+    // Rebuild the vertices with the tangent and bitangent on the end of each
+    const unsigned             newVertexSize = vertexSize + GetStride(TANGENT) + GetStride(BITANGENT);
+    std::vector<unsigned char> newVertexData(static_cast<size_t>(numVertices) * newVertexSize);
+
+    for(unsigned i = 0; i < numVertices; ++i)
+    {
+        unsigned char * vertex = &newVertexData[static_cast<size_t>(i) * newVertexSize];
+
+        memcpy(vertex, &vertexData[static_cast<size_t>(i) * vertexSize], vertexSize);
+        vertex += vertexSize;
+
+        components[0] = streams.m_tangent[0][i];
+        components[1] = streams.m_tangent[1][i];
+        components[2] = streams.m_tangent[2][i];
+        memcpy(vertex, components, sizeof(Tangent));
+        vertex += sizeof(Tangent);
+
+        components[0] = streams.m_biTangent[0][i];
+        components[1] = streams.m_biTangent[1][i];
+        components[2] = streams.m_biTangent[2][i];
+        memcpy(vertex, components, sizeof(BiTangent));
+    }
+
+    vertexData.swap(newVertexData);
+
+    contentTypes.push_back(TANGENT);
+    contentTypes.push_back(BITANGENT);
+}
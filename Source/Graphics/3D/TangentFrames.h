@@ -0,0 +1,60 @@
+#ifndef TANGENTFRAMES_H
+#define TANGENTFRAMES_H
+
+// EngineX Includes
+#include "Graphics\3D\Buffers.h"
+
+// Standard Includes
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Generation of per vertex tangent frames for normal mapping
+//
+// Each triangle gets a tangent and bitangent from how its texture coordinates run across its surface. Those are
+// accumulated at each of its corners, weighted by the angle of the corner, so that a vertex shared by several
+// triangles gets a frame that does not depend on how the surface around it was triangulated. The indices are
+// expected to refer to welded vertices (see WeldVertices) so that adjacent triangles do share them.
+//
+// Each vertex's tangent is then made perpendicular to its normal, and its bitangent is the cross product of the
+// two, flipped where the texture is mirrored.
+//
+// The work is done four triangles, and then four vertices, at a time using SSE.
+//
+
+/**
+* Generates a tangent and bitangent for each vertex of an indexed triangle list
+*
+* @param positions  - Position of each vertex
+* @param texCoords  - Texture coordinates of each vertex, that the tangent frame follows
+* @param normals    - Normal of each vertex
+* @param indices    - Indexed triangle list
+* @param tangents   - OUT - Tangent of each vertex
+* @param biTangents - OUT - Bitangent of each vertex
+*
+* @throws BaseException - If the vertex streams differ in size, the number of indices is not a multiple of 3,
+*                         or an index is out of range
+**/
+void GenerateTangentFrames(const std::vector<Position> & positions,
+                           const std::vector<TexCoord2D> & texCoords,
+                           const std::vector<Normal> & normals,
+                           const std::vector<Index> & indices,
+                           std::vector<Tangent> & tangents,
+                           std::vector<BiTangent> & biTangents);
+
+/**
+* Generates a tangent and bitangent for each interleaved vertex of an indexed triangle list and appends them to the vertex
+*
+* The tangent frame follows the first TEXCOORD2D in the vertex. Does nothing if the vertices already have a TANGENT.
+*
+* @param vertexData   - IN/OUT - Interleaved vertices. Each grows by a Tangent and a BiTangent.
+* @param contentTypes - IN/OUT - What each vertex is made of, in order. TANGENT and BITANGENT are appended.
+* @param indices      - Indexed triangle list
+*
+* @throws BaseException - If the vertices have no POSITION, NORMAL, or TEXCOORD2D, the number of indices
+*                         is not a multiple of 3, or an index is out of range
+**/
+void AddTangentFrames(std::vector<unsigned char> & vertexData,
+                      std::vector<BufferContentType> & contentTypes,
+                      const std::vector<Index> & indices);
+
+#endif // TANGENTFRAMES_H
@@ -0,0 +1,918 @@
+
+// Project Includes
+#include "TextMeshParser.h"
+
+// EngineX Includes
+#include "Core\MappedFile.h"
+#include "Graphics\3D\MeshOptimizer.h"
+#include "Graphics\3D\VertexWelder.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctype.h>
+#include <functional>
+#include <future>
+#include <sstream>
+#include <thread>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    const size_t   MIN_CHUNK_SIZE    = 256 * 1024;   // Smaller files are not worth splitting further
+    const unsigned MAX_UV_SETS       = 8;
+    const unsigned UNDEFINED_RECORD  = 0xFFFFFFFF;
+
+    //--------------------------------------------------------------------------
+    struct Vector3Record
+    {
+        unsigned m_index;
+        float    m_x;
+        float    m_y;
+        float    m_z;
+    };
+
+    struct TexCoordRecord
+    {
+        unsigned m_set;
+        unsigned m_index;
+        float    m_u;
+        float    m_v;
+    };
+
+    struct CornerRecord
+    {
+        unsigned m_face;
+        unsigned m_corner;
+        unsigned m_vertex;
+        unsigned m_normal;
+        unsigned m_firstValue;      // First of the remaining indices in MeshRecords::m_cornerValues
+        unsigned m_numValues;       // Number of remaining indices, which are an optional color followed by the UVs
+    };
+
+    struct PolygonSetRecord
+    {
+        unsigned              m_index;
+        std::vector<unsigned> m_faces;
+    };
+
+    struct TextureRecord
+    {
+        size_t      m_polygonSet;   // Position, among the polygon set records, of the one the texture belongs to
+        std::string m_filepath;
+    };
+
+    //--------------------------------------------------------------------------
+    /**
+    * Records of one mesh, or of the part of one mesh that lies in a chunk of the file
+    **/
+    struct MeshRecords
+    {
+        MeshRecords()
+            :
+            m_startsMesh(false)
+        {
+        }
+
+        const bool IsEmpty() const
+        {
+            return m_positions.empty() && m_normals.empty() && m_texCoords.empty() &&
+                   m_corners.empty() && m_polygonSets.empty() && m_textures.empty();
+        }
+
+        /**
+        * Appends the records of the next part of the same mesh
+        **/
+        void Append(const MeshRecords & rhs)
+        {
+            const unsigned valueOffset      = static_cast<unsigned>(m_cornerValues.size());
+            const size_t   polygonSetOffset = m_polygonSets.size();
+
+            m_positions.insert(m_positions.end(), rhs.m_positions.begin(), rhs.m_positions.end());
+            m_normals.insert(m_normals.end(), rhs.m_normals.begin(), rhs.m_normals.end());
+            m_texCoords.insert(m_texCoords.end(), rhs.m_texCoords.begin(), rhs.m_texCoords.end());
+            m_cornerValues.insert(m_cornerValues.end(), rhs.m_cornerValues.begin(), rhs.m_cornerValues.end());
+            m_polygonSets.insert(m_polygonSets.end(), rhs.m_polygonSets.begin(), rhs.m_polygonSets.end());
+
+            for(std::vector<CornerRecord>::const_iterator it = rhs.m_corners.begin(); it != rhs.m_corners.end(); ++it)
+            {
+                m_corners.push_back(*it);
+                m_corners.back().m_firstValue += valueOffset;
+            }
+
+            for(std::vector<TextureRecord>::const_iterator it = rhs.m_textures.begin(); it != rhs.m_textures.end(); ++it)
+            {
+                m_textures.push_back(*it);
+                m_textures.back().m_polygonSet += polygonSetOffset;
+            }
+        }
+
+
+        bool                          m_startsMesh;     // Whether a mesh name was found at the start of these records
+        std::string                   m_meshName;
+
+        std::vector<Vector3Record>    m_positions;
+        std::vector<Vector3Record>    m_normals;
+        std::vector<TexCoordRecord>   m_texCoords;
+        std::vector<CornerRecord>     m_corners;
+        std::vector<unsigned>         m_cornerValues;
+        std::vector<PolygonSetRecord> m_polygonSets;
+        std::vector<TextureRecord>    m_textures;
+    };
+
+    //--------------------------------------------------------------------------
+    /**
+    * Scans the records in one chunk of a text mesh
+    *
+    * The chunk must start at the beginning of a line. A new MeshRecords is started for every mesh name found,
+    * so the first one holds whatever came before the first mesh name in the chunk.
+    **/
+    class ChunkScanner
+    {
+    public:
+
+        ChunkScanner(const std::string & filepath, const char * fileStart, const char * begin, const char * end)
+            :
+            m_filepath (filepath),
+            m_fileStart(fileStart),
+            m_p        (begin),
+            m_end      (end)
+        {
+        }
+
+        void Scan(std::vector<MeshRecords> & meshes)
+        {
+            meshes.clear();
+            meshes.push_back(MeshRecords());
+
+            while( m_p < m_end )
+            {
+                SkipSpaces();
+
+                if( m_p == m_end )
+                {
+                    break;
+                }
+
+                if( *m_p == '\r' || *m_p == '\n' )
+                {
+                    ++m_p;
+                }
+                else if( *m_p == '/' )
+                {
+                    ScanComment(meshes);
+                }
+                else
+                {
+                    ScanRecord(meshes.back());
+                }
+            }
+        }
+
+    private:
+
+        void ScanComment(std::vector<MeshRecords> & meshes)
+        {
+            if( m_end - m_p < 2 || m_p[1] != '/' )
+            {
+                Throw("Expected a comment");
+            }
+
+            m_p += 2;
+            SkipSpaces();
+
+            const char * lineEnd = m_p;
+
+            while( lineEnd < m_end && *lineEnd != '\r' && *lineEnd != '\n' )
+            {
+                ++lineEnd;
+            }
+
+            static const char   meshName[]    = "Mesh Name:";
+            static const char   textureFile[] = "Color Texture Filepath:";
+            static const size_t meshNameLength    = sizeof(meshName) - 1;
+            static const size_t textureFileLength = sizeof(textureFile) - 1;
+
+            if( static_cast<size_t>(lineEnd - m_p) >= meshNameLength && strncmp(m_p, meshName, meshNameLength) == 0 )
+            {
+                meshes.push_back(MeshRecords());
+                meshes.back().m_startsMesh = true;
+                meshes.back().m_meshName   = Trim(m_p + meshNameLength, lineEnd);
+            }
+            else if( static_cast<size_t>(lineEnd - m_p) >= textureFileLength && strncmp(m_p, textureFile, textureFileLength) == 0 )
+            {
+                TextureRecord texture;
+                texture.m_polygonSet = meshes.back().m_polygonSets.size();
+                texture.m_filepath   = Trim(m_p + textureFileLength, lineEnd);
+
+                meshes.back().m_textures.push_back(texture);
+            }
+
+            m_p = lineEnd;
+        }
+
+        void ScanRecord(MeshRecords & mesh)
+        {
+            const char * name = m_p;
+
+            while( m_p < m_end && *m_p >= 'a' && *m_p <= 'z' )
+            {
+                ++m_p;
+            }
+
+            const size_t nameLength = m_p - name;
+
+            if( nameLength == 1 && (*name == 'v' || *name == 'n') )
+            {
+                Vector3Record record;
+                record.m_index = ReadIndex();
+                record.m_x     = ReadFloat();
+                record.m_y     = ReadFloat();
+                record.m_z     = ReadFloat();
+                ExpectLineEnd();
+
+                (*name == 'v' ? mesh.m_positions : mesh.m_normals).push_back(record);
+            }
+            else if( nameLength == 2 && name[0] == 'u' && name[1] == 'v' )
+            {
+                TexCoordRecord record;
+                record.m_set   = ReadIndex();
+                record.m_index = ReadIndex();
+                record.m_u     = ReadFloat();
+                record.m_v     = ReadFloat();
+                ExpectLineEnd();
+
+                mesh.m_texCoords.push_back(record);
+            }
+            else if( nameLength == 1 && *name == 'f' )
+            {
+                CornerRecord record;
+                record.m_face       = ReadIndex();
+                record.m_corner     = ReadIndex();
+                record.m_vertex     = ReadUnsigned();
+                record.m_normal     = ReadUnsigned();
+                record.m_firstValue = static_cast<unsigned>(mesh.m_cornerValues.size());
+
+                while( !SkipSpacesToLineEnd() )
+                {
+                    mesh.m_cornerValues.push_back(ReadUnsigned());
+                }
+
+                record.m_numValues = static_cast<unsigned>(mesh.m_cornerValues.size()) - record.m_firstValue;
+
+                mesh.m_corners.push_back(record);
+            }
+            else if( nameLength == 2 && name[0] == 'p' && name[1] == 's' )
+            {
+                mesh.m_polygonSets.push_back(PolygonSetRecord());
+                PolygonSetRecord & record = mesh.m_polygonSets.back();
+
+                record.m_index = ReadIndex();
+
+                while( !SkipSpacesToLineEnd() )
+                {
+                    record.m_faces.push_back(ReadUnsigned());
+                }
+            }
+            else
+            {
+                m_p = name;
+                Throw("Unknown record");
+            }
+        }
+
+        /**
+        * Reads a "[n]"
+        **/
+        unsigned ReadIndex()
+        {
+            if( m_p == m_end || *m_p != '[' )
+            {
+                Throw("Expected '['");
+            }
+
+            ++m_p;
+            const unsigned index = ReadUnsigned();
+
+            if( m_p == m_end || *m_p != ']' )
+            {
+                Throw("Expected ']'");
+            }
+
+            ++m_p;
+            return index;
+        }
+
+        unsigned ReadUnsigned()
+        {
+            SkipSpaces();
+
+            if( m_p == m_end || !IsDigit(*m_p) )
+            {
+                Throw("Expected an unsigned integer");
+            }
+
+            unsigned long long value = 0;
+
+            while( m_p < m_end && IsDigit(*m_p) )
+            {
+                value = value * 10 + static_cast<unsigned>(*m_p - '0');
+
+                if( value > 0xFFFFFFFFULL )
+                {
+                    Throw("Integer is out of range");
+                }
+
+                ++m_p;
+            }
+
+            return static_cast<unsigned>(value);
+        }
+
+        /**
+        * Reads a decimal floating point number, with an optional sign, fraction, and exponent
+        *
+        * Up to 19 significant digits are gathered into an integer, which is then scaled by an exact power of ten,
+        * so any number with 15 or fewer significant digits and a small exponent comes out correctly rounded.
+        **/
+        float ReadFloat()
+        {
+            static const double powersOf10[] =
+            {
+                1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            SkipSpaces();
+
+            bool negative = false;
+
+            if( m_p < m_end && (*m_p == '-' || *m_p == '+') )
+            {
+                negative = *m_p == '-';
+                ++m_p;
+            }
+
+            unsigned long long mantissa  = 0;
+            int                numDigits = 0;
+            int                exponent  = 0;
+            bool               anyDigits = false;
+
+            while( m_p < m_end && IsDigit(*m_p) )
+            {
+                if( numDigits < 19 )
+                {
+                    mantissa = mantissa * 10 + static_cast<unsigned>(*m_p - '0');
+                    numDigits += mantissa != 0 ? 1 : 0;
+                }
+                else
+                {
+                    ++exponent;
+                }
+
+                anyDigits = true;
+                ++m_p;
+            }
+
+            if( m_p < m_end && *m_p == '.' )
+            {
+                ++m_p;
+
+                while( m_p < m_end && IsDigit(*m_p) )
+                {
+                    if( numDigits < 19 )
+                    {
+                        mantissa = mantissa * 10 + static_cast<unsigned>(*m_p - '0');
+                        numDigits += mantissa != 0 ? 1 : 0;
+                        --exponent;
+                    }
+
+                    anyDigits = true;
+                    ++m_p;
+                }
+            }
+
+            if( !anyDigits )
+            {
+                Throw("Expected a number");
+            }
+
+            if( m_p < m_end && (*m_p == 'e' || *m_p == 'E') )
+            {
+                ++m_p;
+
+                bool negativeExponent = false;
+
+                if( m_p < m_end && (*m_p == '-' || *m_p == '+') )
+                {
+                    negativeExponent = *m_p == '-';
+                    ++m_p;
+                }
+
+                if( m_p == m_end || !IsDigit(*m_p) )
+                {
+                    Throw("Expected an exponent");
+                }
+
+                int value = 0;
+
+                while( m_p < m_end && IsDigit(*m_p) )
+                {
+                    if( value < 10000 )
+                    {
+                        value = value * 10 + (*m_p - '0');
+                    }
+
+                    ++m_p;
+                }
+
+                exponent += negativeExponent ? -value : value;
+            }
+
+            double result = static_cast<double>(mantissa);
+
+            if( mantissa != 0 )
+            {
+                if( exponent < 0 )
+                {
+                    result = -exponent <= 22 ? result / powersOf10[-exponent] : result * pow(10.0, exponent);
+                }
+                else if( exponent > 0 )
+                {
+                    result = exponent <= 22 ? result * powersOf10[exponent] : result * pow(10.0, exponent);
+                }
+            }
+
+            return static_cast<float>(negative ? -result : result);
+        }
+
+        void SkipSpaces()
+        {
+            while( m_p < m_end && (*m_p == ' ' || *m_p == '\t') )
+            {
+                ++m_p;
+            }
+        }
+
+        /**
+        * Skips spaces and returns whether the end of the line was reached
+        **/
+        bool SkipSpacesToLineEnd()
+        {
+            SkipSpaces();
+            return m_p == m_end || *m_p == '\r' || *m_p == '\n';
+        }
+
+        void ExpectLineEnd()
+        {
+            if( !SkipSpacesToLineEnd() )
+            {
+                Throw("Unexpected characters at the end of a record");
+            }
+        }
+
+        static bool IsDigit(const char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        static std::string Trim(const char * begin, const char * end)
+        {
+            while( begin < end && isspace(static_cast<unsigned char>(*begin)) )
+            {
+                ++begin;
+            }
+
+            while( end > begin && isspace(static_cast<unsigned char>(end[-1])) )
+            {
+                --end;
+            }
+
+            return std::string(begin, end);
+        }
+
+        void Throw(const char * what) const
+        {
+            std::ostringstream msg;
+            msg << what << " in text mesh: " << m_filepath << " at offset " << (m_p - m_fileStart);
+
+            throw Common::Exception(__FILE__, __LINE__, msg.str());
+        }
+
+
+        const std::string & m_filepath;
+        const char *        m_fileStart;
+        const char *        m_p;
+        const char *        m_end;
+    };
+
+    //--------------------------------------------------------------------------
+    void ScanChunk(const std::string & filepath, const char * fileStart, const char * begin, const char * end, std::vector<MeshRecords> & meshes)
+    {
+        ChunkScanner scanner(filepath, fileStart, begin, end);
+        scanner.Scan(meshes);
+    }
+
+    //--------------------------------------------------------------------------
+    void ThrowBuildError(const MeshRecords & mesh, const std::string & what)
+    {
+        std::ostringstream msg;
+        msg << what << " in text mesh " << mesh.m_meshName;
+
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Places records at the index they define
+    *
+    * Indices must be contiguous from 0, as the exporter writes them
+    **/
+    void GatherVector3s(const MeshRecords & mesh,
+                        const std::vector<Vector3Record> & records,
+                        const char * recordName,
+                        std::vector<D3DXVECTOR3> & values)
+    {
+        values.assign(records.size(), D3DXVECTOR3(0.0f, 0.0f, 0.0f));
+        std::vector<unsigned char> defined(records.size(), 0);
+
+        for(std::vector<Vector3Record>::const_iterator it = records.begin(); it != records.end(); ++it)
+        {
+            if( it->m_index >= records.size() )
+            {
+                std::ostringstream msg;
+                msg << recordName << " indices are not contiguous. Found index " << it->m_index << " of " << records.size();
+                ThrowBuildError(mesh, msg.str());
+            }
+
+            values[it->m_index] = D3DXVECTOR3(it->m_x, it->m_y, it->m_z);
+            defined[it->m_index] = 1;
+        }
+
+        if( std::find(defined.begin(), defined.end(), 0) != defined.end() )
+        {
+            std::ostringstream msg;
+            msg << recordName << " indices are not contiguous";
+            ThrowBuildError(mesh, msg.str());
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    void GatherTexCoords(const MeshRecords & mesh, std::vector<std::vector<TexCoord2D> > & texCoords)
+    {
+        texCoords.clear();
+
+        // Count the records of each set
+        std::vector<size_t> counts;
+
+        for(std::vector<TexCoordRecord>::const_iterator it = mesh.m_texCoords.begin(); it != mesh.m_texCoords.end(); ++it)
+        {
+            if( it->m_set >= MAX_UV_SETS )
+            {
+                std::ostringstream msg;
+                msg << "UV set " << it->m_set << " is beyond the maximum of " << MAX_UV_SETS;
+                ThrowBuildError(mesh, msg.str());
+            }
+
+            if( it->m_set >= counts.size() )
+            {
+                counts.resize(it->m_set + 1, 0);
+            }
+
+            ++counts[it->m_set];
+        }
+
+        texCoords.resize(counts.size());
+        std::vector<std::vector<unsigned char> > defined(counts.size());
+
+        for(size_t set = 0; set < counts.size(); ++set)
+        {
+            texCoords[set].assign(counts[set], TexCoord2D(0.0f, 0.0f));
+            defined[set].assign(counts[set], 0);
+        }
+
+        // Place them
+        for(std::vector<TexCoordRecord>::const_iterator it = mesh.m_texCoords.begin(); it != mesh.m_texCoords.end(); ++it)
+        {
+            if( it->m_index >= counts[it->m_set] )
+            {
+                std::ostringstream msg;
+                msg << "UV indices of set " << it->m_set << " are not contiguous. Found index " << it->m_index << " of " << counts[it->m_set];
+                ThrowBuildError(mesh, msg.str());
+            }
+
+            texCoords[it->m_set][it->m_index] = TexCoord2D(it->m_u, it->m_v);
+            defined[it->m_set][it->m_index]   = 1;
+        }
+
+        for(size_t set = 0; set < counts.size(); ++set)
+        {
+            if( std::find(defined[set].begin(), defined[set].end(), 0) != defined[set].end() )
+            {
+                std::ostringstream msg;
+                msg << "UV indices of set " << set << " are not contiguous";
+                ThrowBuildError(mesh, msg.str());
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Gets the file name of a texture without the directories the exporter found it in
+    **/
+    std::string GetTextureFileName(const std::string & filepath)
+    {
+        const size_t slash = filepath.find_last_of("/\\");
+        return slash == std::string::npos ? filepath : filepath.substr(slash + 1);
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Builds the polygon sets of a mesh from all of its records
+    **/
+    void BuildMesh(const MeshRecords & mesh, std::vector<PolygonSetData> & polygonSets)
+    {
+        if( mesh.m_corners.empty() )
+        {
+            return;
+        }
+
+        std::vector<Position>                  positions;
+        std::vector<Normal>                    normals;
+        std::vector<std::vector<TexCoord2D> >  texCoords;
+
+        GatherVector3s(mesh, mesh.m_positions, "Vertex", positions);
+        GatherVector3s(mesh, mesh.m_normals, "Normal", normals);
+        GatherTexCoords(mesh, texCoords);
+
+        const unsigned numUVSets = static_cast<unsigned>(texCoords.size());
+
+        // Find the record of each corner of each face
+        unsigned numFaces = 0;
+
+        for(std::vector<CornerRecord>::const_iterator it = mesh.m_corners.begin(); it != mesh.m_corners.end(); ++it)
+        {
+            if( it->m_corner > 2 )
+            {
+                ThrowBuildError(mesh, "Only triangles are supported");
+            }
+
+            if( it->m_face >= mesh.m_corners.size() )
+            {
+                ThrowBuildError(mesh, "Face indices are not contiguous");
+            }
+
+            numFaces = std::max<unsigned>(numFaces, it->m_face + 1);
+        }
+
+        std::vector<unsigned> cornerRecords(static_cast<size_t>(numFaces) * 3, UNDEFINED_RECORD);
+
+        for(size_t i = 0; i < mesh.m_corners.size(); ++i)
+        {
+            const CornerRecord & corner = mesh.m_corners[i];
+
+            if( corner.m_vertex >= positions.size() || corner.m_normal >= normals.size() )
+            {
+                std::ostringstream msg;
+                msg << "Face " << corner.m_face << " refers to a vertex or normal that does not exist";
+                ThrowBuildError(mesh, msg.str());
+            }
+
+            // The indices after the normal are the UVs of each set, possibly preceded by a color
+            if( corner.m_numValues != numUVSets && corner.m_numValues != numUVSets + 1 )
+            {
+                std::ostringstream msg;
+                msg << "Face " << corner.m_face << " has " << corner.m_numValues << " UV indices, but there are " << numUVSets << " UV sets";
+                ThrowBuildError(mesh, msg.str());
+            }
+
+            const unsigned firstUV = corner.m_firstValue + corner.m_numValues - numUVSets;
+
+            for(unsigned set = 0; set < numUVSets; ++set)
+            {
+                if( mesh.m_cornerValues[firstUV + set] >= texCoords[set].size() )
+                {
+                    std::ostringstream msg;
+                    msg << "Face " << corner.m_face << " refers to a UV that does not exist";
+                    ThrowBuildError(mesh, msg.str());
+                }
+            }
+
+            cornerRecords[static_cast<size_t>(corner.m_face) * 3 + corner.m_corner] = static_cast<unsigned>(i);
+        }
+
+        if( std::find(cornerRecords.begin(), cornerRecords.end(), UNDEFINED_RECORD) != cornerRecords.end() )
+        {
+            ThrowBuildError(mesh, "A face is missing a corner");
+        }
+
+        // Without polygon set records, the whole mesh is one polygon set
+        std::vector<PolygonSetRecord> allFaces;
+        const std::vector<PolygonSetRecord> * polygonSetRecords = &mesh.m_polygonSets;
+
+        if( mesh.m_polygonSets.empty() )
+        {
+            allFaces.push_back(PolygonSetRecord());
+            allFaces.back().m_index = 0;
+
+            for(unsigned face = 0; face < numFaces; ++face)
+            {
+                allFaces.back().m_faces.push_back(face);
+            }
+
+            polygonSetRecords = &allFaces;
+        }
+
+        for(size_t i = 0; i < polygonSetRecords->size(); ++i)
+        {
+            const PolygonSetRecord & record = (*polygonSetRecords)[i];
+
+            polygonSets.push_back(PolygonSetData());
+            PolygonSetData & polygonSet = polygonSets.back();
+
+            // Material
+            polygonSet.m_material.m_diffuse.m_color = D3DXCOLOR(1.0f, 1.0f, 1.0f, 1.0f);
+
+            for(std::vector<TextureRecord>::const_iterator it = mesh.m_textures.begin(); it != mesh.m_textures.end(); ++it)
+            {
+                if( it->m_polygonSet == i )
+                {
+                    polygonSet.m_material.m_diffuse.m_mapped      = true;
+                    polygonSet.m_material.m_diffuse.m_textureFile = GetTextureFileName(it->m_filepath);
+                }
+            }
+
+            // Each vertex is a position, a normal, and then one TexCoord2D per UV set
+            polygonSet.m_contentTypes.push_back(POSITION);
+            polygonSet.m_contentTypes.push_back(NORMAL);
+
+            for(unsigned set = 0; set < numUVSets; ++set)
+            {
+                polygonSet.m_contentTypes.push_back(TEXCOORD2D);
+            }
+
+            const unsigned vertexSize = polygonSet.GetVertexSize();
+
+            // Build a triangle soup, converting to the engine's conventions as we go
+            std::vector<unsigned char> soup(record.m_faces.size() * 3 * vertexSize);
+            unsigned char *            vertex = soup.empty() ? NULL : &soup[0];
+
+            static const unsigned cornerOrder[3] = {0, 2, 1};
+
+            for(std::vector<unsigned>::const_iterator itFace = record.m_faces.begin(); itFace != record.m_faces.end(); ++itFace)
+            {
+                if( *itFace >= numFaces )
+                {
+                    std::ostringstream msg;
+                    msg << "Polygon set " << record.m_index << " refers to face " << *itFace << ", which does not exist";
+                    ThrowBuildError(mesh, msg.str());
+                }
+
+                for(unsigned c = 0; c < 3; ++c)
+                {
+                    const CornerRecord & corner = mesh.m_corners[cornerRecords[static_cast<size_t>(*itFace) * 3 + cornerOrder[c]]];
+
+                    Position position = positions[corner.m_vertex];
+                    position.z = -position.z;
+                    memcpy(vertex, &position, sizeof(Position));
+                    vertex += sizeof(Position);
+
+                    Normal normal = normals[corner.m_normal];
+                    normal.z = -normal.z;
+                    memcpy(vertex, &normal, sizeof(Normal));
+                    vertex += sizeof(Normal);
+
+                    const unsigned firstUV = corner.m_firstValue + corner.m_numValues - numUVSets;
+
+                    for(unsigned set = 0; set < numUVSets; ++set)
+                    {
+                        TexCoord2D texCoord = texCoords[set][mesh.m_cornerValues[firstUV + set]];
+                        texCoord.y = 1.0f - texCoord.y;
+                        memcpy(vertex, &texCoord, sizeof(TexCoord2D));
+                        vertex += sizeof(TexCoord2D);
+                    }
+                }
+            }
+
+            // Weld and optimize, the same as binary files
+            WeldVertices(soup.empty() ? NULL : &soup[0], static_cast<unsigned>(record.m_faces.size() * 3), vertexSize, polygonSet.m_vertices, polygonSet.m_indices);
+
+            polygonSet.m_optimizationReport = OptimizeMesh(polygonSet.m_vertices, vertexSize, polygonSet.m_indices);
+
+            polygonSet.m_numVertices = static_cast<unsigned>(polygonSet.m_vertices.size() / vertexSize);
+            polygonSet.m_numIndices  = static_cast<unsigned>(polygonSet.m_indices.size());
+
+            polygonSet.CalculateBounds();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+const bool IsTextMeshFile(const std::string & filepath)
+{
+    const size_t dot = filepath.find_last_of('.');
+
+    if( dot == std::string::npos || filepath.size() - dot != 4 )
+    {
+        return false;
+    }
+
+    return tolower(filepath[dot + 1]) == 't' &&
+           tolower(filepath[dot + 2]) == 'x' &&
+           tolower(filepath[dot + 3]) == 't';
+}
+
+//------------------------------------------------------------------------------
+void ParseTextMesh(const std::string & filepath,
+                   std::vector<PolygonSetData> & polygonSets)
+{
+    polygonSets.clear();
+
+    MappedFile file(filepath);
+
+    const char * data = reinterpret_cast<const char *>(file.GetData());
+    const size_t size = file.GetSize();
+
+    if( size == 0 )
+    {
+        return;
+    }
+
+    // Split the file into chunks, one per hardware thread, each starting at the beginning of a line
+    size_t numChunks = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    numChunks = std::max<size_t>(1, std::min<size_t>(numChunks, size / MIN_CHUNK_SIZE));
+
+    std::vector<size_t> boundaries(numChunks + 1, size);
+    boundaries[0] = 0;
+
+    for(size_t i = 1; i < numChunks; ++i)
+    {
+        size_t boundary = std::max<size_t>(size / numChunks * i, boundaries[i - 1]);
+
+        while( boundary < size && data[boundary - 1] != '\n' )
+        {
+            ++boundary;
+        }
+
+        boundaries[i] = boundary;
+    }
+
+    // Scan the chunks in parallel
+    //
+    // The calling thread may itself be a worker of a thread pool, so the other chunks get threads of their own
+    // rather than being queued behind it
+    std::vector<std::vector<MeshRecords> > chunks(numChunks);
+    std::vector<std::future<void> >        scans;
+
+    for(size_t i = 1; i < numChunks; ++i)
+    {
+        scans.push_back(std::async(std::launch::async,
+                                   ScanChunk,
+                                   std::cref(filepath),
+                                   data,
+                                   data + boundaries[i],
+                                   data + boundaries[i + 1],
+                                   std::ref(chunks[i])));
+    }
+
+    ScanChunk(filepath, data, data, data + boundaries[1], chunks[0]);
+
+    for(size_t i = 0; i < scans.size(); ++i)
+    {
+        scans[i].get();
+    }
+
+    // Stitch the chunks back together into whole meshes
+    std::vector<MeshRecords> meshes;
+
+    for(size_t i = 0; i < numChunks; ++i)
+    {
+        for(std::vector<MeshRecords>::iterator it = chunks[i].begin(); it != chunks[i].end(); ++it)
+        {
+            if( !it->m_startsMesh && meshes.empty() && it->IsEmpty() )
+            {
+                continue;
+            }
+
+            if( it->m_startsMesh || meshes.empty() )
+            {
+                meshes.push_back(MeshRecords());
+                meshes.back().m_startsMesh = it->m_startsMesh;
+                meshes.back().m_meshName   = it->m_meshName;
+            }
+
+            meshes.back().Append(*it);
+        }
+
+        std::vector<MeshRecords>().swap(chunks[i]);
+    }
+
+    for(std::vector<MeshRecords>::const_iterator it = meshes.begin(); it != meshes.end(); ++it)
+    {
+        BuildMesh(*it, polygonSets);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef TEXTMESHPARSER_H
+#define TEXTMESHPARSER_H
+
+// EngineX Includes
+#include "Graphics\3D\PolygonSetData.h"
+
+// Standard Includes
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Text meshes are written by the EngineX Maya export script. A file holds one or more meshes, each made of
+// records that name the index they define:
+//
+//    // Mesh Name:<name>                         Starts a mesh
+//    v[index] x y z                              Position
+//    n[index] x y z                              Normal
+//    uv[set][index] u v                          Texture coordinates in a UV set
+//    f[face][corner] vertex normal [color] uv0 uv1 ... uvN
+//                                                One corner of a triangle, as indices of the above. The color
+//                                                index is only present if the mesh has colors, and is ignored.
+//    // Color Texture Filepath: <path>           Texture of the polygon set that follows
+//    ps[index] face face ...                     Polygon set, as the faces that belong to it
+//
+// Any other line starting with // is a comment. A mesh without polygon sets is a single polygon set of all its faces.
+//
+// Because every record carries its own index, the file is split into chunks at line boundaries that are scanned
+// in parallel, with no shared state, and the records are stitched together afterwards. Numbers are read with a
+// small purpose built parser rather than iostreams.
+//
+// Maya's right handed space, counter clockwise winding, and bottom up texture coordinates are converted to the
+// left handed space, clockwise winding, and top down texture coordinates that the engine uses.
+//
+
+/**
+* Checks whether a file is a text mesh, going by its extension
+**/
+const bool IsTextMeshFile(const std::string & filepath);
+
+/**
+* Parses a text mesh into descriptions of the polygon sets it contains
+*
+* Each polygon set is welded into unique vertices, optimized, and has its bounds calculated,
+* the same as those of binary files.
+*
+* @param filepath    - Path to the text mesh
+* @param polygonSets - OUT - Polygon sets of every mesh in the file, in order
+*
+* @throws BaseException - If the file could not be read, a record is malformed, or a record refers to one that does not exist
+**/
+void ParseTextMesh(const std::string & filepath,
+                   std::vector<PolygonSetData> & polygonSets);
+
+#endif // TEXTMESHPARSER_H
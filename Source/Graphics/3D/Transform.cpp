@@ -8,7 +8,8 @@
 Transform::Transform()
    :
    m_position(0.0f, 0.0f, 0.0f),
-   m_scale(1.0f, 1.0f, 1.0f)
+   m_scale(1.0f, 1.0f, 1.0f),
+   m_needUpdated(false)
 {
    D3DXMatrixIdentity(&m_transform);
    D3DXQuaternionRotationMatrix(&m_orientation, &m_transform);
@@ -0,0 +1,324 @@
+
+// Project Includes
+#include "VertexQuantizer.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    //--------------------------------------------------------------------------
+    inline float SignNotZero(const float value)
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Decodes one signed normalized short, as the input assembler does
+    **/
+    inline float SNorm16ToFloat(const short value)
+    {
+        const float decoded = static_cast<float>(value) / 32767.0f;
+        return decoded < -1.0f ? -1.0f : decoded;
+    }
+
+    //--------------------------------------------------------------------------
+    inline short FloatToSNorm16(const float value)
+    {
+        const float clamped = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+        return static_cast<short>(floorf(clamped * 32767.0f + 0.5f));
+    }
+
+    //--------------------------------------------------------------------------
+    inline unsigned short FloatToUNorm16(const float value)
+    {
+        const float clamped = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+        return static_cast<unsigned short>(floorf(clamped * 65535.0f + 0.5f));
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Where one content type lies in each vertex, and where it will lie once quantized
+    **/
+    struct ContentLayout
+    {
+        BufferContentType m_contentType;
+        unsigned          m_offset;
+        unsigned          m_quantizedOffset;
+    };
+
+    //--------------------------------------------------------------------------
+    const BufferContentType GetQuantizedContentType(const BufferContentType contentType)
+    {
+        switch( contentType )
+        {
+        case POSITION:   return POSITION16;
+        case NORMAL:     return NORMAL16;
+        case TEXCOORD2D: return TEXCOORD2D16;
+        default:         return contentType;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+VertexQuantization::VertexQuantization()
+    :
+    m_positionScale(1.0f),
+    m_positionBias (0.0f, 0.0f, 0.0f),
+    m_texCoordScale(1.0f, 1.0f),
+    m_texCoordBias (0.0f, 0.0f)
+{
+}
+
+//------------------------------------------------------------------------------
+const D3DXVECTOR2 EncodeOctahedral(const D3DXVECTOR3 & normal)
+{
+    // Project onto the octahedron |x| + |y| + |z| = 1
+    const float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+
+    if( length < FLT_MIN )
+    {
+        return D3DXVECTOR2(0.0f, 0.0f);
+    }
+
+    D3DXVECTOR2 encoded(normal.x / length, normal.y / length);
+
+    // Fold the lower half over the diagonals, onto the corners of the square
+    if( normal.z < 0.0f )
+    {
+        const float x = encoded.x;
+        const float y = encoded.y;
+
+        encoded.x = (1.0f - fabsf(y)) * SignNotZero(x);
+        encoded.y = (1.0f - fabsf(x)) * SignNotZero(y);
+    }
+
+    return encoded;
+}
+
+//------------------------------------------------------------------------------
+const D3DXVECTOR3 DecodeOctahedral(const D3DXVECTOR2 & encoded)
+{
+    // Must match DecodeOctahedral in PerPixelPhong.fx
+    D3DXVECTOR3 normal(encoded.x, encoded.y, 1.0f - fabsf(encoded.x) - fabsf(encoded.y));
+
+    const float fold = normal.z < 0.0f ? -normal.z : 0.0f;
+    normal.x += normal.x >= 0.0f ? -fold : fold;
+    normal.y += normal.y >= 0.0f ? -fold : fold;
+
+    D3DXVec3Normalize(&normal, &normal);
+    return normal;
+}
+
+//------------------------------------------------------------------------------
+const Normal16 QuantizeNormal(const D3DXVECTOR3 & normal)
+{
+    const D3DXVECTOR2 encoded = EncodeOctahedral(normal);
+
+    // Try rounding each component both down and up, and keep whichever decodes closest to the original
+    const float x = encoded.x * 32767.0f;
+    const float y = encoded.y * 32767.0f;
+
+    Normal16 best  = { FloatToSNorm16(encoded.x), FloatToSNorm16(encoded.y) };
+    float bestDot  = -FLT_MAX;
+
+    for(unsigned i = 0; i < 4; ++i)
+    {
+        const float candidateX = (i & 1) ? ceilf(x) : floorf(x);
+        const float candidateY = (i & 2) ? ceilf(y) : floorf(y);
+
+        const Normal16 candidate = { FloatToSNorm16(candidateX / 32767.0f), FloatToSNorm16(candidateY / 32767.0f) };
+
+        const D3DXVECTOR3 decoded = DequantizeNormal(candidate);
+        const float       dot     = D3DXVec3Dot(&decoded, &normal);
+
+        if( dot > bestDot )
+        {
+            bestDot = dot;
+            best    = candidate;
+        }
+    }
+
+    return best;
+}
+
+//------------------------------------------------------------------------------
+const D3DXVECTOR3 DequantizeNormal(const Normal16 & normal)
+{
+    return DecodeOctahedral(D3DXVECTOR2(SNorm16ToFloat(normal.x), SNorm16ToFloat(normal.y)));
+}
+
+//------------------------------------------------------------------------------
+void QuantizeVertices(std::vector<unsigned char> & vertexData,
+                      std::vector<BufferContentType> & contentTypes,
+                      const unsigned numVertices,
+                      VertexQuantization & quantization)
+{
+    // Find where everything lies in the vertices, now and once quantized
+    std::vector<ContentLayout> layout;
+    unsigned                   vertexSize          = 0;
+    unsigned                   quantizedVertexSize = 0;
+    bool                       hasPosition         = false;
+
+    for(std::vector<BufferContentType>::const_iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+    {
+        if( *it == POSITION16 )
+        {
+            // Already quantized
+            return;
+        }
+
+        hasPosition |= (*it == POSITION);
+
+        ContentLayout content;
+        content.m_contentType     = *it;
+        content.m_offset          = vertexSize;
+        content.m_quantizedOffset = quantizedVertexSize;
+        layout.push_back(content);
+
+        vertexSize          += GetStride(*it);
+        quantizedVertexSize += GetStride(GetQuantizedContentType(*it));
+    }
+
+    if( !hasPosition )
+    {
+        const std::string msg("Cannot quantize vertices without a position");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( vertexData.size() != static_cast<size_t>(numVertices) * vertexSize )
+    {
+        const std::string msg("The size of the vertex data does not match the number of vertices and their content types");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Find the range of the positions and of the texture coordinates
+    D3DXVECTOR3 positionMin( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    D3DXVECTOR3 positionMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    D3DXVECTOR2 texCoordMin( FLT_MAX,  FLT_MAX);
+    D3DXVECTOR2 texCoordMax(-FLT_MAX, -FLT_MAX);
+
+    for(unsigned i = 0; i < numVertices; ++i)
+    {
+        const unsigned char * vertex = &vertexData[static_cast<size_t>(i) * vertexSize];
+
+        for(std::vector<ContentLayout>::const_iterator it = layout.begin(); it != layout.end(); ++it)
+        {
+            if( it->m_contentType == POSITION )
+            {
+                Position position;
+                memcpy(&position, vertex + it->m_offset, sizeof(Position));
+                D3DXVec3Minimize(&positionMin, &positionMin, &position);
+                D3DXVec3Maximize(&positionMax, &positionMax, &position);
+            }
+            else if( it->m_contentType == TEXCOORD2D )
+            {
+                TexCoord2D texCoord;
+                memcpy(&texCoord, vertex + it->m_offset, sizeof(TexCoord2D));
+                D3DXVec2Minimize(&texCoordMin, &texCoordMin, &texCoord);
+                D3DXVec2Maximize(&texCoordMax, &texCoordMax, &texCoord);
+            }
+        }
+    }
+
+    // Positions are centered and uniformly scaled into [-1, 1]
+    VertexQuantization result;
+
+    if( numVertices > 0 )
+    {
+        const D3DXVECTOR3 halfExtent = (positionMax - positionMin) * 0.5f;
+
+        result.m_positionBias  = (positionMin + positionMax) * 0.5f;
+        result.m_positionScale = halfExtent.x > halfExtent.y ? halfExtent.x : halfExtent.y;
+        result.m_positionScale = halfExtent.z > result.m_positionScale ? halfExtent.z : result.m_positionScale;
+
+        if( result.m_positionScale < FLT_MIN )
+        {
+            result.m_positionScale = 1.0f;
+        }
+    }
+
+    // Texture coordinates are moved into [0, 1], per component, as they need not be square
+    if( texCoordMin.x <= texCoordMax.x )
+    {
+        result.m_texCoordBias  = texCoordMin;
+        result.m_texCoordScale = texCoordMax - texCoordMin;
+
+        if( result.m_texCoordScale.x < FLT_MIN )
+        {
+            result.m_texCoordScale.x = 1.0f;
+        }
+
+        if( result.m_texCoordScale.y < FLT_MIN )
+        {
+            result.m_texCoordScale.y = 1.0f;
+        }
+    }
+
+    // Build the quantized vertices
+    std::vector<unsigned char> quantizedData(static_cast<size_t>(numVertices) * quantizedVertexSize);
+
+    const float inversePositionScale = 1.0f / result.m_positionScale;
+
+    for(unsigned i = 0; i < numVertices; ++i)
+    {
+        const unsigned char * vertex          = &vertexData[static_cast<size_t>(i) * vertexSize];
+        unsigned char *       quantizedVertex = &quantizedData[static_cast<size_t>(i) * quantizedVertexSize];
+
+        for(std::vector<ContentLayout>::const_iterator it = layout.begin(); it != layout.end(); ++it)
+        {
+            const unsigned char * source      = vertex + it->m_offset;
+            unsigned char *       destination = quantizedVertex + it->m_quantizedOffset;
+
+            if( it->m_contentType == POSITION )
+            {
+                Position position;
+                memcpy(&position, source, sizeof(Position));
+
+                const D3DXVECTOR4 scaled((position - result.m_positionBias) * inversePositionScale, 1.0f);
+
+                Position16 quantized;
+                D3DXFloat32To16Array(&quantized.x, &scaled.x, 4);
+                memcpy(destination, &quantized, sizeof(Position16));
+            }
+            else if( it->m_contentType == NORMAL )
+            {
+                Normal normal;
+                memcpy(&normal, source, sizeof(Normal));
+
+                const Normal16 quantized = QuantizeNormal(normal);
+                memcpy(destination, &quantized, sizeof(Normal16));
+            }
+            else if( it->m_contentType == TEXCOORD2D )
+            {
+                TexCoord2D texCoord;
+                memcpy(&texCoord, source, sizeof(TexCoord2D));
+
+                TexCoord2D16 quantized;
+                quantized.u = FloatToUNorm16((texCoord.x - result.m_texCoordBias.x) / result.m_texCoordScale.x);
+                quantized.v = FloatToUNorm16((texCoord.y - result.m_texCoordBias.y) / result.m_texCoordScale.y);
+                memcpy(destination, &quantized, sizeof(TexCoord2D16));
+            }
+            else
+            {
+                memcpy(destination, source, GetStride(it->m_contentType));
+            }
+        }
+    }
+
+    // Swap in the quantized vertices
+    for(std::vector<BufferContentType>::iterator it = contentTypes.begin(); it != contentTypes.end(); ++it)
+    {
+        *it = GetQuantizedContentType(*it);
+    }
+
+    vertexData.swap(quantizedData);
+    quantization = result;
+}
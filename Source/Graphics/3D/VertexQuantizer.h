@@ -0,0 +1,90 @@
+#ifndef VERTEXQUANTIZER_H
+#define VERTEXQUANTIZER_H
+
+// EngineX Includes
+#include "Graphics\3D\Buffers.h"
+
+// DirectX Includes
+#include <d3dx10.h>
+
+// Standard Includes
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Compression of vertex attributes into smaller formats that the input assembler expands back into floats
+//
+//    POSITION   (12 bytes) -> POSITION16   (8 bytes)  Half floats, after moving the mesh into [-1, 1]
+//    NORMAL     (12 bytes) -> NORMAL16     (4 bytes)  Octahedral encoding, as signed normalized shorts
+//    TEXCOORD2D (8 bytes)  -> TEXCOORD2D16 (4 bytes)  Unsigned normalized shorts, after moving into [0, 1]
+//
+// Moving the attributes into those ranges takes a scale and bias picked per mesh, from the range of its values.
+// The position scale is uniform, so that undoing it is a transform that does not distort normals and can be
+// folded into the world matrix. The texture coordinate scale and bias are applied by the vertex shader.
+//
+// Other content types, tangent frames included, are left as they are.
+//
+
+/**
+* What was done to the vertices of a mesh when they were quantized, so that it can be undone
+*
+* A quantized value q decodes as q * scale + bias. The default is the identity, for vertices that were not quantized.
+**/
+struct VertexQuantization
+{
+   /**
+   * Constructor
+   **/
+   VertexQuantization();
+
+
+   float       m_positionScale;
+   D3DXVECTOR3 m_positionBias;
+   D3DXVECTOR2 m_texCoordScale;   // Shared by every set of texture coordinates
+   D3DXVECTOR2 m_texCoordBias;
+};
+
+/**
+* Encodes a unit vector as a point on an octahedron, unfolded into a square
+*
+* @param normal - Unit vector
+*
+* @return - The point in the square, each component in [-1, 1]
+**/
+const D3DXVECTOR2 EncodeOctahedral(const D3DXVECTOR3 & normal);
+
+/**
+* Decodes a point on an unfolded octahedron back into a unit vector
+**/
+const D3DXVECTOR3 DecodeOctahedral(const D3DXVECTOR2 & encoded);
+
+/**
+* Quantizes a unit normal into two signed normalized shorts
+*
+* The rounding of each component is chosen so that the decoded normal lies as close to the original as possible.
+**/
+const Normal16 QuantizeNormal(const D3DXVECTOR3 & normal);
+
+/**
+* Decodes a normal that was quantized with QuantizeNormal, as the input assembler and shader will
+**/
+const D3DXVECTOR3 DequantizeNormal(const Normal16 & normal);
+
+/**
+* Replaces the positions, normals, and texture coordinates of interleaved vertices with quantized ones
+*
+* POSITION becomes POSITION16, NORMAL becomes NORMAL16, and each TEXCOORD2D becomes TEXCOORD2D16.
+* Does nothing, and leaves the quantization as it is, if the vertices are already quantized.
+*
+* @param vertexData   - IN/OUT - Interleaved vertices, rebuilt with the smaller content types
+* @param contentTypes - IN/OUT - What each vertex is made of, in order
+* @param numVertices  - Number of vertices
+* @param quantization - OUT - The scale and bias needed to decode the vertices
+*
+* @throws BaseException - If the vertices have no POSITION, or the vertex data is not the size the content types say
+**/
+void QuantizeVertices(std::vector<unsigned char> & vertexData,
+                      std::vector<BufferContentType> & contentTypes,
+                      const unsigned numVertices,
+                      VertexQuantization & quantization);
+
+#endif // VERTEXQUANTIZER_H
@@ -0,0 +1,229 @@
+
+// Project Includes
+#include "VertexWelder.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    // Marks a slot of the hash table that holds no vertex
+    const Index EMPTY_SLOT = 0xFFFFFFFF;
+
+    // Number of unique vertices, and of indices, in each block they are kept in
+    const unsigned BLOCK_SHIFT = 12;
+    const unsigned BLOCK_SIZE  = 1 << BLOCK_SHIFT;
+
+    //--------------------------------------------------------------------------
+    /**
+    * Gets a 4 byte word of a vertex, with -0.0f folded to 0.0f so the two compare and hash the same
+    **/
+    inline unsigned int GetCanonicalWord(const unsigned char * vertex, const unsigned wordIndex)
+    {
+        unsigned int word = 0;
+        memcpy(&word, vertex + wordIndex * 4, 4);
+
+        return word == 0x80000000 ? 0 : word;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * FNV-1a hash of a whole vertex
+    **/
+    unsigned int HashVertex(const unsigned char * vertex, const unsigned numWords)
+    {
+        unsigned int hash = 2166136261U;
+
+        for(unsigned i = 0; i < numWords; ++i)
+        {
+            hash ^= GetCanonicalWord(vertex, i);
+            hash *= 16777619U;
+        }
+
+        // Mix the high bits down, as the hash is masked to the size of the table
+        hash ^= hash >> 16;
+
+        return hash;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Query whether or not two vertices are equal
+    **/
+    bool VerticesEqual(const unsigned char * lhs, const unsigned char * rhs, const unsigned numWords)
+    {
+        for(unsigned i = 0; i < numWords; ++i)
+        {
+            if( GetCanonicalWord(lhs, i) != GetCanonicalWord(rhs, i) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    * Copies blocks, one after the other, into a vector of exactly their total size, releasing each once it is copied
+    **/
+    template<typename T>
+    void ConcatenateBlocks(std::vector<std::vector<T> > & blocks, const size_t size, std::vector<T> & result)
+    {
+        std::vector<T>().swap(result);
+        result.reserve(size);
+
+        for(typename std::vector<std::vector<T> >::iterator it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            result.insert(result.end(), it->begin(), it->end());
+            std::vector<T>().swap(*it);
+        }
+
+        std::vector<std::vector<T> >().swap(blocks);
+    }
+}
+
+//------------------------------------------------------------------------------
+void WeldVertices(const unsigned char * vertexData,
+                  const unsigned numVertices,
+                  const unsigned vertexSize,
+                  std::vector<unsigned char> & weldedVertexData,
+                  std::vector<Index> & indices)
+{
+    try
+    {
+        VertexWelder welder(vertexSize, numVertices);
+        welder.AddVertices(vertexData, numVertices);
+        welder.TakeResult(weldedVertexData, indices);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//------------------------------------------------------------------------------
+VertexWelder::VertexWelder(const unsigned vertexSize, const unsigned numVertices)
+    :
+    m_vertexSize(vertexSize),
+    m_numWords  (vertexSize / 4),
+    m_numIndices(0),
+    m_table     (16, EMPTY_SLOT),
+    m_numUnique (0)
+{
+    if( vertexSize == 0 || vertexSize % 4 != 0 )
+    {
+        std::ostringstream msg;
+        msg << "Cannot weld vertices of size " << vertexSize << ". The size must be a multiple of 4 bytes.";
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    // There is exactly one index per vertex of the soup
+    m_indexBlocks.reserve(numVertices / BLOCK_SIZE + 1);
+}
+
+//------------------------------------------------------------------------------
+VertexWelder::~VertexWelder()
+{
+}
+
+//------------------------------------------------------------------------------
+void VertexWelder::AddVertices(const unsigned char * vertexData, const unsigned numVertices)
+{
+    for(unsigned i = 0; i < numVertices; ++i)
+    {
+        // Keep the table at most half full
+        if( static_cast<size_t>(m_numUnique) * 2 >= m_table.size() )
+        {
+            GrowTable();
+        }
+
+        const size_t          tableMask = m_table.size() - 1;
+        const unsigned char * vertex    = vertexData + static_cast<size_t>(i) * m_vertexSize;
+        size_t                slot      = HashVertex(vertex, m_numWords) & tableMask;
+
+        // Linear probe until the vertex or an empty slot is found
+        while( m_table[slot] != EMPTY_SLOT )
+        {
+            if( VerticesEqual(vertex, GetUniqueVertex(m_table[slot]), m_numWords) )
+            {
+                break;
+            }
+
+            slot = (slot + 1) & tableMask;
+        }
+
+        if( m_table[slot] == EMPTY_SLOT )
+        {
+            if( m_numUnique % BLOCK_SIZE == 0 )
+            {
+                m_vertexBlocks.push_back(std::vector<unsigned char>());
+                m_vertexBlocks.back().reserve(static_cast<size_t>(BLOCK_SIZE) * m_vertexSize);
+            }
+
+            m_table[slot] = m_numUnique++;
+            m_vertexBlocks.back().insert(m_vertexBlocks.back().end(), vertex, vertex + m_vertexSize);
+        }
+
+        if( m_numIndices % BLOCK_SIZE == 0 )
+        {
+            m_indexBlocks.push_back(std::vector<Index>());
+            m_indexBlocks.back().reserve(BLOCK_SIZE);
+        }
+
+        m_indexBlocks.back().push_back(m_table[slot]);
+        ++m_numIndices;
+    }
+}
+
+//------------------------------------------------------------------------------
+const unsigned VertexWelder::GetNumUniqueVertices() const
+{
+    return m_numUnique;
+}
+
+//------------------------------------------------------------------------------
+void VertexWelder::TakeResult(std::vector<unsigned char> & weldedVertexData, std::vector<Index> & indices)
+{
+    // The table is not needed to copy the blocks, so it goes first
+    std::vector<Index>(16, EMPTY_SLOT).swap(m_table);
+
+    ConcatenateBlocks(m_vertexBlocks, static_cast<size_t>(m_numUnique) * m_vertexSize, weldedVertexData);
+    ConcatenateBlocks(m_indexBlocks, m_numIndices, indices);
+
+    m_numIndices = 0;
+    m_numUnique  = 0;
+}
+
+//------------------------------------------------------------------------------
+void VertexWelder::GrowTable()
+{
+    std::vector<Index> table(m_table.size() * 2, EMPTY_SLOT);
+    const size_t       tableMask = table.size() - 1;
+
+    // Unique vertices are all different, so each only needs an empty slot
+    for(unsigned i = 0; i < m_numUnique; ++i)
+    {
+        size_t slot = HashVertex(GetUniqueVertex(i), m_numWords) & tableMask;
+
+        while( table[slot] != EMPTY_SLOT )
+        {
+            slot = (slot + 1) & tableMask;
+        }
+
+        table[slot] = i;
+    }
+
+    m_table.swap(table);
+}
+
+//------------------------------------------------------------------------------
+const unsigned char * VertexWelder::GetUniqueVertex(const Index index) const
+{
+    return &m_vertexBlocks[index >> BLOCK_SHIFT][static_cast<size_t>(index & (BLOCK_SIZE - 1)) * m_vertexSize];
+}
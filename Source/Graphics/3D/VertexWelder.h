@@ -0,0 +1,118 @@
+#ifndef VERTEXWELDER_H
+#define VERTEXWELDER_H
+
+// EngineX Includes
+#include "Graphics\3D\Buffers.h"
+
+// Standard Includes
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+/**
+* Removes duplicate vertices from a triangle soup and creates an index list that references the unique ones
+*
+* Vertices are compared as a whole, so two vertices are only merged when every attribute (position, normal, 
+* all UV sets, etc.) is identical. Values are compared exactly, with the exception that +0 and -0 are 
+* considered equal. The first occurrence of each vertex is kept, so the order of the unique vertices follows 
+* the order they were first referenced in the soup.
+*
+* @param vertexData       - Interleaved vertices of the triangle soup
+* @param numVertices      - Number of vertices in the soup
+* @param vertexSize       - Size in bytes of one vertex. Must be a multiple of 4.
+* @param weldedVertexData - OUT - Interleaved unique vertices
+* @param indices          - OUT - One index per vertex of the soup, into the unique vertices
+*
+* @throws BaseException - If the vertex size is not a multiple of 4
+**/
+void WeldVertices(const unsigned char * vertexData,
+                  const unsigned numVertices,
+                  const unsigned vertexSize,
+                  std::vector<unsigned char> & weldedVertexData,
+                  std::vector<Index> & indices);
+
+
+
+//------------------------------------------------------------------------------
+/**
+* Removes duplicate vertices from a triangle soup that is handed over a part at a time
+*
+* Welds exactly as WeldVertices does, but only holds the unique vertices and the indices, so the soup itself
+* never has to be in memory all at once. Memory for the unique vertices grows with the number found, rather
+* than being reserved for the worst case of every vertex in the soup being unique.
+*
+* The unique vertices and the indices are kept in blocks of fixed size, so growing never copies them. They are
+* only copied once, into vectors of exactly their size, when the result is taken.
+**/
+class VertexWelder
+{
+public:
+
+   /**
+   * Constructor
+   *
+   * @param vertexSize  - Size in bytes of one vertex. Must be a multiple of 4.
+   * @param numVertices - Number of vertices in the whole soup, if known, which the list of index blocks is sized for
+   *
+   * @throws BaseException - If the vertex size is not a multiple of 4
+   **/
+   VertexWelder(const unsigned vertexSize, const unsigned numVertices = 0);
+
+   /**
+   * Deconstructor
+   **/
+   ~VertexWelder();
+
+
+   /**
+   * Welds the next part of the soup
+   *
+   * @param vertexData  - Interleaved vertices that follow those already added
+   * @param numVertices - Number of vertices
+   **/
+   void AddVertices(const unsigned char * vertexData, const unsigned numVertices);
+
+   /**
+   * Gets the number of unique vertices found so far
+   **/
+   const unsigned GetNumUniqueVertices() const;
+
+   /**
+   * Hands over the unique vertices and the indices of everything added so far, and starts over
+   *
+   * Each block is released as soon as it has been copied, so at most one block more than the result is held.
+   *
+   * @param weldedVertexData - OUT - Interleaved unique vertices, with no spare capacity
+   * @param indices          - OUT - One index per vertex added, into the unique vertices, with no spare capacity
+   **/
+   void TakeResult(std::vector<unsigned char> & weldedVertexData, std::vector<Index> & indices);
+
+private:
+
+   /** No Copy allowed */
+   VertexWelder(const VertexWelder & rhs);
+
+   /** No assignment allowed */
+   VertexWelder & operator = (const VertexWelder & rhs);
+
+   /**
+   * Doubles the size of the hash table and inserts the unique vertices into it again
+   **/
+   void GrowTable();
+
+   /**
+   * Gets a unique vertex found so far
+   **/
+   const unsigned char * GetUniqueVertex(const Index index) const;
+
+
+   unsigned                                 m_vertexSize;     // Size in bytes of one vertex
+   unsigned                                 m_numWords;       // Number of 4 byte words in one vertex
+   std::vector<std::vector<unsigned char> > m_vertexBlocks;   // Unique vertices found so far, in blocks of fixed size
+   std::vector<std::vector<Index> >         m_indexBlocks;    // One index per vertex added, into the unique vertices, in blocks of fixed size
+   size_t                                   m_numIndices;     // Number of vertices added so far
+   std::vector<Index>                       m_table;          // Open addressed hash table of unique vertex indices, kept at most half full
+   unsigned                                 m_numUnique;      // Number of unique vertices found so far
+};
+
+#endif // VERTEXWELDER_H
@@ -26,7 +26,8 @@ Effect::Effect(ID3D10Device & device,
     m_defaultEffectState         (effectName),
     m_currentEffectState         (effectName),
     m_worldMatrix                (nullptr),
-    m_worldInverseTransposeMatrix(nullptr)
+    m_worldInverseTransposeMatrix(nullptr),
+    m_texCoordScaleBias          (nullptr)
 {
     //-----
     // Compile the effect
@@ -152,11 +153,21 @@ Effect::Effect(ID3D10Device & device,
         // Float4
         else if( variableClass == D3D10_SVC_VECTOR && variableType == D3D10_SVT_FLOAT )
         {
-            m_effectFloat4Variables[name] = effectVariable->AsVector();
+            // Handle non-tweakable float4 parameters
+            if( name == "texCoordScaleBias" )
+            {
+                m_texCoordScaleBias = effectVariable->AsVector();
+            }
+
+            // Handle tweakable float4 parameters
+            else
+            {
+                m_effectFloat4Variables[name] = effectVariable->AsVector();
 
-            D3DXVECTOR4 defaultValue;
-            m_effectFloat4Variables[name]->GetFloatVector((float *)&defaultValue);
-            m_defaultEffectState.CreateFloat4(name, defaultValue);
+                D3DXVECTOR4 defaultValue;
+                m_effectFloat4Variables[name]->GetFloatVector((float *)&defaultValue);
+                m_defaultEffectState.CreateFloat4(name, defaultValue);
+            }
         }
 
         // Texture2D
@@ -281,6 +292,17 @@ void Effect::SetWorldMatrix(const D3DXMATRIX & worldMatrix)
     m_worldInverseTransposeMatrix->SetMatrix((float *)&inverseTranspose);
 }
 
+//----------------------------------------------------------------------------
+void Effect::SetTexCoordDequantization(const D3DXVECTOR4 & scaleBias)
+{
+    if( !m_texCoordScaleBias || !m_texCoordScaleBias->IsValid() )
+    {
+        return;
+    }
+
+    m_texCoordScaleBias->SetFloatVector((float *)&scaleBias);
+}
+
 //----------------------------------------------------------------------------
 std::auto_ptr<Material> Effect::CreateMaterial() const
 {
@@ -328,6 +350,34 @@ void Effect::SetMaterial(const Material & material)
     UpdateTextures(material);  
 }
 
+//----------------------------------------------------------------------------
+void Effect::RequestTextureDetail(const Material & material, const float screenFraction)
+{
+    if( !m_textureManager.IsStreaming() )
+    {
+        return;
+    }
+
+    // The same texture each variable is set to by UpdateTextures
+    for(EffectTextureVariables::const_iterator itEffectVariable = m_effectTextureVariables.begin(); 
+        itEffectVariable != m_effectTextureVariables.end(); ++itEffectVariable)
+    {
+        Material::TextureNames::const_iterator itState = material.m_textureNames.find(itEffectVariable->first);
+
+        if( itState == material.m_textureNames.end() || !itState->second.m_initialized )
+        {
+            itState = m_defaultEffectState.m_textureNames.find(itEffectVariable->first);
+
+            if( itState == m_defaultEffectState.m_textureNames.end() || !itState->second.m_initialized )
+            {
+                continue;
+            }
+        }
+
+        m_textureManager.RequestTextureDetail(itState->second.m_value, screenFraction);
+    }
+}
+
 //----------------------------------------------------------------------------
 void Effect::UpdateMatrices(const Material & material)
 {
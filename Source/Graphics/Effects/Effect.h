@@ -58,6 +58,15 @@ public:
    **/
    void SetWorldMatrix(const D3DXMATRIX & worldMatrix);
 
+   /**
+   * Sets the texCoordScaleBias effect variable, which decodes quantized texture coordinates
+   *
+   * Does nothing if the effect has no such variable, as only effects that draw quantized vertices need one.
+   *
+   * @param scaleBias - Scale in xy and bias in zw, (1, 1, 0, 0) for texture coordinates that are not quantized
+   **/
+   void SetTexCoordDequantization(const D3DXVECTOR4 & scaleBias);
+
    /**
    * Creates an unitialized material containing attributes that reflect all of the
    * effect variables belonging to the effect in thier default state
@@ -84,6 +93,17 @@ public:
    **/
    void SetMaterial(const Material & material);
 
+   /**
+   * Tells the texture manager how large the textures of a material are drawn, so that it can stream in
+   * the mip levels they need (see TextureManager::RequestTextureDetail)
+   *
+   * Does nothing if textures are not streamed.
+   *
+   * @param material       - Material whose textures, or the default ones of this effect, are drawn
+   * @param screenFraction - Fraction of the viewport height the textures are stretched across
+   **/
+   void RequestTextureDetail(const Material & material, const float screenFraction);
+
 
 
 private:
@@ -158,6 +178,7 @@ private:
    
    ID3D10EffectMatrixVariable * m_worldMatrix;
    ID3D10EffectMatrixVariable * m_worldInverseTransposeMatrix;
+   ID3D10EffectVectorVariable * m_texCoordScaleBias;
 
 
    // Tweakable effect parameters
@@ -127,6 +127,15 @@ bool      specularMapped   = false;   // true if texture is mapped to specular c
 
 float     specularExponent = 20.0f;
 
+//-------------------
+// Quantized Vertex Variables
+//
+// Quantized texture coordinates are in [0, 1] and are decoded as texCoord * texCoordScaleBias.xy + texCoordScaleBias.zw
+// The scale and bias belong to the mesh rather than the material, and are set by the polygon set as it is drawn
+// Quantized positions are decoded by the world matrix
+
+float4    texCoordScaleBias = float4(1.0f, 1.0f, 0.0f, 0.0f);
+
 //-------------------
 // Texture Samplers
 
@@ -145,6 +154,13 @@ struct VS_INPUT
    float3 normal    : NORMAL;
 };
 
+struct VS_INPUT_QUANTIZED
+{
+   float4 position  : POSITION;   // Half floats
+   float2 texCoord  : TEXCOORD;   // Unsigned normalized, in [0, 1]
+   float2 normal    : NORMAL;     // Signed normalized, octahedral encoded
+};
+
 struct PS_INPUT
 {
    float4   position  : SV_POSITION;
@@ -218,6 +234,19 @@ float3 Blinn_Phong(in float3 normal, in float3 viewer, in float3 light, in float
    return colorD + colorS;
 }
 
+//--------------------------------------------------------------------------------------
+// Decodes a unit vector that was encoded as a point on an octahedron, unfolded into a square
+//
+float3 DecodeOctahedral(float2 encoded)
+{
+   float3 normal = float3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+   float  fold   = saturate(-normal.z);
+
+   normal.xy += (normal.xy >= 0.0f) ? -fold : fold;
+
+   return normalize(normal);
+}
+
 //--------------------------------------------------------------------------------------
 // Vertex Shader
 //--------------------------------------------------------------------------------------
@@ -242,6 +271,31 @@ PS_INPUT VS( VS_INPUT input )
    return output;
 }
 
+//--------------------------------------------------------------------------------------
+// Vertex Shader for quantized vertices
+//
+PS_INPUT VS_Quantized( VS_INPUT_QUANTIZED input )
+{
+   PS_INPUT output = (PS_INPUT)0;
+   
+   // Transform the incoming model-space position to projection space
+   // The world matrix includes the scale and bias that decode the position
+   matrix worldViewProjection = mul( mul(world, view), projection);
+   output.position            = mul( input.position, worldViewProjection);
+   
+   // Decode the texture coordinate
+   output.texCoord = input.texCoord * texCoordScaleBias.xy + texCoordScaleBias.zw;
+   
+   // Transform the decoded normal to world space
+   // The scale that decodes the position is in the world matrix, so the normal has to be renormalized
+   output.normal = normalize(mul(float4(DecodeOctahedral(input.normal), 0.0f), worldInverseTranspose).xyz);
+
+   // Pass the position in world space
+   output.positionW = mul(input.position, world).xyz;
+   
+   return output;
+}
+
 //--------------------------------------------------------------------------------------
 // Pixel Shader
 //--------------------------------------------------------------------------------------
@@ -290,3 +344,19 @@ technique10 RenderDefault
         SetDepthStencilState( DefaultDepthStencil, 0);
     }
 }
+
+//--------------------------------------------------------------------------------------
+// Renders vertices that were quantized (see VertexQuantizer.h)
+//
+technique10 RenderQuantized
+{
+    pass P0
+    {
+        SetVertexShader( CompileShader( vs_4_0, VS_Quantized() ) );
+        SetGeometryShader( NULL );
+        SetPixelShader( CompileShader( ps_4_0, PS() ) );
+        
+        SetBlendState( DefaultBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetDepthStencilState( DefaultDepthStencil, 0);
+    }
+}
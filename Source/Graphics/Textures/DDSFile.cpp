@@ -0,0 +1,177 @@
+
+// Project Includes
+#include "DDSFile.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <sstream>
+
+//------------------------------------------------------------------------------------------
+DDSFile::DDSFile(const std::string & filePath)
+{
+    try
+    {
+        m_file.reset(new MappedFile(filePath));
+        Parse();
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+DDSFile::DDSFile(const MappedFile::SharedPtr & file)
+    :
+    m_file(file)
+{
+    if( !m_file )
+    {
+        const std::string msg("File is NULL");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    try
+    {
+        Parse();
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void DDSFile::Parse()
+{
+    try
+    {
+        ReadDDSLayout(m_file->GetData(), m_file->GetSize(), m_file->GetFilePath(), m_layout);
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    m_subresources.resize(m_layout.m_subresources.size());
+
+    for(size_t index = 0; index < m_subresources.size(); ++index)
+    {
+        const DDSSubresource & subresource = m_layout.m_subresources[index];
+
+        m_subresources[index].pSysMem          = m_file->GetData() + subresource.m_offset;
+        m_subresources[index].SysMemPitch      = subresource.m_rowPitch;
+        m_subresources[index].SysMemSlicePitch = subresource.m_slicePitch;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const std::string & DDSFile::GetFilePath() const
+{
+    return m_file->GetFilePath();
+}
+
+//------------------------------------------------------------------------------------------
+const D3D10_RESOURCE_DIMENSION DDSFile::GetDimension() const
+{
+    return static_cast<D3D10_RESOURCE_DIMENSION>(m_layout.m_dimension);
+}
+
+//------------------------------------------------------------------------------------------
+const DXGI_FORMAT DDSFile::GetFormat() const
+{
+    return static_cast<DXGI_FORMAT>(m_layout.m_format);
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned DDSFile::GetWidth() const
+{
+    return m_layout.m_width;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned DDSFile::GetHeight() const
+{
+    return m_layout.m_height;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned DDSFile::GetDepth() const
+{
+    return m_layout.m_depth;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned DDSFile::GetNumMipLevels() const
+{
+    return m_layout.m_numMipLevels;
+}
+
+//------------------------------------------------------------------------------------------
+const bool DDSFile::HasFullMipChain() const
+{
+    return m_layout.HasFullMipChain();
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned DDSFile::GetArraySize() const
+{
+    return m_layout.m_arraySize;
+}
+
+//------------------------------------------------------------------------------------------
+const bool DDSFile::IsCubeMap() const
+{
+    return m_layout.m_isCubeMap;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned DDSFile::GetNumSubresources() const
+{
+    return static_cast<unsigned>(m_subresources.size());
+}
+
+//------------------------------------------------------------------------------------------
+const D3D10_SUBRESOURCE_DATA * DDSFile::GetSubresourceData() const
+{
+    return &m_subresources[0];
+}
+
+//------------------------------------------------------------------------------------------
+const D3D10_SUBRESOURCE_DATA & DDSFile::GetSubresource(const unsigned mipLevel, const unsigned arraySlice) const
+{
+    if( mipLevel >= m_layout.m_numMipLevels || arraySlice >= m_layout.m_arraySize )
+    {
+        std::ostringstream msg;
+        msg << "DDS file has no mip level " << mipLevel << " of array slice " << arraySlice << ": " << m_file->GetFilePath();
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    return m_subresources[static_cast<size_t>(arraySlice) * m_layout.m_numMipLevels + mipLevel];
+}
+
+//------------------------------------------------------------------------------------------
+void DDSFile::GetTexture2DDesc(D3D10_TEXTURE2D_DESC & desc) const
+{
+    if( m_layout.m_dimension != DDS_DIMENSION_TEXTURE2D )
+    {
+        std::string msg("DDS file does not hold a 2D texture: ");
+        msg += m_file->GetFilePath();
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    ZeroMemory(&desc, sizeof(D3D10_TEXTURE2D_DESC));
+    desc.Width              = m_layout.m_width;
+    desc.Height             = m_layout.m_height;
+    desc.MipLevels          = m_layout.m_numMipLevels;
+    desc.ArraySize          = m_layout.m_arraySize;
+    desc.Format             = static_cast<DXGI_FORMAT>(m_layout.m_format);
+    desc.SampleDesc.Count   = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.Usage              = D3D10_USAGE_IMMUTABLE;
+    desc.BindFlags          = D3D10_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags     = 0;
+    desc.MiscFlags          = m_layout.m_isCubeMap ? D3D10_RESOURCE_MISC_TEXTURECUBE : 0;
+}
@@ -0,0 +1,139 @@
+#ifndef DDSFILE_H
+#define DDSFILE_H
+
+// Project Includes
+#include "DDSLayout.h"
+
+// EngineX Includes
+#include "Core\MappedFile.h"
+
+// DirectX Includes
+#include <d3d10.h>
+#include <dxgi.h>
+
+// Standard Includes
+#include <memory>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+/**
+* A DirectDraw Surface (.dds) file, parsed in place
+*
+* The file is memory mapped and only its headers are read, by ReadDDSLayout. Every mip level of every array
+* slice is described by a D3D10_SUBRESOURCE_DATA that points straight into the mapped file, so creating a texture
+* from it copies the texels once, from the file's pages to the device, and nowhere else. The file stays mapped for
+* as long as this object exists.
+*
+* Nothing here uses a device.
+**/
+class DDSFile
+{
+public:
+
+   typedef std::shared_ptr<DDSFile> SharedPtr;
+
+   /**
+   * Constructor
+   *
+   * @param filePath - Path to the file to map and parse
+   *
+   * @throws BaseException - If the file cannot be mapped, is not a DDS file, is in a format that has no
+   *                         DXGI equivalent, or is too short to hold the texels its headers describe
+   **/
+   DDSFile(const std::string & filePath);
+
+   /**
+   * Constructor
+   *
+   * @param file - A file that was already mapped, such as to hash its contents. It stays mapped for as long
+   *               as this object exists.
+   *
+   * @throws BaseException - As above
+   **/
+   DDSFile(const MappedFile::SharedPtr & file);
+
+
+   /**
+   * Gets the path of the file
+   **/
+   const std::string & GetFilePath() const;
+
+   /**
+   * Gets whether the texture is 1D, 2D, or a volume
+   **/
+   const D3D10_RESOURCE_DIMENSION GetDimension() const;
+
+   const DXGI_FORMAT GetFormat() const;
+   const unsigned    GetWidth() const;
+   const unsigned    GetHeight() const;
+   const unsigned    GetDepth() const;
+
+   /**
+   * Gets the number of mip levels in each array slice
+   **/
+   const unsigned GetNumMipLevels() const;
+
+   /**
+   * Query whether or not each array slice holds every mip level, down to 1x1
+   **/
+   const bool HasFullMipChain() const;
+
+   /**
+   * Gets the number of array slices, counting each face of a cube map as one
+   **/
+   const unsigned GetArraySize() const;
+
+   /**
+   * Query whether or not the array slices are the faces of cube maps, 6 to a cube
+   **/
+   const bool IsCubeMap() const;
+
+   /**
+   * Gets the number of subresources, one for each mip level of each array slice
+   **/
+   const unsigned GetNumSubresources() const;
+
+   /**
+   * Gets the texels of every subresource, in the order D3D10 numbers them, ready to create a texture from
+   **/
+   const D3D10_SUBRESOURCE_DATA * GetSubresourceData() const;
+
+   /**
+   * Gets the texels of one subresource
+   *
+   * @throws BaseException - If the mip level or array slice is out of range
+   **/
+   const D3D10_SUBRESOURCE_DATA & GetSubresource(const unsigned mipLevel, const unsigned arraySlice) const;
+
+   /**
+   * Describes a 2D texture, that is only read by shaders, with every mip level and array slice of the file
+   *
+   * @param desc - OUT - Description to create the texture with
+   *
+   * @throws BaseException - If the file does not hold a 2D texture
+   **/
+   void GetTexture2DDesc(D3D10_TEXTURE2D_DESC & desc) const;
+
+private:
+
+   /** No Copy allowed */
+   DDSFile(const DDSFile & rhs);
+
+   /** No assignment allowed */
+   DDSFile & operator = (const DDSFile & rhs);
+
+   /**
+   * Reads the layout of the file and points a subresource at each mip level of each array slice
+   *
+   * @throws BaseException - See the constructor
+   **/
+   void Parse();
+
+
+   MappedFile::SharedPtr               m_file;           // The mapped file, which the subresources point into
+   DDSLayout                           m_layout;         // What the file holds and where
+   std::vector<D3D10_SUBRESOURCE_DATA> m_subresources;   // Each mip level of the first array slice, then of the next...
+};
+
+#endif // DDSFILE_H
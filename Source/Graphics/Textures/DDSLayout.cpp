@@ -0,0 +1,402 @@
+
+// Project Includes
+#include "DDSLayout.h"
+#include "TextureFormat.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+//------------------------------------------------------------------------------------------
+namespace
+{
+    /**
+    * Builds a FourCC code from its four characters
+    **/
+    const unsigned MakeFourCC(const char a, const char b, const char c, const char d)
+    {
+        return  static_cast<unsigned>(static_cast<unsigned char>(a))        |
+               (static_cast<unsigned>(static_cast<unsigned char>(b)) << 8)  |
+               (static_cast<unsigned>(static_cast<unsigned char>(c)) << 16) |
+               (static_cast<unsigned>(static_cast<unsigned char>(d)) << 24);
+    }
+
+    const unsigned DDS_MAGIC                = MakeFourCC('D', 'D', 'S', ' ');
+    const unsigned DDS_HEADER_SIZE          = 124;
+    const unsigned DDS_PIXELFORMAT_SIZE     = 32;
+
+    // DDS_HEADER flags
+    const unsigned DDSD_MIPMAPCOUNT         = 0x00020000;
+    const unsigned DDSD_DEPTH               = 0x00800000;
+
+    // DDS_HEADER caps2
+    const unsigned DDSCAPS2_CUBEMAP         = 0x00000200;
+    const unsigned DDSCAPS2_CUBEMAP_FACES   = 0x0000FC00;
+    const unsigned DDSCAPS2_VOLUME          = 0x00200000;
+
+    // DDS_PIXELFORMAT flags
+    const unsigned DDPF_ALPHAPIXELS         = 0x00000001;
+    const unsigned DDPF_ALPHA               = 0x00000002;
+    const unsigned DDPF_FOURCC              = 0x00000004;
+    const unsigned DDPF_RGB                 = 0x00000040;
+    const unsigned DDPF_LUMINANCE           = 0x00020000;
+    const unsigned DDPF_BUMPDUDV            = 0x00080000;
+
+    // DDS_HEADER_DXT10 misc flag
+    const unsigned DDS_RESOURCE_MISC_TEXTURECUBE = 0x00000004;
+
+    // DXGI_FORMAT values of the formats legacy headers can describe
+    const unsigned FORMAT_R32G32B32A32_FLOAT = 2;
+    const unsigned FORMAT_R16G16B16A16_FLOAT = 10;
+    const unsigned FORMAT_R16G16B16A16_UNORM = 11;
+    const unsigned FORMAT_R16G16B16A16_SNORM = 13;
+    const unsigned FORMAT_R32G32_FLOAT       = 16;
+    const unsigned FORMAT_R10G10B10A2_UNORM  = 24;
+    const unsigned FORMAT_R8G8B8A8_UNORM     = 28;
+    const unsigned FORMAT_R8G8B8A8_SNORM     = 31;
+    const unsigned FORMAT_R16G16_FLOAT       = 34;
+    const unsigned FORMAT_R16G16_UNORM       = 35;
+    const unsigned FORMAT_R16G16_SNORM       = 37;
+    const unsigned FORMAT_R32_FLOAT          = 41;
+    const unsigned FORMAT_R8G8_UNORM         = 49;
+    const unsigned FORMAT_R8G8_SNORM         = 51;
+    const unsigned FORMAT_R16_FLOAT          = 54;
+    const unsigned FORMAT_R16_UNORM          = 56;
+    const unsigned FORMAT_R8_UNORM           = 61;
+    const unsigned FORMAT_A8_UNORM           = 65;
+    const unsigned FORMAT_R8G8_B8G8_UNORM    = 68;
+    const unsigned FORMAT_G8R8_G8B8_UNORM    = 69;
+    const unsigned FORMAT_BC1_UNORM          = 71;
+    const unsigned FORMAT_BC2_UNORM          = 74;
+    const unsigned FORMAT_BC3_UNORM          = 77;
+    const unsigned FORMAT_BC4_UNORM          = 80;
+    const unsigned FORMAT_BC4_SNORM          = 81;
+    const unsigned FORMAT_BC5_UNORM          = 83;
+    const unsigned FORMAT_BC5_SNORM          = 84;
+    const unsigned FORMAT_B5G6R5_UNORM       = 85;
+    const unsigned FORMAT_B5G5R5A1_UNORM     = 86;
+    const unsigned FORMAT_B8G8R8A8_UNORM     = 87;
+    const unsigned FORMAT_B8G8R8X8_UNORM     = 88;
+
+    /**
+    * Largest number of mip levels a D3D10 texture can have, for 8192 texels across
+    **/
+    const unsigned MAX_MIP_LEVELS = 14;
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Gets the size of a mip level, from the size of the most detailed one
+    **/
+    const unsigned GetMipSize(const unsigned size, const unsigned mipLevel)
+    {
+        return std::max<unsigned>(1, size >> mipLevel);
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Reads a little endian 32 bit value and moves past it. The caller checks there is room for it.
+    **/
+    const unsigned ReadUInt32(const unsigned char * data, size_t & offset)
+    {
+        unsigned value = 0;
+        std::memcpy(&value, data + offset, sizeof(value));
+        offset += sizeof(value);
+        return value;
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Gets the DXGI format that matches the pixel format of a legacy header
+    *
+    * @throws BaseException - If there is none
+    **/
+    const unsigned GetLegacyFormat(const unsigned flags,
+                                   const unsigned fourCC,
+                                   const unsigned bitCount,
+                                   const unsigned redMask,
+                                   const unsigned greenMask,
+                                   const unsigned blueMask,
+                                   const unsigned alphaMask,
+                                   const std::string & filePath)
+    {
+        if( flags & DDPF_FOURCC )
+        {
+            // Premultiplied DXT2 and DXT4 are stored the same as DXT3 and DXT5
+            if( fourCC == MakeFourCC('D', 'X', 'T', '1') )                                              return FORMAT_BC1_UNORM;
+            if( fourCC == MakeFourCC('D', 'X', 'T', '2') || fourCC == MakeFourCC('D', 'X', 'T', '3') )  return FORMAT_BC2_UNORM;
+            if( fourCC == MakeFourCC('D', 'X', 'T', '4') || fourCC == MakeFourCC('D', 'X', 'T', '5') )  return FORMAT_BC3_UNORM;
+            if( fourCC == MakeFourCC('A', 'T', 'I', '1') || fourCC == MakeFourCC('B', 'C', '4', 'U') )  return FORMAT_BC4_UNORM;
+            if( fourCC == MakeFourCC('B', 'C', '4', 'S') )                                              return FORMAT_BC4_SNORM;
+            if( fourCC == MakeFourCC('A', 'T', 'I', '2') || fourCC == MakeFourCC('B', 'C', '5', 'U') )  return FORMAT_BC5_UNORM;
+            if( fourCC == MakeFourCC('B', 'C', '5', 'S') )                                              return FORMAT_BC5_SNORM;
+            if( fourCC == MakeFourCC('R', 'G', 'B', 'G') )                                              return FORMAT_R8G8_B8G8_UNORM;
+            if( fourCC == MakeFourCC('G', 'R', 'G', 'B') )                                              return FORMAT_G8R8_G8B8_UNORM;
+
+            // D3DFORMAT values stored in place of a FourCC
+            switch( fourCC )
+            {
+            case 36:  return FORMAT_R16G16B16A16_UNORM;   // D3DFMT_A16B16G16R16
+            case 110: return FORMAT_R16G16B16A16_SNORM;   // D3DFMT_Q16W16V16U16
+            case 111: return FORMAT_R16_FLOAT;            // D3DFMT_R16F
+            case 112: return FORMAT_R16G16_FLOAT;         // D3DFMT_G16R16F
+            case 113: return FORMAT_R16G16B16A16_FLOAT;   // D3DFMT_A16B16G16R16F
+            case 114: return FORMAT_R32_FLOAT;            // D3DFMT_R32F
+            case 115: return FORMAT_R32G32_FLOAT;         // D3DFMT_G32R32F
+            case 116: return FORMAT_R32G32B32A32_FLOAT;   // D3DFMT_A32B32G32R32F
+            default:  break;
+            }
+        }
+        else if( flags & DDPF_RGB )
+        {
+            const unsigned alpha = (flags & DDPF_ALPHAPIXELS) ? alphaMask : 0;
+
+            if( bitCount == 32 )
+            {
+                if( redMask == 0x000000FF && greenMask == 0x0000FF00 && blueMask == 0x00FF0000 && alpha == 0xFF000000 ) return FORMAT_R8G8B8A8_UNORM;
+                if( redMask == 0x00FF0000 && greenMask == 0x0000FF00 && blueMask == 0x000000FF && alpha == 0xFF000000 ) return FORMAT_B8G8R8A8_UNORM;
+                if( redMask == 0x00FF0000 && greenMask == 0x0000FF00 && blueMask == 0x000000FF && alpha == 0          ) return FORMAT_B8G8R8X8_UNORM;
+                if( redMask == 0x000003FF && greenMask == 0x000FFC00 && blueMask == 0x3FF00000 && alpha == 0xC0000000 ) return FORMAT_R10G10B10A2_UNORM;
+                if( redMask == 0x0000FFFF && greenMask == 0xFFFF0000 && blueMask == 0          && alpha == 0          ) return FORMAT_R16G16_UNORM;
+                if( redMask == 0xFFFFFFFF && greenMask == 0          && blueMask == 0          && alpha == 0          ) return FORMAT_R32_FLOAT;
+            }
+            else if( bitCount == 16 )
+            {
+                if( redMask == 0xF800 && greenMask == 0x07E0 && blueMask == 0x001F && alpha == 0      ) return FORMAT_B5G6R5_UNORM;
+                if( redMask == 0x7C00 && greenMask == 0x03E0 && blueMask == 0x001F && alpha == 0x8000 ) return FORMAT_B5G5R5A1_UNORM;
+            }
+        }
+        else if( flags & DDPF_LUMINANCE )
+        {
+            const unsigned alpha = (flags & DDPF_ALPHAPIXELS) ? alphaMask : 0;
+
+            if( bitCount == 8  && redMask == 0x00FF && alpha == 0      ) return FORMAT_R8_UNORM;
+            if( bitCount == 16 && redMask == 0xFFFF && alpha == 0      ) return FORMAT_R16_UNORM;
+            if( bitCount == 16 && redMask == 0x00FF && alpha == 0xFF00 ) return FORMAT_R8G8_UNORM;
+        }
+        else if( flags & DDPF_ALPHA )
+        {
+            if( bitCount == 8 ) return FORMAT_A8_UNORM;
+        }
+        else if( flags & DDPF_BUMPDUDV )
+        {
+            if( bitCount == 16 && redMask == 0x00FF && greenMask == 0xFF00                                                 ) return FORMAT_R8G8_SNORM;
+            if( bitCount == 32 && redMask == 0x000000FF && greenMask == 0x0000FF00 && blueMask == 0x00FF0000               ) return FORMAT_R8G8B8A8_SNORM;
+            if( bitCount == 32 && redMask == 0x0000FFFF && greenMask == 0xFFFF0000                                         ) return FORMAT_R16G16_SNORM;
+        }
+
+        std::string msg("DDS file is in a format that has no DXGI equivalent: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+DDSLayout::DDSLayout()
+    :
+    m_dimension   (DDS_DIMENSION_UNKNOWN),
+    m_format      (0),
+    m_width       (0),
+    m_height      (0),
+    m_depth       (0),
+    m_numMipLevels(0),
+    m_arraySize   (0),
+    m_isCubeMap   (false)
+{
+}
+
+//------------------------------------------------------------------------------------------
+const bool DDSLayout::HasFullMipChain() const
+{
+    const unsigned largest = std::max<unsigned>(m_width, std::max<unsigned>(m_height, m_depth));
+    return m_numMipLevels && (largest >> (m_numMipLevels - 1)) == 1;
+}
+
+//------------------------------------------------------------------------------------------
+const DDSSubresource & DDSLayout::GetSubresource(const unsigned mipLevel, const unsigned arraySlice) const
+{
+    return m_subresources[static_cast<size_t>(arraySlice) * m_numMipLevels + mipLevel];
+}
+
+//------------------------------------------------------------------------------------------
+void ReadDDSLayout(const unsigned char * data,
+                   const size_t size,
+                   const std::string & filePath,
+                   DDSLayout & layout)
+{
+    size_t offset = 0;
+
+    // Legacy header
+    if( !data || size < 4 + DDS_HEADER_SIZE || ReadUInt32(data, offset) != DDS_MAGIC || ReadUInt32(data, offset) != DDS_HEADER_SIZE )
+    {
+        std::string msg("Not a DDS file: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    const unsigned flags       = ReadUInt32(data, offset);
+    const unsigned height      = ReadUInt32(data, offset);
+    const unsigned width       = ReadUInt32(data, offset);
+    ReadUInt32(data, offset);                              // Pitch or linear size, which is worked out from the format instead
+    const unsigned depth       = ReadUInt32(data, offset);
+    const unsigned mipMapCount = ReadUInt32(data, offset);
+    offset += 11 * 4;                                      // Reserved
+
+    const unsigned pixelFormatSize = ReadUInt32(data, offset);
+    const unsigned pixelFlags      = ReadUInt32(data, offset);
+    const unsigned fourCC          = ReadUInt32(data, offset);
+    const unsigned bitCount        = ReadUInt32(data, offset);
+    const unsigned redMask         = ReadUInt32(data, offset);
+    const unsigned greenMask       = ReadUInt32(data, offset);
+    const unsigned blueMask        = ReadUInt32(data, offset);
+    const unsigned alphaMask       = ReadUInt32(data, offset);
+
+    ReadUInt32(data, offset);                              // Caps
+    const unsigned caps2 = ReadUInt32(data, offset);
+    offset += 3 * 4;                                       // Caps3, caps4, and reserved
+
+    if( pixelFormatSize != DDS_PIXELFORMAT_SIZE )
+    {
+        std::string msg("DDS file has a corrupt pixel format: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    layout = DDSLayout();
+    layout.m_width        = width;
+    layout.m_height       = std::max<unsigned>(height, 1);
+    layout.m_depth        = 1;
+    layout.m_numMipLevels = (flags & DDSD_MIPMAPCOUNT) ? std::max<unsigned>(mipMapCount, 1) : 1;
+    layout.m_arraySize    = 1;
+
+    try
+    {
+        if( (pixelFlags & DDPF_FOURCC) && fourCC == MakeFourCC('D', 'X', '1', '0') )
+        {
+            // DX10 extended header
+            if( size - offset < 5 * 4 )
+            {
+                std::string msg("DDS file is too short for its DX10 header: ");
+                msg += filePath;
+                throw Common::Exception(__FILE__, __LINE__, msg);
+            }
+
+            layout.m_format    = ReadUInt32(data, offset);
+            layout.m_dimension = static_cast<DDSDimension>(ReadUInt32(data, offset));
+
+            const unsigned miscFlag = ReadUInt32(data, offset);
+            layout.m_arraySize = ReadUInt32(data, offset);
+            ReadUInt32(data, offset);                      // Alpha mode
+
+            switch( layout.m_dimension )
+            {
+            case DDS_DIMENSION_TEXTURE1D:
+                layout.m_height = 1;
+                break;
+
+            case DDS_DIMENSION_TEXTURE2D:
+                if( miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE )
+                {
+                    layout.m_isCubeMap  = true;
+                    layout.m_arraySize *= 6;
+                }
+                break;
+
+            case DDS_DIMENSION_TEXTURE3D:
+                if( !(flags & DDSD_DEPTH) || layout.m_arraySize != 1 )
+                {
+                    std::string msg("DDS file has a volume texture without a depth, or an array of them: ");
+                    msg += filePath;
+                    throw Common::Exception(__FILE__, __LINE__, msg);
+                }
+
+                layout.m_depth = std::max<unsigned>(depth, 1);
+                break;
+
+            default:
+                std::string msg("DDS file has an unknown resource dimension: ");
+                msg += filePath;
+                throw Common::Exception(__FILE__, __LINE__, msg);
+            }
+
+            // Make sure the format can be sized, before relying on it below
+            GetBitsPerTexel(layout.m_format);
+        }
+        else
+        {
+            layout.m_format = GetLegacyFormat(pixelFlags, fourCC, bitCount, redMask, greenMask, blueMask, alphaMask, filePath);
+
+            if( (flags & DDSD_DEPTH) && (caps2 & DDSCAPS2_VOLUME) )
+            {
+                layout.m_dimension = DDS_DIMENSION_TEXTURE3D;
+                layout.m_depth     = std::max<unsigned>(depth, 1);
+            }
+            else
+            {
+                layout.m_dimension = DDS_DIMENSION_TEXTURE2D;
+
+                if( caps2 & DDSCAPS2_CUBEMAP )
+                {
+                    // D3D10 cannot leave out faces
+                    if( (caps2 & DDSCAPS2_CUBEMAP_FACES) != DDSCAPS2_CUBEMAP_FACES )
+                    {
+                        std::string msg("DDS file has a cube map without all 6 faces: ");
+                        msg += filePath;
+                        throw Common::Exception(__FILE__, __LINE__, msg);
+                    }
+
+                    layout.m_isCubeMap = true;
+                    layout.m_arraySize = 6;
+                }
+            }
+        }
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
+
+    if( layout.m_width == 0 || layout.m_arraySize == 0 || layout.m_numMipLevels > MAX_MIP_LEVELS ||
+        (layout.m_numMipLevels > 1 &&
+         std::max<unsigned>(layout.m_width, std::max<unsigned>(layout.m_height, layout.m_depth)) >> (layout.m_numMipLevels - 1) == 0) )
+    {
+        std::string msg("DDS file has an invalid size or number of mip levels: ");
+        msg += filePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Each array slice holds its mip levels, most detailed first, each one the depth slices of its rows
+    layout.m_subresources.resize(static_cast<size_t>(layout.m_arraySize) * layout.m_numMipLevels);
+
+    for(unsigned slice = 0; slice < layout.m_arraySize; ++slice)
+    {
+        for(unsigned level = 0; level < layout.m_numMipLevels; ++level)
+        {
+            unsigned rowPitch = 0;
+            unsigned numRows  = 0;
+
+            GetSurfaceLayout(layout.m_format, GetMipSize(layout.m_width, level), GetMipSize(layout.m_height, level), rowPitch, numRows);
+
+            const size_t slicePitch      = static_cast<size_t>(rowPitch) * numRows;
+            const size_t subresourceSize = slicePitch * GetMipSize(layout.m_depth, level);
+
+            if( size - offset < subresourceSize )
+            {
+                std::ostringstream msg;
+                msg << "DDS file is too short to hold mip level " << level << " of array slice " << slice << ": " << filePath;
+                throw Common::Exception(__FILE__, __LINE__, msg.str());
+            }
+
+            DDSSubresource & subresource = layout.m_subresources[static_cast<size_t>(slice) * layout.m_numMipLevels + level];
+            subresource.m_offset     = offset;
+            subresource.m_size       = subresourceSize;
+            subresource.m_rowPitch   = rowPitch;
+            subresource.m_slicePitch = static_cast<unsigned>(slicePitch);
+
+            offset += subresourceSize;
+        }
+    }
+}
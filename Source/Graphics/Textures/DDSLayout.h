@@ -0,0 +1,98 @@
+#ifndef DDSLAYOUT_H
+#define DDSLAYOUT_H
+
+// Standard Includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+// Where everything lies within a DirectDraw Surface (.dds) file
+//
+// Only the headers are read. The layout says what the texture is and, for every mip level of every array slice,
+// where its texels start in the file and how they are pitched. Nothing here needs the DirectX headers: formats
+// are DXGI_FORMAT values and dimensions are D3D10_RESOURCE_DIMENSION values, so files can be checked by tools on
+// any platform. DDSFile turns a layout into what D3D10 creates textures from.
+//
+
+/**
+* Kinds of texture a file can hold, the same values as D3D10_RESOURCE_DIMENSION
+**/
+enum DDSDimension
+{
+   DDS_DIMENSION_UNKNOWN   = 0,
+   DDS_DIMENSION_TEXTURE1D = 2,
+   DDS_DIMENSION_TEXTURE2D = 3,
+   DDS_DIMENSION_TEXTURE3D = 4
+};
+
+/**
+* Where one mip level of one array slice lies in the file
+**/
+struct DDSSubresource
+{
+   size_t   m_offset;       // Bytes from the start of the file to the first texel
+   size_t   m_size;         // Bytes taken up by all of its depth slices
+   unsigned m_rowPitch;     // Bytes from one row, or row of blocks, to the next
+   unsigned m_slicePitch;   // Bytes from one depth slice to the next
+};
+
+/**
+* What a file holds and where
+**/
+struct DDSLayout
+{
+   /**
+   * Constructor
+   *
+   * By default, the layout describes nothing
+   **/
+   DDSLayout();
+
+   /**
+   * Query whether or not each array slice holds every mip level, down to 1x1
+   **/
+   const bool HasFullMipChain() const;
+
+   /**
+   * Gets where a mip level of an array slice lies
+   *
+   * NOTE - The mip level and array slice must be in range
+   **/
+   const DDSSubresource & GetSubresource(const unsigned mipLevel, const unsigned arraySlice) const;
+
+
+   DDSDimension                m_dimension;
+   unsigned                    m_format;         // DXGI_FORMAT value
+   unsigned                    m_width;
+   unsigned                    m_height;
+   unsigned                    m_depth;          // 1 unless it is a volume texture
+   unsigned                    m_numMipLevels;   // In each array slice
+   unsigned                    m_arraySize;      // Including each face of a cube map
+   bool                        m_isCubeMap;
+   std::vector<DDSSubresource> m_subresources;   // Each mip level of the first array slice, then of the next...
+};
+
+/**
+* Reads the headers of a DDS file and works out where each subresource lies
+*
+* Both the legacy header and the DX10 extended header are understood. Legacy files are mapped to the matching
+* DXGI format from their FourCC code or their bit masks: DXT1 through DXT5, ATI1/ATI2 (BC4 and BC5), the float
+* and 16 bit per channel D3DFMT codes, and the common 8, 16, and 32 bit layouts. DX10 headers can hold any DXGI
+* format, including BC6H and BC7. 1D, 2D, and volume textures, arrays, and cube maps are all described, in the
+* order of D3D10 subresources: each array slice, or face of a cube, in turn, with all of its mip levels.
+*
+* @param data     - Contents of the file
+* @param size     - Size of the file in bytes
+* @param filePath - Path of the file, for error messages
+* @param layout   - OUT - What the file holds and where
+*
+* @throws BaseException - If the data is not a DDS file, is in a format that has no DXGI equivalent,
+*                         or is too short to hold the texels its headers describe
+**/
+void ReadDDSLayout(const unsigned char * data,
+                   const size_t size,
+                   const std::string & filePath,
+                   DDSLayout & layout);
+
+#endif // DDSLAYOUT_H
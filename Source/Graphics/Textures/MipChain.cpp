@@ -0,0 +1,332 @@
+// Project Includes
+#include "MipChain.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+
+//------------------------------------------------------------------------------------------
+namespace
+{
+    const unsigned BYTES_PER_TEXEL = 4;
+
+    /**
+    * Number of steps linear colors are quantized to when they are converted back to 8 bits
+    *
+    * Fine enough that every 8 bit sRGB value survives being converted to linear and back unchanged.
+    **/
+    const unsigned NUM_LINEAR_STEPS = 4096;
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Lookup tables for converting 8 bit colors to and from linear floats
+    **/
+    struct ConversionTables
+    {
+        float         m_toLinear[256];                   // 8 bit color to linear
+        float         m_toUnit[256];                     // 8 bit alpha to 0 through 1
+        unsigned char m_fromLinear[NUM_LINEAR_STEPS];    // Quantized linear color to 8 bits
+    };
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Fills in the tables, for sRGB or for colors that are already linear
+    **/
+    void BuildConversionTables(ConversionTables & tables, const bool sRGB)
+    {
+        for(unsigned value = 0; value < 256; ++value)
+        {
+            const float unit = static_cast<float>(value) / 255.0f;
+
+            tables.m_toUnit[value]   = unit;
+            tables.m_toLinear[value] = !sRGB           ? unit :
+                                       unit <= 0.04045f ? unit / 12.92f :
+                                                          std::pow((unit + 0.055f) / 1.055f, 2.4f);
+        }
+
+        for(unsigned step = 0; step < NUM_LINEAR_STEPS; ++step)
+        {
+            const float linear  = static_cast<float>(step) / static_cast<float>(NUM_LINEAR_STEPS - 1);
+            const float encoded = !sRGB                ? linear :
+                                  linear <= 0.0031308f ? linear * 12.92f :
+                                                         1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+
+            tables.m_fromLinear[step] = static_cast<unsigned char>(std::min<float>(encoded * 255.0f + 0.5f, 255.0f));
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Gets the tables, built the first time they are asked for
+    **/
+    const ConversionTables & GetConversionTables(const bool sRGB)
+    {
+        struct Tables
+        {
+            Tables()
+            {
+                BuildConversionTables(m_sRGB, true);
+                BuildConversionTables(m_linear, false);
+            }
+
+            ConversionTables m_sRGB;
+            ConversionTables m_linear;
+        };
+
+        // Built once, even if worker threads ask for them at the same time
+        static const Tables tables;
+
+        return sRGB ? tables.m_sRGB : tables.m_linear;
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Converts one texel to linear color and alpha, with straight alpha
+    **/
+    template<bool premultiplied>
+    inline __m128 DecodeTexel(const unsigned char * texel, const ConversionTables & tables)
+    {
+        const unsigned alpha = texel[3];
+
+        // Premultiplied colors are divided by alpha first, since sRGB encoding does not distribute over multiplication
+        if( premultiplied && alpha > 0 && alpha < 255 )
+        {
+            unsigned color[3];
+
+            for(unsigned channel = 0; channel < 3; ++channel)
+            {
+                color[channel] = std::min<unsigned>((texel[channel] * 255 + alpha / 2) / alpha, 255);
+            }
+
+            return _mm_setr_ps(tables.m_toLinear[color[0]],
+                               tables.m_toLinear[color[1]],
+                               tables.m_toLinear[color[2]],
+                               tables.m_toUnit[alpha]);
+        }
+
+        return _mm_setr_ps(tables.m_toLinear[texel[0]],
+                           tables.m_toLinear[texel[1]],
+                           tables.m_toLinear[texel[2]],
+                           tables.m_toUnit[alpha]);
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Converts linear color and alpha, with straight alpha, back to one texel
+    **/
+    template<bool premultiplied>
+    inline void EncodeTexel(const __m128 value, unsigned char * texel, const ConversionTables & tables)
+    {
+        // Scale the colors to the linear steps and alpha to 8 bits, rounding to nearest
+        const __m128 scale   = _mm_setr_ps(static_cast<float>(NUM_LINEAR_STEPS - 1),
+                                           static_cast<float>(NUM_LINEAR_STEPS - 1),
+                                           static_cast<float>(NUM_LINEAR_STEPS - 1),
+                                           255.0f);
+        const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+        unsigned steps[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(steps), _mm_cvtps_epi32(_mm_mul_ps(clamped, scale)));
+
+        const unsigned alpha = steps[3];
+
+        for(unsigned channel = 0; channel < 3; ++channel)
+        {
+            const unsigned color = tables.m_fromLinear[steps[channel]];
+
+            texel[channel] = static_cast<unsigned char>(premultiplied ? (color * alpha + 127) / 255 : color);
+        }
+
+        texel[3] = static_cast<unsigned char>(alpha);
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Generates one mip level from the one above it, with a 2x2 box filter
+    *
+    * A level with an odd width or height repeats its last column or row of texels.
+    **/
+    template<bool premultiplied>
+    void Downsample(const unsigned char * source,
+                    const unsigned sourceWidth,
+                    const unsigned sourceHeight,
+                    unsigned char * destination,
+                    const unsigned destinationWidth,
+                    const unsigned destinationHeight,
+                    const ConversionTables & tables)
+    {
+        // Weights of (alpha, alpha, alpha, 1), so that colors are weighted by alpha and alpha is summed as it is
+        const __m128 colorMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+        const __m128 alphaOne  = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+        const __m128 quarter   = _mm_set1_ps(0.25f);
+
+        const unsigned sourcePitch = sourceWidth * BYTES_PER_TEXEL;
+
+        for(unsigned y = 0; y < destinationHeight; ++y)
+        {
+            const unsigned char * rows[2] = {source + (2 * y) * sourcePitch,
+                                             source + std::min<unsigned>(2 * y + 1, sourceHeight - 1) * sourcePitch};
+
+            unsigned char * texel = destination + y * destinationWidth * BYTES_PER_TEXEL;
+
+            for(unsigned x = 0; x < destinationWidth; ++x, texel += BYTES_PER_TEXEL)
+            {
+                const unsigned columns[2] = {(2 * x) * BYTES_PER_TEXEL,
+                                             std::min<unsigned>(2 * x + 1, sourceWidth - 1) * BYTES_PER_TEXEL};
+
+                __m128 sum         = _mm_setzero_ps();
+                __m128 weightedSum = _mm_setzero_ps();
+
+                for(unsigned row = 0; row < 2; ++row)
+                {
+                    for(unsigned column = 0; column < 2; ++column)
+                    {
+                        const __m128 value   = DecodeTexel<premultiplied>(rows[row] + columns[column], tables);
+                        const __m128 alpha   = _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+                        const __m128 weights = _mm_or_ps(_mm_and_ps(alpha, colorMask), alphaOne);
+
+                        sum         = _mm_add_ps(sum, value);
+                        weightedSum = _mm_add_ps(weightedSum, _mm_mul_ps(value, weights));
+                    }
+                }
+
+                // Colors weighted by alpha, unless all four texels are transparent, then alpha averaged
+                const __m128 totalAlpha = _mm_shuffle_ps(weightedSum, weightedSum, _MM_SHUFFLE(3, 3, 3, 3));
+                __m128       color;
+
+                if( _mm_cvtss_f32(totalAlpha) > 0.0f )
+                {
+                    color = _mm_div_ps(weightedSum, totalAlpha);
+                }
+                else
+                {
+                    color = _mm_mul_ps(sum, quarter);
+                }
+
+                const __m128 average = _mm_or_ps(_mm_and_ps(color, colorMask),
+                                                 _mm_andnot_ps(colorMask, _mm_mul_ps(totalAlpha, quarter)));
+
+                EncodeTexel<premultiplied>(average, texel, tables);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+MipChain::MipChain(const unsigned char * texels,
+                   const unsigned width,
+                   const unsigned height,
+                   const unsigned rowPitch,
+                   const bool sRGB,
+                   const AlphaMode alphaMode)
+    :
+    m_width(width),
+    m_height(height),
+    m_numMipLevels(1)
+{
+    if( !texels || !width || !height )
+    {
+        const std::string msg("Cannot generate mip levels for an empty image");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Work out where each level lies, all the way down to 1x1
+    std::vector<size_t> offsets(1, 0);
+    size_t              numBytes = width * height * BYTES_PER_TEXEL;
+
+    for(unsigned levelWidth = width, levelHeight = height; levelWidth > 1 || levelHeight > 1; ++m_numMipLevels)
+    {
+        levelWidth  = std::max<unsigned>(levelWidth  / 2, 1);
+        levelHeight = std::max<unsigned>(levelHeight / 2, 1);
+
+        offsets.push_back(numBytes);
+        numBytes += levelWidth * levelHeight * BYTES_PER_TEXEL;
+    }
+
+    m_texels.resize(numBytes);
+
+    // The most detailed level is copied as it is
+    const unsigned rowSize = width * BYTES_PER_TEXEL;
+
+    for(unsigned row = 0; row < height; ++row)
+    {
+        std::memcpy(&m_texels[row * rowSize], texels + row * rowPitch, rowSize);
+    }
+
+    // Each of the others is filtered from the one above it
+    const ConversionTables & tables = GetConversionTables(sRGB);
+
+    m_subresources.resize(m_numMipLevels);
+
+    for(unsigned mipLevel = 0; mipLevel < m_numMipLevels; ++mipLevel)
+    {
+        const unsigned levelWidth  = std::max<unsigned>(width  >> mipLevel, 1);
+        const unsigned levelHeight = std::max<unsigned>(height >> mipLevel, 1);
+
+        if( mipLevel > 0 )
+        {
+            const unsigned char * source       = &m_texels[offsets[mipLevel - 1]];
+            const unsigned        sourceWidth  = std::max<unsigned>(width  >> (mipLevel - 1), 1);
+            const unsigned        sourceHeight = std::max<unsigned>(height >> (mipLevel - 1), 1);
+            unsigned char *       destination  = &m_texels[offsets[mipLevel]];
+
+            if( alphaMode == ALPHA_PREMULTIPLIED )
+            {
+                Downsample<true>(source, sourceWidth, sourceHeight, destination, levelWidth, levelHeight, tables);
+            }
+            else
+            {
+                Downsample<false>(source, sourceWidth, sourceHeight, destination, levelWidth, levelHeight, tables);
+            }
+        }
+
+        m_subresources[mipLevel].pSysMem          = &m_texels[offsets[mipLevel]];
+        m_subresources[mipLevel].SysMemPitch      = levelWidth * BYTES_PER_TEXEL;
+        m_subresources[mipLevel].SysMemSlicePitch = levelWidth * levelHeight * BYTES_PER_TEXEL;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned MipChain::GetWidth() const
+{
+    return m_width;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned MipChain::GetHeight() const
+{
+    return m_height;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned MipChain::GetNumMipLevels() const
+{
+    return m_numMipLevels;
+}
+
+//------------------------------------------------------------------------------------------
+const D3D10_SUBRESOURCE_DATA * MipChain::GetSubresourceData() const
+{
+    return &m_subresources[0];
+}
+
+//------------------------------------------------------------------------------------------
+void MipChain::GetTexture2DDesc(D3D10_TEXTURE2D_DESC & desc) const
+{
+    ZeroMemory(&desc, sizeof(D3D10_TEXTURE2D_DESC));
+    desc.Width              = m_width;
+    desc.Height             = m_height;
+    desc.MipLevels          = m_numMipLevels;
+    desc.ArraySize          = 1;
+    desc.Format             = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count   = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.Usage              = D3D10_USAGE_IMMUTABLE;
+    desc.BindFlags          = D3D10_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags     = 0;
+    desc.MiscFlags          = 0;
+}
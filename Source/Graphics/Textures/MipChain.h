@@ -0,0 +1,97 @@
+#ifndef MIPCHAIN_H
+#define MIPCHAIN_H
+
+// DirectX Includes
+#include <d3d10.h>
+#include <dxgi.h>
+
+// Standard Includes
+#include <memory>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+/**
+* An image, with every mip level down to 1x1 generated from it on the CPU, ready to create a texture from
+*
+* Images that come without mip levels, such as PNG and JPG files, get them from here instead of from D3DX10.
+* Each level is a 2x2 box filter of the one above it, done with SSE2 in linear space: 8 bit sRGB colors are
+* converted to linear, averaged, and converted back, so that minified images keep their brightness. Colors are
+* weighted by their alpha while they are averaged, so that the colors of transparent texels, which are often
+* black, do not bleed into the edges of sprites.
+*
+* Texels are 32 bit RGBA, stored as DXGI_FORMAT_R8G8B8A8_UNORM, the format D3DX10 loads these files in.
+*
+* Nothing here uses a device, so mip levels can be generated on worker threads or by tools.
+**/
+class MipChain
+{
+public:
+
+   typedef std::shared_ptr<MipChain> SharedPtr;
+
+   /**
+   * How the colors of an image relate to its alpha
+   **/
+   enum AlphaMode
+   {
+      ALPHA_STRAIGHT = 0,    // Colors are independent of alpha, as PNG files store them
+      ALPHA_PREMULTIPLIED,   // Colors have been multiplied by alpha. Generated levels are premultiplied too.
+   };
+
+   /**
+   * Constructor
+   *
+   * @param texels    - The most detailed mip level, 32 bit RGBA texels, a row after another
+   * @param width     - Width of the image, in texels
+   * @param height    - Height of the image, in texels
+   * @param rowPitch  - Number of bytes from the start of one row to the start of the next
+   * @param sRGB      - Whether or not colors are sRGB encoded, as the colors of 8 bit images nearly always are.
+   *                    If not, they are averaged as they are.
+   * @param alphaMode - How the colors relate to alpha
+   *
+   * @throws BaseException - If the image is empty
+   **/
+   MipChain(const unsigned char * texels,
+            const unsigned width,
+            const unsigned height,
+            const unsigned rowPitch,
+            const bool sRGB = true,
+            const AlphaMode alphaMode = ALPHA_STRAIGHT);
+
+   const unsigned GetWidth() const;
+   const unsigned GetHeight() const;
+
+   /**
+   * Gets the number of mip levels, including the most detailed one
+   **/
+   const unsigned GetNumMipLevels() const;
+
+   /**
+   * Gets the texels of every mip level, from the most detailed, ready to create a texture from
+   **/
+   const D3D10_SUBRESOURCE_DATA * GetSubresourceData() const;
+
+   /**
+   * Describes a 2D texture, that is only read by shaders, with every mip level
+   *
+   * @param desc - OUT - Description to create the texture with
+   **/
+   void GetTexture2DDesc(D3D10_TEXTURE2D_DESC & desc) const;
+
+private:
+
+   /** No Copy allowed */
+   MipChain(const MipChain & rhs);
+
+   /** No assignment allowed */
+   MipChain & operator = (const MipChain & rhs);
+
+
+   unsigned                            m_width;
+   unsigned                            m_height;
+   unsigned                            m_numMipLevels;
+   std::vector<unsigned char>          m_texels;         // Every mip level, one after another, with no gaps between rows
+   std::vector<D3D10_SUBRESOURCE_DATA> m_subresources;   // Where each mip level lies in m_texels
+};
+
+#endif // MIPCHAIN_H
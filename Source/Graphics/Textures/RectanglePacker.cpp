@@ -0,0 +1,341 @@
+// Project Includes
+#include "RectanglePacker.h"
+
+// Standard Includes
+#include <algorithm>
+#include <limits>
+
+//------------------------------------------------------------------------------------------
+namespace
+{
+    /**
+    * Gets the smallest power of two that is not less than a value
+    **/
+    const unsigned NextPowerOfTwo(const unsigned value)
+    {
+        unsigned powerOfTwo = 1;
+
+        while( powerOfTwo < value )
+        {
+            powerOfTwo <<= 1;
+        }
+
+        return powerOfTwo;
+    }
+
+    /**
+    * Query whether or not one rectangle lies entirely within another
+    **/
+    const bool Contains(const RectanglePacker::Rect & outer, const RectanglePacker::Rect & inner)
+    {
+        return inner.m_x >= outer.m_x &&
+               inner.m_y >= outer.m_y &&
+               inner.m_x + inner.m_width  <= outer.m_x + outer.m_width &&
+               inner.m_y + inner.m_height <= outer.m_y + outer.m_height;
+    }
+
+    /**
+    * Orders rectangles, by their index, from the longest side to the shortest, then from the largest area
+    **/
+    class LongerSideFirst
+    {
+    public:
+
+        LongerSideFirst(const std::vector<RectanglePacker::Rect> & rects)
+            :
+            m_rects(rects)
+        {
+        }
+
+        bool operator()(const unsigned lhs, const unsigned rhs) const
+        {
+            const RectanglePacker::Rect & a = m_rects[lhs];
+            const RectanglePacker::Rect & b = m_rects[rhs];
+
+            const unsigned aLongSide = std::max<unsigned>(a.m_width, a.m_height);
+            const unsigned bLongSide = std::max<unsigned>(b.m_width, b.m_height);
+
+            if( aLongSide != bLongSide )
+            {
+                return aLongSide > bLongSide;
+            }
+
+            return a.m_width * a.m_height > b.m_width * b.m_height;
+        }
+
+    private:
+
+        const std::vector<RectanglePacker::Rect> & m_rects;
+    };
+}
+
+//------------------------------------------------------------------------------------------
+RectanglePacker::Rect::Rect()
+    :
+    m_x(0),
+    m_y(0),
+    m_width(0),
+    m_height(0)
+{
+}
+
+//------------------------------------------------------------------------------------------
+RectanglePacker::Rect::Rect(const unsigned x, const unsigned y, const unsigned width, const unsigned height)
+    :
+    m_x(x),
+    m_y(y),
+    m_width(width),
+    m_height(height)
+{
+}
+
+//------------------------------------------------------------------------------------------
+RectanglePacker::RectanglePacker(const unsigned width, const unsigned height)
+    :
+    m_width(width),
+    m_height(height),
+    m_usedArea(0)
+{
+    m_freeRects.push_back(Rect(0, 0, width, height));
+}
+
+//------------------------------------------------------------------------------------------
+const bool RectanglePacker::Insert(const unsigned width, const unsigned height, Rect & placed)
+{
+    // Find the free rectangle that leaves the least room along the shorter side, then along the longer side
+    unsigned bestShortSide = std::numeric_limits<unsigned>::max();
+    unsigned bestLongSide  = std::numeric_limits<unsigned>::max();
+    bool     found         = false;
+
+    for(std::vector<Rect>::const_iterator it = m_freeRects.begin(); it != m_freeRects.end(); ++it)
+    {
+        if( it->m_width < width || it->m_height < height )
+        {
+            continue;
+        }
+
+        const unsigned leftoverWidth  = it->m_width  - width;
+        const unsigned leftoverHeight = it->m_height - height;
+        const unsigned shortSide      = std::min<unsigned>(leftoverWidth, leftoverHeight);
+        const unsigned longSide       = std::max<unsigned>(leftoverWidth, leftoverHeight);
+
+        if( shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide) )
+        {
+            placed        = Rect(it->m_x, it->m_y, width, height);
+            bestShortSide = shortSide;
+            bestLongSide  = longSide;
+            found         = true;
+        }
+    }
+
+    if( !found )
+    {
+        return false;
+    }
+
+    // Carve the placed rectangle out of every free rectangle it overlaps
+    // Split rectangles are appended, so only the ones that were there before are visited
+    size_t numFreeRects = m_freeRects.size();
+
+    for(size_t index = 0; index < numFreeRects; )
+    {
+        if( SplitFreeRect(m_freeRects[index], placed) )
+        {
+            m_freeRects.erase(m_freeRects.begin() + index);
+            --numFreeRects;
+        }
+        else
+        {
+            ++index;
+        }
+    }
+
+    PruneFreeRects();
+
+    m_usedArea += width * height;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+const float RectanglePacker::GetOccupancy() const
+{
+    if( !m_width || !m_height )
+    {
+        return 0.0f;
+    }
+
+    return static_cast<float>(m_usedArea) / (static_cast<float>(m_width) * static_cast<float>(m_height));
+}
+
+//------------------------------------------------------------------------------------------
+const bool RectanglePacker::Pack(std::vector<Rect> & rects, const unsigned maxSize, unsigned & width, unsigned & height)
+{
+    // Start with the smallest bin that could hold the largest rectangle and the total area
+    unsigned maxWidth  = 1;
+    unsigned maxHeight = 1;
+    unsigned totalArea = 0;
+
+    for(std::vector<Rect>::const_iterator it = rects.begin(); it != rects.end(); ++it)
+    {
+        maxWidth   = std::max<unsigned>(maxWidth,  it->m_width);
+        maxHeight  = std::max<unsigned>(maxHeight, it->m_height);
+        totalArea += it->m_width * it->m_height;
+    }
+
+    if( maxWidth > maxSize || maxHeight > maxSize )
+    {
+        return false;
+    }
+
+    width  = NextPowerOfTwo(maxWidth);
+    height = NextPowerOfTwo(maxHeight);
+
+    while( width * height < totalArea )
+    {
+        if( width <= height && width < maxSize )
+        {
+            width <<= 1;
+        }
+        else if( height < maxSize )
+        {
+            height <<= 1;
+        }
+        else if( width < maxSize )
+        {
+            width <<= 1;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    std::vector<unsigned> order(rects.size());
+    for(unsigned index = 0; index < order.size(); ++index)
+    {
+        order[index] = index;
+    }
+
+    std::stable_sort(order.begin(), order.end(), LongerSideFirst(rects));
+
+    // Grow the bin, the shorter side first, until everything fits
+    for(;;)
+    {
+        RectanglePacker packer(width, height);
+        bool            packedAll = true;
+
+        for(std::vector<unsigned>::const_iterator it = order.begin(); it != order.end(); ++it)
+        {
+            Rect & rect = rects[*it];
+
+            if( !rect.m_width || !rect.m_height )
+            {
+                rect.m_x = 0;
+                rect.m_y = 0;
+                continue;
+            }
+
+            if( !packer.Insert(rect.m_width, rect.m_height, rect) )
+            {
+                packedAll = false;
+                break;
+            }
+        }
+
+        if( packedAll )
+        {
+            return true;
+        }
+
+        if( width <= height && width < maxSize )
+        {
+            width <<= 1;
+        }
+        else if( height < maxSize )
+        {
+            height <<= 1;
+        }
+        else if( width < maxSize )
+        {
+            width <<= 1;
+        }
+        else
+        {
+            return false;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const bool RectanglePacker::SplitFreeRect(const Rect & freeRect, const Rect & placed)
+{
+    // Copied, because adding the split rectangles may move the one referenced
+    const Rect free = freeRect;
+
+    if( placed.m_x >= free.m_x + free.m_width  || placed.m_x + placed.m_width  <= free.m_x ||
+        placed.m_y >= free.m_y + free.m_height || placed.m_y + placed.m_height <= free.m_y )
+    {
+        return false;
+    }
+
+    // Space above and below the placed rectangle
+    if( placed.m_y > free.m_y )
+    {
+        m_freeRects.push_back(Rect(free.m_x, free.m_y, free.m_width, placed.m_y - free.m_y));
+    }
+
+    if( placed.m_y + placed.m_height < free.m_y + free.m_height )
+    {
+        m_freeRects.push_back(Rect(free.m_x,
+                                   placed.m_y + placed.m_height,
+                                   free.m_width,
+                                   free.m_y + free.m_height - (placed.m_y + placed.m_height)));
+    }
+
+    // Space to the left and to the right of it
+    if( placed.m_x > free.m_x )
+    {
+        m_freeRects.push_back(Rect(free.m_x, free.m_y, placed.m_x - free.m_x, free.m_height));
+    }
+
+    if( placed.m_x + placed.m_width < free.m_x + free.m_width )
+    {
+        m_freeRects.push_back(Rect(placed.m_x + placed.m_width,
+                                   free.m_y,
+                                   free.m_x + free.m_width - (placed.m_x + placed.m_width),
+                                   free.m_height));
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------
+void RectanglePacker::PruneFreeRects()
+{
+    // Of two identical rectangles, only the first is kept
+    std::vector<bool> contained(m_freeRects.size(), false);
+
+    for(size_t i = 0; i < m_freeRects.size(); ++i)
+    {
+        for(size_t j = 0; j < m_freeRects.size() && !contained[i]; ++j)
+        {
+            if( i != j && !contained[j] && Contains(m_freeRects[j], m_freeRects[i]) )
+            {
+                contained[i] = true;
+            }
+        }
+    }
+
+    std::vector<Rect> freeRects;
+    freeRects.reserve(m_freeRects.size());
+
+    for(size_t index = 0; index < m_freeRects.size(); ++index)
+    {
+        if( !contained[index] )
+        {
+            freeRects.push_back(m_freeRects[index]);
+        }
+    }
+
+    m_freeRects.swap(freeRects);
+}
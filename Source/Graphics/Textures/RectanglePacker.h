@@ -0,0 +1,90 @@
+#ifndef RECTANGLEPACKER_H
+#define RECTANGLEPACKER_H
+
+// Standard Includes
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+/**
+* Packs rectangles into a bin without overlapping, such as the images of a texture atlas
+*
+* Uses the MaxRects algorithm: every maximal rectangle of free space in the bin is kept, overlapping one
+* another, and each rectangle is placed in the free one that it fits most snugly along its shorter leftover
+* side. Rectangles are never rotated, so that the texels of an image keep their orientation.
+*
+* Nothing here uses a device, so tools can pack as well as the engine.
+**/
+class RectanglePacker
+{
+public:
+
+   struct Rect
+   {
+      Rect();
+      Rect(const unsigned x, const unsigned y, const unsigned width, const unsigned height);
+
+      unsigned m_x;
+      unsigned m_y;
+      unsigned m_width;
+      unsigned m_height;
+   };
+
+   /**
+   * Constructor
+   *
+   * @param width  - Width of the bin
+   * @param height - Height of the bin
+   **/
+   RectanglePacker(const unsigned width, const unsigned height);
+
+   /**
+   * Places one rectangle in the free space that is left
+   *
+   * @param width  - Width of the rectangle
+   * @param height - Height of the rectangle
+   * @param placed - OUT - Where the rectangle was placed, if it fit
+   * @return bool  - Whether or not the rectangle fit
+   **/
+   const bool Insert(const unsigned width, const unsigned height, Rect & placed);
+
+   /**
+   * Gets the fraction of the bin that is covered by the rectangles placed so far
+   **/
+   const float GetOccupancy() const;
+
+   /**
+   * Packs many rectangles at once, into the smallest bin with power of two sides that holds them all
+   *
+   * Rectangles are placed from the longest side to the shortest, which packs far tighter than placing them
+   * in the order they are given.
+   *
+   * @param rects   - IN/OUT - The width and height of each rectangle in. Where each was placed out.
+   * @param maxSize - Longest side the bin may have
+   * @param width   - OUT - Width of the bin
+   * @param height  - OUT - Height of the bin
+   * @return bool   - Whether or not the rectangles fit into a bin of maxSize by maxSize
+   **/
+   static const bool Pack(std::vector<Rect> & rects, const unsigned maxSize, unsigned & width, unsigned & height);
+
+private:
+
+   /**
+   * Splits a free rectangle around a placed one, adding whatever free space is left of it around the placed one
+   *
+   * @return bool - Whether or not they overlapped, in which case the free rectangle is no longer free
+   **/
+   const bool SplitFreeRect(const Rect & freeRect, const Rect & placed);
+
+   /**
+   * Removes the free rectangles that lie within another
+   **/
+   void PruneFreeRects();
+
+
+   unsigned          m_width;
+   unsigned          m_height;
+   unsigned          m_usedArea;    // Sum of the areas of the placed rectangles
+   std::vector<Rect> m_freeRects;   // Every maximal rectangle of free space
+};
+
+#endif // RECTANGLEPACKER_H
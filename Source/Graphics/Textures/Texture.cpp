@@ -2,20 +2,151 @@
 
 // Project Includes
 #include "Texture.h"
+#include "TextureFormat.h"
+
+// EngineX Includes
+#include "Core\MappedFile.h"
 
 // Common Lib Includes
 #include "Exception.h"
 
+// Windows Includes
+#include <wincodec.h>
+
+// Standard Includes
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <memory>
+
 //------------------------------------------------------------------------------------------
-Texture::Texture(ID3D10Device & device, const std::string & filePath, DXGI_FORMAT format)
+namespace
+{
+    /**
+    * Query whether or not a file is a DDS file, by its extension
+    **/
+    const bool IsDDSFile(const std::string & filePath)
+    {
+        if( filePath.size() < 4 )
+        {
+            return false;
+        }
+
+        std::string extension = filePath.substr(filePath.size() - 4);
+
+        for(std::string::iterator it = extension.begin(); it != extension.end(); ++it)
+        {
+            *it = static_cast<char>(tolower(static_cast<unsigned char>(*it)));
+        }
+
+        return extension == ".dds";
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Largest size, across, of the most detailed mip level a streamed texture keeps resident when it is not used
+    *
+    * Streamed textures are created with only these mip levels, so that they can be drawn right away, blurry,
+    * without a spike in load time or video memory.
+    **/
+    const unsigned MIN_STREAMED_SIZE = 64;
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Releases a COM object, if there is one
+    **/
+    template<typename T>
+    void Release(T * object)
+    {
+        if( object )
+        {
+            object->Release();
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Gets the most detailed mip level, no more detailed than the one asked for, that a texture can be created with
+    *
+    * Block compressed textures must be a whole number of blocks across.
+    **/
+    const unsigned GetNearestMipLevel(const DXGI_FORMAT format,
+                                      const unsigned width,
+                                      const unsigned height,
+                                      const unsigned numMipLevels,
+                                      const unsigned mipLevel)
+    {
+        unsigned nearest = std::min<unsigned>(mipLevel, numMipLevels - 1);
+
+        if( IsBlockCompressed(format) )
+        {
+            while( nearest > 0 && (((width >> nearest) % 4) != 0 || ((height >> nearest) % 4) != 0) )
+            {
+                --nearest;
+            }
+        }
+
+        return nearest;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+Texture::Texture(ID3D10Device & device, const std::string & filePath, DXGI_FORMAT format, const bool streamed)
     :
     m_device(device),
     m_texture(0),
     m_hasAlpha(false),
     m_width(0),
-    m_height(0)
+    m_height(0),
+    m_format(DXGI_FORMAT_UNKNOWN),
+    m_numMipLevels(0),
+    m_residentBytes(0),
+    m_residentMipLevel(0),
+    m_maxResidentMipLevel(0)
 {
-    // Attempt to load the image file as a resource in R32G32B32A32 format
+    // DDS files that are already in the desired format, with all of their mip levels, need no decoding
+    if( IsDDSFile(filePath) )
+    {
+        DDSFile::SharedPtr file;
+
+        try
+        {
+            file.reset(new DDSFile(filePath));
+        }
+        catch(Common::Exception &)
+        {
+            // Left for D3DX10 to load, or to report why it cannot
+        }
+
+        if( file && CanCreateFromDDSFile(*file, format) )
+        {
+            CreateFromDDSFile(file, format, streamed);
+            return;
+        }
+    }
+
+    // Other images are decoded and filtered into a full mip chain here, in linear space
+    if( CanGenerateMipChain(filePath, format) )
+    {
+        std::vector<unsigned char> texels;
+        unsigned                   width  = 0;
+        unsigned                   height = 0;
+
+        try
+        {
+            const MappedFile file(filePath);
+            DecodeImage(file.GetData(), file.GetSize(), filePath, texels, width, height);
+        }
+        catch(Common::Exception & e)
+        {
+            throw e;
+        }
+
+        CreateFromMipChain(MipChain(&texels[0], width, height, width * 4), filePath);
+        return;
+    }
+
+    // Attempt to load the image file as a resource in the desired format
     D3DX10_IMAGE_LOAD_INFO loadInfo;
     ZeroMemory(&loadInfo, sizeof(D3DX10_IMAGE_LOAD_INFO));
     loadInfo.BindFlags = D3D10_BIND_SHADER_RESOURCE;
@@ -29,6 +160,286 @@ Texture::Texture(ID3D10Device & device, const std::string & filePath, DXGI_FORMA
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
+    CreateView(resource, filePath, format);
+}
+
+//------------------------------------------------------------------------------------------
+Texture::Texture(ID3D10Device & device, ID3D10Resource * resource, const std::string & name, DXGI_FORMAT format)
+    :
+    m_device(device),
+    m_texture(0),
+    m_hasAlpha(false),
+    m_width(0),
+    m_height(0),
+    m_format(DXGI_FORMAT_UNKNOWN),
+    m_numMipLevels(0),
+    m_residentBytes(0),
+    m_residentMipLevel(0),
+    m_maxResidentMipLevel(0)
+{
+    if( !resource )
+    {
+        std::string msg("Resource is NULL for texture: ");
+        msg += name;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    CreateView(resource, name, format);
+}
+
+//------------------------------------------------------------------------------------------
+Texture::Texture(ID3D10Device & device, const DDSFile::SharedPtr & file, DXGI_FORMAT format, const bool streamed)
+    :
+    m_device(device),
+    m_texture(0),
+    m_hasAlpha(false),
+    m_width(0),
+    m_height(0),
+    m_format(DXGI_FORMAT_UNKNOWN),
+    m_numMipLevels(0),
+    m_residentBytes(0),
+    m_residentMipLevel(0),
+    m_maxResidentMipLevel(0)
+{
+    if( !file )
+    {
+        const std::string msg("DDS file is NULL");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    if( !CanCreateFromDDSFile(*file, format) )
+    {
+        std::string msg("DDS file is not a 2D texture with a full mip chain in the desired format: ");
+        msg += file->GetFilePath();
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    CreateFromDDSFile(file, format, streamed);
+}
+
+//------------------------------------------------------------------------------------------
+Texture::Texture(ID3D10Device & device, const MipChain & mipChain, const std::string & name)
+    :
+    m_device(device),
+    m_texture(0),
+    m_hasAlpha(false),
+    m_width(0),
+    m_height(0),
+    m_format(DXGI_FORMAT_UNKNOWN),
+    m_numMipLevels(0),
+    m_residentBytes(0),
+    m_residentMipLevel(0),
+    m_maxResidentMipLevel(0)
+{
+    CreateFromMipChain(mipChain, name);
+}
+
+//------------------------------------------------------------------------------------------
+const bool Texture::CanCreateFromDDSFile(const DDSFile & file, DXGI_FORMAT format)
+{
+    return file.GetDimension() == D3D10_RESOURCE_DIMENSION_TEXTURE2D &&
+           file.GetArraySize() == 1                                  &&
+           !file.IsCubeMap()                                         &&
+           file.HasFullMipChain()                                    &&
+           (format == DXGI_FORMAT_FROM_FILE || format == file.GetFormat());
+}
+
+//------------------------------------------------------------------------------------------
+const bool Texture::CanGenerateMipChain(const std::string & filePath, DXGI_FORMAT format)
+{
+    return !IsDDSFile(filePath) &&
+           (format == DXGI_FORMAT_FROM_FILE || format == DXGI_FORMAT_R8G8B8A8_UNORM);
+}
+
+//------------------------------------------------------------------------------------------
+void Texture::DecodeImage(const void * data,
+                          const size_t numBytes,
+                          const std::string & name,
+                          std::vector<unsigned char> & texels,
+                          unsigned & width,
+                          unsigned & height)
+{
+    if( numBytes > 0xFFFFFFFF )
+    {
+        std::string msg("Image is too large to decode: ");
+        msg += name;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // WIC is COM, which must be initialized on each thread that uses it. A thread that already joined 
+    // a single threaded apartment, such as the main window's, can use it from there.
+    const HRESULT initResult = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+    if( FAILED(initResult) && initResult != RPC_E_CHANGED_MODE )
+    {
+        std::string msg("Failed to initialize COM to decode texture: ");
+        msg += name;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    IWICImagingFactory *    factory   = NULL;
+    IWICStream *            stream    = NULL;
+    IWICBitmapDecoder *     decoder   = NULL;
+    IWICBitmapFrameDecode * frame     = NULL;
+    IWICFormatConverter *   converter = NULL;
+
+    // Decoded straight from the file's contents to 32 bit BGRA, which every version of WIC can convert to
+    HRESULT result = CoCreateInstance(CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+
+    if( SUCCEEDED(result) )
+    {
+        result = factory->CreateStream(&stream);
+    }
+
+    if( SUCCEEDED(result) )
+    {
+        result = stream->InitializeFromMemory(static_cast<BYTE *>(const_cast<void *>(data)), static_cast<DWORD>(numBytes));
+    }
+
+    if( SUCCEEDED(result) )
+    {
+        result = factory->CreateDecoderFromStream(stream, NULL, WICDecodeMetadataCacheOnDemand, &decoder);
+    }
+
+    if( SUCCEEDED(result) )
+    {
+        result = decoder->GetFrame(0, &frame);
+    }
+
+    if( SUCCEEDED(result) )
+    {
+        result = factory->CreateFormatConverter(&converter);
+    }
+
+    if( SUCCEEDED(result) )
+    {
+        result = converter->Initialize(frame, GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone, NULL, 0.0, WICBitmapPaletteTypeCustom);
+    }
+
+    UINT frameWidth  = 0;
+    UINT frameHeight = 0;
+
+    if( SUCCEEDED(result) )
+    {
+        result = converter->GetSize(&frameWidth, &frameHeight);
+    }
+
+    if( SUCCEEDED(result) && (frameWidth == 0 || frameHeight == 0 || frameWidth > 0xFFFFFFFF / 4 / frameHeight) )
+    {
+        result = E_FAIL;
+    }
+
+    if( SUCCEEDED(result) )
+    {
+        texels.resize(static_cast<size_t>(frameWidth) * frameHeight * 4);
+        result = converter->CopyPixels(NULL, frameWidth * 4, static_cast<UINT>(texels.size()), &texels[0]);
+    }
+
+    Release(converter);
+    Release(frame);
+    Release(decoder);
+    Release(stream);
+    Release(factory);
+
+    if( SUCCEEDED(initResult) )
+    {
+        CoUninitialize();
+    }
+
+    if( FAILED(result) )
+    {
+        texels.clear();
+
+        std::string msg("Failed to decode texture: ");
+        msg += name;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    // Swap blue and red, for R8G8B8A8_UNORM
+    for(size_t i = 0; i < texels.size(); i += 4)
+    {
+        std::swap(texels[i], texels[i + 2]);
+    }
+
+    width  = frameWidth;
+    height = frameHeight;
+}
+
+//------------------------------------------------------------------------------------------
+void Texture::CreateFromDDSFile(const DDSFile::SharedPtr & file, DXGI_FORMAT format, const bool streamed)
+{
+    unsigned mipLevel = 0;
+
+    if( streamed )
+    {
+        // Least detailed mip level that is no larger than a streamed texture keeps resident
+        const unsigned largest = std::max<unsigned>(file->GetWidth(), file->GetHeight());
+
+        while( (largest >> mipLevel) > MIN_STREAMED_SIZE )
+        {
+            ++mipLevel;
+        }
+
+        mipLevel = GetNearestMipLevel(file->GetFormat(), file->GetWidth(), file->GetHeight(), file->GetNumMipLevels(), mipLevel);
+    }
+
+    CreateFromMipLevel(*file, format, mipLevel);
+
+    if( streamed )
+    {
+        m_file                = file;
+        m_maxResidentMipLevel = mipLevel;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void Texture::CreateFromMipLevel(const DDSFile & file, DXGI_FORMAT format, const unsigned mipLevel)
+{
+    D3D10_TEXTURE2D_DESC desc;
+    file.GetTexture2DDesc(desc);
+
+    // Only the mip levels from this one down
+    desc.Width     = std::max<unsigned>(desc.Width  >> mipLevel, 1);
+    desc.Height    = std::max<unsigned>(desc.Height >> mipLevel, 1);
+    desc.MipLevels = desc.MipLevels - mipLevel;
+
+    ID3D10Texture2D * texture = NULL;
+    if( FAILED(m_device.CreateTexture2D(&desc, file.GetSubresourceData() + mipLevel, &texture)) )
+    {
+        std::string msg("Failed to create texture from DDS file: ");
+        msg += file.GetFilePath();
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    CreateView(texture, file.GetFilePath(), format);
+
+    // Report the size of the whole texture, not only of what is resident
+    m_width            = file.GetWidth();
+    m_height           = file.GetHeight();
+    m_numMipLevels     = file.GetNumMipLevels();
+    m_residentMipLevel = mipLevel;
+}
+
+//------------------------------------------------------------------------------------------
+void Texture::CreateFromMipChain(const MipChain & mipChain, const std::string & name)
+{
+    D3D10_TEXTURE2D_DESC desc;
+    mipChain.GetTexture2DDesc(desc);
+
+    ID3D10Texture2D * texture = NULL;
+    if( FAILED(m_device.CreateTexture2D(&desc, mipChain.GetSubresourceData(), &texture)) )
+    {
+        std::string msg("Failed to create texture: ");
+        msg += name;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    CreateView(texture, name, DXGI_FORMAT_R8G8B8A8_UNORM);
+}
+
+//------------------------------------------------------------------------------------------
+void Texture::CreateView(ID3D10Resource * resource, const std::string & name, DXGI_FORMAT format)
+{
     // Cast the resource into a 2D texture
     D3D10_RESOURCE_DIMENSION type;
     resource->GetType(&type);
@@ -38,7 +449,7 @@ Texture::Texture(ID3D10Device & device, const std::string & filePath, DXGI_FORMA
         resource->Release();
 
         std::string msg("Only 2D textures are supported : ");
-        msg += filePath;
+        msg += name;
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
@@ -48,13 +459,13 @@ Texture::Texture(ID3D10Device & device, const std::string & filePath, DXGI_FORMA
     D3D10_TEXTURE2D_DESC texDesc;
     texture->GetDesc(&texDesc);
 
-    // Check if that the texture is in R32G32B32A32 format
-    if( texDesc.Format != format )
+    // Check that the texture is in the desired format, unless it was left in the format of the file
+    if( format != DXGI_FORMAT_FROM_FILE && texDesc.Format != format )
     {
         texture->Release();
 
         std::string msg("Failed to load texture : ");
-        msg += filePath + " in desired format";
+        msg += name + " in desired format";
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
@@ -70,13 +481,25 @@ Texture::Texture(ID3D10Device & device, const std::string & filePath, DXGI_FORMA
         texture->Release();
 
         std::string msg("Failed to create shader resource view : ");
-        msg += filePath;
+        msg += name;
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
 
-    // Get the width and height
-    m_width  = texDesc.Width;
-    m_height = texDesc.Height;
+    // Get the width, height, and how much memory it takes up
+    m_width        = texDesc.Width;
+    m_height       = texDesc.Height;
+    m_format       = texDesc.Format;
+    m_numMipLevels = texDesc.MipLevels;
+
+    try
+    {
+        m_residentBytes = GetTextureSize(texDesc.Format, texDesc.Width, texDesc.Height, texDesc.MipLevels, texDesc.ArraySize);
+    }
+    catch(Common::Exception &)
+    {
+        // Formats that cannot be sized are still usable, they are just left out of the reports
+        m_residentBytes = 0;
+    }
    
     // Release the texture interface now that we have a shader resource view
     texture->Release();
@@ -106,6 +529,12 @@ void Texture::SetTextureEffectVariable(ID3D10EffectShaderResourceVariable * effe
         const std::string msg("Failed to set effect variable to use texture");
         throw Common::Exception(__FILE__, __LINE__, msg);
     }
+
+    // Remember it, to set it again when the texture is created again
+    if( m_file && std::find(m_effectVariables.begin(), m_effectVariables.end(), effectVariable) == m_effectVariables.end() )
+    {
+        m_effectVariables.push_back(effectVariable);
+    }
 }
 
 //------------------------------------------------------------------------------------------
@@ -120,3 +549,128 @@ unsigned Texture::GetHeight() const
     return m_height;
 }
 
+//------------------------------------------------------------------------------------------
+const DXGI_FORMAT Texture::GetFormat() const
+{
+    return m_format;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned Texture::GetNumMipLevels() const
+{
+    return m_numMipLevels;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned Texture::GetResidentBytes() const
+{
+    return m_residentBytes;
+}
+
+//------------------------------------------------------------------------------------------
+const bool Texture::IsStreamed() const
+{
+    return m_file.get() != NULL;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned Texture::GetResidentMipLevel() const
+{
+    return m_residentMipLevel;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned Texture::GetMaxResidentMipLevel() const
+{
+    return m_maxResidentMipLevel;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned Texture::GetNearestResidentMipLevel(const unsigned mipLevel) const
+{
+    if( !m_file )
+    {
+        return 0;
+    }
+
+    return GetNearestMipLevel(m_format, m_width, m_height, m_numMipLevels, std::min<unsigned>(mipLevel, m_maxResidentMipLevel));
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned Texture::GetResidentBytes(const unsigned mipLevel) const
+{
+    if( !m_file )
+    {
+        return m_residentBytes;
+    }
+
+    const unsigned nearest = GetNearestResidentMipLevel(mipLevel);
+
+    try
+    {
+        return GetTextureSize(m_format, 
+                              std::max<unsigned>(m_width  >> nearest, 1), 
+                              std::max<unsigned>(m_height >> nearest, 1), 
+                              m_numMipLevels - nearest, 
+                              1);
+    }
+    catch(Common::Exception &)
+    {
+        // Formats that cannot be sized are left out of the reports, the same as when they are resident
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void Texture::SetResidentMipLevel(const unsigned mipLevel)
+{
+    if( !m_file )
+    {
+        const std::string msg("Only streamed textures can change which mip levels are resident");
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    const unsigned nearest = GetNearestResidentMipLevel(mipLevel);
+
+    if( nearest == m_residentMipLevel )
+    {
+        return;
+    }
+
+    // Create the texture again, keeping the old view until the new one exists
+    ID3D10ShaderResourceView * oldTexture = m_texture;
+    m_texture = NULL;
+
+    try
+    {
+        CreateFromMipLevel(*m_file, m_format, nearest);
+    }
+    catch(Common::Exception & e)
+    {
+        m_texture = oldTexture;
+        throw e;
+    }
+
+    // Set the variables that still use the old view to use the new one
+    for(EffectVariables::iterator it = m_effectVariables.begin(); it != m_effectVariables.end(); ++it)
+    {
+        ID3D10ShaderResourceView * current = NULL;
+
+        if( FAILED((*it)->GetResource(&current)) )
+        {
+            continue;
+        }
+
+        if( current == oldTexture )
+        {
+            (*it)->SetResource(m_texture);
+        }
+
+        if( current )
+        {
+            current->Release();
+        }
+    }
+
+    oldTexture->Release();
+}
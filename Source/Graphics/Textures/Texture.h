@@ -2,6 +2,10 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
+// EngineX Includes
+#include "Graphics\Textures\DDSFile.h"
+#include "Graphics\Textures\MipChain.h"
+
 // DirectX Includes
 #include <d3d10.h>
 #include <dxgi.h>
@@ -9,10 +13,16 @@
 
 // Standard Includes
 #include <string>
+#include <vector>
 
 //------------------------------------------------------------------------------------------
 /**
 * Wrapper around the Direct3D texture resource
+*
+* A texture created from a DDS file can be streamed. It then keeps the file mapped and only has some of its mip levels
+* in video memory, the least detailed ones, from the resident mip level down. SetResidentMipLevel creates the texture
+* again from the file with more or fewer of them. The width, height, and number of mip levels are those of the whole
+* texture either way. TextureManager decides which mip levels of each streamed texture are resident.
 */
 class Texture
 {
@@ -23,17 +33,109 @@ public:
    *
    * @param device   - Direct3D device
    * @param filePath - Path to the texture file to load
-   * @param format   - Desired format to store the loaded texture in
+   * @param format   - Desired format to store the loaded texture in. By default, the format of the file is kept, 
+   *                   so block compressed files stay compressed in video memory and others stay 8 bits per channel.
+   *                   Expanding into a float format, such as R32G32B32A32_FLOAT, must be asked for.
+   * @param streamed - Whether or not to stream the texture, if it can be, starting with only its least detailed
+   *                   mip levels resident
+   *
+   * DDS files that CanCreateFromDDSFile accepts are created straight from their mapped mip chains. Other images
+   * that CanGenerateMipChain accepts, such as PNG and JPG files, are decoded by WIC and get their mip levels
+   * from a MipChain. The rest are left to D3DX10, which also generates any mip levels the file lacks. Only
+   * textures created from DDS files are streamed.
    *
    * @throws BaseException - if the texture cannot be loaded
    */
-   Texture(ID3D10Device & device, const std::string & filePath, DXGI_FORMAT format = DXGI_FORMAT_R32G32B32A32_FLOAT);
+   Texture(ID3D10Device & device, const std::string & filePath, DXGI_FORMAT format = DXGI_FORMAT_FROM_FILE, const bool streamed = false);
+
+   /**
+   * Constructor
+   *
+   * @param device   - Direct3D device
+   * @param resource - Texture resource that was already created, such as by a TextureLoader. 
+   *                   This object takes over the reference to it, even if construction fails.
+   * @param name     - Name of the texture, for error messages
+   * @param format   - Format the texture is expected to be in, or DXGI_FORMAT_FROM_FILE to accept any
+   *
+   * @throws BaseException - if the resource is not a 2D texture in the format or a view cannot be created for it
+   */
+   Texture(ID3D10Device & device, ID3D10Resource * resource, const std::string & name, DXGI_FORMAT format = DXGI_FORMAT_FROM_FILE);
+
+   /**
+   * Constructor
+   *
+   * Creates the texture from the mip levels of a DDS file as they lie in the file, without decoding or copying them
+   *
+   * @param device   - Direct3D device
+   * @param file     - Parsed DDS file. It is only held on to if the texture is streamed.
+   * @param format   - Format the texture is expected to be in, or DXGI_FORMAT_FROM_FILE to accept any
+   * @param streamed - Whether or not to stream the texture, starting with only its least detailed mip levels resident
+   *
+   * @throws BaseException - if CanCreateFromDDSFile does not accept the file, or the texture cannot be created
+   */
+   Texture(ID3D10Device & device, const DDSFile::SharedPtr & file, DXGI_FORMAT format = DXGI_FORMAT_FROM_FILE, const bool streamed = false);
+
+   /**
+   * Constructor
+   *
+   * Creates the texture from an image and the mip levels that were generated for it, in R8G8B8A8_UNORM
+   *
+   * @param device    - Direct3D device
+   * @param mipChain  - Image with its mip levels
+   * @param name      - Name of the texture, for error messages
+   *
+   * @throws BaseException - if the texture cannot be created
+   */
+   Texture(ID3D10Device & device, const MipChain & mipChain, const std::string & name);
 
    /**
    * Deconstructor
    */
    ~Texture();
 
+   /**
+   * Query whether or not a texture can be created straight from a DDS file
+   *
+   * It must hold a single 2D texture, not an array or cube map, with every mip level down to 1x1,
+   * already in the desired format. Anything else is left to D3DX10 to convert.
+   *
+   * @param file   - Parsed DDS file
+   * @param format - Desired format, or DXGI_FORMAT_FROM_FILE to accept any
+   */
+   static const bool CanCreateFromDDSFile(const DDSFile & file, DXGI_FORMAT format);
+
+   /**
+   * Query whether or not an image file gets its mip levels from a MipChain, rather than from D3DX10
+   *
+   * It must not be a DDS file, which has mip levels of its own or is in a format that cannot be filtered 8 bits
+   * at a time, and the desired format must be the one D3DX10 loads other images in.
+   *
+   * @param filePath - Path to the image file
+   * @param format   - Desired format, or DXGI_FORMAT_FROM_FILE to accept any
+   */
+   static const bool CanGenerateMipChain(const std::string & filePath, DXGI_FORMAT format);
+
+   /**
+   * Decodes an image file into 32 bit RGBA texels in system memory, without any mip levels
+   *
+   * Decoding is done by WIC, without the device, so it can be done on a worker thread.
+   *
+   * @param data     - Contents of the image file
+   * @param numBytes - Size of the contents, in bytes
+   * @param name     - Name of the image, for error messages
+   * @param texels   - OUT - Texels, a row after another, with no gaps between rows
+   * @param width    - OUT - Width of the image, in texels
+   * @param height   - OUT - Height of the image, in texels
+   *
+   * @throws BaseException - if the image cannot be decoded
+   */
+   static void DecodeImage(const void * data,
+                           const size_t numBytes,
+                           const std::string & name,
+                           std::vector<unsigned char> & texels,
+                           unsigned & width,
+                           unsigned & height);
+
    /**
    * Sets an effect variable to use this texture
    */
@@ -49,6 +151,66 @@ public:
    **/
    unsigned GetHeight() const;
 
+   /**
+   * Gets the format the texture is stored in
+   **/
+   const DXGI_FORMAT GetFormat() const;
+
+   /**
+   * Gets the number of mip levels in the texture
+   **/
+   const unsigned GetNumMipLevels() const;
+
+   /**
+   * Gets the number of bytes of video memory the texture takes up, with all of its resident mip levels and array slices
+   **/
+   const unsigned GetResidentBytes() const;
+
+   /**
+   * Query whether or not the texture is streamed
+   **/
+   const bool IsStreamed() const;
+
+   /**
+   * Gets the most detailed mip level that is in video memory. 0 unless the texture is streamed.
+   **/
+   const unsigned GetResidentMipLevel() const;
+
+   /**
+   * Gets the least detailed mip level that can be the most detailed one in video memory
+   *
+   * Streamed textures always keep the mip levels from this one down resident. 0 unless the texture is streamed.
+   **/
+   const unsigned GetMaxResidentMipLevel() const;
+
+   /**
+   * Gets the most detailed mip level that can be resident in place of one that was asked for
+   *
+   * Block compressed textures must be a whole number of blocks across, so a mip level that is not is
+   * rounded to a more detailed one that is.
+   *
+   * @param mipLevel - Mip level that was asked for. Clamped to the mip levels the texture can have resident.
+   **/
+   const unsigned GetNearestResidentMipLevel(const unsigned mipLevel) const;
+
+   /**
+   * Gets the number of bytes of video memory the texture would take up with a mip level as the most detailed one
+   *
+   * @param mipLevel - Mip level that would be resident, as given by GetNearestResidentMipLevel
+   **/
+   const unsigned GetResidentBytes(const unsigned mipLevel) const;
+
+   /**
+   * Creates the texture again with a different most detailed mip level in video memory, from the mapped file
+   *
+   * Effect variables this texture was set on are set to the new one, unless they were set to another texture since.
+   *
+   * @param mipLevel - Most detailed mip level to have resident. Rounded with GetNearestResidentMipLevel.
+   *
+   * @throws BaseException - if the texture is not streamed or cannot be created again. It is left as it was.
+   **/
+   void SetResidentMipLevel(const unsigned mipLevel);
+
 private:
 
    /**
@@ -60,12 +222,54 @@ private:
    */
    Texture(const Texture & rhs);
 
+   /**
+   * Creates the texture and its view from a DDS file that CanCreateFromDDSFile accepts
+   *
+   * A streamed texture holds on to the file and is created with only the mip levels it always keeps resident.
+   *
+   * @throws BaseException - if the texture cannot be created
+   */
+   void CreateFromDDSFile(const DDSFile::SharedPtr & file, DXGI_FORMAT format, const bool streamed);
+
+   /**
+   * Creates the texture and its view from some of the mip levels of a DDS file
+   *
+   * @param mipLevel - Most detailed mip level to create it with. Less detailed ones are all created too.
+   *
+   * @throws BaseException - if the texture cannot be created. The texture is left as it was.
+   */
+   void CreateFromMipLevel(const DDSFile & file, DXGI_FORMAT format, const unsigned mipLevel);
+
+   /**
+   * Creates the texture and its view from an image and its generated mip levels
+   *
+   * @throws BaseException - if the texture cannot be created
+   */
+   void CreateFromMipChain(const MipChain & mipChain, const std::string & name);
+
+   /**
+   * Creates the shader resource view from a texture resource, and releases the resource
+   *
+   * @throws BaseException - if the resource is not a 2D texture in the format or the view cannot be created
+   */
+   void CreateView(ID3D10Resource * resource, const std::string & name, DXGI_FORMAT format);
+
 
    ID3D10Device &              m_device;
    ID3D10ShaderResourceView *  m_texture;
    bool                        m_hasAlpha;
    unsigned                    m_width;
    unsigned                    m_height;
+   DXGI_FORMAT                 m_format;
+   unsigned                    m_numMipLevels;
+   unsigned                    m_residentBytes;
+
+   DDSFile::SharedPtr          m_file;                   // Mapped file the mip levels are streamed from, if the texture is streamed
+   unsigned                    m_residentMipLevel;       // Most detailed mip level in video memory
+   unsigned                    m_maxResidentMipLevel;    // Least detailed mip level that is ever the most detailed one in video memory
+
+   typedef std::vector<ID3D10EffectShaderResourceVariable *> EffectVariables;
+   EffectVariables             m_effectVariables;        // Variables the texture was set on, to set again when a streamed texture is created again
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,202 @@
+// Project Includes
+#include "TextureAtlas.h"
+#include "MipChain.h"
+#include "RectanglePacker.h"
+
+// EngineX Includes
+#include "Core\ContentHash.h"
+#include "Core\MappedFile.h"
+
+// Common Lib Includes
+#include "Exception.h"
+#include "StringUtility.h"
+
+// Standard Includes
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <sstream>
+
+//------------------------------------------------------------------------------------------
+namespace
+{
+    const unsigned BYTES_PER_TEXEL = 4;
+
+    /**
+    * An image decoded to 32 bit RGBA texels, a row after another with no gaps between them
+    **/
+    struct DecodedImage
+    {
+        std::string                m_name;
+        unsigned                   m_width;
+        unsigned                   m_height;
+        std::vector<unsigned char> m_texels;
+    };
+
+    /**
+    * Copies an image into the atlas, repeating its edge texels into the padding around it
+    *
+    * @param image      - The image
+    * @param padded     - Where the image, with its padding, was placed in the atlas
+    * @param padding    - Number of texels of padding on each side
+    * @param atlas      - The atlas texels
+    * @param atlasWidth - Width of the atlas, in texels
+    **/
+    void CopyImage(const DecodedImage & image,
+                   const RectanglePacker::Rect & padded,
+                   const unsigned padding,
+                   std::vector<unsigned char> & atlas,
+                   const unsigned atlasWidth)
+    {
+        for(unsigned y = 0; y < padded.m_height; ++y)
+        {
+            const unsigned sourceY = std::min<unsigned>(y > padding ? y - padding : 0, image.m_height - 1);
+
+            for(unsigned x = 0; x < padded.m_width; ++x)
+            {
+                const unsigned sourceX = std::min<unsigned>(x > padding ? x - padding : 0, image.m_width - 1);
+
+                std::memcpy(&atlas[((padded.m_y + y) * atlasWidth + padded.m_x + x) * BYTES_PER_TEXEL],
+                            &image.m_texels[(sourceY * image.m_width + sourceX) * BYTES_PER_TEXEL],
+                            BYTES_PER_TEXEL);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+TextureAtlas::TextureAtlas(ID3D10Device & device,
+                           TextureManager & textureManager,
+                           const std::string & atlasName,
+                           const std::vector<std::string> & textureFilePaths,
+                           const unsigned padding,
+                           const unsigned maxSize)
+    :
+    m_textureName(atlasName),
+    m_width(0),
+    m_height(0)
+{
+    // Decode every image
+    std::vector<DecodedImage> images(textureFilePaths.size());
+
+    for(unsigned index = 0; index < textureFilePaths.size(); ++index)
+    {
+        Common::RemoveExtFromFilename(textureFilePaths[index], images[index].m_name);
+
+        for(unsigned other = 0; other < index; ++other)
+        {
+            if( images[other].m_name == images[index].m_name )
+            {
+                std::string msg("More than one image is named ");
+                msg += images[index].m_name;
+                msg += " in atlas: ";
+                msg += atlasName;
+                throw Common::Exception(__FILE__, __LINE__, msg);
+            }
+        }
+
+        try
+        {
+            const std::string filePath = textureManager.GetTextureDirectory() + "\\" + textureFilePaths[index];
+            const MappedFile  file(filePath);
+
+            Texture::DecodeImage(file.GetData(),
+                                 file.GetSize(),
+                                 filePath,
+                                 images[index].m_texels,
+                                 images[index].m_width,
+                                 images[index].m_height);
+        }
+        catch(Common::Exception & e)
+        {
+            throw e;
+        }
+    }
+
+    // Pack them, with their padding
+    std::vector<RectanglePacker::Rect> rects;
+    rects.reserve(images.size());
+
+    for(std::vector<DecodedImage>::const_iterator it = images.begin(); it != images.end(); ++it)
+    {
+        rects.push_back(RectanglePacker::Rect(0, 0, it->m_width + 2 * padding, it->m_height + 2 * padding));
+    }
+
+    if( !RectanglePacker::Pack(rects, maxSize, m_width, m_height) )
+    {
+        std::ostringstream msg;
+        msg << "Images do not fit into " << maxSize << " by " << maxSize << " texels for atlas: " << atlasName;
+        throw Common::Exception(__FILE__, __LINE__, msg.str());
+    }
+
+    // Copy them into the atlas and work out their texture coordinates
+    std::vector<unsigned char> texels(m_width * m_height * BYTES_PER_TEXEL, 0);
+
+    for(unsigned index = 0; index < images.size(); ++index)
+    {
+        CopyImage(images[index], rects[index], padding, texels, m_width);
+
+        AtlasRegion region;
+        region.m_x             = rects[index].m_x + padding;
+        region.m_y             = rects[index].m_y + padding;
+        region.m_width         = images[index].m_width;
+        region.m_height        = images[index].m_height;
+        region.m_texCoordMin.x = static_cast<float>(region.m_x) / static_cast<float>(m_width);
+        region.m_texCoordMin.y = static_cast<float>(region.m_y) / static_cast<float>(m_height);
+        region.m_texCoordMax.x = static_cast<float>(region.m_x + region.m_width)  / static_cast<float>(m_width);
+        region.m_texCoordMax.y = static_cast<float>(region.m_y + region.m_height) / static_cast<float>(m_height);
+
+        m_regions[images[index].m_name] = region;
+    }
+
+    // Hand the texture to the manager, which shares it if the same atlas was already built
+    const ContentHash contentHash = HashContent(&texels[0], texels.size(), textureManager.GetContentSeed(DXGI_FORMAT_R8G8B8A8_UNORM, false));
+
+    if( !textureManager.ShareTexture(m_textureName, contentHash) )
+    {
+        // Sprites are filtered with their colors weighted by alpha, so transparent texels do not darken their edges
+        const MipChain mipChain(&texels[0], m_width, m_height, m_width * BYTES_PER_TEXEL);
+        textureManager.AddTexture(m_textureName, contentHash, std::auto_ptr<Texture>(new Texture(device, mipChain, m_textureName)));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const std::string & TextureAtlas::GetTextureName() const
+{
+    return m_textureName;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned TextureAtlas::GetWidth() const
+{
+    return m_width;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned TextureAtlas::GetHeight() const
+{
+    return m_height;
+}
+
+//------------------------------------------------------------------------------------------
+const bool TextureAtlas::HasRegion(const std::string & regionName) const
+{
+    return m_regions.find(regionName) != m_regions.end();
+}
+
+//------------------------------------------------------------------------------------------
+const AtlasRegion & TextureAtlas::GetRegion(const std::string & regionName) const
+{
+    RegionMap::const_iterator it = m_regions.find(regionName);
+
+    if( it == m_regions.end() )
+    {
+        std::string msg("Atlas ");
+        msg += m_textureName;
+        msg += " does not hold an image named ";
+        msg += regionName;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    return it->second;
+}
@@ -0,0 +1,108 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+// Project Includes
+#include "TextureManager.h"
+
+// DirectX Includes
+#include <d3d10.h>
+#include <d3dx10.h>
+
+// Standard Includes
+#include <map>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+/**
+* Where one image lies within a texture atlas
+**/
+struct AtlasRegion
+{
+   unsigned    m_x;              // Left edge, in texels
+   unsigned    m_y;              // Top edge, in texels
+   unsigned    m_width;          // Width of the image, in texels
+   unsigned    m_height;         // Height of the image, in texels
+   D3DXVECTOR2 m_texCoordMin;    // Texture coordinates of the top left corner
+   D3DXVECTOR2 m_texCoordMax;    // Texture coordinates of the bottom right corner
+};
+
+//------------------------------------------------------------------------------------------
+/**
+* Many small images, such as sprites, the elements of a HUD, or the parts of a lens flare, packed into one texture
+*
+* Everything drawn from the same atlas binds the same texture, so the Effect never has to rebind it between
+* them. Each image is a region of the atlas, named after its file without the extension.
+*
+* The images are decoded, packed with a RectanglePacker, and copied into a single 32 bit RGBA texture, which is
+* added to the TextureManager under the name of the atlas. The edge texels of each image are repeated into the
+* padding around it, so that filtering at its edges does not bleed in its neighbours. Mip levels are generated
+* by a MipChain.
+**/
+class TextureAtlas
+{
+public:
+
+   /**
+   * Constructor
+   *
+   * @param device           - Direct3D device
+   * @param textureManager   - Manager to add the atlas texture to
+   * @param atlasName        - Name of the atlas texture, for the application to refer to
+   * @param textureFilePaths - File paths to the images, relative to the directory path the textureManager has been
+   *                           created with
+   * @param padding          - Number of texels to leave around each image
+   * @param maxSize          - Longest side the atlas texture may have
+   *
+   * @throws BaseException - If an image cannot be loaded, two images have the same name, the images do not
+   *                         fit into maxSize by maxSize texels, or the texture cannot be created
+   **/
+   TextureAtlas(ID3D10Device & device,
+                TextureManager & textureManager,
+                const std::string & atlasName,
+                const std::vector<std::string> & textureFilePaths,
+                const unsigned padding = 2,
+                const unsigned maxSize = 2048);
+
+   /**
+   * Gets the name of the atlas texture in the TextureManager
+   **/
+   const std::string & GetTextureName() const;
+
+   const unsigned GetWidth() const;
+   const unsigned GetHeight() const;
+
+   /**
+   * Query whether or not the atlas holds an image
+   *
+   * @param regionName - Name of the image's file, without the extension
+   **/
+   const bool HasRegion(const std::string & regionName) const;
+
+   /**
+   * Gets where an image lies within the atlas
+   *
+   * @param regionName - Name of the image's file, without the extension
+   *
+   * @throws BaseException - If the atlas does not hold the image
+   **/
+   const AtlasRegion & GetRegion(const std::string & regionName) const;
+
+private:
+
+   /** No Copy allowed */
+   TextureAtlas(const TextureAtlas & rhs);
+
+   /** No assignment allowed */
+   TextureAtlas & operator = (const TextureAtlas & rhs);
+
+
+   typedef std::map<std::string, AtlasRegion> RegionMap;
+
+   std::string m_textureName;    // Name of the atlas texture in the TextureManager
+   unsigned    m_width;
+   unsigned    m_height;
+   RegionMap   m_regions;        // Where each image lies, by name
+};
+
+#endif // TEXTUREATLAS_H
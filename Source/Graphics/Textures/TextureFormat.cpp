@@ -0,0 +1,242 @@
+
+// Project Includes
+#include "TextureFormat.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <algorithm>
+#include <sstream>
+
+//------------------------------------------------------------------------------------------
+namespace
+{
+    /**
+    * Name and texel size of a format
+    **/
+    struct FormatInfo
+    {
+        const char * m_name;           // Without the DXGI_FORMAT_ prefix
+        unsigned     m_bitsPerTexel;   // Average, for block compressed formats. 0 if unknown.
+    };
+
+    /**
+    * Every format, indexed by its value
+    **/
+    const FormatInfo FORMATS[] =
+    {
+        { "UNKNOWN",                      0 },   // 0
+        { "R32G32B32A32_TYPELESS",      128 },   // 1
+        { "R32G32B32A32_FLOAT",         128 },   // 2
+        { "R32G32B32A32_UINT",          128 },   // 3
+        { "R32G32B32A32_SINT",          128 },   // 4
+        { "R32G32B32_TYPELESS",          96 },   // 5
+        { "R32G32B32_FLOAT",             96 },   // 6
+        { "R32G32B32_UINT",              96 },   // 7
+        { "R32G32B32_SINT",              96 },   // 8
+        { "R16G16B16A16_TYPELESS",       64 },   // 9
+        { "R16G16B16A16_FLOAT",          64 },   // 10
+        { "R16G16B16A16_UNORM",          64 },   // 11
+        { "R16G16B16A16_UINT",           64 },   // 12
+        { "R16G16B16A16_SNORM",          64 },   // 13
+        { "R16G16B16A16_SINT",           64 },   // 14
+        { "R32G32_TYPELESS",             64 },   // 15
+        { "R32G32_FLOAT",                64 },   // 16
+        { "R32G32_UINT",                 64 },   // 17
+        { "R32G32_SINT",                 64 },   // 18
+        { "R32G8X24_TYPELESS",           64 },   // 19
+        { "D32_FLOAT_S8X24_UINT",        64 },   // 20
+        { "R32_FLOAT_X8X24_TYPELESS",    64 },   // 21
+        { "X32_TYPELESS_G8X24_UINT",     64 },   // 22
+        { "R10G10B10A2_TYPELESS",        32 },   // 23
+        { "R10G10B10A2_UNORM",           32 },   // 24
+        { "R10G10B10A2_UINT",            32 },   // 25
+        { "R11G11B10_FLOAT",             32 },   // 26
+        { "R8G8B8A8_TYPELESS",           32 },   // 27
+        { "R8G8B8A8_UNORM",              32 },   // 28
+        { "R8G8B8A8_UNORM_SRGB",         32 },   // 29
+        { "R8G8B8A8_UINT",               32 },   // 30
+        { "R8G8B8A8_SNORM",              32 },   // 31
+        { "R8G8B8A8_SINT",               32 },   // 32
+        { "R16G16_TYPELESS",             32 },   // 33
+        { "R16G16_FLOAT",                32 },   // 34
+        { "R16G16_UNORM",                32 },   // 35
+        { "R16G16_UINT",                 32 },   // 36
+        { "R16G16_SNORM",                32 },   // 37
+        { "R16G16_SINT",                 32 },   // 38
+        { "R32_TYPELESS",                32 },   // 39
+        { "D32_FLOAT",                   32 },   // 40
+        { "R32_FLOAT",                   32 },   // 41
+        { "R32_UINT",                    32 },   // 42
+        { "R32_SINT",                    32 },   // 43
+        { "R24G8_TYPELESS",              32 },   // 44
+        { "D24_UNORM_S8_UINT",           32 },   // 45
+        { "R24_UNORM_X8_TYPELESS",       32 },   // 46
+        { "X24_TYPELESS_G8_UINT",        32 },   // 47
+        { "R8G8_TYPELESS",               16 },   // 48
+        { "R8G8_UNORM",                  16 },   // 49
+        { "R8G8_UINT",                   16 },   // 50
+        { "R8G8_SNORM",                  16 },   // 51
+        { "R8G8_SINT",                   16 },   // 52
+        { "R16_TYPELESS",                16 },   // 53
+        { "R16_FLOAT",                   16 },   // 54
+        { "D16_UNORM",                   16 },   // 55
+        { "R16_UNORM",                   16 },   // 56
+        { "R16_UINT",                    16 },   // 57
+        { "R16_SNORM",                   16 },   // 58
+        { "R16_SINT",                    16 },   // 59
+        { "R8_TYPELESS",                  8 },   // 60
+        { "R8_UNORM",                     8 },   // 61
+        { "R8_UINT",                      8 },   // 62
+        { "R8_SNORM",                     8 },   // 63
+        { "R8_SINT",                      8 },   // 64
+        { "A8_UNORM",                     8 },   // 65
+        { "R1_UNORM",                     1 },   // 66
+        { "R9G9B9E5_SHAREDEXP",          32 },   // 67
+        { "R8G8_B8G8_UNORM",             16 },   // 68
+        { "G8R8_G8B8_UNORM",             16 },   // 69
+        { "BC1_TYPELESS",                 4 },   // 70
+        { "BC1_UNORM",                    4 },   // 71
+        { "BC1_UNORM_SRGB",               4 },   // 72
+        { "BC2_TYPELESS",                 8 },   // 73
+        { "BC2_UNORM",                    8 },   // 74
+        { "BC2_UNORM_SRGB",               8 },   // 75
+        { "BC3_TYPELESS",                 8 },   // 76
+        { "BC3_UNORM",                    8 },   // 77
+        { "BC3_UNORM_SRGB",               8 },   // 78
+        { "BC4_TYPELESS",                 4 },   // 79
+        { "BC4_UNORM",                    4 },   // 80
+        { "BC4_SNORM",                    4 },   // 81
+        { "BC5_TYPELESS",                 8 },   // 82
+        { "BC5_UNORM",                    8 },   // 83
+        { "BC5_SNORM",                    8 },   // 84
+        { "B5G6R5_UNORM",                16 },   // 85
+        { "B5G5R5A1_UNORM",              16 },   // 86
+        { "B8G8R8A8_UNORM",              32 },   // 87
+        { "B8G8R8X8_UNORM",              32 },   // 88
+        { "R10G10B10_XR_BIAS_A2_UNORM",  32 },   // 89
+        { "B8G8R8A8_TYPELESS",           32 },   // 90
+        { "B8G8R8A8_UNORM_SRGB",         32 },   // 91
+        { "B8G8R8X8_TYPELESS",           32 },   // 92
+        { "B8G8R8X8_UNORM_SRGB",         32 },   // 93
+        { "BC6H_TYPELESS",                8 },   // 94
+        { "BC6H_UF16",                    8 },   // 95
+        { "BC6H_SF16",                    8 },   // 96
+        { "BC7_TYPELESS",                 8 },   // 97
+        { "BC7_UNORM",                    8 },   // 98
+        { "BC7_UNORM_SRGB",               8 },   // 99
+    };
+
+    const unsigned NUM_FORMATS = sizeof(FORMATS) / sizeof(FORMATS[0]);
+
+    // Formats that are laid out differently than their texel size says
+    const unsigned FORMAT_R8G8_B8G8_UNORM = 68;
+    const unsigned FORMAT_G8R8_G8B8_UNORM = 69;
+    const unsigned FORMAT_BC1_TYPELESS    = 70;
+    const unsigned FORMAT_BC5_SNORM       = 84;
+    const unsigned FORMAT_BC6H_TYPELESS   = 94;
+    const unsigned FORMAT_BC7_UNORM_SRGB  = 99;
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Gets the number of bytes in each 4x4 block of a block compressed format
+    **/
+    const unsigned GetBytesPerBlock(const unsigned format)
+    {
+        return GetBitsPerTexel(format) * 16 / 8;
+    }
+
+    //--------------------------------------------------------------------------------------
+    /**
+    * Query whether or not a format packs two texels into each 32 bit element, sharing their chroma
+    **/
+    const bool IsPacked(const unsigned format)
+    {
+        return format == FORMAT_R8G8_B8G8_UNORM ||
+               format == FORMAT_G8R8_G8B8_UNORM;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const bool IsBlockCompressed(const unsigned format)
+{
+    return (format >= FORMAT_BC1_TYPELESS  && format <= FORMAT_BC5_SNORM) ||
+           (format >= FORMAT_BC6H_TYPELESS && format <= FORMAT_BC7_UNORM_SRGB);
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned GetBitsPerTexel(const unsigned format)
+{
+    if( format < NUM_FORMATS && FORMATS[format].m_bitsPerTexel )
+    {
+        return FORMATS[format].m_bitsPerTexel;
+    }
+
+    std::ostringstream msg;
+    msg << "Texel size unknown for format " << GetFormatName(format);
+    throw Common::Exception(__FILE__, __LINE__, msg.str());
+}
+
+//------------------------------------------------------------------------------------------
+void GetSurfaceLayout(const unsigned format,
+                      const unsigned width,
+                      const unsigned height,
+                      unsigned & rowPitch,
+                      unsigned & numRows)
+{
+    if( IsBlockCompressed(format) )
+    {
+        rowPitch = std::max<unsigned>(1, (width + 3) / 4) * GetBytesPerBlock(format);
+        numRows  = std::max<unsigned>(1, (height + 3) / 4);
+    }
+    else if( IsPacked(format) )
+    {
+        rowPitch = ((width + 1) / 2) * 4;
+        numRows  = height;
+    }
+    else
+    {
+        rowPitch = (width * GetBitsPerTexel(format) + 7) / 8;
+        numRows  = height;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned GetTextureSize(const unsigned format,
+                              const unsigned width,
+                              const unsigned height,
+                              const unsigned numMipLevels,
+                              const unsigned arraySize)
+{
+    unsigned sliceSize = 0;
+
+    for(unsigned level = 0; level < numMipLevels; ++level)
+    {
+        unsigned rowPitch = 0;
+        unsigned numRows  = 0;
+
+        GetSurfaceLayout(format,
+                         std::max<unsigned>(1, width >> level),
+                         std::max<unsigned>(1, height >> level),
+                         rowPitch,
+                         numRows);
+
+        sliceSize += rowPitch * numRows;
+    }
+
+    return sliceSize * arraySize;
+}
+
+//------------------------------------------------------------------------------------------
+const std::string GetFormatName(const unsigned format)
+{
+    if( format < NUM_FORMATS )
+    {
+        return FORMATS[format].m_name;
+    }
+
+    std::ostringstream name;
+    name << "FORMAT_" << format;
+    return name.str();
+}
@@ -0,0 +1,68 @@
+#ifndef TEXTUREFORMAT_H
+#define TEXTUREFORMAT_H
+
+// Standard Includes
+#include <string>
+
+//------------------------------------------------------------------------------------------
+// Sizes of texels and surfaces in the different texture formats
+//
+// Block compressed formats (BC1 through BC7) store 4x4 blocks of texels, 8 bytes per block for BC1 and BC4,
+// and 16 bytes for the rest. A surface smaller than a block still takes up a whole one.
+//
+// Formats are the values of DXGI_FORMAT, which converts to them, so that nothing here needs the DirectX headers
+// and files can be checked by tools on any platform.
+//
+
+/**
+* Query whether or not a format stores 4x4 blocks of texels
+**/
+const bool IsBlockCompressed(const unsigned format);
+
+/**
+* Gets the number of bits each texel takes up, on average, in a format
+*
+* @throws BaseException - If the format is unknown
+**/
+const unsigned GetBitsPerTexel(const unsigned format);
+
+/**
+* Gets the layout of one surface, such as one mip level of one face, in a format
+*
+* @param format   - Format of the surface
+* @param width    - Width of the surface, in texels
+* @param height   - Height of the surface, in texels
+* @param rowPitch - OUT - Size in bytes of one row, or of one row of blocks if the format is block compressed
+* @param numRows  - OUT - Number of rows, or of rows of blocks
+*
+* @throws BaseException - If the format is unknown
+**/
+void GetSurfaceLayout(const unsigned format,
+                      const unsigned width,
+                      const unsigned height,
+                      unsigned & rowPitch,
+                      unsigned & numRows);
+
+/**
+* Gets the number of bytes a texture takes up, with all of its mip levels and array slices
+*
+* @param format       - Format of the texture
+* @param width        - Width of the most detailed mip level, in texels
+* @param height       - Height of the most detailed mip level, in texels
+* @param numMipLevels - Number of mip levels in each array slice
+* @param arraySize    - Number of array slices, 6 for a cube map
+*
+* @throws BaseException - If the format is unknown
+**/
+const unsigned GetTextureSize(const unsigned format,
+                              const unsigned width,
+                              const unsigned height,
+                              const unsigned numMipLevels,
+                              const unsigned arraySize);
+
+/**
+* Gets the name of a format, without the DXGI_FORMAT_ prefix, for reports
+**/
+const std::string GetFormatName(const unsigned format);
+
+#endif // TEXTUREFORMAT_H
@@ -0,0 +1,298 @@
+
+// Project Includes
+#include "TextureLoader.h"
+
+// EngineX Includes
+#include "Core\MappedFile.h"
+
+// Common Lib Includes
+#include "Exception.h"
+
+// Standard Includes
+#include <cctype>
+#include <chrono>
+
+//------------------------------------------------------------------------------------------
+class TextureLoader::DecodeTask
+{
+public:
+
+    DecodeTask(ID3DX10DataProcessor * processor, const std::string & textureFilePath, DXGI_FORMAT format, const ContentHash contentSeed)
+        :
+        m_processor      (processor),
+        m_textureFilePath(textureFilePath),
+        m_format         (format),
+        m_contentSeed    (contentSeed)
+    {
+    }
+
+    DecodedTexture operator()() const
+    {
+        const MappedFile::SharedPtr file(new MappedFile(m_textureFilePath));
+
+        // Seeded the same as TextureManager::CreateTextureFromFile, so both share textures
+        DecodedTexture decoded;
+        decoded.m_contentHash = HashContent(file->GetData(), file->GetSize(), m_contentSeed);
+
+        // A DDS file that is already in the desired format, with all of its mip levels, only needs to be parsed
+        if( IsDDSFile() )
+        {
+            try
+            {
+                DDSFile::SharedPtr ddsFile(new DDSFile(file));
+
+                if( Texture::CanCreateFromDDSFile(*ddsFile, m_format) )
+                {
+                    decoded.m_ddsFile = ddsFile;
+                    return decoded;
+                }
+            }
+            catch(Common::Exception &)
+            {
+                // Left for the processor to decode, or to report why it cannot
+            }
+        }
+
+        // Other images are decoded and filtered into a full mip chain here, rather than by the processor
+        if( Texture::CanGenerateMipChain(m_textureFilePath, m_format) )
+        {
+            std::vector<unsigned char> texels;
+            unsigned                   width  = 0;
+            unsigned                   height = 0;
+
+            Texture::DecodeImage(file->GetData(), file->GetSize(), m_textureFilePath, texels, width, height);
+
+            decoded.m_mipChain.reset(new MipChain(&texels[0], width, height, width * 4));
+            return decoded;
+        }
+
+        if( FAILED(m_processor->Process(const_cast<unsigned char *>(file->GetData()), file->GetSize())) )
+        {
+            std::string msg("Failed to decode texture file: ");
+            msg += m_textureFilePath;
+            throw Common::Exception(__FILE__, __LINE__, msg);
+        }
+
+        return decoded;
+    }
+
+private:
+
+    /**
+    * Query whether or not the file is a DDS file, by its extension
+    **/
+    const bool IsDDSFile() const
+    {
+        const size_t size = m_textureFilePath.size();
+
+        return size > 4 && m_textureFilePath[size - 4] == '.' &&
+               tolower(m_textureFilePath[size - 3]) == 'd' &&
+               tolower(m_textureFilePath[size - 2]) == 'd' &&
+               tolower(m_textureFilePath[size - 1]) == 's';
+    }
+
+    ID3DX10DataProcessor * m_processor;
+    std::string            m_textureFilePath;
+    DXGI_FORMAT            m_format;
+    ContentHash            m_contentSeed;
+};
+
+//------------------------------------------------------------------------------------------
+TextureLoader::PendingTexture::PendingTexture(const std::string & textureFilePath, DXGI_FORMAT format)
+    :
+    m_textureFilePath(textureFilePath),
+    m_format         (format),
+    m_processor      (NULL)
+{
+    ZeroMemory(&m_loadInfo, sizeof(D3DX10_IMAGE_LOAD_INFO));
+    m_loadInfo.BindFlags = D3D10_BIND_SHADER_RESOURCE;
+    m_loadInfo.Format    = format;
+}
+
+//------------------------------------------------------------------------------------------
+TextureLoader::PendingTexture::~PendingTexture()
+{
+    if( m_processor )
+    {
+        m_processor->Destroy();
+        m_processor = NULL;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+TextureLoader::TextureLoader(ID3D10Device & device, TextureManager & textureManager, ThreadPool & threadPool)
+    :
+    m_device        (device),
+    m_textureManager(textureManager),
+    m_threadPool    (threadPool)
+{
+}
+
+//------------------------------------------------------------------------------------------
+TextureLoader::~TextureLoader()
+{
+    // The workers still use the processors of the textures being decoded
+    for(PendingMap::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+    {
+        if( it->second->m_decode.valid() )
+        {
+            it->second->m_decode.wait();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+void TextureLoader::Request(const std::string & textureName,
+                            const std::string & textureFileName,
+                            DXGI_FORMAT format)
+{
+    if( m_textureManager.HasTexture(textureName) || IsPending(textureName) )
+    {
+        return;
+    }
+
+    const std::string               textureFilePath = m_textureManager.GetTextureDirectory() + "\\" + textureFileName;
+    std::shared_ptr<PendingTexture> pending(new PendingTexture(textureFilePath, format));
+
+    if( !Texture::CanGenerateMipChain(textureFilePath, format) &&
+        FAILED(D3DX10CreateAsyncTextureProcessor(&m_device, &pending->m_loadInfo, &pending->m_processor)) )
+    {
+        std::string msg("Failed to create texture processor for file: ");
+        msg += textureFilePath;
+        throw Common::Exception(__FILE__, __LINE__, msg);
+    }
+
+    const ContentHash contentSeed = m_textureManager.GetContentSeed(format, true);
+
+    pending->m_decode      = m_threadPool.Submit(DecodeTask(pending->m_processor, textureFilePath, format, contentSeed));
+    m_pending[textureName] = pending;
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned TextureLoader::Update(const double budgetMilliseconds)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const Clock::time_point start      = Clock::now();
+    unsigned                numCreated = 0;
+
+    PendingMap::iterator it = m_pending.begin();
+
+    while( it != m_pending.end() )
+    {
+        if( numCreated > 0 )
+        {
+            const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+            if( elapsed.count() >= budgetMilliseconds )
+            {
+                break;
+            }
+        }
+
+        if( it->second->m_decode.wait_for(std::chrono::seconds(0)) != std::future_status::ready )
+        {
+            ++it;
+            continue;
+        }
+
+        CreateTexture(it->first, *it->second);
+        ++numCreated;
+
+        it = m_pending.erase(it);
+    }
+
+    return numCreated;
+}
+
+//------------------------------------------------------------------------------------------
+void TextureLoader::Finish()
+{
+    for(PendingMap::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+    {
+        CreateTexture(it->first, *it->second);
+    }
+
+    m_pending.clear();
+}
+
+//------------------------------------------------------------------------------------------
+const bool TextureLoader::IsPending(const std::string & textureName) const
+{
+    return m_pending.find(textureName) != m_pending.end();
+}
+
+//------------------------------------------------------------------------------------------
+const unsigned TextureLoader::GetNumPending() const
+{
+    return static_cast<unsigned>(m_pending.size());
+}
+
+//------------------------------------------------------------------------------------------
+void TextureLoader::CreateTexture(const std::string & textureName, PendingTexture & pending)
+{
+    DecodedTexture decoded;
+
+    try
+    {
+        decoded = pending.m_decode.get();
+    }
+    catch(...)
+    {
+        // Left for TextureManager::CreateTextureFromFile to report when the texture is used
+        return;
+    }
+
+    // Another request may have loaded the same name or the same contents in the meantime
+    if( m_textureManager.HasTexture(textureName) || m_textureManager.ShareTexture(textureName, decoded.m_contentHash) )
+    {
+        return;
+    }
+
+    if( decoded.m_ddsFile )
+    {
+        try
+        {
+            std::auto_ptr<Texture> texture(new Texture(m_device, decoded.m_ddsFile, pending.m_format, m_textureManager.IsStreaming()));
+            m_textureManager.AddTexture(textureName, decoded.m_contentHash, texture);
+        }
+        catch(Common::Exception &)
+        {
+            // Left for TextureManager::CreateTextureFromFile to report when the texture is used
+        }
+
+        return;
+    }
+
+    if( decoded.m_mipChain )
+    {
+        try
+        {
+            std::auto_ptr<Texture> texture(new Texture(m_device, *decoded.m_mipChain, pending.m_textureFilePath));
+            m_textureManager.AddTexture(textureName, decoded.m_contentHash, texture);
+        }
+        catch(Common::Exception &)
+        {
+            // Left for TextureManager::CreateTextureFromFile to report when the texture is used
+        }
+
+        return;
+    }
+
+    ID3D10Resource * resource = NULL;
+
+    if( FAILED(pending.m_processor->CreateDeviceObject(reinterpret_cast<void **>(&resource))) )
+    {
+        return;
+    }
+
+    try
+    {
+        std::auto_ptr<Texture> texture(new Texture(m_device, resource, pending.m_textureFilePath, pending.m_format));
+        m_textureManager.AddTexture(textureName, decoded.m_contentHash, texture);
+    }
+    catch(Common::Exception &)
+    {
+        // Left for TextureManager::CreateTextureFromFile to report when the texture is used
+    }
+}
@@ -0,0 +1,182 @@
+#ifndef TEXTURELOADER_H
+#define TEXTURELOADER_H
+
+// EngineX Includes
+#include "Core\ContentHash.h"
+#include "Core\ThreadPool.h"
+#include "Graphics\Textures\DDSFile.h"
+#include "Graphics\Textures\MipChain.h"
+#include "Graphics\Textures\TextureManager.h"
+
+// DirectX Includes
+#include <d3d10.h>
+#include <dxgi.h>
+#include <d3dx10.h>
+
+// Standard Includes
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+
+//------------------------------------------------------------------------------------------
+/**
+* Loads a batch of textures at once, decoding the image files on the worker threads of a thread pool
+*
+* Each file is read, hashed, and decoded by a D3DX10 texture processor on a worker thread, which does not use
+* the device. The D3D textures are created by Update or Finish, on the thread that owns the device, and are
+* added to the TextureManager under the name they were requested by. Requests for a name that is already
+* loaded or pending, and files whose contents match a texture that is already loaded, are not decoded twice.
+*
+* DDS files that Texture::CanCreateFromDDSFile accepts are only parsed on the worker thread, and their texture
+* is created straight from the mapped mip chain, without the processor. Their mip levels are streamed if the
+* texture manager has a streaming budget, as the loader is for the textures of models, whose PolygonSets report
+* how large they are drawn.
+*
+* Images that Texture::CanGenerateMipChain accepts, such as PNG and JPG files, are decoded by WIC into system
+* memory and get their mip levels from a MipChain, both on the worker thread, also without the processor. Only
+* their texture is created on the thread that owns the device.
+*
+* A texture that fails to load is simply not added. TextureManager::CreateTextureFromFile will then try to
+* load it again when it is used, and report the error there.
+**/
+class TextureLoader
+{
+public:
+
+   /**
+   * Constructor
+   *
+   * @param device         - D3D device the textures are created on
+   * @param textureManager - Where the textures are added once they are created
+   * @param threadPool     - Where the image files are decoded
+   **/
+   TextureLoader(ID3D10Device & device, TextureManager & textureManager, ThreadPool & threadPool);
+
+   /**
+   * Deconstructor
+   *
+   * Waits for the textures that are still being decoded, and discards them
+   **/
+   ~TextureLoader();
+
+
+   /**
+   * Starts loading a texture in the background, unless it is already loaded or pending
+   *
+   * @param textureName     - Name of the texture for the application to refer to
+   * @param textureFileName - Filename of the image file, in the texture manager's directory
+   * @param format          - Desired format to store the loaded texture in. By default, the format of the file
+   *                          is kept (see Texture).
+   *
+   * @throws BaseException - If the texture processor could not be created
+   **/
+   void Request(const std::string & textureName,
+                const std::string & textureFileName,
+                DXGI_FORMAT format = DXGI_FORMAT_FROM_FILE);
+
+   /**
+   * Creates the textures whose files have been decoded
+   *
+   * Textures are created one at a time until the budget is used up. At least one is created each call,
+   * if any are ready. Must be called on the thread that owns the device.
+   *
+   * @param budgetMilliseconds - Time, in milliseconds, that may be spent creating textures
+   * @return                   - Number of textures that were finished
+   **/
+   const unsigned Update(const double budgetMilliseconds);
+
+   /**
+   * Waits for every pending texture to be decoded and creates them all
+   *
+   * Must be called on the thread that owns the device.
+   **/
+   void Finish();
+
+   /**
+   * Query whether or not a texture that was requested is still being loaded
+   **/
+   const bool IsPending(const std::string & textureName) const;
+
+   /**
+   * Gets the number of textures that are still being loaded
+   **/
+   const unsigned GetNumPending() const;
+
+private:
+
+   /** No Copy allowed */
+   TextureLoader(const TextureLoader & rhs);
+
+   /** No assignment allowed */
+   TextureLoader & operator = (const TextureLoader & rhs);
+
+   /**
+   * What a worker thread made of an image file
+   **/
+   struct DecodedTexture
+   {
+      ContentHash         m_contentHash;   // Hash of the file, seeded by TextureManager::GetContentSeed
+      DDSFile::SharedPtr  m_ddsFile;       // The parsed file, if the texture can be created from it directly
+      MipChain::SharedPtr m_mipChain;      // The decoded image with its mip levels, if it got them from a MipChain. If neither is set, the processor holds the decoded image.
+   };
+
+   /**
+   * Reads, hashes, and decodes one image file on a worker thread
+   **/
+   class DecodeTask;
+
+   /**
+   * A texture that is being decoded
+   **/
+   struct PendingTexture
+   {
+      /**
+      * Constructor
+      **/
+      PendingTexture(const std::string & textureFilePath, DXGI_FORMAT format);
+
+      /**
+      * Deconstructor
+      *
+      * Destroys the processor. The decode must not be running anymore.
+      **/
+      ~PendingTexture();
+
+      std::string                 m_textureFilePath;   // Full path to the image file
+      DXGI_FORMAT                 m_format;            // Format the texture is stored in
+      D3DX10_IMAGE_LOAD_INFO      m_loadInfo;          // How the processor loads the image. Must outlive the processor.
+      ID3DX10DataProcessor *      m_processor;         // Decodes the image, and then creates the texture from it. NULL if it gets a MipChain instead.
+      std::future<DecodedTexture> m_decode;            // The decoded file, once the worker is done with it
+
+   private:
+
+      /** No Copy allowed */
+      PendingTexture(const PendingTexture & rhs);
+
+      /** No assignment allowed */
+      PendingTexture & operator = (const PendingTexture & rhs);
+   };
+
+   /**
+   * Creates the texture for a pending texture that has finished decoding and adds it to the texture manager
+   * Does nothing if decoding failed.
+   **/
+   void CreateTexture(const std::string & textureName, PendingTexture & pending);
+
+
+   ID3D10Device &   m_device;
+   TextureManager & m_textureManager;
+   ThreadPool &     m_threadPool;
+
+   /**
+   * Textures that are being loaded
+   *
+   * Key   - name the texture was requested by
+   * Value - the texture being decoded
+   **/
+   typedef std::map<std::string, std::shared_ptr<PendingTexture> > PendingMap;
+   PendingMap       m_pending;
+};
+
+#endif // TEXTURELOADER_H
@@ -5,11 +5,19 @@
 // Common Lib Includes
 #include "Exception.h"
 
+// Standard Includes
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <vector>
+
 //----------------------------------------------------------------------------
 TextureManager::TextureManager(ID3D10Device & device,  const std::string & textureDirectory)
     :
     m_device(device),
-    m_textureDirectory(textureDirectory)
+    m_textureDirectory(textureDirectory),
+    m_streamingBudget(0),
+    m_frame(1)
 {
 }
 
@@ -17,7 +25,9 @@ TextureManager::TextureManager(ID3D10Device & device,  const std::string & textu
 TextureManager::~TextureManager()
 {
     // Release all textures
-    for(TextureMap::iterator it = m_textures.begin(); it != m_textures.end(); ++it)
+    //
+    // Each is listed once by content, but may be listed by several names
+    for(ContentMap::iterator it = m_texturesByContent.begin(); it != m_texturesByContent.end(); ++it)
     {
         delete it->second;
     }
@@ -26,7 +36,8 @@ TextureManager::~TextureManager()
 //----------------------------------------------------------------------------
 Texture & TextureManager::CreateTextureFromFile(const std::string & textureName, 
                                                 const std::string & textureFileName, 
-                                                DXGI_FORMAT format)
+                                                DXGI_FORMAT format,
+                                                const bool streamed)
 {
     // Check if the texture already exists
     TextureMap::iterator it = m_textures.end();
@@ -41,20 +52,37 @@ Texture & TextureManager::CreateTextureFromFile(const std::string & textureName,
         return *(it->second);
     }
 
-    // Create the texture
+    // Check if a texture with the same contents already exists under another name
     Texture * texture = NULL;
     std::string textureFilePath = m_textureDirectory + "\\" + textureFileName;
+    ContentHash contentHash = 0;
+
+    try
+    {
+        contentHash = HashFileContent(textureFilePath, GetContentSeed(format, streamed));
+    }
+    catch(Common::Exception & e)
+    {
+        throw e;
+    }
 
+    if( ShareTexture(textureName, contentHash) )
+    {
+        return *(m_textures[textureName]);
+    }
+
+    // Create the texture
     try
     {
-        texture = new Texture(m_device, textureFilePath, format);
+        texture = new Texture(m_device, textureFilePath, format, streamed && IsStreaming());
     }
     catch(Common::Exception & e)
     {
         throw e;
     }
 
-    m_textures[textureName] = texture;
+    m_textures[textureName]          = texture;
+    m_texturesByContent[contentHash] = texture;
 
     return *texture;
 }
@@ -81,3 +109,306 @@ Texture & TextureManager::GetTexture(const std::string & textureName)
     return *(it->second);
 }
 
+//----------------------------------------------------------------------------
+const bool TextureManager::HasTexture(const std::string & textureName) const
+{
+    return m_textures.find(textureName) != m_textures.end();
+}
+
+//----------------------------------------------------------------------------
+Texture & TextureManager::AddTexture(const std::string & textureName, const ContentHash contentHash, std::auto_ptr<Texture> texture)
+{
+    // Keep the texture that already exists by that name or with those contents
+    TextureMap::iterator it = m_textures.find(textureName);
+
+    if( it != m_textures.end() )
+    {
+        return *(it->second);
+    }
+
+    if( ShareTexture(textureName, contentHash) )
+    {
+        return *(m_textures[textureName]);
+    }
+
+    // Store the given one
+    Texture * added = texture.release();
+
+    m_textures[textureName]          = added;
+    m_texturesByContent[contentHash] = added;
+
+    return *added;
+}
+
+//----------------------------------------------------------------------------
+const bool TextureManager::ShareTexture(const std::string & textureName, const ContentHash contentHash)
+{
+    ContentMap::iterator itContent = m_texturesByContent.find(contentHash);
+
+    if( itContent == m_texturesByContent.end() )
+    {
+        return false;
+    }
+
+    m_textures[textureName] = itContent->second;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+const ContentHash TextureManager::GetContentSeed(DXGI_FORMAT format, const bool streamed) const
+{
+    // A texture that is not streamed must not share one that is, or it would be drawn at whatever detail
+    // the other's users asked for
+    const ContentHash seed = static_cast<ContentHash>(format);
+
+    return (streamed && IsStreaming()) ? ~seed : seed;
+}
+
+//----------------------------------------------------------------------------
+const std::string & TextureManager::GetTextureDirectory() const
+{
+    return m_textureDirectory;
+}
+
+//----------------------------------------------------------------------------
+void TextureManager::GetTextureMemory(std::vector<TextureMemory> & report) const
+{
+    report.clear();
+
+    std::set<const Texture *> reported;
+
+    for(TextureMap::const_iterator it = m_textures.begin(); it != m_textures.end(); ++it)
+    {
+        const Texture & texture = *(it->second);
+
+        TextureMemory memory;
+        memory.m_textureName      = it->first;
+        memory.m_format           = texture.GetFormat();
+        memory.m_width            = texture.GetWidth();
+        memory.m_height           = texture.GetHeight();
+        memory.m_numMipLevels     = texture.GetNumMipLevels();
+        memory.m_residentMipLevel = texture.GetResidentMipLevel();
+        memory.m_residentBytes    = texture.GetResidentBytes();
+        memory.m_shared           = !reported.insert(&texture).second;
+
+        report.push_back(memory);
+    }
+}
+
+//----------------------------------------------------------------------------
+const unsigned TextureManager::GetResidentBytes() const
+{
+    unsigned residentBytes = 0;
+
+    for(ContentMap::const_iterator it = m_texturesByContent.begin(); it != m_texturesByContent.end(); ++it)
+    {
+        residentBytes += it->second->GetResidentBytes();
+    }
+
+    return residentBytes;
+}
+
+//----------------------------------------------------------------------------
+void TextureManager::SetStreamingBudget(const unsigned budgetBytes)
+{
+    m_streamingBudget = budgetBytes;
+}
+
+//----------------------------------------------------------------------------
+const unsigned TextureManager::GetStreamingBudget() const
+{
+    return m_streamingBudget;
+}
+
+//----------------------------------------------------------------------------
+const bool TextureManager::IsStreaming() const
+{
+    return m_streamingBudget > 0;
+}
+
+//----------------------------------------------------------------------------
+void TextureManager::RequestTextureDetail(const std::string & textureName, const float screenFraction)
+{
+    if( !IsStreaming() )
+    {
+        return;
+    }
+
+    TextureMap::const_iterator it = m_textures.find(textureName);
+
+    if( it == m_textures.end() || !it->second->IsStreamed() )
+    {
+        return;
+    }
+
+    TextureUse & use = m_uses[it->second];
+
+    if( use.m_lastUsedFrame != m_frame )
+    {
+        use.m_screenFraction = screenFraction;
+        use.m_lastUsedFrame  = m_frame;
+    }
+    else
+    {
+        use.m_screenFraction = std::max<float>(use.m_screenFraction, screenFraction);
+    }
+}
+
+//----------------------------------------------------------------------------
+const unsigned TextureManager::UpdateStreaming(const unsigned viewportHeight, const double budgetMilliseconds)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const Clock::time_point start       = Clock::now();
+    unsigned                numUpgraded = 0;
+
+    // Textures drawn in this frame that need more detail than is resident, the largest on screen first
+    std::vector<std::pair<float, Texture *> > upgrades;
+
+    for(ContentMap::const_iterator it = m_texturesByContent.begin(); it != m_texturesByContent.end(); ++it)
+    {
+        UseMap::const_iterator itUse = m_uses.find(it->second);
+
+        if( itUse != m_uses.end() && itUse->second.m_lastUsedFrame == m_frame && 
+            GetWantedMipLevel(*(it->second), viewportHeight) < it->second->GetResidentMipLevel() )
+        {
+            upgrades.push_back(std::make_pair(itUse->second.m_screenFraction, it->second));
+        }
+    }
+
+    std::sort(upgrades.begin(), upgrades.end());
+
+    for(std::vector<std::pair<float, Texture *> >::reverse_iterator it = upgrades.rbegin(); it != upgrades.rend(); ++it)
+    {
+        if( numUpgraded > 0 )
+        {
+            const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+            if( elapsed.count() >= budgetMilliseconds )
+            {
+                break;
+            }
+        }
+
+        // Settle for less detail than wanted, if that is all there is room for
+        Texture &      texture       = *(it->second);
+        const unsigned residentBytes = texture.GetResidentBytes();
+
+        for(unsigned mipLevel = GetWantedMipLevel(texture, viewportHeight); mipLevel < texture.GetResidentMipLevel(); ++mipLevel)
+        {
+            const unsigned nearest = texture.GetNearestResidentMipLevel(mipLevel);
+
+            if( !MakeRoom(texture.GetResidentBytes(nearest) - residentBytes, texture, viewportHeight) )
+            {
+                continue;
+            }
+
+            try
+            {
+                texture.SetResidentMipLevel(nearest);
+                ++numUpgraded;
+            }
+            catch(Common::Exception &)
+            {
+                // Stays as blurry as it was, and is tried again next frame
+            }
+
+            break;
+        }
+    }
+
+    ++m_frame;
+
+    return numUpgraded;
+}
+
+//----------------------------------------------------------------------------
+const unsigned TextureManager::GetWantedMipLevel(const Texture & texture, const unsigned viewportHeight) const
+{
+    UseMap::const_iterator it = m_uses.find(&texture);
+
+    if( it == m_uses.end() || it->second.m_lastUsedFrame != m_frame )
+    {
+        return texture.GetMaxResidentMipLevel();
+    }
+
+    // Least detailed mip level that still has at least one texel for each pixel it covers
+    const float    numPixels = it->second.m_screenFraction * viewportHeight;
+    const unsigned largest   = std::max<unsigned>(texture.GetWidth(), texture.GetHeight());
+    unsigned       mipLevel  = 0;
+
+    while( mipLevel < texture.GetMaxResidentMipLevel() && static_cast<float>(largest >> (mipLevel + 1)) >= numPixels )
+    {
+        ++mipLevel;
+    }
+
+    return mipLevel;
+}
+
+//----------------------------------------------------------------------------
+const bool TextureManager::MakeRoom(const unsigned numBytes, const Texture & keep, const unsigned viewportHeight)
+{
+    unsigned residentBytes = GetResidentBytes();
+
+    if( residentBytes + numBytes <= m_streamingBudget )
+    {
+        return true;
+    }
+
+    // Textures that can give up mip levels, least recently used first
+    std::vector<std::pair<unsigned, Texture *> > victims;
+    unsigned                                     freeableBytes = 0;
+
+    for(ContentMap::const_iterator it = m_texturesByContent.begin(); it != m_texturesByContent.end(); ++it)
+    {
+        Texture & texture = *(it->second);
+
+        if( &texture == &keep || !texture.IsStreamed() )
+        {
+            continue;
+        }
+
+        const unsigned mipLevel = texture.GetNearestResidentMipLevel(GetWantedMipLevel(texture, viewportHeight));
+
+        if( mipLevel <= texture.GetResidentMipLevel() )
+        {
+            continue;
+        }
+
+        UseMap::const_iterator itUse = m_uses.find(&texture);
+
+        victims.push_back(std::make_pair(itUse == m_uses.end() ? 0 : itUse->second.m_lastUsedFrame, &texture));
+        freeableBytes += texture.GetResidentBytes() - texture.GetResidentBytes(mipLevel);
+    }
+
+    if( residentBytes + numBytes > m_streamingBudget + freeableBytes )
+    {
+        return false;
+    }
+
+    std::sort(victims.begin(), victims.end());
+
+    for(std::vector<std::pair<unsigned, Texture *> >::iterator it = victims.begin(); it != victims.end(); ++it)
+    {
+        Texture &      texture = *(it->second);
+        const unsigned before  = texture.GetResidentBytes();
+
+        try
+        {
+            texture.SetResidentMipLevel(texture.GetNearestResidentMipLevel(GetWantedMipLevel(texture, viewportHeight)));
+        }
+        catch(Common::Exception &)
+        {
+            continue;
+        }
+
+        residentBytes -= before - texture.GetResidentBytes();
+
+        if( residentBytes + numBytes <= m_streamingBudget )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
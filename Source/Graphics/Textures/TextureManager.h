@@ -2,6 +2,7 @@
 #define TEXTUREMANAGER_H
 
 // EngineX Includes
+#include "Core\ContentHash.h"
 #include "Texture.h"
 
 // DirectX Includes
@@ -12,12 +13,29 @@
 // Standard Includes
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
 
 
 class TextureManager
 {
 public:
 
+   /**
+   * Video memory taken up by a texture, for reports
+   **/
+   struct TextureMemory
+   {
+      std::string m_textureName;        // Name the texture is stored under
+      DXGI_FORMAT m_format;             // Format the texture is stored in
+      unsigned    m_width;
+      unsigned    m_height;
+      unsigned    m_numMipLevels;
+      unsigned    m_residentMipLevel;   // Most detailed mip level in video memory, 0 unless the texture is streamed
+      unsigned    m_residentBytes;      // Bytes of video memory the texture takes up
+      bool        m_shared;             // Whether or not the texture is the same one as an earlier name in the report
+   };
+
    /**
    * Constructor
    *
@@ -38,16 +56,25 @@ public:
    * If an effect by the same name already exists, a new texture will not be created and a reference
    * to the old effect returned
    *
+   * If a texture was already created from a file with the same contents, in the same format, under another name,
+   * that texture is shared under this name as well, rather than loading another copy into video memory
+   *
    * @param textureName     - Name of the texture for the application to refer to
    * @param textureFileName - Filename of the image file that is the texture
-   * @param format          - Desired format to store the loaded texture in
+   * @param format          - Desired format to store the loaded texture in. By default, the format of the file
+   *                          is kept (see Texture).
+   * @param streamed        - Whether or not to stream the texture's mip levels, if a streaming budget is set
+   *                          (see SetStreamingBudget). Only textures whose size on screen is reported each frame
+   *                          they are drawn (see RequestTextureDetail) should be, or they stay at their least
+   *                          detailed mip levels.
    * @return Texture &      - reference to the created texture
    *
    * @throws BaseException - If texture creation fails
    */
    Texture & CreateTextureFromFile(const std::string & textureName, 
                                    const std::string & textureFileName, 
-                                   DXGI_FORMAT format = DXGI_FORMAT_R32G32B32A32_FLOAT);
+                                   DXGI_FORMAT format = DXGI_FORMAT_FROM_FILE,
+                                   const bool streamed = false);
 
    /**
    * Gets a loaded texture
@@ -58,10 +85,141 @@ public:
    */
    Texture & GetTexture(const std::string & textureName);
 
+   /**
+   * Query whether or not a texture by a name exists
+   **/
+   const bool HasTexture(const std::string & textureName) const;
+
+   /**
+   * Adds a texture that was created elsewhere, such as by a TextureLoader
+   *
+   * If a texture with the same contents already exists, the given texture is released and the existing one is
+   * shared under this name as well. If a texture by the same name already exists, the given texture is released.
+   *
+   * @param textureName - Name of the texture for the application to refer to
+   * @param contentHash - Hash of the contents of the file the texture was loaded from, seeded by GetContentSeed
+   * @param texture     - The texture. The manager takes ownership of it.
+   * @return Texture &  - reference to the texture stored under the name
+   */
+   Texture & AddTexture(const std::string & textureName, const ContentHash contentHash, std::auto_ptr<Texture> texture);
+
+   /**
+   * Shares a texture with the same contents as an existing one under another name
+   *
+   * @param textureName - Name of the texture for the application to refer to
+   * @param contentHash - Hash of the contents of the file the texture was loaded from, seeded by GetContentSeed
+   * @return bool       - true if the name refers to a texture after the call. false if no texture has those contents.
+   */
+   const bool ShareTexture(const std::string & textureName, const ContentHash contentHash);
+
+   /**
+   * Gets the seed to hash the contents of a texture file with, so that only textures loaded the same way are shared
+   *
+   * @param format   - Format the texture is stored in
+   * @param streamed - Whether or not the texture was asked to be streamed (see CreateTextureFromFile)
+   **/
+   const ContentHash GetContentSeed(DXGI_FORMAT format, const bool streamed) const;
+
+   /**
+   * Gets the directory that contains all texture files
+   */
+   const std::string & GetTextureDirectory() const;
+
+   /**
+   * Gets the video memory taken up by each texture, in order of their names
+   *
+   * @param report - OUT - One entry for each name. A texture shared under several names is marked as shared
+   *                       in all but the first of its entries.
+   **/
+   void GetTextureMemory(std::vector<TextureMemory> & report) const;
+
+   /**
+   * Gets the number of bytes of video memory taken up by all of the textures, counting shared textures once
+   **/
+   const unsigned GetResidentBytes() const;
+
+   /**
+   * Sets how much video memory textures may take up, and streams the textures created from now on that ask to be
+   *
+   * Streamed textures start with only their least detailed mip levels resident (see Texture). UpdateStreaming
+   * makes more of them resident for the textures that are drawn large enough on screen to need them, and takes
+   * them away from the textures that were used least recently when the budget would be exceeded. Textures that
+   * are not streamed count against the budget but are never changed. 0, the default, streams nothing.
+   *
+   * @param budgetBytes - Bytes of video memory all of the textures may take up
+   **/
+   void SetStreamingBudget(const unsigned budgetBytes);
+
+   /**
+   * Gets how much video memory textures may take up, or 0 if textures are not streamed
+   **/
+   const unsigned GetStreamingBudget() const;
+
+   /**
+   * Query whether or not textures created from now on that ask to be streamed are
+   **/
+   const bool IsStreaming() const;
+
+   /**
+   * Tells the manager that a texture is being drawn, and how large
+   *
+   * Called for each texture of each object that is drawn, such as by Effect::RequestTextureDetail.
+   * The largest size requested since the last call to UpdateStreaming is the one that counts.
+   * Does nothing if textures are not streamed or no texture by the name exists.
+   *
+   * @param textureName    - Name of the texture
+   * @param screenFraction - Fraction of the viewport height the texture is stretched across. Anything of 1 or more
+   *                         asks for all of its detail.
+   **/
+   void RequestTextureDetail(const std::string & textureName, const float screenFraction);
+
+   /**
+   * Changes which mip levels of the streamed textures are resident, from the sizes requested since the last call
+   *
+   * The textures that are drawn the largest are made more detailed first. Textures are changed one at a time
+   * until the time budget is used up. At least one is changed each call, if any need to be. Must be called on 
+   * the thread that owns the device, once a frame, after the frame is drawn.
+   *
+   * @param viewportHeight     - Height of the viewport, in pixels, that the textures were drawn to
+   * @param budgetMilliseconds - Time, in milliseconds, that may be spent creating textures again
+   * @return                   - Number of textures that were made more detailed
+   **/
+   const unsigned UpdateStreaming(const unsigned viewportHeight, const double budgetMilliseconds);
+
 protected:
 
 private:
 
+   /**
+   * How a streamed texture was drawn
+   **/
+   struct TextureUse
+   {
+      float    m_screenFraction;   // Largest fraction of the viewport height it was stretched across in the last frame it was used
+      unsigned m_lastUsedFrame;    // Last frame it was drawn in
+   };
+
+   /**
+   * Gets the least detailed mip level of a streamed texture that is still as large as it was drawn in the current frame
+   * or, if it was not drawn in the current frame, the least detailed one that it keeps resident
+   **/
+   const unsigned GetWantedMipLevel(const Texture & texture, const unsigned viewportHeight) const;
+
+   /**
+   * Takes mip levels away from other streamed textures, until there is room in the budget for more bytes
+   *
+   * The textures that were used least recently lose theirs first. Those that were used in the current frame 
+   * only lose the ones they do not need at the size they were drawn. Nothing is taken away unless the room
+   * can be made.
+   *
+   * @param numBytes       - Bytes that need to fit in the budget
+   * @param keep           - Texture the room is made for, which is left alone
+   * @param viewportHeight - Height of the viewport, in pixels, that the textures were drawn to
+   * @return               - Whether or not there is room
+   **/
+   const bool MakeRoom(const unsigned numBytes, const Texture & keep, const unsigned viewportHeight);
+
+
    ID3D10Device & m_device;
    std::string    m_textureDirectory;
 
@@ -73,6 +231,27 @@ private:
    **/
    typedef std::map<std::string, Texture *> TextureMap;
    TextureMap m_textures;
+
+   /**
+   * Textures, one entry per texture actually created
+   *
+   * Key   - hash of the contents of the file the texture was loaded from, and of its format
+   * Value - pointer to the texture object, which may be in m_textures under several names
+   **/
+   typedef std::map<ContentHash, Texture *> ContentMap;
+   ContentMap m_texturesByContent;
+
+   unsigned   m_streamingBudget;   // Bytes of video memory textures may take up, or 0 if textures are not streamed
+   unsigned   m_frame;             // Frame that the textures are being drawn in, counted by UpdateStreaming
+
+   /**
+   * How each streamed texture that was drawn was drawn
+   *
+   * Key   - pointer to the texture object, which may be in m_textures under several names
+   * Value - how it was drawn
+   **/
+   typedef std::map<const Texture *, TextureUse> UseMap;
+   UseMap     m_uses;
 };
 
 
@@ -2,9 +2,6 @@
 
 #include "SectorBackground.h"
 
-// EngineX Includes
-#include "Graphics\3D\Shapes.h"
-
 // Common Lib Includes
 #include "Exception.h"
 #include "StringUtility.h"
@@ -15,6 +12,7 @@ SectorBackground::SectorBackground(ID3D10Device & device,
                                    TextureManager & textureManager,
                                    EffectManager & effectManager,
                                    RenderQueue & renderQueue,
+                                   ShapeCache & shapeCache,
                                    const std::string & nebulaFilename,
                                    const std::string & starsFilename,
                                    const std::string & flareGlowFilename,
@@ -38,30 +36,13 @@ SectorBackground::SectorBackground(ID3D10Device & device,
     // Create graphic objects
     //
 
-    // Create the nebula
-    std::vector<Position>   positions;
-    std::vector<TexCoord2D> texCoords;
-    std::vector<Normal>     normals;
-    std::vector<Index>      indices;
-
-    GenerateSphere(positions, texCoords, normals, indices, 1.0f, 128, true);
-
+    // Create the nebula, from the sphere shared by everything else drawn with one
     std::vector<Buffer::SharedPtr> buffers;
-   
-    Buffer::SharedPtr bufPositions(new Buffer(m_device, POSITION, positions));
-    buffers.push_back(bufPositions);
-
-    Buffer::SharedPtr bufTexCoords(new Buffer(m_device, TEXCOORD2D, texCoords));
-    buffers.push_back(bufTexCoords);
-
-    Buffer::SharedPtr bufNormals(new Buffer(m_device, NORMAL, normals));
-    buffers.push_back(bufNormals);
-
-    Buffer::SharedPtr bufIndices(new Buffer(m_device, INDEX, indices));
-    buffers.push_back(bufIndices);
 
     try
     {     
+        shapeCache.GetSphere(1.0f, 128, true, buffers);
+
         m_nebula = new PolygonSet(m_device, m_effectManager, m_inputLayoutManager);
         m_nebula->SetBuffers(buffers, D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
       
@@ -9,6 +9,7 @@
 #include "Graphics\3D\LensFlare.h"
 #include "Graphics\Lights\AmbientLight.h"
 #include "Graphics\3D\RenderQueue.h"
+#include "Graphics\3D\ShapeCache.h"
 
 // DirectX Includes
 #include <d3d10.h>
@@ -31,6 +32,7 @@ public:
                     TextureManager & textureManager,
                     EffectManager & effectManager,
                     RenderQueue & renderQueue,
+                    ShapeCache & shapeCache,
                     const std::string & nebulaFilename,
                     const std::string & starsFilename,
                     const std::string & flareGlowFilename,
@@ -3,6 +3,7 @@
 #include "TestApp.h"
 
 // EngineX Includes
+#include "Graphics\3D\ModelLoader.h"
 #include "Graphics\3D\PolygonSetParser.h"
 #include "Graphics\3D\Shapes.h"
 
@@ -62,6 +63,9 @@ void TestApp::Init(HINSTANCE instance, const DisplayMode & displayMode)
 //----------------------------------------------------------------------------
 void TestApp::InitResources()
 {
+   // Stream the mip levels of the model textures, so that all of the textures fit in a fixed amount of video memory
+   m_textureManager->SetStreamingBudget(32 * 1024 * 1024);
+
    // Create a camera
    RECT rect;
    GetClientRect(m_hwnd, &rect);
@@ -79,7 +83,6 @@ void TestApp::InitResources()
 
    //-----
    // Create geometry to render
-   std::string modelFilePath;
 
    // Create the sector background
    try
@@ -89,6 +92,7 @@ void TestApp::InitResources()
                                                 *m_textureManager, 
                                                 *m_effectManager,
                                                 *m_renderQueue,
+                                                *m_shapeCache,
                                                 "nebula_bluedistance.dds",
                                                 "nebula_bluedistance_stars_blue_diff_alpha.dds",
                                                 "glow.png",
@@ -102,15 +106,29 @@ void TestApp::InitResources()
       throw e;
    }
 
-   // Ship
-   modelFilePath = m_modelDirectory + "\\Argon_M3.dat";
+   // Models
+   //
+   // The files are parsed in parallel on the worker threads
+   std::vector<std::string> modelFilePaths;
+   modelFilePaths.push_back(m_modelDirectory + "\\Argon_M3.dat");
+   modelFilePaths.push_back(m_modelDirectory + "\\asteroid_A_ClassMine.dat");
+
+   ModelLoader modelLoader(*m_device, *m_inputLayoutManager, *m_textureManager, *m_effectManager, *m_threadPool);
+   modelLoader.SetBufferCache(m_bufferCache);
 
    try
    {
-      PolygonSetParser parser(*m_device, *m_inputLayoutManager, *m_textureManager, *m_effectManager);
-      
-      parser.ParseFile(modelFilePath, false);
-      m_ship = parser.GetPolygonSet(0).release();
+      modelLoader.LoadFiles(modelFilePaths);
+   }
+   catch(BaseException & e)
+   {
+      throw e;
+   }
+
+   // Ship
+   try
+   {
+      m_ship = modelLoader.GetPolygonSet(0, 0).release();
       
       // I think it looked better without the specular map
       Material material = m_ship->GetMaterial();
@@ -126,14 +144,9 @@ void TestApp::InitResources()
    }
 
    // Asteroid
-   modelFilePath = m_modelDirectory + "\\asteroid_A_ClassMine.dat";
-
    try
    {
-      PolygonSetParser parser(*m_device, *m_inputLayoutManager, *m_textureManager, *m_effectManager);
-      
-      parser.ParseFile(modelFilePath, false);
-      m_asteroid = parser.GetPolygonSet(0).release();
+      m_asteroid = modelLoader.GetPolygonSet(1, 0).release();
       
       // I think it looked better without the specular map
 //    Material material = m_asteroid->GetMaterial();
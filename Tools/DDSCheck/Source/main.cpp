@@ -0,0 +1,220 @@
+
+//----------------------------------------------------------------------------------------------------------------------
+// DDSCheck
+//
+// Checks that the DDS files the sample scene ships with are read as they should be, without a device, so that it
+// runs on any platform (see Makefile). For each file it checks:
+//
+//    Format, size and number of mip levels
+//    Row pitch of the most detailed mip level
+//    Where the second and the last mip level start, and that the last one ends where the file does
+//    That every mip level starts where the one before it ends
+//    That the file, cut short by a byte, or with a corrupt magic number, throws
+//
+// Usage:
+//
+//    DDSCheck [<directory>]
+//
+// The directory defaults to the sample scene's textures, relative to this tool's directory. Prints a line for each
+// file and returns 0 if every check passed, 1 otherwise.
+//
+
+// EngineX Includes
+//
+// Included from their own directories, so that this builds without the rest of the engine
+#include "DDSLayout.h"
+#include "MappedFile.h"
+
+// Standard Includes
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+namespace
+{
+   const std::string DEFAULT_DIRECTORY = "../../Tests/0001_SpaceScene/Resources/Textures";
+
+   // DXGI_FORMAT values the shipped files are in
+   const unsigned FORMAT_BC1_UNORM      = 71;
+   const unsigned FORMAT_BC2_UNORM      = 74;
+   const unsigned FORMAT_BC3_UNORM      = 77;
+   const unsigned FORMAT_B8G8R8X8_UNORM = 88;
+
+   /**
+   * What a shipped file is known to hold, worked out from its header by hand
+   **/
+   struct ExpectedFile
+   {
+      const char * m_name;
+      unsigned     m_format;
+      unsigned     m_width;
+      unsigned     m_height;
+      unsigned     m_numMipLevels;
+      unsigned     m_rowPitch;          // Of the most detailed mip level
+      size_t       m_secondMipOffset;   // 0 if there is only one mip level
+      size_t       m_lastMipOffset;
+   };
+
+   const ExpectedFile EXPECTED_FILES[] =
+   {
+      { "Cube.dds",                                        FORMAT_B8G8R8X8_UNORM,  768,  128,  1, 3072,       0,     128 },
+      { "argon_M3_diff.dds",                               FORMAT_BC1_UNORM,      1024, 1024, 11, 2048,  524416,  699184 },
+      { "argon_M3_emis.dds",                               FORMAT_BC3_UNORM,      1024, 1024, 11, 4096, 1048704, 1398240 },
+      { "argon_M3_light.dds",                              FORMAT_BC3_UNORM,      1024, 1024, 11, 4096, 1048704, 1398240 },
+      { "argon_M3_spec.dds",                               FORMAT_BC1_UNORM,      2048, 2048, 12, 4096, 2097280, 2796336 },
+      { "asteroids_02_diff.dds",                           FORMAT_BC1_UNORM,      1024, 1024, 11, 2048,  524416,  699184 },
+      { "asteroids_02_spec.dds",                           FORMAT_BC1_UNORM,      1024, 1024, 11, 2048,  524416,  699184 },
+      { "fighterexp_1_diff.dds",                           FORMAT_BC3_UNORM,      1024, 1024, 11, 4096, 1048704, 1398240 },
+      { "nebula_bluedistance_background_part_01_diff.dds", FORMAT_BC1_UNORM,      2048, 1024,  1, 4096,       0,     128 },
+      { "nebula_bluedistance_background_part_02_diff.dds", FORMAT_BC1_UNORM,      2048, 1024,  1, 4096,       0,     128 },
+      { "nebula_bluedistance_background_part_03_diff.dds", FORMAT_BC1_UNORM,      2048, 1024,  1, 4096,       0,     128 },
+      { "nebula_bluedistance_background_part_04_diff.dds", FORMAT_BC1_UNORM,      2048, 1024,  1, 4096,       0,     128 },
+      { "nebula_bluedistance_stars_blue_diff.dds",         FORMAT_BC1_UNORM,      1024, 1024, 11, 2048,  524416,  699184 },
+      { "nebula_bluedistance_stars_blue_diff_alpha.dds",   FORMAT_BC2_UNORM,      1024, 1024,  1, 4096,       0,     128 }
+   };
+
+   const unsigned NUM_EXPECTED_FILES = sizeof(EXPECTED_FILES) / sizeof(EXPECTED_FILES[0]);
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Records a failed check
+   **/
+   template<typename T>
+   void Expect(const std::string & what, const T & actual, const T & expected, std::vector<std::string> & failures)
+   {
+      if( actual != expected )
+      {
+         std::ostringstream failure;
+         failure << what << " is " << actual << ", expected " << expected;
+         failures.push_back(failure.str());
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Query whether or not reading a layout from data throws
+   **/
+   const bool Throws(const unsigned char * data, const size_t size, const std::string & filePath)
+   {
+      try
+      {
+         DDSLayout layout;
+         ReadDDSLayout(data, size, filePath, layout);
+      }
+      catch(std::exception &)
+      {
+         return true;
+      }
+
+      return false;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Checks one file against what it is known to hold
+   *
+   * @return - Whether or not every check passed. If not, prints why.
+   **/
+   const bool CheckFile(const std::string & directory, const ExpectedFile & expected)
+   {
+      const std::string        filePath = directory + "/" + expected.m_name;
+      std::vector<std::string> failures;
+
+      try
+      {
+         const MappedFile file(filePath);
+         DDSLayout        layout;
+
+         ReadDDSLayout(file.GetData(), file.GetSize(), filePath, layout);
+
+         Expect("Dimension",    layout.m_dimension,           DDS_DIMENSION_TEXTURE2D,                       failures);
+         Expect("Format",       layout.m_format,              expected.m_format,                             failures);
+         Expect("Width",        layout.m_width,               expected.m_width,                              failures);
+         Expect("Height",       layout.m_height,              expected.m_height,                             failures);
+         Expect("Depth",        layout.m_depth,               1u,                                            failures);
+         Expect("Array size",   layout.m_arraySize,           1u,                                            failures);
+         Expect("Mip levels",   layout.m_numMipLevels,        expected.m_numMipLevels,                       failures);
+         Expect("Subresources", layout.m_subresources.size(), static_cast<size_t>(expected.m_numMipLevels), failures);
+
+         if( failures.empty() )
+         {
+            const DDSSubresource & first = layout.GetSubresource(0, 0);
+            const DDSSubresource & last  = layout.GetSubresource(layout.m_numMipLevels - 1, 0);
+
+            Expect("Row pitch",           first.m_rowPitch,            expected.m_rowPitch,      failures);
+            Expect("Last mip offset",     last.m_offset,               expected.m_lastMipOffset, failures);
+            Expect("End of the last mip", last.m_offset + last.m_size, file.GetSize(),           failures);
+
+            if( layout.m_numMipLevels > 1 )
+            {
+               Expect("Second mip offset", layout.GetSubresource(1, 0).m_offset, expected.m_secondMipOffset, failures);
+            }
+
+            for(unsigned level = 1; level < layout.m_numMipLevels; ++level)
+            {
+               const DDSSubresource & previous = layout.GetSubresource(level - 1, 0);
+
+               std::ostringstream what;
+               what << "Offset of mip " << level;
+               Expect(what.str(), layout.GetSubresource(level, 0).m_offset, previous.m_offset + previous.m_size, failures);
+            }
+
+            // Corrupt copies of the file
+            if( !Throws(file.GetData(), file.GetSize() - 1, filePath) )
+            {
+               failures.push_back("Reading the file without its last byte did not throw");
+            }
+
+            std::vector<unsigned char> corrupt(file.GetData(), file.GetData() + file.GetSize());
+            corrupt[0] = 'X';
+
+            if( !Throws(&corrupt[0], corrupt.size(), filePath) )
+            {
+               failures.push_back("Reading the file with a corrupt magic number did not throw");
+            }
+         }
+      }
+      catch(std::exception & e)
+      {
+         failures.push_back(e.what());
+      }
+      catch(...)
+      {
+         failures.push_back("Unknown error");
+      }
+
+      std::cout << (failures.empty() ? "PASS " : "FAIL ") << expected.m_name << "\n";
+
+      for(std::vector<std::string>::const_iterator it = failures.begin(); it != failures.end(); ++it)
+      {
+         std::cout << "   " << *it << "\n";
+      }
+
+      return failures.empty();
+   }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+int main(int argc, char * argv[])
+{
+   if( argc > 2 )
+   {
+      std::cerr << "Usage: DDSCheck [<directory>]\n";
+      return 1;
+   }
+
+   const std::string directory = argc == 2 ? argv[1] : DEFAULT_DIRECTORY;
+
+   // Check every file, even after one fails, so that one run covers them all
+   bool passedAll = true;
+
+   for(unsigned i = 0; i < NUM_EXPECTED_FILES; ++i)
+   {
+      passedAll = CheckFile(directory, EXPECTED_FILES[i]) && passedAll;
+   }
+
+   return passedAll ? 0 : 1;
+}
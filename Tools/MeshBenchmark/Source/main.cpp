@@ -0,0 +1,456 @@
+
+//----------------------------------------------------------------------------------------------------------------------
+// MeshBenchmark
+//
+// Times the parts of importing meshes whose speed has been quoted, so that the numbers can be reproduced. Runs without
+// a device. It times:
+//
+//    Tangent frame generation (see TangentFrames.h) on a flat grid of quads, about a million triangles by default.
+//    The frames are checked to be unit length and perpendicular to the normals, so that a broken generator is not
+//    reported as a fast one.
+//    Text mesh import (see TextMeshParser.h), including weld and optimize, of a file made of copies of a text mesh,
+//    30 copies of the sample scene's fighter by default. Each copy is checked to import as the original does.
+//
+// Each is run as many times as given, 10 by default, and the best and mean times are reported.
+//
+// Usage:
+//
+//    MeshBenchmark [-grid <quads per side>] [-copies <count>] [-repeat <count>] [<text mesh>]
+//
+// The text mesh defaults to the sample scene's fighter, relative to this tool's directory. The copies are written to
+// the working directory while they are timed.
+//
+// Prints a line for each benchmark and returns 0 if every one ran and checked out, 1 otherwise.
+//
+
+// EngineX Includes
+#include "Graphics\3D\TangentFrames.h"
+#include "Graphics\3D\TextMeshParser.h"
+
+// Standard Includes
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+namespace
+{
+   // 708 x 708 quads is just over a million triangles
+   const unsigned DEFAULT_GRID_SIZE = 708;
+   const unsigned DEFAULT_REPEAT    = 10;
+
+   const std::string DEFAULT_TEXT_MESH = "../../Tests/0001_SpaceScene/Resources/Models/argonM3.txt";
+   const unsigned    DEFAULT_COPIES    = 30;
+
+   // Where the copies of the text mesh are written while they are timed
+   const std::string COPIES_FILE = "MeshBenchmark_copies.txt";
+
+   const double BYTES_PER_MEGABYTE = 1000000.0;
+
+   // How far a generated frame may stray from unit length, or from perpendicular to its normal
+   const float FRAME_TOLERANCE = 0.001f;
+
+   typedef std::chrono::steady_clock Clock;
+
+   /**
+   * How long something took over several runs, in milliseconds
+   **/
+   struct Timing
+   {
+      Timing()
+         :
+         m_best(0.0),
+         m_mean(0.0)
+      {
+      }
+
+      double m_best;
+      double m_mean;
+   };
+
+   /**
+   * Generates the tangent frames of a mesh, for timing
+   **/
+   struct TangentFramesTask
+   {
+      TangentFramesTask(const std::vector<Position> & positions,
+                        const std::vector<TexCoord2D> & texCoords,
+                        const std::vector<Normal> & normals,
+                        const std::vector<Index> & indices,
+                        std::vector<Tangent> & tangents,
+                        std::vector<BiTangent> & biTangents)
+         :
+         m_positions(positions),
+         m_texCoords(texCoords),
+         m_normals(normals),
+         m_indices(indices),
+         m_tangents(tangents),
+         m_biTangents(biTangents)
+      {
+      }
+
+      void operator()() const
+      {
+         GenerateTangentFrames(m_positions, m_texCoords, m_normals, m_indices, m_tangents, m_biTangents);
+      }
+
+      const std::vector<Position> &   m_positions;
+      const std::vector<TexCoord2D> & m_texCoords;
+      const std::vector<Normal> &     m_normals;
+      const std::vector<Index> &      m_indices;
+      std::vector<Tangent> &          m_tangents;
+      std::vector<BiTangent> &        m_biTangents;
+   };
+
+   /**
+   * Imports a text mesh, for timing
+   **/
+   struct TextMeshTask
+   {
+      TextMeshTask(const std::string & filepath, std::vector<PolygonSetData> & polygonSets)
+         :
+         m_filepath(filepath),
+         m_polygonSets(polygonSets)
+      {
+      }
+
+      void operator()() const
+      {
+         m_polygonSets.clear();
+         ParseTextMesh(m_filepath, m_polygonSets);
+      }
+
+      const std::string &           m_filepath;
+      std::vector<PolygonSetData> & m_polygonSets;
+   };
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Runs something a number of times and measures how long each run takes
+   *
+   * @param run    - What to time, called with no arguments (see TangentFramesTask and TextMeshTask)
+   * @param repeat - How many times to run it, at least once
+   **/
+   template<typename Function>
+   const Timing Time(Function run, const unsigned repeat)
+   {
+      Timing timing;
+      double total = 0.0;
+
+      for(unsigned i = 0; i < repeat; ++i)
+      {
+         const Clock::time_point start = Clock::now();
+         run();
+         const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+         timing.m_best = (i == 0 || elapsed.count() < timing.m_best) ? elapsed.count() : timing.m_best;
+         total        += elapsed.count();
+      }
+
+      timing.m_mean = total / repeat;
+      return timing;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Prints whether or not a benchmark ran and checked out, and why not
+   **/
+   void WriteResult(const std::string & name, const std::vector<std::string> & failures)
+   {
+      std::cout << (failures.empty() ? "PASS " : "FAIL ") << name << "\n";
+
+      for(std::vector<std::string>::const_iterator it = failures.begin(); it != failures.end(); ++it)
+      {
+         std::cout << "   " << *it << "\n";
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Makes a flat grid of quads in the XZ plane, facing up, with the texture stretched once across it
+   *
+   * @param size - Number of quads along each side
+   **/
+   void MakeGrid(const unsigned size,
+                 std::vector<Position> & positions,
+                 std::vector<TexCoord2D> & texCoords,
+                 std::vector<Normal> & normals,
+                 std::vector<Index> & indices)
+   {
+      const unsigned rowSize = size + 1;
+
+      positions.clear();
+      texCoords.clear();
+      normals.clear();
+      indices.clear();
+
+      positions.reserve(rowSize * rowSize);
+      texCoords.reserve(rowSize * rowSize);
+      normals.reserve(rowSize * rowSize);
+      indices.reserve(size * size * 6);
+
+      for(unsigned z = 0; z < rowSize; ++z)
+      {
+         for(unsigned x = 0; x < rowSize; ++x)
+         {
+            positions.push_back(Position(static_cast<float>(x), 0.0f, static_cast<float>(z)));
+            texCoords.push_back(TexCoord2D(static_cast<float>(x) / size, 1.0f - static_cast<float>(z) / size));
+            normals.push_back(Normal(0.0f, 1.0f, 0.0f));
+         }
+      }
+
+      // Clockwise seen from above, as the engine winds front faces
+      for(unsigned z = 0; z < size; ++z)
+      {
+         for(unsigned x = 0; x < size; ++x)
+         {
+            const Index corner = z * rowSize + x;
+
+            indices.push_back(corner);
+            indices.push_back(corner + rowSize);
+            indices.push_back(corner + 1);
+
+            indices.push_back(corner + 1);
+            indices.push_back(corner + rowSize);
+            indices.push_back(corner + rowSize + 1);
+         }
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Times tangent frame generation on a grid
+   *
+   * @return - Whether or not it ran and every frame checked out. If not, prints why.
+   **/
+   const bool BenchmarkTangentFrames(const unsigned gridSize, const unsigned repeat)
+   {
+      std::vector<std::string> failures;
+      std::vector<Position>    positions;
+      std::vector<TexCoord2D>  texCoords;
+      std::vector<Normal>      normals;
+      std::vector<Index>       indices;
+      std::vector<Tangent>     tangents;
+      std::vector<BiTangent>   biTangents;
+      Timing                   timing;
+
+      try
+      {
+         MakeGrid(gridSize, positions, texCoords, normals, indices);
+
+         timing = Time(TangentFramesTask(positions, texCoords, normals, indices, tangents, biTangents), repeat);
+
+         for(size_t i = 0; i < positions.size(); ++i)
+         {
+            if( std::fabs(D3DXVec3Length(&tangents[i]) - 1.0f)   > FRAME_TOLERANCE ||
+                std::fabs(D3DXVec3Length(&biTangents[i]) - 1.0f) > FRAME_TOLERANCE ||
+                std::fabs(D3DXVec3Dot(&tangents[i], &normals[i])) > FRAME_TOLERANCE )
+            {
+               std::ostringstream failure;
+               failure << "Vertex " << i << " has a tangent frame that is not unit length and perpendicular to its normal";
+               failures.push_back(failure.str());
+               break;
+            }
+         }
+      }
+      catch(std::exception & e)
+      {
+         failures.push_back(e.what());
+      }
+      catch(...)
+      {
+         failures.push_back("Unknown error");
+      }
+
+      WriteResult("Tangent frames", failures);
+
+      if( failures.empty() )
+      {
+         const double numTriangles = static_cast<double>(indices.size() / 3);
+
+         std::cout << "   " << indices.size() / 3 << " triangles, " << positions.size() << " vertices\n"
+                   << "   Best " << timing.m_best << " ms, mean " << timing.m_mean << " ms, "
+                   << timing.m_best * 1000000.0 / numTriangles << " ms per million triangles\n";
+      }
+
+      return failures.empty();
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Writes a file made of copies of another
+   *
+   * @throws std::runtime_error - If either file could not be read or written
+   **/
+   void WriteCopies(const std::string & sourcePath, const std::string & copiesPath, const unsigned copies)
+   {
+      std::ifstream      source(sourcePath.c_str(), std::ios::binary);
+      std::ostringstream contents;
+
+      if( !source || !(contents << source.rdbuf()) )
+      {
+         throw std::runtime_error("Could not read " + sourcePath);
+      }
+
+      // Each copy must start on a line of its own
+      std::string copy = contents.str();
+
+      if( !copy.empty() && copy[copy.size() - 1] != '\n' )
+      {
+         copy += '\n';
+      }
+
+      std::ofstream file(copiesPath.c_str(), std::ios::binary | std::ios::trunc);
+
+      for(unsigned i = 0; i < copies && file; ++i)
+      {
+         file.write(copy.data(), copy.size());
+      }
+
+      if( !file )
+      {
+         throw std::runtime_error("Could not write " + copiesPath);
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Times importing a file made of copies of a text mesh
+   *
+   * @return - Whether or not it ran and every copy imported as the original does. If not, prints why.
+   **/
+   const bool BenchmarkTextMesh(const std::string & filepath, const unsigned copies, const unsigned repeat)
+   {
+      std::vector<std::string> failures;
+      Timing                   timing;
+      double                   fileSize       = 0.0;
+      size_t                   numPolygonSets = 0;
+
+      try
+      {
+         std::vector<PolygonSetData> original;
+         std::vector<PolygonSetData> polygonSets;
+
+         ParseTextMesh(filepath, original);
+         WriteCopies(filepath, COPIES_FILE, copies);
+
+         timing = Time(TextMeshTask(COPIES_FILE, polygonSets), repeat);
+
+         std::ifstream file(COPIES_FILE.c_str(), std::ios::binary | std::ios::ate);
+         fileSize       = static_cast<double>(file.tellg());
+         numPolygonSets = polygonSets.size();
+
+         if( polygonSets.size() != original.size() * copies )
+         {
+            std::ostringstream failure;
+            failure << "Imported " << polygonSets.size() << " polygon sets, expected " << original.size() * copies;
+            failures.push_back(failure.str());
+         }
+         else
+         {
+            for(size_t i = 0; i < polygonSets.size(); ++i)
+            {
+               const PolygonSetData & expected = original[i % original.size()];
+
+               if( polygonSets[i].m_numVertices != expected.m_numVertices || polygonSets[i].m_numIndices != expected.m_numIndices )
+               {
+                  std::ostringstream failure;
+                  failure << "Polygon set " << i << " has " << polygonSets[i].m_numVertices << " vertices and "
+                          << polygonSets[i].m_numIndices << " indices, expected " << expected.m_numVertices << " and "
+                          << expected.m_numIndices;
+                  failures.push_back(failure.str());
+                  break;
+               }
+            }
+         }
+      }
+      catch(std::exception & e)
+      {
+         failures.push_back(e.what());
+      }
+      catch(...)
+      {
+         failures.push_back("Unknown error");
+      }
+
+      std::remove(COPIES_FILE.c_str());
+
+      WriteResult("Text mesh", failures);
+
+      if( failures.empty() )
+      {
+         std::cout << "   " << copies << " copies of " << filepath << ", " << fileSize / BYTES_PER_MEGABYTE << " MB, "
+                   << numPolygonSets << " polygon sets, " << std::thread::hardware_concurrency() << " hardware threads\n"
+                   << "   Best " << timing.m_best << " ms, mean " << timing.m_mean << " ms, "
+                   << fileSize / BYTES_PER_MEGABYTE / (timing.m_best / 1000.0) << " MB/s\n";
+      }
+
+      return failures.empty();
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Writes how to use the tool
+   **/
+   void WriteUsage()
+   {
+      std::cerr << "Usage: MeshBenchmark [-grid <quads per side>] [-copies <count>] [-repeat <count>] [<text mesh>]\n";
+   }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+int main(int argc, char * argv[])
+{
+   std::string textMesh = DEFAULT_TEXT_MESH;
+   unsigned    gridSize = DEFAULT_GRID_SIZE;
+   unsigned    copies   = DEFAULT_COPIES;
+   unsigned    repeat   = DEFAULT_REPEAT;
+
+   for(int i = 1; i < argc; ++i)
+   {
+      const std::string argument(argv[i]);
+
+      if( argument == "-grid" && i + 1 < argc )
+      {
+         gridSize = static_cast<unsigned>(std::atoi(argv[++i]));
+      }
+      else if( argument == "-copies" && i + 1 < argc )
+      {
+         copies = static_cast<unsigned>(std::atoi(argv[++i]));
+      }
+      else if( argument == "-repeat" && i + 1 < argc )
+      {
+         repeat = static_cast<unsigned>(std::atoi(argv[++i]));
+      }
+      else if( !argument.empty() && argument[0] == '-' )
+      {
+         WriteUsage();
+         return 1;
+      }
+      else
+      {
+         textMesh = argument;
+      }
+   }
+
+   if( gridSize == 0 || copies == 0 || repeat == 0 )
+   {
+      WriteUsage();
+      return 1;
+   }
+
+   // Run every benchmark, even after one fails, so that one run covers them all
+   bool passedAll = BenchmarkTangentFrames(gridSize, repeat);
+   passedAll      = BenchmarkTextMesh(textMesh, copies, repeat) && passedAll;
+
+   return passedAll ? 0 : 1;
+}
@@ -0,0 +1,832 @@
+
+//----------------------------------------------------------------------------------------------------------------------
+// MeshCodecCheck
+//
+// Checks that compressed vertices and indices (see MeshCodec.h), and the cooked meshes that hold them (see
+// CookedMesh.h), come back exactly as they went in, and that cut short they throw rather than read past their end.
+// Runs without a device. It checks:
+//
+//    Synthetic vertices and indices: random and smoothly changing words, every vertex size up to 64 bytes, block
+//    sized counts and counts either side of them, and indices across the whole 32 bit range
+//    The vertices, indices and levels of detail of each polygon set of each file, imported as the engine imports them
+//    That each encoding, cut short or with a byte left over, throws
+//    That a compressed cooked mesh reads back the same geometry as was written, and that it throws if the file is
+//    cut short, or if any of its ENCODED sections is
+//    That an uncompressed cooked mesh throws if an index is out of range
+//    That an index whose varint does not fit in 32 bits throws
+//
+// For each file it also reports how well the geometry compresses, the size of the cooked mesh with and without
+// compression, and how fast vertices and indices decode on one thread.
+//
+// Usage:
+//
+//    MeshCodecCheck [-quantize] [-lod <ratio>]... [-repeat <count>] [<file>...]
+//
+// The files default to the sample scene's fighter and mine, relative to this tool's directory. Decoding is timed over
+// as many repeats as given, 100 by default. Cooked meshes are written to the working directory while they are checked.
+// Prints a line for each check and returns 0 if every check passed, 1 otherwise.
+//
+
+// EngineX Includes
+#include "Graphics\3D\CookedMesh.h"
+#include "Graphics\3D\MeshCodec.h"
+#include "Graphics\3D\PolygonSetImporter.h"
+
+// Standard Includes
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+namespace
+{
+   const char * const DEFAULT_FILES[] =
+   {
+      "../../Tests/0001_SpaceScene/Resources/Models/Argon_M3.dat",
+      "../../Tests/0001_SpaceScene/Resources/Models/asteroid_A_ClassMine.dat"
+   };
+
+   const unsigned NUM_DEFAULT_FILES = sizeof(DEFAULT_FILES) / sizeof(DEFAULT_FILES[0]);
+   const unsigned DEFAULT_REPEAT    = 100;
+
+   // Encodings up to this size are checked cut short at every length, larger ones at a few
+   const size_t MAX_EVERY_PREFIX_SIZE = 4096;
+
+   // Where cooked meshes are written while they are checked
+   const std::string RAW_COOKED_FILE     = "MeshCodecCheck_raw.exm";
+   const std::string ENCODED_COOKED_FILE = "MeshCodecCheck_encoded.exm";
+   const std::string CORRUPT_COOKED_FILE = "MeshCodecCheck_corrupt.exm";
+
+   const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+   typedef std::chrono::steady_clock Clock;
+
+   /**
+   * What was compressed and how long it took to decode, summed over several encodings
+   **/
+   struct CodecTotals
+   {
+      CodecTotals()
+         :
+         m_rawBytes(0),
+         m_encodedBytes(0),
+         m_decodedBytes(0),
+         m_decodeSeconds(0.0)
+      {
+      }
+
+      size_t m_rawBytes;
+      size_t m_encodedBytes;
+      double m_decodedBytes;    // Over every repeat
+      double m_decodeSeconds;   // Over every repeat
+   };
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Records a failed check
+   **/
+   template<typename T>
+   void Expect(const std::string & what, const T & actual, const T & expected, std::vector<std::string> & failures)
+   {
+      if( actual != expected )
+      {
+         std::ostringstream failure;
+         failure << what << " is " << actual << ", expected " << expected;
+         failures.push_back(failure.str());
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Gets the first element of data, or NULL if there is none
+   **/
+   template<typename T>
+   const T * GetData(const std::vector<T> & data)
+   {
+      return data.empty() ? NULL : &data[0];
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Gets the lengths to cut an encoding short to. Every length if it is small, otherwise a few.
+   **/
+   const std::vector<size_t> GetTruncatedSizes(const size_t size)
+   {
+      std::vector<size_t> sizes;
+
+      if( size <= MAX_EVERY_PREFIX_SIZE )
+      {
+         for(size_t i = 0; i < size; ++i)
+         {
+            sizes.push_back(i);
+         }
+      }
+      else
+      {
+         sizes.push_back(0);
+         sizes.push_back(1);
+         sizes.push_back(size / 2);
+         sizes.push_back(size - 1);
+      }
+
+      return sizes;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Query whether or not decoding vertices throws
+   **/
+   const bool DecodeVerticesThrows(const unsigned char * encoded,
+                                   const size_t encodedSize,
+                                   const unsigned numVertices,
+                                   const unsigned vertexSize)
+   {
+      try
+      {
+         std::vector<unsigned char> vertices;
+         DecodeVertices(encoded, encodedSize, numVertices, vertexSize, vertices);
+      }
+      catch(std::exception &)
+      {
+         return true;
+      }
+
+      return false;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Query whether or not decoding indices throws
+   **/
+   const bool DecodeIndicesThrows(const unsigned char * encoded,
+                                  const size_t encodedSize,
+                                  const unsigned numIndices)
+   {
+      try
+      {
+         std::vector<Index> indices;
+         DecodeIndices(encoded, encodedSize, numIndices, indices);
+      }
+      catch(std::exception &)
+      {
+         return true;
+      }
+
+      return false;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Query whether or not reading a cooked mesh throws
+   **/
+   const bool ReadCookedMeshThrows(const std::string & filepath)
+   {
+      try
+      {
+         std::vector<PolygonSetData> polygonSets;
+         ReadCookedMesh(filepath, polygonSets);
+      }
+      catch(std::exception &)
+      {
+         return true;
+      }
+
+      return false;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Encodes vertices, checks that they decode to the same bytes, and that the encoding cut short or with a byte
+   * left over throws
+   *
+   * @param repeat - How many times to time decoding, if at all
+   * @param totals - IN/OUT - Sizes and decoding time are added to these
+   **/
+   void CheckVertices(const std::string & what,
+                      const unsigned char * vertices,
+                      const unsigned numVertices,
+                      const unsigned vertexSize,
+                      const unsigned repeat,
+                      CodecTotals & totals,
+                      std::vector<std::string> & failures)
+   {
+      const size_t               size = static_cast<size_t>(numVertices) * vertexSize;
+      std::vector<unsigned char> encoded;
+      std::vector<unsigned char> decoded;
+
+      EncodeVertices(vertices, numVertices, vertexSize, encoded);
+      DecodeVertices(GetData(encoded), encoded.size(), numVertices, vertexSize, decoded);
+
+      if( decoded.size() != size || (size && memcmp(&decoded[0], vertices, size) != 0) )
+      {
+         failures.push_back(what + " decoded to different vertices");
+      }
+
+      const std::vector<size_t> truncatedSizes = GetTruncatedSizes(encoded.size());
+
+      for(std::vector<size_t>::const_iterator it = truncatedSizes.begin(); it != truncatedSizes.end(); ++it)
+      {
+         if( !DecodeVerticesThrows(GetData(encoded), *it, numVertices, vertexSize) )
+         {
+            std::ostringstream failure;
+            failure << what << " cut short to " << *it << " of " << encoded.size() << " bytes did not throw";
+            failures.push_back(failure.str());
+            break;
+         }
+      }
+
+      encoded.push_back(0);
+
+      if( !DecodeVerticesThrows(GetData(encoded), encoded.size(), numVertices, vertexSize) )
+      {
+         failures.push_back(what + " with a byte left over did not throw");
+      }
+
+      encoded.pop_back();
+
+      totals.m_rawBytes     += size;
+      totals.m_encodedBytes += encoded.size();
+
+      if( repeat )
+      {
+         const Clock::time_point start = Clock::now();
+
+         for(unsigned i = 0; i < repeat; ++i)
+         {
+            DecodeVertices(GetData(encoded), encoded.size(), numVertices, vertexSize, decoded);
+         }
+
+         const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+         totals.m_decodedBytes  += static_cast<double>(size) * repeat;
+         totals.m_decodeSeconds += elapsed.count();
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Encodes indices, checks that they decode to the same indices, and that the encoding cut short or with a byte
+   * left over throws
+   *
+   * @param repeat - How many times to time decoding, if at all
+   * @param totals - IN/OUT - Sizes and decoding time are added to these
+   **/
+   void CheckIndices(const std::string & what,
+                     const Index * indices,
+                     const unsigned numIndices,
+                     const unsigned repeat,
+                     CodecTotals & totals,
+                     std::vector<std::string> & failures)
+   {
+      const size_t               size = static_cast<size_t>(numIndices) * sizeof(Index);
+      std::vector<unsigned char> encoded;
+      std::vector<Index>         decoded;
+
+      EncodeIndices(indices, numIndices, encoded);
+      DecodeIndices(GetData(encoded), encoded.size(), numIndices, decoded);
+
+      if( decoded.size() != numIndices || (numIndices && memcmp(&decoded[0], indices, size) != 0) )
+      {
+         failures.push_back(what + " decoded to different indices");
+      }
+
+      const std::vector<size_t> truncatedSizes = GetTruncatedSizes(encoded.size());
+
+      for(std::vector<size_t>::const_iterator it = truncatedSizes.begin(); it != truncatedSizes.end(); ++it)
+      {
+         if( !DecodeIndicesThrows(GetData(encoded), *it, numIndices) )
+         {
+            std::ostringstream failure;
+            failure << what << " cut short to " << *it << " of " << encoded.size() << " bytes did not throw";
+            failures.push_back(failure.str());
+            break;
+         }
+      }
+
+      encoded.push_back(0);
+
+      if( !DecodeIndicesThrows(GetData(encoded), encoded.size(), numIndices) )
+      {
+         failures.push_back(what + " with a byte left over did not throw");
+      }
+
+      encoded.pop_back();
+
+      totals.m_rawBytes     += size;
+      totals.m_encodedBytes += encoded.size();
+
+      if( repeat )
+      {
+         const Clock::time_point start = Clock::now();
+
+         for(unsigned i = 0; i < repeat; ++i)
+         {
+            DecodeIndices(GetData(encoded), encoded.size(), numIndices, decoded);
+         }
+
+         const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+         totals.m_decodedBytes  += static_cast<double>(size) * repeat;
+         totals.m_decodeSeconds += elapsed.count();
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Checks that a polygon set read back from a cooked mesh has the same geometry as the one that was written
+   **/
+   void CompareGeometry(const std::string & what,
+                        const PolygonSetData & expected,
+                        const PolygonSetData & actual,
+                        std::vector<std::string> & failures)
+   {
+      const size_t numFailures = failures.size();
+
+      Expect(what + " vertex count",      actual.m_numVertices,           expected.m_numVertices,           failures);
+      Expect(what + " vertex size",       actual.GetVertexSize(),         expected.GetVertexSize(),         failures);
+      Expect(what + " index count",       actual.m_numIndices,            expected.m_numIndices,            failures);
+      Expect(what + " levels of detail",  actual.m_levelsOfDetail.size(), expected.m_levelsOfDetail.size(), failures);
+
+      if( actual.m_contentTypes != expected.m_contentTypes )
+      {
+         failures.push_back(what + " has different content types");
+      }
+
+      if( failures.size() != numFailures )
+      {
+         return;
+      }
+
+      if( memcmp(actual.GetVertexData(), expected.GetVertexData(), static_cast<size_t>(expected.m_numVertices) * expected.GetVertexSize()) != 0 )
+      {
+         failures.push_back(what + " has different vertices");
+      }
+
+      if( memcmp(actual.GetIndexData(), expected.GetIndexData(), expected.m_numIndices * sizeof(Index)) != 0 )
+      {
+         failures.push_back(what + " has different indices");
+      }
+
+      for(unsigned i = 0; i < expected.m_levelsOfDetail.size(); ++i)
+      {
+         std::ostringstream level;
+         level << what << " level of detail " << i;
+
+         const unsigned numIndices = expected.m_levelsOfDetail[i].m_numIndices;
+         Expect(level.str() + " index count", actual.m_levelsOfDetail[i].m_numIndices, numIndices, failures);
+
+         if( actual.m_levelsOfDetail[i].m_numIndices == numIndices &&
+             memcmp(actual.GetLevelOfDetailIndexData(i), expected.GetLevelOfDetailIndexData(i), numIndices * sizeof(Index)) != 0 )
+         {
+            failures.push_back(level.str() + " has different indices");
+         }
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Reads a whole file
+   *
+   * @throws std::runtime_error - If the file could not be read
+   **/
+   const std::vector<char> ReadWholeFile(const std::string & filepath)
+   {
+      std::ifstream file(filepath.c_str(), std::ios::binary | std::ios::ate);
+
+      if( !file )
+      {
+         throw std::runtime_error("Could not open " + filepath);
+      }
+
+      std::vector<char> contents(static_cast<size_t>(file.tellg()));
+      file.seekg(0);
+
+      if( !contents.empty() && !file.read(&contents[0], contents.size()) )
+      {
+         throw std::runtime_error("Could not read " + filepath);
+      }
+
+      return contents;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Writes a whole file
+   *
+   * @throws std::runtime_error - If the file could not be written
+   **/
+   void WriteWholeFile(const std::string & filepath, const std::vector<char> & contents, const size_t size)
+   {
+      std::ofstream file(filepath.c_str(), std::ios::binary | std::ios::trunc);
+
+      if( !file || (size && !file.write(&contents[0], size)) )
+      {
+         throw std::runtime_error("Could not write " + filepath);
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Checks that a compressed cooked mesh of some polygon sets reads back the same geometry, and that it throws
+   * when the file, or any of its ENCODED sections, is cut short. Checks that the uncompressed cooked mesh throws
+   * when an index is out of range.
+   *
+   * @param rawSize     - OUT - Size of the cooked mesh without compression, in bytes
+   * @param encodedSize - OUT - Size of the cooked mesh with compression, in bytes
+   **/
+   void CheckCookedMesh(const std::vector<PolygonSetData> & polygonSets,
+                        size_t & rawSize,
+                        size_t & encodedSize,
+                        std::vector<std::string> & failures)
+   {
+      WriteCookedMesh(RAW_COOKED_FILE, polygonSets, CookedMeshSettings(), false);
+      WriteCookedMesh(ENCODED_COOKED_FILE, polygonSets, CookedMeshSettings(), true);
+
+      const std::vector<char> rawContents = ReadWholeFile(RAW_COOKED_FILE);
+      rawSize = rawContents.size();
+
+      // The first index of the first polygon set refers to a vertex that is not there
+      CookedMeshHeader rawHeader;
+      memcpy(&rawHeader, &rawContents[0], sizeof(rawHeader));
+
+      for(unsigned i = 0; i < rawHeader.m_numSections; ++i)
+      {
+         CookedMeshSection section;
+         memcpy(&section, &rawContents[sizeof(rawHeader) + i * sizeof(CookedMeshSection)], sizeof(section));
+
+         if( section.m_type != COOKED_SECTION_INDICES || section.m_size < sizeof(Index) )
+         {
+            continue;
+         }
+
+         std::vector<char> corrupt(rawContents);
+         const Index       outOfRange = 0xFFFFFFFF;
+         memcpy(&corrupt[section.m_offset], &outOfRange, sizeof(outOfRange));
+
+         WriteWholeFile(CORRUPT_COOKED_FILE, corrupt, corrupt.size());
+
+         if( !ReadCookedMeshThrows(CORRUPT_COOKED_FILE) )
+         {
+            failures.push_back("Cooked mesh with an index out of range did not throw");
+         }
+
+         break;
+      }
+
+      // The polygon sets are released before the file is removed, which Windows does not allow while it is mapped
+      {
+         std::vector<PolygonSetData> cooked;
+         ReadCookedMesh(ENCODED_COOKED_FILE, cooked);
+
+         Expect("Cooked polygon sets", cooked.size(), polygonSets.size(), failures);
+
+         for(unsigned i = 0; i < cooked.size() && i < polygonSets.size(); ++i)
+         {
+            std::ostringstream what;
+            what << "Cooked polygon set " << i;
+            CompareGeometry(what.str(), polygonSets[i], cooked[i], failures);
+         }
+      }
+
+      std::vector<char> contents = ReadWholeFile(ENCODED_COOKED_FILE);
+      encodedSize = contents.size();
+
+      WriteWholeFile(CORRUPT_COOKED_FILE, contents, contents.size() - 1);
+
+      if( !ReadCookedMeshThrows(CORRUPT_COOKED_FILE) )
+      {
+         failures.push_back("Cooked mesh without its last byte did not throw");
+      }
+
+      // Each ENCODED section in turn claims to be a byte shorter than it is, the rest of the file as written
+      CookedMeshHeader header;
+      memcpy(&header, &contents[0], sizeof(header));
+
+      for(unsigned i = 0; i < header.m_numSections; ++i)
+      {
+         const size_t      sectionOffset = sizeof(header) + i * sizeof(CookedMeshSection);
+         CookedMeshSection section;
+         memcpy(&section, &contents[sectionOffset], sizeof(section));
+
+         if( (section.m_type != COOKED_SECTION_ENCODED_VERTICES &&
+              section.m_type != COOKED_SECTION_ENCODED_INDICES  &&
+              section.m_type != COOKED_SECTION_ENCODED_LOD_INDICES) || section.m_size == 0 )
+         {
+            continue;
+         }
+
+         std::vector<char> corrupt(contents);
+         --section.m_size;
+         memcpy(&corrupt[sectionOffset], &section, sizeof(section));
+
+         WriteWholeFile(CORRUPT_COOKED_FILE, corrupt, corrupt.size());
+
+         if( !ReadCookedMeshThrows(CORRUPT_COOKED_FILE) )
+         {
+            std::ostringstream failure;
+            failure << "Cooked mesh with section " << i << " of type " << section.m_type << " cut short did not throw";
+            failures.push_back(failure.str());
+         }
+      }
+
+      std::remove(RAW_COOKED_FILE.c_str());
+      std::remove(ENCODED_COOKED_FILE.c_str());
+      std::remove(CORRUPT_COOKED_FILE.c_str());
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Prints whether or not a check passed, and why not
+   **/
+   void WriteResult(const std::string & name, const std::vector<std::string> & failures)
+   {
+      std::cout << (failures.empty() ? "PASS " : "FAIL ") << name << "\n";
+
+      for(std::vector<std::string>::const_iterator it = failures.begin(); it != failures.end(); ++it)
+      {
+         std::cout << "   " << *it << "\n";
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Prints how well some geometry compressed and how fast it decoded
+   **/
+   void WriteTotals(const std::string & name, const CodecTotals & totals)
+   {
+      std::cout << "   " << name << ": " << totals.m_rawBytes << " bytes, " << totals.m_encodedBytes << " encoded";
+
+      if( totals.m_rawBytes )
+      {
+         std::cout << " (" << 100.0 * totals.m_encodedBytes / totals.m_rawBytes << "%)";
+      }
+
+      if( totals.m_decodeSeconds > 0.0 )
+      {
+         std::cout << ", decoded at " << totals.m_decodedBytes / BYTES_PER_MEGABYTE / totals.m_decodeSeconds << " MB/s";
+      }
+
+      std::cout << "\n";
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Checks vertices and indices made up to cover the cases the meshes might not
+   *
+   * @return - Whether or not every check passed. If not, prints why.
+   **/
+   const bool CheckSynthetic()
+   {
+      // Counts either side of the group and block sizes of the vertex codec
+      const unsigned COUNTS[]   = { 0, 1, 15, 16, 17, 255, 256, 257, 1000 };
+      const unsigned NUM_COUNTS = sizeof(COUNTS) / sizeof(COUNTS[0]);
+
+      std::vector<std::string> failures;
+      std::mt19937             random(1);
+      CodecTotals              totals;
+
+      try
+      {
+         for(unsigned c = 0; c < NUM_COUNTS; ++c)
+         {
+            const unsigned count = COUNTS[c];
+
+            for(unsigned vertexSize = 4; vertexSize <= 64; vertexSize += 4)
+            {
+               std::vector<unsigned char> noise(static_cast<size_t>(count) * vertexSize);
+               std::vector<unsigned char> smooth(noise.size());
+
+               for(size_t i = 0; i < noise.size(); ++i)
+               {
+                  noise[i] = static_cast<unsigned char>(random());
+               }
+
+               // Words that change by a little from one vertex to the next, either way, as attributes tend to
+               for(unsigned word = 0; word < vertexSize / 4; ++word)
+               {
+                  unsigned value = random();
+
+                  for(unsigned i = 0; i < count; ++i)
+                  {
+                     value += (random() % 65) - 32;
+                     memcpy(&smooth[static_cast<size_t>(i) * vertexSize + word * 4], &value, 4);
+                  }
+               }
+
+               std::ostringstream what;
+               what << count << " vertices of size " << vertexSize;
+
+               CheckVertices(what.str() + " of noise",            GetData(noise),  count, vertexSize, 0, totals, failures);
+               CheckVertices(what.str() + " that vary a little", GetData(smooth), count, vertexSize, 0, totals, failures);
+            }
+
+            // Indices anywhere in the 32 bit range, and a grid's triangles in the order they are usually drawn
+            const unsigned     numIndices = count * 3;
+            std::vector<Index> wide(numIndices);
+            std::vector<Index> grid(numIndices);
+
+            for(unsigned i = 0; i < numIndices; ++i)
+            {
+               wide[i] = (i % 7 == 0) ? 0xFFFFFFFF - (random() % 4) : static_cast<Index>(random());
+            }
+
+            for(unsigned i = 0; i < count; ++i)
+            {
+               const Index corner = (i / 2) + (i / 2) / 32;
+
+               grid[i * 3]     = corner + ((i % 2) ? 1 : 0);
+               grid[i * 3 + 1] = corner + ((i % 2) ? 34 : 1);
+               grid[i * 3 + 2] = corner + 33;
+            }
+
+            std::ostringstream what;
+            what << numIndices << " indices";
+
+            CheckIndices(what.str() + " anywhere in range", GetData(wide), numIndices, 0, totals, failures);
+            CheckIndices(what.str() + " of a grid",         GetData(grid), numIndices, 0, totals, failures);
+         }
+
+         // Sizes that are not a whole number of words are refused
+         std::vector<unsigned char> vertices(6, 0);
+         std::vector<unsigned char> encoded;
+         bool                       threw = false;
+
+         try
+         {
+            EncodeVertices(&vertices[0], 1, 6, encoded);
+         }
+         catch(std::exception &)
+         {
+            threw = true;
+         }
+
+         if( !threw )
+         {
+            failures.push_back("Encoding vertices of size 6 did not throw");
+         }
+
+         if( !DecodeVerticesThrows(&vertices[0], vertices.size(), 1, 6) )
+         {
+            failures.push_back("Decoding vertices of size 6 did not throw");
+         }
+
+         // An index's varint has 5 bytes at most, and the last of them only 4 bits to give
+         const unsigned char widest[]   = { 0xFF, 0xFF, 0xFF, 0xFF, 0x0F };
+         const unsigned char overlong[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x1F };
+
+         if( DecodeIndicesThrows(widest, sizeof(widest), 1) )
+         {
+            failures.push_back("Decoding an index whose varint fills 32 bits threw");
+         }
+
+         if( !DecodeIndicesThrows(overlong, sizeof(overlong), 1) )
+         {
+            failures.push_back("Decoding an index whose varint does not fit in 32 bits did not throw");
+         }
+      }
+      catch(std::exception & e)
+      {
+         failures.push_back(e.what());
+      }
+      catch(...)
+      {
+         failures.push_back("Unknown error");
+      }
+
+      WriteResult("Synthetic vertices and indices", failures);
+      return failures.empty();
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Checks the geometry of one file, and a cooked mesh of it
+   *
+   * @return - Whether or not every check passed. If not, prints why.
+   **/
+   const bool CheckFile(PolygonSetImporter & importer, const std::string & filepath, const unsigned repeat)
+   {
+      std::vector<std::string>    failures;
+      std::vector<PolygonSetData> polygonSets;
+      CodecTotals                 vertexTotals;
+      CodecTotals                 indexTotals;
+      size_t                      rawCookedSize     = 0;
+      size_t                      encodedCookedSize = 0;
+
+      try
+      {
+         importer.ImportFile(filepath, polygonSets);
+
+         for(unsigned i = 0; i < polygonSets.size(); ++i)
+         {
+            const PolygonSetData & polygonSet = polygonSets[i];
+
+            std::ostringstream what;
+            what << "Polygon set " << i;
+
+            CheckVertices(what.str() + " vertices", polygonSet.GetVertexData(), polygonSet.m_numVertices, polygonSet.GetVertexSize(), repeat, vertexTotals, failures);
+            CheckIndices(what.str() + " indices", polygonSet.GetIndexData(), polygonSet.m_numIndices, repeat, indexTotals, failures);
+
+            for(unsigned j = 0; j < polygonSet.m_levelsOfDetail.size(); ++j)
+            {
+               std::ostringstream level;
+               level << what.str() << " level of detail " << j << " indices";
+
+               CheckIndices(level.str(), polygonSet.GetLevelOfDetailIndexData(j), polygonSet.m_levelsOfDetail[j].m_numIndices, repeat, indexTotals, failures);
+            }
+         }
+
+         CheckCookedMesh(polygonSets, rawCookedSize, encodedCookedSize, failures);
+      }
+      catch(std::exception & e)
+      {
+         failures.push_back(e.what());
+      }
+      catch(...)
+      {
+         failures.push_back("Unknown error");
+      }
+
+      WriteResult(filepath, failures);
+
+      WriteTotals("Vertices", vertexTotals);
+      WriteTotals("Indices", indexTotals);
+
+      if( encodedCookedSize )
+      {
+         std::cout << "   Cooked mesh: " << rawCookedSize << " bytes, " << encodedCookedSize << " compressed\n";
+      }
+
+      return failures.empty();
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Writes how to use the tool
+   **/
+   void WriteUsage()
+   {
+      std::cerr << "Usage: MeshCodecCheck [-quantize] [-lod <ratio>]... [-repeat <count>] [<file>...]\n";
+   }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+int main(int argc, char * argv[])
+{
+   PolygonSetImporter       importer;
+   std::vector<std::string> filepaths;
+   std::vector<float>       levelOfDetailRatios;
+   unsigned                 repeat = DEFAULT_REPEAT;
+
+   for(int i = 1; i < argc; ++i)
+   {
+      const std::string argument(argv[i]);
+
+      if( argument == "-quantize" )
+      {
+         importer.SetQuantizeVertices(true);
+      }
+      else if( argument == "-lod" && i + 1 < argc )
+      {
+         levelOfDetailRatios.push_back(static_cast<float>(std::atof(argv[++i])));
+      }
+      else if( argument == "-repeat" && i + 1 < argc )
+      {
+         repeat = static_cast<unsigned>(std::atoi(argv[++i]));
+      }
+      else if( !argument.empty() && argument[0] == '-' )
+      {
+         WriteUsage();
+         return 1;
+      }
+      else
+      {
+         filepaths.push_back(argument);
+      }
+   }
+
+   if( filepaths.empty() )
+   {
+      filepaths.assign(DEFAULT_FILES, DEFAULT_FILES + NUM_DEFAULT_FILES);
+   }
+
+   importer.SetLevelOfDetailRatios(levelOfDetailRatios);
+
+   // Check everything, even after one check fails, so that one run covers it all
+   bool passedAll = CheckSynthetic();
+
+   for(std::vector<std::string>::const_iterator it = filepaths.begin(); it != filepaths.end(); ++it)
+   {
+      passedAll = CheckFile(importer, *it, repeat) && passedAll;
+   }
+
+   return passedAll ? 0 : 1;
+}
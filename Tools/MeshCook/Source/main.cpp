@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------------------------------------------------
+// MeshCook
+//
+// Cooks meshes ahead of time (see CookedMesh.h), so that the engine loads the cooked mesh next to each source file
+// rather than importing the source file. Runs without a device.
+//
+// Usage:
+//
+//    MeshCook [-quantize] [-clusters] [-lod <ratio>]... [-tangents] [-compress] [-stream] <file>...
+//
+// Each binary (.dat) or text (.txt) mesh is imported with the options given, and written to a cooked mesh (.exm)
+// next to it. The engine only uses a cooked mesh when it imports the file with the same options: the same
+// quantization, clusters and level of detail ratios set on its importer, and tangents asked for or not.
+// -compress compresses the vertices and indices (see MeshCodec.h), and -stream reads the source files through a
+// buffer rather than mapping them. Neither changes what is cooked.
+//
+// Prints the path and size of each cooked mesh, and returns 0 if every file was cooked, 1 otherwise.
+//
+
+// EngineX Includes
+#include "Graphics\3D\CookedMesh.h"
+#include "Graphics\3D\PolygonSetImporter.h"
+
+// Standard Includes
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+namespace
+{
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Cooks one file, and prints where it went or why it could not be cooked
+   *
+   * @return - false if the file could not be cooked
+   **/
+   const bool Cook(PolygonSetImporter & importer, const std::string & filepath, const bool generateTangentData)
+   {
+      const std::string cookedFilepath = GetCookedMeshFilePath(filepath);
+
+      try
+      {
+         importer.CookFile(filepath, generateTangentData);
+      }
+      catch(std::exception & e)
+      {
+         std::cerr << "Failed to cook " << filepath << ": " << e.what() << "\n";
+         return false;
+      }
+      catch(...)
+      {
+         std::cerr << "Failed to cook " << filepath << ": Unknown error\n";
+         return false;
+      }
+
+      std::ifstream cooked(cookedFilepath.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+      std::cout << cookedFilepath << " " << static_cast<long long>(cooked.tellg()) << " bytes\n";
+
+      return true;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   void WriteUsage()
+   {
+      std::cerr << "Usage: MeshCook [-quantize] [-clusters] [-lod <ratio>]... [-tangents] [-compress] [-stream] <file>...\n";
+   }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+int main(int argc, char * argv[])
+{
+   PolygonSetImporter       importer;
+   std::vector<std::string> filepaths;
+   std::vector<float>       levelOfDetailRatios;
+   bool                     generateTangentData = false;
+
+   for(int i = 1; i < argc; ++i)
+   {
+      const std::string argument(argv[i]);
+
+      if( argument == "-quantize" )
+      {
+         importer.SetQuantizeVertices(true);
+      }
+      else if( argument == "-clusters" )
+      {
+         importer.SetGenerateClusters(true);
+      }
+      else if( argument == "-lod" && i + 1 < argc )
+      {
+         levelOfDetailRatios.push_back(static_cast<float>(std::atof(argv[++i])));
+      }
+      else if( argument == "-tangents" )
+      {
+         generateTangentData = true;
+      }
+      else if( argument == "-compress" )
+      {
+         importer.SetCompressCookedMeshes(true);
+      }
+      else if( argument == "-stream" )
+      {
+         importer.SetStreamSourceFiles(true);
+      }
+      else if( !argument.empty() && argument[0] == '-' )
+      {
+         WriteUsage();
+         return 1;
+      }
+      else
+      {
+         filepaths.push_back(argument);
+      }
+   }
+
+   if( filepaths.empty() )
+   {
+      WriteUsage();
+      return 1;
+   }
+
+   importer.SetLevelOfDetailRatios(levelOfDetailRatios);
+
+   // Cook every file, even after one fails
+   bool cookedAll = true;
+
+   for(std::vector<std::string>::const_iterator it = filepaths.begin(); it != filepaths.end(); ++it)
+   {
+      cookedAll = Cook(importer, *it, generateTangentData) && cookedAll;
+   }
+
+   return cookedAll ? 0 : 1;
+}
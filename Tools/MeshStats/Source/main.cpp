@@ -0,0 +1,344 @@
+
+//----------------------------------------------------------------------------------------------------------------------
+// MeshStats
+//
+// Reports what meshes cost to store and to draw, as JSON, so that assets can be reviewed before they are checked in.
+// Runs without a device. For each polygon set of each file it reports:
+//
+//    Vertex and triangle counts, and how many of the vertices the source file stored were duplicates
+//    Indices left over after the last whole triangle, which the source file should not have
+//    Vertex cache efficiency (ACMR and ATVR) of the indices as they are drawn, and as they were before optimization
+//    Overdraw, estimated from six fixed views (see MeshStatistics.h)
+//    Bounds
+//    Memory taken by each content type of the vertices, the indices, and the indices of any levels of detail
+//
+// Usage:
+//
+//    MeshStats [-resolution <pixels>] [-quantize] [-clusters] [-lod <ratio>]... <file>...
+//
+// Binary (.dat) and text (.txt) meshes are imported exactly as the engine imports them, with the options given.
+// Cooked meshes (.exm) are read as they are. Returns 0 if every file was measured, 1 otherwise.
+//
+
+// EngineX Includes
+#include "Graphics\3D\CookedMesh.h"
+#include "Graphics\3D\MeshStatistics.h"
+#include "Graphics\3D\PolygonSetImporter.h"
+
+// Standard Includes
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+namespace
+{
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Gets a name for a content type, that tells the quantized ones apart
+   **/
+   const std::string GetContentTypeName(const BufferContentType contentType)
+   {
+      switch( contentType )
+      {
+      case POSITION16:   return "POSITION16";
+      case NORMAL16:     return "NORMAL16";
+      case TEXCOORD2D16: return "TEXCOORD2D16";
+      case TEXCOORD1D:   return "TEXCOORD1D";
+      case TEXCOORD2D:   return "TEXCOORD2D";
+      case TEXCOORD3D:   return "TEXCOORD3D";
+      default:           return ContentTypeToSemanticName(contentType);
+      }
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Quotes a string for JSON
+   **/
+   const std::string Quote(const std::string & text)
+   {
+      std::ostringstream quoted;
+      quoted << '"';
+
+      for(std::string::const_iterator it = text.begin(); it != text.end(); ++it)
+      {
+         if( *it == '"' || *it == '\\' )
+         {
+            quoted << '\\' << *it;
+         }
+         else if( static_cast<unsigned char>(*it) < 0x20 )
+         {
+            quoted << ' ';
+         }
+         else
+         {
+            quoted << *it;
+         }
+      }
+
+      quoted << '"';
+      return quoted.str();
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Query whether or not a file is a cooked mesh, by its extension
+   **/
+   const bool IsCookedMeshFile(const std::string & filepath)
+   {
+      return filepath.size() > 4 && filepath.compare(filepath.size() - 4, 4, ".exm") == 0;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Writes vertex cache statistics as a JSON object
+   **/
+   void WriteVertexCache(std::ostream & out, const VertexCacheStatistics & statistics)
+   {
+      out << "{ \"triangles\": "   << statistics.m_numTriangles
+          << ", \"verticesUsed\": " << statistics.m_numVerticesUsed
+          << ", \"transformed\": "  << statistics.m_numTransformed
+          << ", \"acmr\": "         << statistics.m_acmr
+          << ", \"atvr\": "         << statistics.m_atvr
+          << " }";
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Writes a vector as a JSON array
+   **/
+   void WriteVector(std::ostream & out, const D3DXVECTOR3 & vector)
+   {
+      out << "[" << vector.x << ", " << vector.y << ", " << vector.z << "]";
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Writes the statistics of one polygon set as a JSON object
+   **/
+   void WritePolygonSet(std::ostream & out,
+                        const PolygonSetData & polygonSet,
+                        const MeshStatistics & statistics,
+                        const unsigned resolution)
+   {
+      out << "        {\n"
+          << "          \"vertices\": "             << statistics.m_numVertices          << ",\n"
+          << "          \"triangles\": "            << statistics.m_numTriangles         << ",\n"
+          << "          \"sourceVertices\": "       << statistics.m_numSourceVertices    << ",\n"
+          << "          \"weldedVertices\": "       << statistics.m_numWeldedVertices    << ",\n"
+          << "          \"duplicateVertexRatio\": " << statistics.m_duplicateVertexRatio << ",\n"
+          << "          \"quantized\": "            << (polygonSet.IsQuantized() ? "true" : "false") << ",\n"
+          << "          \"levelsOfDetail\": "       << polygonSet.m_levelsOfDetail.size() << ",\n"
+          << "          \"clusters\": "             << polygonSet.m_clusters.size()       << ",\n"
+          << "          \"submeshes\": "            << polygonSet.m_submeshes.size()      << ",\n"
+          << "          \"leftoverIndices\": "      << polygonSet.m_optimizationReport.m_numLeftoverIndices << ",\n";
+
+      out << "          \"vertexCache\": ";
+      WriteVertexCache(out, statistics.m_vertexCache);
+      out << ",\n";
+
+      out << "          \"importedVertexCache\": ";
+      WriteVertexCache(out, polygonSet.m_optimizationReport.m_before);
+      out << ",\n";
+
+      out << "          \"overdraw\": { \"ratio\": "        << statistics.m_overdraw
+          << ", \"pixelsCovered\": "   << statistics.m_numPixelsCovered
+          << ", \"fragmentsShaded\": " << statistics.m_numFragmentsShaded
+          << ", \"views\": 6, \"resolution\": " << resolution
+          << " },\n";
+
+      out << "          \"bounds\": { \"min\": ";
+      WriteVector(out, statistics.m_bounds.m_boxMin);
+      out << ", \"max\": ";
+      WriteVector(out, statistics.m_bounds.m_boxMax);
+      out << ", \"sphereCenter\": ";
+      WriteVector(out, statistics.m_bounds.m_sphereCenter);
+      out << ", \"sphereRadius\": " << statistics.m_bounds.m_sphereRadius << " },\n";
+
+      out << "          \"memory\": {\n"
+          << "            \"attributes\": [";
+
+      for(std::vector<MeshStatistics::AttributeMemory>::const_iterator it = statistics.m_attributeMemory.begin(); it != statistics.m_attributeMemory.end(); ++it)
+      {
+         out << (it == statistics.m_attributeMemory.begin() ? " " : ", ")
+             << "{ \"contentType\": " << Quote(GetContentTypeName(it->m_contentType))
+             << ", \"bytes\": " << it->m_numBytes << " }";
+      }
+
+      out << " ],\n"
+          << "            \"vertexBytes\": "             << statistics.m_vertexBytes             << ",\n"
+          << "            \"indexBytes\": "              << statistics.m_indexBytes              << ",\n"
+          << "            \"levelOfDetailIndexBytes\": " << statistics.m_levelOfDetailIndexBytes << ",\n"
+          << "            \"totalBytes\": "
+          << statistics.m_vertexBytes + statistics.m_indexBytes + statistics.m_levelOfDetailIndexBytes << "\n"
+          << "          }\n"
+          << "        }";
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Measures one file and writes it as a JSON object
+   *
+   * @return - Whether or not the file could be measured. If not, the object holds the error instead.
+   **/
+   const bool WriteFile(std::ostream & out,
+                        PolygonSetImporter & importer,
+                        const std::string & filepath,
+                        const unsigned resolution)
+   {
+      std::vector<PolygonSetData> polygonSets;
+      std::vector<MeshStatistics> statistics;
+      std::string                 error;
+
+      try
+      {
+         if( IsCookedMeshFile(filepath) )
+         {
+            ReadCookedMesh(filepath, polygonSets);
+         }
+         else
+         {
+            importer.ImportFile(filepath, polygonSets);
+         }
+
+         for(std::vector<PolygonSetData>::const_iterator it = polygonSets.begin(); it != polygonSets.end(); ++it)
+         {
+            statistics.push_back(AnalyzeMesh(*it, resolution));
+         }
+      }
+      catch(std::exception & e)
+      {
+         error = e.what();
+      }
+      catch(...)
+      {
+         error = "Unknown error";
+      }
+
+      out << "    {\n"
+          << "      \"path\": " << Quote(filepath) << ",\n";
+
+      if( !error.empty() )
+      {
+         out << "      \"error\": " << Quote(error) << "\n"
+             << "    }";
+
+         return false;
+      }
+
+      // Totals over the polygon sets
+      unsigned numVertices       = 0;
+      unsigned numTriangles      = 0;
+      unsigned numSourceVertices = 0;
+      unsigned numWeldedVertices = 0;
+      unsigned numBytes          = 0;
+
+      for(std::vector<MeshStatistics>::const_iterator it = statistics.begin(); it != statistics.end(); ++it)
+      {
+         numVertices       += it->m_numVertices;
+         numTriangles      += it->m_numTriangles;
+         numSourceVertices += it->m_numSourceVertices;
+         numWeldedVertices += it->m_numWeldedVertices;
+         numBytes          += it->m_vertexBytes + it->m_indexBytes + it->m_levelOfDetailIndexBytes;
+      }
+
+      const float duplicateVertexRatio = numSourceVertices ? 1.0f - static_cast<float>(numWeldedVertices) / numSourceVertices : 0.0f;
+
+      out << "      \"polygonSets\": [\n";
+
+      for(unsigned i = 0; i < polygonSets.size(); ++i)
+      {
+         WritePolygonSet(out, polygonSets[i], statistics[i], resolution);
+         out << (i + 1 < polygonSets.size() ? ",\n" : "\n");
+      }
+
+      out << "      ],\n"
+          << "      \"totals\": { \"vertices\": " << numVertices
+          << ", \"triangles\": "            << numTriangles
+          << ", \"sourceVertices\": "       << numSourceVertices
+          << ", \"weldedVertices\": "       << numWeldedVertices
+          << ", \"duplicateVertexRatio\": " << duplicateVertexRatio
+          << ", \"bytes\": "                << numBytes
+          << " }\n"
+          << "    }";
+
+      return true;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   /**
+   * Writes how to use the tool
+   **/
+   void WriteUsage()
+   {
+      std::cerr << "Usage: MeshStats [-resolution <pixels>] [-quantize] [-clusters] [-lod <ratio>]... <file>...\n";
+   }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+int main(int argc, char * argv[])
+{
+   PolygonSetImporter       importer;
+   std::vector<std::string> filepaths;
+   std::vector<float>       levelOfDetailRatios;
+   unsigned                 resolution = OVERDRAW_RESOLUTION;
+
+   for(int i = 1; i < argc; ++i)
+   {
+      const std::string argument(argv[i]);
+
+      if( argument == "-resolution" && i + 1 < argc )
+      {
+         resolution = static_cast<unsigned>(std::atoi(argv[++i]));
+      }
+      else if( argument == "-quantize" )
+      {
+         importer.SetQuantizeVertices(true);
+      }
+      else if( argument == "-clusters" )
+      {
+         importer.SetGenerateClusters(true);
+      }
+      else if( argument == "-lod" && i + 1 < argc )
+      {
+         levelOfDetailRatios.push_back(static_cast<float>(std::atof(argv[++i])));
+      }
+      else if( !argument.empty() && argument[0] == '-' )
+      {
+         WriteUsage();
+         return 1;
+      }
+      else
+      {
+         filepaths.push_back(argument);
+      }
+   }
+
+   if( filepaths.empty() || resolution == 0 )
+   {
+      WriteUsage();
+      return 1;
+   }
+
+   importer.SetLevelOfDetailRatios(levelOfDetailRatios);
+
+   // Write every file, even after one fails, so that one report covers them all
+   bool measuredAll = true;
+
+   std::cout << "{\n"
+             << "  \"files\": [\n";
+
+   for(unsigned i = 0; i < filepaths.size(); ++i)
+   {
+      measuredAll = WriteFile(std::cout, importer, filepaths[i], resolution) && measuredAll;
+      std::cout << (i + 1 < filepaths.size() ? ",\n" : "\n");
+   }
+
+   std::cout << "  ]\n"
+             << "}\n";
+
+   return measuredAll ? 0 : 1;
+}